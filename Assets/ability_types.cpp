@@ -1,5 +1,8 @@
 #include "ability_types.h"
 #include "../core/engine.h"
+#include "../physics/spatial_grid.h"
+#include "damage_batch.h"
+#include "projectile_system.h"
 
 namespace CHULUBME {
 
@@ -19,13 +22,18 @@ void TargetedAbility::Initialize() {
     Ability::Initialize();
 }
 
+void TargetedAbility::SetParameters(const AbilityParameters& parameters) {
+    SetDamage(parameters.baseDamage, parameters.damagePerLevel, parameters.apRatio, parameters.adRatio);
+    SetMagicalDamage(parameters.isMagicalDamage != 0);
+}
+
 bool TargetedAbility::Use(Entity caster, Entity target) {
     if (!Ability::Use(caster, target)) {
         return false;
     }
     
-    // Check if target is valid
-    if (!target.IsActive()) {
+    // Check if target is valid (stale handles to destroyed entities are rejected)
+    if (!target.IsValid() || !target.IsActive()) {
         return false;
     }
     
@@ -66,13 +74,19 @@ void AreaOfEffectAbility::Initialize() {
     Ability::Initialize();
 }
 
+void AreaOfEffectAbility::SetParameters(const AbilityParameters& parameters) {
+    SetRadius(parameters.radius);
+    SetDamage(parameters.baseDamage, parameters.damagePerLevel, parameters.apRatio, parameters.adRatio);
+    SetMagicalDamage(parameters.isMagicalDamage != 0);
+}
+
 bool AreaOfEffectAbility::UseAtPosition(Entity caster, const glm::vec3& position) {
     if (!Ability::Use(caster)) {
         return false;
     }
     
     // Find targets in area
-    std::vector<Entity> targets = FindTargetsInArea(position);
+    TargetList targets = FindTargetsInArea(caster, position);
     
     // Apply effects to targets
     return ApplyEffects(caster, position, targets);
@@ -89,15 +103,30 @@ float AreaOfEffectAbility::GetDamage() const {
     return m_baseDamage + (m_damagePerLevel * (m_level - 1));
 }
 
-bool AreaOfEffectAbility::ApplyEffects(Entity caster, const glm::vec3& position, const std::vector<Entity>& targets) {
+bool AreaOfEffectAbility::ApplyEffects(Entity caster, const glm::vec3& position, const TargetList& targets) {
     // Default implementation does nothing
     return true;
 }
 
-std::vector<Entity> AreaOfEffectAbility::FindTargetsInArea(const glm::vec3& position) const {
-    // TODO: Implement proper target finding using physics system
-    // For now, just return an empty vector
-    return std::vector<Entity>();
+TargetList AreaOfEffectAbility::FindTargetsInArea(Entity caster, const glm::vec3& position) const {
+    TargetList targets;
+    
+    EntityManager* manager = caster.GetManager();
+    SpatialSystem* spatialSystem = manager ? manager->GetSystem<SpatialSystem>() : nullptr;
+    if (!spatialSystem) {
+        return targets;
+    }
+    
+    FrameVector<EntityID> hits;
+    spatialSystem->GetGrid().QueryRadius(position, m_radius, hits);
+    
+    for (EntityID hit : hits) {
+        if (hit != caster.GetID()) {
+            targets.emplace_back(hit, manager);
+        }
+    }
+    
+    return targets;
 }
 
 // SkillshotAbility implementation
@@ -118,6 +147,13 @@ void SkillshotAbility::Initialize() {
     Ability::Initialize();
 }
 
+void SkillshotAbility::SetParameters(const AbilityParameters& parameters) {
+    SetWidth(parameters.width);
+    SetSpeed(parameters.speed);
+    SetDamage(parameters.baseDamage, parameters.damagePerLevel, parameters.apRatio, parameters.adRatio);
+    SetMagicalDamage(parameters.isMagicalDamage != 0);
+}
+
 bool SkillshotAbility::UseInDirection(Entity caster, const glm::vec3& direction) {
     if (!Ability::Use(caster)) {
         return false;
@@ -131,8 +167,13 @@ bool SkillshotAbility::UseInDirection(Entity caster, const glm::vec3& direction)
     
     glm::vec3 origin = transform->GetPosition();
     
+    // Travelling skillshots hit whatever they cross on later updates
+    if (LaunchProjectile(caster, origin, direction)) {
+        return true;
+    }
+    
     // Find targets hit by skillshot
-    std::vector<Entity> targets = FindTargetsInSkillshot(origin, direction);
+    TargetList targets = FindTargetsInSkillshot(caster, origin, direction);
     
     // Apply effects to targets
     return ApplyEffects(caster, origin, direction, targets);
@@ -149,15 +190,38 @@ float SkillshotAbility::GetDamage() const {
     return m_baseDamage + (m_damagePerLevel * (m_level - 1));
 }
 
-bool SkillshotAbility::ApplyEffects(Entity caster, const glm::vec3& origin, const glm::vec3& direction, const std::vector<Entity>& targets) {
+bool SkillshotAbility::ApplyEffects(Entity caster, const glm::vec3& origin, const glm::vec3& direction, const TargetList& targets) {
     // Default implementation does nothing
     return true;
 }
 
-std::vector<Entity> SkillshotAbility::FindTargetsInSkillshot(const glm::vec3& origin, const glm::vec3& direction) const {
-    // TODO: Implement proper target finding using physics system
-    // For now, just return an empty vector
-    return std::vector<Entity>();
+bool SkillshotAbility::LaunchProjectile(Entity caster, const glm::vec3& origin, const glm::vec3& direction) {
+    // Default implementation hits instantly
+    return false;
+}
+
+TargetList SkillshotAbility::FindTargetsInSkillshot(Entity caster, const glm::vec3& origin, const glm::vec3& direction) const {
+    TargetList targets;
+    
+    EntityManager* manager = caster.GetManager();
+    SpatialSystem* spatialSystem = manager ? manager->GetSystem<SpatialSystem>() : nullptr;
+    if (!spatialSystem || glm::length(direction) <= 0.0f) {
+        return targets;
+    }
+    
+    // Sweep the skillshot width along its full range
+    const glm::vec3 end = origin + glm::normalize(direction) * m_range;
+    
+    FrameVector<EntityID> hits;
+    spatialSystem->GetGrid().QueryCapsule(origin, end, m_width * 0.5f, hits);
+    
+    for (EntityID hit : hits) {
+        if (hit != caster.GetID()) {
+            targets.emplace_back(hit, manager);
+        }
+    }
+    
+    return targets;
 }
 
 // SelfBuffAbility implementation
@@ -166,7 +230,7 @@ SelfBuffAbility::SelfBuffAbility(const std::string& abilityId, const std::string
     , m_duration(0.0f)
     , m_remainingDuration(0.0f)
     , m_isActive(false)
-    , m_activeCaster(0, nullptr)
+    , m_activeCaster(INVALID_ENTITY, nullptr)
 {
     m_abilityType = AbilityType::SelfBuff;
 }
@@ -177,6 +241,10 @@ void SelfBuffAbility::Initialize() {
     m_remainingDuration = 0.0f;
 }
 
+void SelfBuffAbility::SetParameters(const AbilityParameters& parameters) {
+    SetDuration(parameters.duration);
+}
+
 bool SelfBuffAbility::Use(Entity caster, Entity target) {
     if (!Ability::Use(caster)) {
         return false;
@@ -209,7 +277,7 @@ void SelfBuffAbility::Update(float deltaTime) {
         if (m_remainingDuration <= 0.0f) {
             RemoveBuffEffects(m_activeCaster);
             m_isActive = false;
-            m_activeCaster = Entity(0, nullptr);
+            m_activeCaster = Entity(INVALID_ENTITY, nullptr);
             m_remainingDuration = 0.0f;
         }
     }
@@ -247,7 +315,7 @@ bool DamageAbility::ApplyEffects(Entity caster, Entity target) {
     float damage = GetDamage();
     
     // Add AP and AD scaling
-    HeroStats casterStats = casterHero->GetCurrentStats();
+    const CombatStats& casterStats = casterHero->GetCombatStats();
     damage += casterStats.abilityPower * m_apRatio;
     damage += casterStats.attackDamage * m_adRatio;
     
@@ -270,6 +338,11 @@ void HealAbility::Initialize() {
     TargetedAbility::Initialize();
 }
 
+void HealAbility::SetParameters(const AbilityParameters& parameters) {
+    TargetedAbility::SetParameters(parameters);
+    SetHealing(parameters.baseHealing, parameters.healingPerLevel, parameters.apRatio);
+}
+
 void HealAbility::SetHealing(float baseHealing, float healingPerLevel, float apRatio) {
     m_baseHealing = baseHealing;
     m_healingPerLevel = healingPerLevel;
@@ -293,7 +366,7 @@ bool HealAbility::ApplyEffects(Entity caster, Entity target) {
     float healing = GetHealing();
     
     // Add AP scaling
-    HeroStats casterStats = casterHero->GetCurrentStats();
+    const CombatStats& casterStats = casterHero->GetCombatStats();
     healing += casterStats.abilityPower * m_apRatio;
     
     // Apply healing to target
@@ -312,7 +385,7 @@ void AreaDamageAbility::Initialize() {
     AreaOfEffectAbility::Initialize();
 }
 
-bool AreaDamageAbility::ApplyEffects(Entity caster, const glm::vec3& position, const std::vector<Entity>& targets) {
+bool AreaDamageAbility::ApplyEffects(Entity caster, const glm::vec3& position, const TargetList& targets) {
     // Get caster hero component
     HeroComponent* casterHero = caster.GetComponent<HeroComponent>();
     
@@ -324,18 +397,16 @@ bool AreaDamageAbility::ApplyEffects(Entity caster, const glm::vec3& position, c
     float damage = GetDamage();
     
     // Add AP and AD scaling
-    HeroStats casterStats = casterHero->GetCurrentStats();
+    const CombatStats& casterStats = casterHero->GetCombatStats();
     damage += casterStats.abilityPower * m_apRatio;
     damage += casterStats.attackDamage * m_adRatio;
     
-    // Apply damage to all targets
+    // Apply damage to all targets in one batch; stale handles resolve to no component
+    DamageBatch batch(caster.GetManager());
     for (Entity target : targets) {
-        HeroComponent* targetHero = target.GetComponent<HeroComponent>();
-        
-        if (targetHero) {
-            targetHero->TakeDamage(damage, m_isMagicalDamage);
-        }
+        batch.Add(caster.GetID(), target.GetID(), damage, m_isMagicalDamage);
     }
+    batch.Resolve();
     
     return true;
 }
@@ -350,7 +421,7 @@ void SkillshotDamageAbility::Initialize() {
     SkillshotAbility::Initialize();
 }
 
-bool SkillshotDamageAbility::ApplyEffects(Entity caster, const glm::vec3& origin, const glm::vec3& direction, const std::vector<Entity>& targets) {
+bool SkillshotDamageAbility::ApplyEffects(Entity caster, const glm::vec3& origin, const glm::vec3& direction, const TargetList& targets) {
     // Get caster hero component
     HeroComponent* casterHero = caster.GetComponent<HeroComponent>();
     
@@ -359,23 +430,49 @@ bool SkillshotDamageAbility::ApplyEffects(Entity caster, const glm::vec3& origin
     }
     
     // Calculate damage
+    float damage = GetScaledDamage(*casterHero);
+    
+    // Apply damage to all targets in one batch; stale handles resolve to no component
+    DamageBatch batch(caster.GetManager());
+    for (Entity target : targets) {
+        batch.Add(caster.GetID(), target.GetID(), damage, m_isMagicalDamage);
+    }
+    batch.Resolve();
+    
+    return true;
+}
+
+bool SkillshotDamageAbility::LaunchProjectile(Entity caster, const glm::vec3& origin, const glm::vec3& direction) {
+    HeroComponent* casterHero = caster.GetComponent<HeroComponent>();
+    ProjectileSystem* projectileSystem = caster.GetManager() ? caster.GetManager()->GetSystem<ProjectileSystem>() : nullptr;
+    if (!casterHero || !projectileSystem || m_speed <= 0.0f) {
+        return false;
+    }
+    
+    // Damage is fixed when the projectile is launched
+    ProjectileDesc desc;
+    desc.caster = caster.GetID();
+    desc.origin = origin;
+    desc.direction = direction;
+    desc.speed = m_speed;
+    desc.range = m_range;
+    desc.radius = m_width * 0.5f;
+    desc.damage = GetScaledDamage(*casterHero);
+    desc.isMagical = m_isMagicalDamage;
+    projectileSystem->Launch(desc);
+    
+    return true;
+}
+
+float SkillshotDamageAbility::GetScaledDamage(const HeroComponent& casterHero) const {
     float damage = GetDamage();
     
     // Add AP and AD scaling
-    HeroStats casterStats = casterHero->GetCurrentStats();
+    const CombatStats& casterStats = casterHero.GetCombatStats();
     damage += casterStats.abilityPower * m_apRatio;
     damage += casterStats.attackDamage * m_adRatio;
     
-    // Apply damage to all targets
-    for (Entity target : targets) {
-        HeroComponent* targetHero = target.GetComponent<HeroComponent>();
-        
-        if (targetHero) {
-            targetHero->TakeDamage(damage, m_isMagicalDamage);
-        }
-    }
-    
-    return true;
+    return damage;
 }
 
 // MovementSpeedBuffAbility implementation
@@ -389,6 +486,11 @@ void MovementSpeedBuffAbility::Initialize() {
     SelfBuffAbility::Initialize();
 }
 
+void MovementSpeedBuffAbility::SetParameters(const AbilityParameters& parameters) {
+    SelfBuffAbility::SetParameters(parameters);
+    SetMovementSpeedBonus(parameters.movementSpeedBonus);
+}
+
 bool MovementSpeedBuffAbility::ApplyBuffEffects(Entity caster) {
     // Get hero component
     HeroComponent* heroComponent = caster.GetComponent<HeroComponent>();
@@ -398,12 +500,7 @@ bool MovementSpeedBuffAbility::ApplyBuffEffects(Entity caster) {
     }
     
     // Apply movement speed bonus
-    // Note: This is a simplified implementation. In a real game, you would
-    // have a more complex stat modification system.
-    HeroStats currentStats = heroComponent->GetCurrentStats();
-    currentStats.movementSpeed += m_movementSpeedBonus;
-    
-    // TODO: Apply modified stats to hero
+    heroComponent->AddStatModifier(StatModifier(StatType::MovementSpeed, StatModifierType::Flat, m_movementSpeedBonus, this));
     
     return true;
 }
@@ -417,12 +514,7 @@ void MovementSpeedBuffAbility::RemoveBuffEffects(Entity caster) {
     }
     
     // Remove movement speed bonus
-    // Note: This is a simplified implementation. In a real game, you would
-    // have a more complex stat modification system.
-    HeroStats currentStats = heroComponent->GetCurrentStats();
-    currentStats.movementSpeed -= m_movementSpeedBonus;
-    
-    // TODO: Apply modified stats to hero
+    heroComponent->RemoveStatModifiers(this);
 }
 
 // AttackDamageBuffAbility implementation
@@ -436,6 +528,11 @@ void AttackDamageBuffAbility::Initialize() {
     SelfBuffAbility::Initialize();
 }
 
+void AttackDamageBuffAbility::SetParameters(const AbilityParameters& parameters) {
+    SelfBuffAbility::SetParameters(parameters);
+    SetAttackDamageBonus(parameters.attackDamageBonus);
+}
+
 bool AttackDamageBuffAbility::ApplyBuffEffects(Entity caster) {
     // Get hero component
     HeroComponent* heroComponent = caster.GetComponent<HeroComponent>();
@@ -445,12 +542,7 @@ bool AttackDamageBuffAbility::ApplyBuffEffects(Entity caster) {
     }
     
     // Apply attack damage bonus
-    // Note: This is a simplified implementation. In a real game, you would
-    // have a more complex stat modification system.
-    HeroStats currentStats = heroComponent->GetCurrentStats();
-    currentStats.attackDamage += m_attackDamageBonus;
-    
-    // TODO: Apply modified stats to hero
+    heroComponent->AddStatModifier(StatModifier(StatType::AttackDamage, StatModifierType::Flat, m_attackDamageBonus, this));
     
     return true;
 }
@@ -464,12 +556,7 @@ void AttackDamageBuffAbility::RemoveBuffEffects(Entity caster) {
     }
     
     // Remove attack damage bonus
-    // Note: This is a simplified implementation. In a real game, you would
-    // have a more complex stat modification system.
-    HeroStats currentStats = heroComponent->GetCurrentStats();
-    currentStats.attackDamage -= m_attackDamageBonus;
-    
-    // TODO: Apply modified stats to hero
+    heroComponent->RemoveStatModifiers(this);
 }
 
 } // namespace CHULUBME
@@ -5,6 +5,9 @@
 
 namespace CHULUBME {
 
+// Targets found by an ability cast; stored in the casting thread's frame arena
+using TargetList = FrameVector<Entity>;
+
 /**
  * @brief Base class for targeted abilities
  */
@@ -16,8 +19,11 @@ public:
     // Initialize the ability
     void Initialize() override;
     
+    // Apply the damage parameters
+    void SetParameters(const AbilityParameters& parameters) override;
+    
     // Use the ability on a target
-    bool Use(Entity caster, Entity target = Entity(0, nullptr)) override;
+    bool Use(Entity caster, Entity target = Entity(INVALID_ENTITY, nullptr)) override;
     
     // Set damage
     void SetDamage(float baseDamage, float damagePerLevel, float apRatio, float adRatio);
@@ -54,6 +60,9 @@ public:
     // Initialize the ability
     void Initialize() override;
     
+    // Apply the radius and damage parameters
+    void SetParameters(const AbilityParameters& parameters) override;
+    
     // Use the ability at a position
     bool UseAtPosition(Entity caster, const glm::vec3& position) override;
     
@@ -77,10 +86,10 @@ public:
     
 protected:
     // Apply ability effects to targets in area
-    virtual bool ApplyEffects(Entity caster, const glm::vec3& position, const std::vector<Entity>& targets);
+    virtual bool ApplyEffects(Entity caster, const glm::vec3& position, const TargetList& targets);
     
-    // Find targets in area
-    std::vector<Entity> FindTargetsInArea(const glm::vec3& position) const;
+    // Find targets in area (excluding the caster)
+    TargetList FindTargetsInArea(Entity caster, const glm::vec3& position) const;
     
     // Area parameters
     float m_radius;
@@ -104,6 +113,9 @@ public:
     // Initialize the ability
     void Initialize() override;
     
+    // Apply the width, speed and damage parameters
+    void SetParameters(const AbilityParameters& parameters) override;
+    
     // Use the ability in a direction
     bool UseInDirection(Entity caster, const glm::vec3& direction) override;
     
@@ -133,10 +145,13 @@ public:
     
 protected:
     // Apply ability effects to targets hit by skillshot
-    virtual bool ApplyEffects(Entity caster, const glm::vec3& origin, const glm::vec3& direction, const std::vector<Entity>& targets);
+    virtual bool ApplyEffects(Entity caster, const glm::vec3& origin, const glm::vec3& direction, const TargetList& targets);
+    
+    // Find targets hit by skillshot (excluding the caster), nearest first
+    TargetList FindTargetsInSkillshot(Entity caster, const glm::vec3& origin, const glm::vec3& direction) const;
     
-    // Find targets hit by skillshot
-    std::vector<Entity> FindTargetsInSkillshot(const glm::vec3& origin, const glm::vec3& direction) const;
+    // Launch the skillshot as a travelling projectile; returns false to hit instantly instead
+    virtual bool LaunchProjectile(Entity caster, const glm::vec3& origin, const glm::vec3& direction);
     
     // Skillshot parameters
     float m_width;
@@ -161,8 +176,11 @@ public:
     // Initialize the ability
     void Initialize() override;
     
+    // Apply the duration parameters
+    void SetParameters(const AbilityParameters& parameters) override;
+    
     // Use the ability
-    bool Use(Entity caster, Entity target = Entity(0, nullptr)) override;
+    bool Use(Entity caster, Entity target = Entity(INVALID_ENTITY, nullptr)) override;
     
     // Set duration
     void SetDuration(float duration) { m_duration = duration; }
@@ -214,6 +232,9 @@ public:
     // Initialize the ability
     void Initialize() override;
     
+    // Apply the damage and healing parameters
+    void SetParameters(const AbilityParameters& parameters) override;
+    
     // Set healing
     void SetHealing(float baseHealing, float healingPerLevel, float apRatio);
     
@@ -243,7 +264,7 @@ public:
     
 protected:
     // Apply ability effects to targets in area
-    bool ApplyEffects(Entity caster, const glm::vec3& position, const std::vector<Entity>& targets) override;
+    bool ApplyEffects(Entity caster, const glm::vec3& position, const TargetList& targets) override;
 };
 
 /**
@@ -259,7 +280,13 @@ public:
     
 protected:
     // Apply ability effects to targets hit by skillshot
-    bool ApplyEffects(Entity caster, const glm::vec3& origin, const glm::vec3& direction, const std::vector<Entity>& targets) override;
+    bool ApplyEffects(Entity caster, const glm::vec3& origin, const glm::vec3& direction, const TargetList& targets) override;
+    
+    // Launch a damaging projectile when the skillshot has a speed and a projectile system exists
+    bool LaunchProjectile(Entity caster, const glm::vec3& origin, const glm::vec3& direction) override;
+    
+    // Get damage including the caster's AP and AD scaling
+    float GetScaledDamage(const HeroComponent& casterHero) const;
 };
 
 /**
@@ -273,6 +300,9 @@ public:
     // Initialize the ability
     void Initialize() override;
     
+    // Apply the duration and movement speed bonus parameters
+    void SetParameters(const AbilityParameters& parameters) override;
+    
     // Set movement speed bonus
     void SetMovementSpeedBonus(float bonus) { m_movementSpeedBonus = bonus; }
     
@@ -301,6 +331,9 @@ public:
     // Initialize the ability
     void Initialize() override;
     
+    // Apply the duration and attack damage bonus parameters
+    void SetParameters(const AbilityParameters& parameters) override;
+    
     // Set attack damage bonus
     void SetAttackDamageBonus(float bonus) { m_attackDamageBonus = bonus; }
     
@@ -0,0 +1,502 @@
+#include "asset_manager.h"
+#include "../rendering/renderer.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+namespace CHULUBME {
+
+namespace {
+
+// Default budgets
+constexpr std::size_t DEFAULT_MEMORY_BUDGET = 512u * 1024u * 1024u;
+constexpr std::size_t DEFAULT_UPLOAD_BUDGET = 8u * 1024u * 1024u;
+
+// Size of the fixed TGA header
+constexpr std::size_t TGA_HEADER_SIZE = 18;
+
+} // namespace
+
+AssetManager& AssetManager::Instance() {
+    static AssetManager instance;
+    return instance;
+}
+
+AssetManager::AssetManager()
+    : m_loadingCount(0)
+    , m_decoder(&AssetManager::DecodeTGA)
+    , m_memoryBudget(DEFAULT_MEMORY_BUDGET)
+    , m_uploadBudget(DEFAULT_UPLOAD_BUDGET)
+    , m_memoryUsage(0)
+    , m_frame(0)
+    , m_running(false)
+{
+}
+
+AssetManager::~AssetManager() {
+    // GL objects may outlive the context here, so only stop the threads
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_loadCondition.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+bool AssetManager::Initialize(std::size_t ioThreadCount) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_running) {
+        return true;
+    }
+
+    m_running = true;
+    const std::size_t threadCount = std::max<std::size_t>(ioThreadCount, 1);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back(&AssetManager::WorkerLoop, this);
+    }
+
+    return true;
+}
+
+void AssetManager::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_loadCondition.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_textures.clear();
+    m_shaders.clear();
+    m_textureLookup.clear();
+    m_shaderLookup.clear();
+    m_loadQueue.clear();
+    m_uploadQueue.clear();
+    m_loadingCount = 0;
+    m_placeholderTexture.reset();
+    m_placeholderShader.reset();
+    m_memoryUsage = 0;
+}
+
+void AssetManager::Update() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // Upload decoded assets until the budget is spent; the lock is released
+    // around each upload so I/O threads can keep handing over results
+    std::size_t uploaded = 0;
+    while (!m_uploadQueue.empty()) {
+        const Request request = m_uploadQueue.front();
+
+        if (request.isShader) {
+            ShaderEntry& entry = m_shaders[request.index];
+            const std::size_t size = entry.vertexSource.size() + entry.fragmentSource.size();
+            if (uploaded > 0 && uploaded + size > m_uploadBudget) {
+                break;
+            }
+            m_uploadQueue.pop_front();
+
+            std::string vertexSource = std::move(entry.vertexSource);
+            std::string fragmentSource = std::move(entry.fragmentSource);
+            entry.vertexSource.clear();
+            entry.fragmentSource.clear();
+
+            lock.unlock();
+            std::shared_ptr<Shader> shader = std::make_shared<Shader>(vertexSource, fragmentSource);
+            lock.lock();
+
+            ShaderEntry& loaded = m_shaders[request.index];
+            loaded.shader = std::move(shader);
+            loaded.state = AssetState::Resident;
+            uploaded += size;
+        } else {
+            TextureEntry& entry = m_textures[request.index];
+            const std::size_t size = entry.image.pixels.size();
+            if (uploaded > 0 && uploaded + size > m_uploadBudget) {
+                break;
+            }
+            m_uploadQueue.pop_front();
+
+            DecodedImage image = std::move(entry.image);
+            entry.image = DecodedImage();
+
+            lock.unlock();
+            std::shared_ptr<Texture> texture = std::make_shared<Texture>(image.width, image.height, image.channels, image.pixels.data());
+            lock.lock();
+
+            TextureEntry& loaded = m_textures[request.index];
+            loaded.memorySize = texture->GetMemorySize();
+            loaded.texture = std::move(texture);
+            loaded.state = AssetState::Resident;
+            loaded.lastUsedFrame = m_frame;
+            m_memoryUsage += loaded.memorySize;
+            uploaded += size;
+        }
+    }
+
+    EvictTextures();
+    ++m_frame;
+}
+
+TextureHandle AssetManager::LoadTexture(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    TextureHandle handle;
+    auto it = m_textureLookup.find(filename);
+    if (it != m_textureLookup.end()) {
+        handle.id = it->second;
+        return handle;
+    }
+
+    TextureEntry entry;
+    entry.filename = filename;
+    entry.state = AssetState::Unloaded;
+    entry.memorySize = 0;
+    entry.lastUsedFrame = m_frame;
+    m_textures.push_back(std::move(entry));
+
+    handle.id = static_cast<std::uint32_t>(m_textures.size());
+    m_textureLookup[filename] = handle.id;
+    QueueLoad(false, handle.id - 1);
+    return handle;
+}
+
+ShaderHandle AssetManager::LoadShader(const std::string& vertexFilename, const std::string& fragmentFilename) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    ShaderHandle handle;
+    const std::string key = vertexFilename + '\n' + fragmentFilename;
+    auto it = m_shaderLookup.find(key);
+    if (it != m_shaderLookup.end()) {
+        handle.id = it->second;
+        return handle;
+    }
+
+    ShaderEntry entry;
+    entry.vertexFilename = vertexFilename;
+    entry.fragmentFilename = fragmentFilename;
+    entry.state = AssetState::Unloaded;
+    m_shaders.push_back(std::move(entry));
+
+    handle.id = static_cast<std::uint32_t>(m_shaders.size());
+    m_shaderLookup[key] = handle.id;
+    QueueLoad(true, handle.id - 1);
+    return handle;
+}
+
+std::shared_ptr<Texture> AssetManager::GetTexture(TextureHandle handle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!handle.IsValid() || handle.id > m_textures.size()) {
+        return GetPlaceholderTexture();
+    }
+
+    TextureEntry& entry = m_textures[handle.id - 1];
+    entry.lastUsedFrame = m_frame;
+
+    if (entry.state == AssetState::Resident) {
+        return entry.texture;
+    }
+
+    // Evicted textures stream back in when they are needed again
+    if (entry.state == AssetState::Unloaded) {
+        QueueLoad(false, handle.id - 1);
+    }
+
+    return GetPlaceholderTexture();
+}
+
+std::shared_ptr<Shader> AssetManager::GetShader(ShaderHandle handle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!handle.IsValid() || handle.id > m_shaders.size()) {
+        return m_placeholderShader;
+    }
+
+    const ShaderEntry& entry = m_shaders[handle.id - 1];
+    return entry.state == AssetState::Resident ? entry.shader : m_placeholderShader;
+}
+
+AssetState AssetManager::GetState(TextureHandle handle) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!handle.IsValid() || handle.id > m_textures.size()) {
+        return AssetState::Unloaded;
+    }
+    return m_textures[handle.id - 1].state;
+}
+
+AssetState AssetManager::GetState(ShaderHandle handle) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!handle.IsValid() || handle.id > m_shaders.size()) {
+        return AssetState::Unloaded;
+    }
+    return m_shaders[handle.id - 1].state;
+}
+
+void AssetManager::SetPlaceholderTexture(std::shared_ptr<Texture> texture) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_placeholderTexture = std::move(texture);
+}
+
+void AssetManager::SetPlaceholderShader(std::shared_ptr<Shader> shader) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_placeholderShader = std::move(shader);
+}
+
+void AssetManager::SetImageDecoder(ImageDecoder decoder) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_decoder = decoder ? std::move(decoder) : ImageDecoder(&AssetManager::DecodeTGA);
+}
+
+void AssetManager::SetMemoryBudget(std::size_t bytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_memoryBudget = bytes;
+}
+
+std::size_t AssetManager::GetMemoryBudget() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_memoryBudget;
+}
+
+void AssetManager::SetUploadBudget(std::size_t bytesPerFrame) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_uploadBudget = bytesPerFrame;
+}
+
+std::size_t AssetManager::GetMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_memoryUsage;
+}
+
+std::size_t AssetManager::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_loadQueue.size() + m_loadingCount + m_uploadQueue.size();
+}
+
+bool AssetManager::DecodeTGA(const std::vector<unsigned char>& bytes, DecodedImage& image) {
+    if (bytes.size() < TGA_HEADER_SIZE) {
+        return false;
+    }
+
+    const std::size_t idLength = bytes[0];
+    const unsigned char colorMapType = bytes[1];
+    const unsigned char imageType = bytes[2];
+    const int width = bytes[12] | (bytes[13] << 8);
+    const int height = bytes[14] | (bytes[15] << 8);
+    const int bitsPerPixel = bytes[16];
+    const bool topToBottom = (bytes[17] & 0x20) != 0;
+
+    // True-color (2), grayscale (3) and their run-length encoded forms (10, 11)
+    const bool encoded = imageType == 10 || imageType == 11;
+    const bool grayscale = imageType == 3 || imageType == 11;
+    if (colorMapType != 0 || (imageType != 2 && imageType != 3 && !encoded) || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    const int channels = bitsPerPixel / 8;
+    if (grayscale ? channels != 1 : (channels != 3 && channels != 4)) {
+        return false;
+    }
+
+    const std::size_t pixelCount = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+    const std::size_t imageSize = pixelCount * static_cast<std::size_t>(channels);
+    std::vector<unsigned char> pixels(imageSize);
+
+    std::size_t offset = TGA_HEADER_SIZE + idLength;
+    if (!encoded) {
+        if (bytes.size() < offset + imageSize) {
+            return false;
+        }
+        std::memcpy(pixels.data(), bytes.data() + offset, imageSize);
+    } else {
+        // Packets of a repeated pixel (high bit set) or of raw pixels
+        std::size_t written = 0;
+        while (written < imageSize) {
+            if (offset >= bytes.size()) {
+                return false;
+            }
+
+            const unsigned char packet = bytes[offset++];
+            const std::size_t count = static_cast<std::size_t>(packet & 0x7F) + 1;
+            const std::size_t packetSize = count * static_cast<std::size_t>(channels);
+            if (written + packetSize > imageSize) {
+                return false;
+            }
+
+            if (packet & 0x80) {
+                if (offset + channels > bytes.size()) {
+                    return false;
+                }
+                for (std::size_t i = 0; i < count; ++i) {
+                    std::memcpy(pixels.data() + written + i * channels, bytes.data() + offset, channels);
+                }
+                offset += channels;
+            } else {
+                if (offset + packetSize > bytes.size()) {
+                    return false;
+                }
+                std::memcpy(pixels.data() + written, bytes.data() + offset, packetSize);
+                offset += packetSize;
+            }
+
+            written += packetSize;
+        }
+    }
+
+    // TGA stores BGR(A)
+    if (channels >= 3) {
+        for (std::size_t i = 0; i < imageSize; i += channels) {
+            std::swap(pixels[i], pixels[i + 2]);
+        }
+    }
+
+    // Images stored top to bottom are flipped to the bottom-up order GL expects
+    if (topToBottom) {
+        const std::size_t rowSize = static_cast<std::size_t>(width) * static_cast<std::size_t>(channels);
+        for (int row = 0; row < height / 2; ++row) {
+            std::swap_ranges(pixels.begin() + row * rowSize, pixels.begin() + (row + 1) * rowSize,
+                             pixels.begin() + (height - 1 - row) * rowSize);
+        }
+    }
+
+    image.width = width;
+    image.height = height;
+    image.channels = channels;
+    image.pixels = std::move(pixels);
+    return true;
+}
+
+void AssetManager::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (;;) {
+        m_loadCondition.wait(lock, [this]() { return !m_running || !m_loadQueue.empty(); });
+        if (!m_running) {
+            return;
+        }
+
+        const Request request = m_loadQueue.front();
+        m_loadQueue.pop_front();
+        ++m_loadingCount;
+
+        bool loaded;
+        if (request.isShader) {
+            ShaderEntry& entry = m_shaders[request.index];
+            entry.state = AssetState::Loading;
+            const std::string vertexFilename = entry.vertexFilename;
+            const std::string fragmentFilename = entry.fragmentFilename;
+
+            lock.unlock();
+            std::string vertexSource;
+            std::string fragmentSource;
+            loaded = LoadShaderData(vertexFilename, fragmentFilename, vertexSource, fragmentSource);
+            lock.lock();
+
+            // Entries may have moved while the lock was released
+            ShaderEntry& result = m_shaders[request.index];
+            result.vertexSource = std::move(vertexSource);
+            result.fragmentSource = std::move(fragmentSource);
+            result.state = loaded ? AssetState::Decoded : AssetState::Failed;
+        } else {
+            TextureEntry& entry = m_textures[request.index];
+            entry.state = AssetState::Loading;
+            const std::string filename = entry.filename;
+            const ImageDecoder decoder = m_decoder;
+
+            lock.unlock();
+            DecodedImage image;
+            loaded = LoadTextureData(filename, decoder, image);
+            lock.lock();
+
+            TextureEntry& result = m_textures[request.index];
+            result.image = std::move(image);
+            result.state = loaded ? AssetState::Decoded : AssetState::Failed;
+        }
+
+        if (loaded) {
+            m_uploadQueue.push_back(request);
+        }
+        --m_loadingCount;
+    }
+}
+
+bool AssetManager::LoadTextureData(const std::string& filename, const ImageDecoder& decoder, DecodedImage& image) {
+    std::vector<unsigned char> bytes;
+    return ReadFile(filename, bytes) && decoder(bytes, image) && !image.pixels.empty();
+}
+
+bool AssetManager::LoadShaderData(const std::string& vertexFilename, const std::string& fragmentFilename,
+                                  std::string& vertexSource, std::string& fragmentSource) {
+    std::vector<unsigned char> vertexBytes;
+    std::vector<unsigned char> fragmentBytes;
+    if (!ReadFile(vertexFilename, vertexBytes) || !ReadFile(fragmentFilename, fragmentBytes)) {
+        return false;
+    }
+
+    vertexSource.assign(vertexBytes.begin(), vertexBytes.end());
+    fragmentSource.assign(fragmentBytes.begin(), fragmentBytes.end());
+    return true;
+}
+
+bool AssetManager::ReadFile(const std::string& filename, std::vector<unsigned char>& bytes) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !file.bad();
+}
+
+void AssetManager::QueueLoad(bool isShader, std::uint32_t index) {
+    if (isShader) {
+        m_shaders[index].state = AssetState::Queued;
+    } else {
+        m_textures[index].state = AssetState::Queued;
+    }
+
+    m_loadQueue.push_back({ isShader, index });
+    m_loadCondition.notify_one();
+}
+
+void AssetManager::EvictTextures() {
+    while (m_memoryUsage > m_memoryBudget) {
+        // Least recently used texture that nothing outside the cache holds
+        TextureEntry* victim = nullptr;
+        for (TextureEntry& entry : m_textures) {
+            if (entry.state != AssetState::Resident || entry.lastUsedFrame >= m_frame || entry.texture.use_count() > 1) {
+                continue;
+            }
+            if (!victim || entry.lastUsedFrame < victim->lastUsedFrame) {
+                victim = &entry;
+            }
+        }
+
+        if (!victim) {
+            return;
+        }
+
+        m_memoryUsage -= victim->memorySize;
+        victim->memorySize = 0;
+        victim->texture.reset();
+        victim->state = AssetState::Unloaded;
+    }
+}
+
+const std::shared_ptr<Texture>& AssetManager::GetPlaceholderTexture() {
+    // Created on demand so textures requested before the first Update still get one
+    if (!m_placeholderTexture) {
+        const unsigned char white[4] = { 255, 255, 255, 255 };
+        m_placeholderTexture = std::make_shared<Texture>(1, 1, 4, white);
+    }
+    return m_placeholderTexture;
+}
+
+} // namespace CHULUBME
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../core/containers.h"
+
+namespace CHULUBME {
+
+// Forward declarations
+class Shader;
+class Texture;
+
+/**
+ * @brief Handle to a texture owned by the AssetManager (0 is invalid)
+ */
+struct TextureHandle {
+    std::uint32_t id = 0;
+
+    // Check if the handle refers to a texture
+    bool IsValid() const { return id != 0; }
+};
+
+/**
+ * @brief Handle to a shader owned by the AssetManager (0 is invalid)
+ */
+struct ShaderHandle {
+    std::uint32_t id = 0;
+
+    // Check if the handle refers to a shader
+    bool IsValid() const { return id != 0; }
+};
+
+/**
+ * @brief Loading state of an asset
+ */
+enum class AssetState : std::uint8_t {
+    Unloaded,   // Evicted, or never requested
+    Queued,     // Waiting for an I/O thread
+    Loading,    // Being read and decoded
+    Decoded,    // Waiting for its GPU upload
+    Resident,   // Uploaded and usable
+    Failed      // File missing or undecodable
+};
+
+/**
+ * @brief Pixels decoded from an image file, rows ordered bottom to top
+ */
+struct DecodedImage {
+    int width;
+    int height;
+    int channels;
+    std::vector<unsigned char> pixels;
+
+    // Constructor with default values
+    DecodedImage() :
+        width(0),
+        height(0),
+        channels(0)
+    {}
+};
+
+// Decode an image file's bytes; returns false if the data is not a supported image
+using ImageDecoder = std::function<bool(const std::vector<unsigned char>& bytes, DecodedImage& image)>;
+
+/**
+ * @brief Asynchronous, deduplicated loader and cache for textures and shaders
+ *
+ * Load calls return a handle immediately; requesting the same file again
+ * returns the same handle. I/O threads read and decode files, and Update,
+ * called once per frame on the thread owning the GL context, uploads decoded
+ * assets until the per-frame upload budget is spent. Until an asset is
+ * resident its getter returns the placeholder.
+ *
+ * Resident textures are tracked against a video memory budget. When Update
+ * finds the budget exceeded it evicts the least recently used textures that
+ * were not used this frame and are referenced by nothing but the cache. An
+ * evicted texture is loaded again the next time its handle is resolved.
+ */
+class AssetManager {
+public:
+    // Singleton instance
+    static AssetManager& Instance();
+
+    // Start the I/O threads
+    bool Initialize(std::size_t ioThreadCount = 2);
+
+    // Stop the I/O threads and release every asset (call on the GL thread)
+    void Shutdown();
+
+    // Upload decoded assets within the upload budget and evict over the memory budget (call on the GL thread)
+    void Update();
+
+    // Request a texture
+    TextureHandle LoadTexture(const std::string& filename);
+
+    // Request a shader from vertex and fragment source files
+    ShaderHandle LoadShader(const std::string& vertexFilename, const std::string& fragmentFilename);
+
+    // Get a texture, or the placeholder until it is resident (marks it as used this frame; call on the GL thread)
+    std::shared_ptr<Texture> GetTexture(TextureHandle handle);
+
+    // Get a shader, or the placeholder until it is resident
+    std::shared_ptr<Shader> GetShader(ShaderHandle handle);
+
+    // Get the loading state of an asset
+    AssetState GetState(TextureHandle handle) const;
+    AssetState GetState(ShaderHandle handle) const;
+
+    // Set the texture returned while textures load (a 1x1 white texture by default)
+    void SetPlaceholderTexture(std::shared_ptr<Texture> texture);
+
+    // Set the shader returned while shaders load (none by default)
+    void SetPlaceholderShader(std::shared_ptr<Shader> shader);
+
+    // Replace the image decoder (uncompressed and RLE TGA by default)
+    void SetImageDecoder(ImageDecoder decoder);
+
+    // Set the video memory budget for resident textures in bytes
+    void SetMemoryBudget(std::size_t bytes);
+
+    // Get the video memory budget in bytes
+    std::size_t GetMemoryBudget() const;
+
+    // Set the number of bytes uploaded per frame (at least one asset is always uploaded)
+    void SetUploadBudget(std::size_t bytesPerFrame);
+
+    // Get the video memory used by resident textures in bytes
+    std::size_t GetMemoryUsage() const;
+
+    // Get the number of assets queued, loading or waiting for upload
+    std::size_t GetPendingCount() const;
+
+    // Decode an uncompressed or RLE true-color, or grayscale, TGA file
+    static bool DecodeTGA(const std::vector<unsigned char>& bytes, DecodedImage& image);
+
+private:
+    // Private constructor for singleton
+    AssetManager();
+    ~AssetManager();
+
+    // Deleted copy constructor and assignment operator
+    AssetManager(const AssetManager&) = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+
+    // Cached texture
+    struct TextureEntry {
+        std::string filename;
+        AssetState state;
+        std::shared_ptr<Texture> texture;
+        DecodedImage image;
+        std::size_t memorySize;
+        std::uint64_t lastUsedFrame;
+    };
+
+    // Cached shader
+    struct ShaderEntry {
+        std::string vertexFilename;
+        std::string fragmentFilename;
+        AssetState state;
+        std::shared_ptr<Shader> shader;
+        std::string vertexSource;
+        std::string fragmentSource;
+    };
+
+    // Work item for the I/O threads and the upload queue
+    struct Request {
+        bool isShader;
+        std::uint32_t index;
+    };
+
+    // Body of an I/O thread
+    void WorkerLoop();
+
+    // Read and decode an asset (runs on an I/O thread without the lock held)
+    static bool LoadTextureData(const std::string& filename, const ImageDecoder& decoder, DecodedImage& image);
+    static bool LoadShaderData(const std::string& vertexFilename, const std::string& fragmentFilename,
+                               std::string& vertexSource, std::string& fragmentSource);
+
+    // Read a whole file
+    static bool ReadFile(const std::string& filename, std::vector<unsigned char>& bytes);
+
+    // Queue an asset for the I/O threads (lock held)
+    void QueueLoad(bool isShader, std::uint32_t index);
+
+    // Evict least recently used textures until the budget is met (lock held)
+    void EvictTextures();
+
+    // Get the placeholder texture, creating the default one on first use (lock held, GL thread)
+    const std::shared_ptr<Texture>& GetPlaceholderTexture();
+
+    // Cached assets, indexed by handle id - 1
+    std::vector<TextureEntry> m_textures;
+    std::vector<ShaderEntry> m_shaders;
+
+    // Handle of each requested file
+    FlatHashMap<std::string, std::uint32_t> m_textureLookup;
+    FlatHashMap<std::string, std::uint32_t> m_shaderLookup;
+
+    // Assets waiting for an I/O thread, and decoded assets waiting for upload
+    std::deque<Request> m_loadQueue;
+    std::deque<Request> m_uploadQueue;
+
+    // Number of assets being read by I/O threads
+    std::size_t m_loadingCount;
+
+    // Placeholders
+    std::shared_ptr<Texture> m_placeholderTexture;
+    std::shared_ptr<Shader> m_placeholderShader;
+
+    // Image decoder
+    ImageDecoder m_decoder;
+
+    // Budgets and video memory usage in bytes
+    std::size_t m_memoryBudget;
+    std::size_t m_uploadBudget;
+    std::size_t m_memoryUsage;
+
+    // Frames seen by Update
+    std::uint64_t m_frame;
+
+    // I/O threads
+    std::vector<std::thread> m_workers;
+    bool m_running;
+
+    // Guards everything above
+    mutable std::mutex m_mutex;
+    std::condition_variable m_loadCondition;
+};
+
+} // namespace CHULUBME
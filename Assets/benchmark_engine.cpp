@@ -0,0 +1,1053 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <GL/glew.h>
+#include <json/json.h>
+
+#include "core/ecs.h"
+#include "core/job_system.h"
+#include "core/memory.h"
+#include "core/profiler.h"
+#include "rendering/renderer.h"
+#include "rendering/render_queue.h"
+#include "physics/spatial_grid.h"
+#include "gameplay/hero_system.h"
+#include "gameplay/hero_data.h"
+#include "gameplay/ability_types.h"
+#include "gameplay/damage_batch.h"
+
+using namespace CHULUBME;
+
+// Written at the end of every batch so the measured work cannot be optimized away
+static volatile std::uint64_t g_benchmarkSink = 0;
+
+/**
+ * @brief Timing of one benchmark
+ */
+struct BenchmarkResult {
+    std::string name;
+    std::uint64_t operationsPerBatch;
+    std::uint64_t itemsPerBatch;
+    std::size_t batchCount;
+    double medianNanoseconds;
+    double minNanoseconds;
+
+    // Constructor with default values
+    BenchmarkResult() :
+        operationsPerBatch(0),
+        itemsPerBatch(0),
+        batchCount(0),
+        medianNanoseconds(0.0),
+        minNanoseconds(0.0)
+    {}
+
+    // Get the median time of one operation
+    double GetNanosecondsPerOperation() const {
+        return operationsPerBatch > 0 ? medianNanoseconds / static_cast<double>(operationsPerBatch) : 0.0;
+    }
+
+    // Get the median operation rate
+    double GetOperationsPerSecond() const {
+        return medianNanoseconds > 0.0 ? static_cast<double>(operationsPerBatch) * 1e9 / medianNanoseconds : 0.0;
+    }
+
+    // Get the median rate of items processed (targets hit, draws issued, ...)
+    double GetItemsPerSecond() const {
+        return medianNanoseconds > 0.0 ? static_cast<double>(itemsPerBatch) * 1e9 / medianNanoseconds : 0.0;
+    }
+};
+
+/**
+ * @brief Runs benchmarks as repeated batches and collects their timings
+ *
+ * A batch performs a fixed number of operations and returns the number of
+ * items it processed. After one warm-up batch, batches are timed until the
+ * minimum time has passed; the median batch is reported, so one preempted
+ * batch does not skew the result.
+ */
+class BenchmarkRunner {
+public:
+    BenchmarkRunner(double minSeconds, const std::string& filter)
+        : m_minSeconds(minSeconds), m_filter(filter) {}
+
+    // Check if a benchmark passes the name filter
+    bool IsSelected(const std::string& name) const {
+        return m_filter.empty() || name.find(m_filter) != std::string::npos;
+    }
+
+    // Check if any of a group's benchmarks passes the name filter (to skip the group's setup)
+    bool IsAnySelected(std::initializer_list<const char*> names) const {
+        return std::any_of(names.begin(), names.end(), [this](const char* name) { return IsSelected(name); });
+    }
+
+    // Time a batch function returning the number of items it processed
+    template<typename Func>
+    void Run(const std::string& name, std::uint64_t operationsPerBatch, Func&& batch) {
+        if (!IsSelected(name)) {
+            return;
+        }
+
+        using Clock = std::chrono::steady_clock;
+
+        BenchmarkResult result;
+        result.name = name;
+        result.operationsPerBatch = operationsPerBatch;
+        result.itemsPerBatch = batch();
+
+        std::vector<double> timings;
+        const Clock::time_point start = Clock::now();
+        do {
+            const Clock::time_point batchStart = Clock::now();
+            batch();
+            timings.push_back(std::chrono::duration<double, std::nano>(Clock::now() - batchStart).count());
+        } while (timings.size() < MIN_BATCHES || std::chrono::duration<double>(Clock::now() - start).count() < m_minSeconds);
+
+        std::sort(timings.begin(), timings.end());
+        result.batchCount = timings.size();
+        result.medianNanoseconds = timings[timings.size() / 2];
+        result.minNanoseconds = timings.front();
+
+        std::cout << std::left << std::setw(40) << name << std::right << std::fixed
+                  << std::setw(12) << std::setprecision(2) << result.GetNanosecondsPerOperation() << " ns/op"
+                  << std::setw(16) << std::setprecision(0) << result.GetOperationsPerSecond() << " op/s";
+        if (result.itemsPerBatch != result.operationsPerBatch) {
+            std::cout << std::setw(16) << result.GetItemsPerSecond() << " items/s";
+        }
+        std::cout << std::endl;
+
+        m_results.push_back(result);
+    }
+
+    // Get the collected results
+    const std::vector<BenchmarkResult>& GetResults() const { return m_results; }
+
+private:
+    // Fewest timed batches per benchmark
+    static constexpr std::size_t MIN_BATCHES = 5;
+
+    // Minimum time spent timing each benchmark
+    double m_minSeconds;
+
+    // Substring a benchmark name must contain to run
+    std::string m_filter;
+
+    // Collected results
+    std::vector<BenchmarkResult> m_results;
+};
+
+// Benchmark components
+class VelocityComponent : public Component {
+public:
+    VelocityComponent(const glm::vec3& velocity = glm::vec3(1.0f, 0.0f, 0.0f)) : m_velocity(velocity) {}
+
+    const glm::vec3& GetVelocity() const { return m_velocity; }
+
+private:
+    glm::vec3 m_velocity;
+};
+
+class HealthComponent : public Component {
+public:
+    HealthComponent(float health = 100.0f) : m_health(health) {}
+
+    float GetHealth() const { return m_health; }
+    void SetHealth(float health) { m_health = health; }
+
+private:
+    float m_health;
+};
+
+// Moves every entity with a velocity, one entity at a time on the updating thread
+class MovementSystem : public System {
+public:
+    MovementSystem(EntityManager* manager) : System(manager) {
+        RequireComponent<Transform>();
+        RequireComponent<VelocityComponent>();
+    }
+
+    void Update(float deltaTime) override {
+        m_manager->View<Transform, VelocityComponent>().ForEach(
+            [deltaTime](EntityID, Transform& transform, VelocityComponent& velocity) {
+                transform.SetPosition(transform.GetPosition() + velocity.GetVelocity() * deltaTime);
+            });
+    }
+};
+
+// Moves every entity with a velocity, one chunk per job
+class ParallelMovementSystem : public System {
+public:
+    ParallelMovementSystem(EntityManager* manager) : System(manager) {
+        RequireComponent<Transform>();
+        RequireComponent<VelocityComponent>();
+    }
+
+    void Update(float deltaTime) override {
+        ParallelForEach<Transform, VelocityComponent>(
+            [deltaTime](EntityCommandBuffer&, EntityID, Transform& transform, VelocityComponent& velocity) {
+                transform.SetPosition(transform.GetPosition() + velocity.GetVelocity() * deltaTime);
+            });
+    }
+};
+
+// Fill a manager with MAX_ENTITIES moving entities
+static std::vector<EntityID> SpawnMovingEntities(EntityManager& manager) {
+    std::vector<EntityID> entities;
+    entities.reserve(MAX_ENTITIES);
+
+    for (std::size_t i = 0; i < MAX_ENTITIES; ++i) {
+        Entity entity = manager.CreateEntity();
+        entity.AddComponent<Transform>(glm::vec3(static_cast<float>(i), 0.0f, 0.0f));
+        entity.AddComponent<VelocityComponent>();
+        entity.AddComponent<HealthComponent>();
+        entities.push_back(entity.GetID());
+    }
+
+    return entities;
+}
+
+// ECS benchmarks
+static void RunEcsBenchmarks(BenchmarkRunner& runner, JobSystem& jobSystem) {
+    // Create, populate and destroy a full world
+    runner.Run("ecs/entity_churn", MAX_ENTITIES, []() -> std::uint64_t {
+        EntityManager manager;
+        std::vector<EntityID> entities = SpawnMovingEntities(manager);
+        for (EntityID entity : entities) {
+            manager.DestroyEntity(entity);
+        }
+        manager.ProcessDestructions();
+        return entities.size();
+    });
+
+    // Reuse the slots of a world that was already populated once
+    {
+        EntityManager manager;
+        runner.Run("ecs/entity_churn_reused_slots", MAX_ENTITIES, [&manager]() -> std::uint64_t {
+            std::vector<EntityID> entities = SpawnMovingEntities(manager);
+            for (EntityID entity : entities) {
+                manager.DestroyEntity(entity);
+            }
+            manager.ProcessDestructions();
+            return entities.size();
+        });
+    }
+
+    // Random-order lookups of two components per entity
+    {
+        EntityManager manager;
+        std::vector<EntityID> entities = SpawnMovingEntities(manager);
+        std::shuffle(entities.begin(), entities.end(), std::mt19937(1));
+
+        runner.Run("ecs/get_component", entities.size() * 2, [&manager, &entities]() -> std::uint64_t {
+            float sum = 0.0f;
+            for (EntityID entity : entities) {
+                sum += manager.GetComponent<Transform>(entity)->GetPosition().x;
+                sum += manager.GetComponent<HealthComponent>(entity)->GetHealth();
+            }
+            g_benchmarkSink = g_benchmarkSink + static_cast<std::uint64_t>(sum);
+            return entities.size() * 2;
+        });
+    }
+
+    // One system update over every entity, through the manager's scheduler
+    {
+        EntityManager manager;
+        manager.RegisterSystem<MovementSystem>();
+        SpawnMovingEntities(manager);
+
+        runner.Run("ecs/system_update", MAX_ENTITIES, [&manager]() -> std::uint64_t {
+            manager.UpdateSystems(1.0f / 60.0f);
+            return MAX_ENTITIES;
+        });
+    }
+
+    {
+        EntityManager manager;
+        manager.SetJobSystem(&jobSystem);
+        manager.RegisterSystem<ParallelMovementSystem>();
+        SpawnMovingEntities(manager);
+
+        runner.Run("ecs/system_update_parallel", MAX_ENTITIES, [&manager]() -> std::uint64_t {
+            manager.UpdateSystems(1.0f / 60.0f);
+            return MAX_ENTITIES;
+        });
+    }
+}
+
+// Allocations per round and their size
+constexpr std::size_t ALLOCATIONS_PER_ROUND = 4096;
+constexpr std::size_t ALLOCATION_SIZE = 64;
+
+// Rounds each thread runs per multi-threaded batch
+constexpr std::size_t THREAD_ROUNDS = 16;
+
+// Allocate a round of blocks, then free them the way the allocator expects
+static std::uint64_t RunLinearRound(LinearAllocator& allocator, void** blocks) {
+    std::uint64_t allocated = 0;
+    for (std::size_t i = 0; i < ALLOCATIONS_PER_ROUND; ++i) {
+        blocks[i] = allocator.Allocate(ALLOCATION_SIZE);
+        allocated += blocks[i] != nullptr;
+    }
+    allocator.Reset();
+    return allocated;
+}
+
+static std::uint64_t RunPoolRound(PoolAllocator& allocator, void** blocks) {
+    std::uint64_t allocated = 0;
+    for (std::size_t i = 0; i < ALLOCATIONS_PER_ROUND; ++i) {
+        blocks[i] = allocator.Allocate(ALLOCATION_SIZE);
+        allocated += blocks[i] != nullptr;
+    }
+    for (std::size_t i = 0; i < ALLOCATIONS_PER_ROUND; ++i) {
+        allocator.Free(blocks[i]);
+    }
+    return allocated;
+}
+
+static std::uint64_t RunStackRound(StackAllocator& allocator, void** blocks) {
+    std::uint64_t allocated = 0;
+    for (std::size_t i = 0; i < ALLOCATIONS_PER_ROUND; ++i) {
+        blocks[i] = allocator.Allocate(ALLOCATION_SIZE);
+        allocated += blocks[i] != nullptr;
+    }
+    for (std::size_t i = ALLOCATIONS_PER_ROUND; i-- > 0;) {
+        allocator.Free(blocks[i]);
+    }
+    return allocated;
+}
+
+static std::uint64_t RunHeapRound(HeapAllocator& allocator, void** blocks) {
+    std::uint64_t allocated = 0;
+    for (std::size_t i = 0; i < ALLOCATIONS_PER_ROUND; ++i) {
+        blocks[i] = allocator.Allocate(ALLOCATION_SIZE);
+        allocated += blocks[i] != nullptr;
+    }
+    for (std::size_t i = 0; i < ALLOCATIONS_PER_ROUND; ++i) {
+        allocator.Free(blocks[i]);
+    }
+    return allocated;
+}
+
+// Run rounds on several threads at once; getAllocator returns the allocator a thread uses
+template<typename GetFunc, typename RoundFunc>
+static std::uint64_t RunThreadedRounds(std::size_t threadCount, GetFunc&& getAllocator, RoundFunc&& round) {
+    std::atomic<std::uint64_t> allocated(0);
+    std::atomic<bool> start(false);
+    std::vector<std::thread> threads;
+
+    for (std::size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            auto& allocator = getAllocator(t);
+            std::vector<void*> blocks(ALLOCATIONS_PER_ROUND);
+
+            // Start together so the threads contend for the whole batch
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+
+            std::uint64_t threadAllocated = 0;
+            for (std::size_t r = 0; r < THREAD_ROUNDS; ++r) {
+                threadAllocated += round(allocator, blocks.data());
+            }
+            allocated.fetch_add(threadAllocated, std::memory_order_relaxed);
+        });
+    }
+
+    start.store(true, std::memory_order_release);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    return allocated.load(std::memory_order_relaxed);
+}
+
+// Allocator benchmarks; one operation is an allocation and its matching free
+static void RunMemoryBenchmarks(BenchmarkRunner& runner, std::size_t threadCount) {
+    // Capacity for one round, with room for per-allocation headers and alignment
+    const std::size_t arenaSize = ALLOCATIONS_PER_ROUND * ALLOCATION_SIZE * 2;
+    std::vector<void*> blocks(ALLOCATIONS_PER_ROUND);
+
+    LinearAllocator linear(arenaSize);
+    runner.Run("memory/linear", ALLOCATIONS_PER_ROUND, [&]() { return RunLinearRound(linear, blocks.data()); });
+
+    PoolAllocator pool(ALLOCATION_SIZE, ALLOCATIONS_PER_ROUND);
+    runner.Run("memory/pool", ALLOCATIONS_PER_ROUND, [&]() { return RunPoolRound(pool, blocks.data()); });
+
+    StackAllocator stack(arenaSize);
+    runner.Run("memory/stack", ALLOCATIONS_PER_ROUND, [&]() { return RunStackRound(stack, blocks.data()); });
+
+    HeapAllocator heap;
+    runner.Run("memory/heap", ALLOCATIONS_PER_ROUND, [&]() { return RunHeapRound(heap, blocks.data()); });
+
+    // Linear, pool and stack allocators are single-threaded, so each thread owns one;
+    // the heap allocator is thread-safe and shared by every thread
+    std::vector<std::unique_ptr<LinearAllocator>> linearAllocators;
+    std::vector<std::unique_ptr<PoolAllocator>> poolAllocators;
+    std::vector<std::unique_ptr<StackAllocator>> stackAllocators;
+    for (std::size_t t = 0; t < threadCount; ++t) {
+        linearAllocators.push_back(std::make_unique<LinearAllocator>(arenaSize));
+        poolAllocators.push_back(std::make_unique<PoolAllocator>(ALLOCATION_SIZE, ALLOCATIONS_PER_ROUND));
+        stackAllocators.push_back(std::make_unique<StackAllocator>(arenaSize));
+    }
+
+    const std::uint64_t threadedOperations = threadCount * THREAD_ROUNDS * ALLOCATIONS_PER_ROUND;
+
+    runner.Run("memory/linear_threaded", threadedOperations, [&]() {
+        return RunThreadedRounds(threadCount, [&](std::size_t t) -> LinearAllocator& { return *linearAllocators[t]; }, RunLinearRound);
+    });
+
+    runner.Run("memory/pool_threaded", threadedOperations, [&]() {
+        return RunThreadedRounds(threadCount, [&](std::size_t t) -> PoolAllocator& { return *poolAllocators[t]; }, RunPoolRound);
+    });
+
+    runner.Run("memory/stack_threaded", threadedOperations, [&]() {
+        return RunThreadedRounds(threadCount, [&](std::size_t t) -> StackAllocator& { return *stackAllocators[t]; }, RunStackRound);
+    });
+
+    runner.Run("memory/heap_threaded", threadedOperations, [&]() {
+        return RunThreadedRounds(threadCount, [&](std::size_t) -> HeapAllocator& { return heap; }, RunHeapRound);
+    });
+}
+
+// Heroes spawned for the ability benchmarks, and the side of the square map they are scattered on
+constexpr std::size_t BENCHMARK_HERO_COUNT = 1000;
+constexpr float BENCHMARK_MAP_SIZE = 5000.0f;
+
+// Casts per ability batch
+constexpr std::size_t CASTS_PER_BATCH = 1024;
+
+// Grid cell size matching the hero data's ability radii (in the same units as their ranges)
+constexpr float BENCHMARK_GRID_CELL_SIZE = 250.0f;
+
+// Health and mana given to every hero so no cast fails and no hero dies during a run
+constexpr float BENCHMARK_VITALS = 1.0e8f;
+
+// Casting hero and the ability it casts
+struct BenchmarkCast {
+    Entity caster;
+    std::shared_ptr<Ability> ability;
+    glm::vec3 target;
+
+    // Constructor with default values
+    BenchmarkCast() : caster(INVALID_ENTITY, nullptr), target(0.0f) {}
+};
+
+// Ability benchmarks on heroes created from a hero data file
+static bool RunAbilityBenchmarks(BenchmarkRunner& runner, const std::string& heroFilename) {
+    if (!runner.IsAnySelected({ "abilities/aoe_target_query", "abilities/skillshot_target_query", "abilities/aoe_cast",
+                                "abilities/skillshot_cast", "abilities/damage_batch_resolve" })) {
+        return true;
+    }
+
+    // Compile JSON in memory; compiled files are loaded as they are
+    std::shared_ptr<HeroDataFile> heroData = std::make_shared<HeroDataFile>();
+    if (HeroDataFile::IsCompiledFile(heroFilename)) {
+        if (!heroData->Open(heroFilename)) {
+            return false;
+        }
+    } else {
+        std::ifstream input(heroFilename);
+        if (!input.is_open()) {
+            return false;
+        }
+        std::stringstream json;
+        json << input.rdbuf();
+
+        std::vector<unsigned char> compiled;
+        if (!HeroDataCompiler::Compile(json.str(), compiled) || !heroData->Open(std::move(compiled))) {
+            return false;
+        }
+    }
+
+    if (heroData->GetHeroCount() == 0) {
+        return false;
+    }
+
+    EntityManager manager;
+    SpatialSystem* spatialSystem = manager.RegisterSystem<SpatialSystem>(BENCHMARK_GRID_CELL_SIZE);
+    HeroSystem* heroSystem = manager.RegisterSystem<HeroSystem>();
+    AbilitySystem* abilitySystem = manager.RegisterSystem<AbilitySystem>();
+    heroSystem->SetHeroData(heroData);
+
+    // Ability types the sample heroes use
+    abilitySystem->RegisterAbilityType<DamageAbility>("DamageAbility");
+    abilitySystem->RegisterAbilityType<HealAbility>("HealAbility");
+    abilitySystem->RegisterAbilityType<AreaDamageAbility>("AreaDamageAbility");
+    abilitySystem->RegisterAbilityType<SkillshotDamageAbility>("SkillshotDamageAbility");
+    abilitySystem->RegisterAbilityType<MovementSpeedBuffAbility>("MovementSpeedBuffAbility");
+    abilitySystem->RegisterAbilityType<AttackDamageBuffAbility>("AttackDamageBuffAbility");
+
+    // Scatter copies of every hero definition over the map
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> coordinate(0.0f, BENCHMARK_MAP_SIZE);
+    std::vector<Entity> heroes;
+    for (std::size_t i = 0; i < BENCHMARK_HERO_COUNT; ++i) {
+        const HeroRecord& record = heroData->GetHero(static_cast<std::uint32_t>(i % heroData->GetHeroCount()));
+        Entity hero = heroSystem->CreateHeroFromDefinition(std::string(heroData->GetString(record.id)));
+        if (hero.GetID() == INVALID_ENTITY) {
+            return false;
+        }
+
+        hero.GetComponent<Transform>()->SetPosition(glm::vec3(coordinate(random), 0.0f, coordinate(random)));
+        hero.GetComponent<HeroComponent>()->SetReplicatedVitals(BENCHMARK_VITALS, BENCHMARK_VITALS);
+        heroes.push_back(hero);
+    }
+
+    // Bucket the heroes at their new positions
+    spatialSystem->Update(0.0f);
+    const SpatialGrid& grid = spatialSystem->GetGrid();
+
+    // Every area and skillshot ability of the spawned heroes, each cast at or towards another hero
+    std::vector<BenchmarkCast> areaCasts;
+    std::vector<BenchmarkCast> skillshotCasts;
+    std::uniform_int_distribution<std::size_t> heroIndex(0, heroes.size() - 1);
+    for (Entity hero : heroes) {
+        for (const std::shared_ptr<Ability>& ability : hero.GetComponent<HeroComponent>()->GetAbilities()) {
+            BenchmarkCast cast;
+            cast.caster = hero;
+            cast.ability = ability;
+            cast.target = heroes[heroIndex(random)].GetComponent<Transform>()->GetPosition();
+
+            if (std::dynamic_pointer_cast<AreaOfEffectAbility>(ability)) {
+                areaCasts.push_back(cast);
+            } else if (std::dynamic_pointer_cast<SkillshotAbility>(ability)) {
+                skillshotCasts.push_back(cast);
+            }
+        }
+    }
+
+    if (areaCasts.empty() || skillshotCasts.empty()) {
+        return false;
+    }
+
+    // Target queries the abilities make, without applying effects
+    runner.Run("abilities/aoe_target_query", CASTS_PER_BATCH, [&]() -> std::uint64_t {
+        MemoryManager::ResetThreadFrameArenas();
+        FrameVector<EntityID> hits;
+        std::uint64_t targets = 0;
+        for (std::size_t i = 0; i < CASTS_PER_BATCH; ++i) {
+            const BenchmarkCast& cast = areaCasts[i % areaCasts.size()];
+            const AreaOfEffectAbility& ability = static_cast<const AreaOfEffectAbility&>(*cast.ability);
+            hits.clear();
+            grid.QueryRadius(cast.target, ability.GetRadius(), hits);
+            targets += hits.size();
+        }
+        return targets;
+    });
+
+    runner.Run("abilities/skillshot_target_query", CASTS_PER_BATCH, [&]() -> std::uint64_t {
+        MemoryManager::ResetThreadFrameArenas();
+        FrameVector<EntityID> hits;
+        std::uint64_t targets = 0;
+        for (std::size_t i = 0; i < CASTS_PER_BATCH; ++i) {
+            const BenchmarkCast& cast = skillshotCasts[i % skillshotCasts.size()];
+            const SkillshotAbility& ability = static_cast<const SkillshotAbility&>(*cast.ability);
+            const glm::vec3 origin = cast.caster.GetComponent<Transform>()->GetPosition();
+            const glm::vec3 offset = cast.target - origin;
+            const float length = glm::length(offset);
+            if (length <= 0.0f) {
+                continue;
+            }
+            hits.clear();
+            grid.QueryCapsule(origin, origin + offset * (ability.GetRange() / length), ability.GetWidth() * 0.5f, hits);
+            targets += hits.size();
+        }
+        return targets;
+    });
+
+    // Targets one pass over the area casts hits (excluding the casters, as the abilities do),
+    // counted once so batches time only the casts
+    MemoryManager::ResetThreadFrameArenas();
+    std::uint64_t areaTargets = 0;
+    {
+        FrameVector<EntityID> hits;
+        for (std::size_t i = 0; i < CASTS_PER_BATCH; ++i) {
+            const BenchmarkCast& cast = areaCasts[i % areaCasts.size()];
+            hits.clear();
+            grid.QueryRadius(cast.target, static_cast<const AreaOfEffectAbility&>(*cast.ability).GetRadius(), hits);
+            areaTargets += hits.size() - std::count(hits.begin(), hits.end(), cast.caster.GetID());
+        }
+    }
+
+    // Full casts: cost checks, target query and batched damage application
+    runner.Run("abilities/aoe_cast", CASTS_PER_BATCH, [&]() -> std::uint64_t {
+        MemoryManager::ResetThreadFrameArenas();
+        std::uint64_t casts = 0;
+        for (std::size_t i = 0; i < CASTS_PER_BATCH; ++i) {
+            const BenchmarkCast& cast = areaCasts[i % areaCasts.size()];
+            cast.ability->SetCooldownRemaining(0.0f);
+            casts += cast.ability->UseAtPosition(cast.caster, cast.target);
+        }
+        g_benchmarkSink = g_benchmarkSink + casts;
+        return areaTargets;
+    });
+
+    runner.Run("abilities/skillshot_cast", CASTS_PER_BATCH, [&]() -> std::uint64_t {
+        MemoryManager::ResetThreadFrameArenas();
+        std::uint64_t casts = 0;
+        for (std::size_t i = 0; i < CASTS_PER_BATCH; ++i) {
+            const BenchmarkCast& cast = skillshotCasts[i % skillshotCasts.size()];
+            cast.ability->SetCooldownRemaining(0.0f);
+            casts += cast.ability->UseInDirection(cast.caster, cast.target - cast.caster.GetComponent<Transform>()->GetPosition());
+        }
+        g_benchmarkSink = g_benchmarkSink + casts;
+        return casts;
+    });
+
+    // Damage application alone: mitigation and health updates for random hero pairs
+    std::vector<std::pair<EntityID, EntityID>> damagePairs;
+    for (std::size_t i = 0; i < CASTS_PER_BATCH * 8; ++i) {
+        damagePairs.emplace_back(heroes[heroIndex(random)].GetID(), heroes[heroIndex(random)].GetID());
+    }
+
+    runner.Run("abilities/damage_batch_resolve", damagePairs.size(), [&]() -> std::uint64_t {
+        MemoryManager::ResetThreadFrameArenas();
+        DamageBatch batch(&manager);
+        for (std::size_t i = 0; i < damagePairs.size(); ++i) {
+            batch.Add(damagePairs[i].first, damagePairs[i].second, 1.0f, (i & 1) != 0);
+        }
+        g_benchmarkSink = g_benchmarkSink + static_cast<std::uint64_t>(batch.Resolve());
+        return damagePairs.size();
+    });
+
+    MemoryManager::ResetThreadFrameArenas();
+    return true;
+}
+
+/**
+ * @brief GL entry points that do nothing, for timing the CPU side of rendering
+ *
+ * GLEW's function pointers are pointed at stubs instead of being loaded by
+ * glewInit, so no context or GPU is needed. Programs report a fixed set of
+ * uniforms and a material block, so shaders cache locations and materials
+ * pack parameters as they would on a driver; mapped buffers are backed by
+ * host memory. GL 1.1 functions are exported by the GL library itself and
+ * do nothing while no context is current.
+ */
+namespace NullGpuBackend {
+
+// Reflected uniform
+struct UniformInfo {
+    const char* name;
+    GLenum type;
+    GLint offset;
+};
+
+// Plain uniforms of every program; locations are the index plus one
+static const UniformInfo s_uniforms[] = {
+    { "model", GL_FLOAT_MAT4, -1 },
+    { "view", GL_FLOAT_MAT4, -1 },
+    { "projection", GL_FLOAT_MAT4, -1 },
+    { "tint", GL_FLOAT_VEC4, -1 },
+    { "albedoMap", GL_SAMPLER_2D, -1 }
+};
+
+// Members of every program's material block (std140)
+static const UniformInfo s_blockMembers[] = {
+    { "baseColor", GL_FLOAT_VEC4, 0 },
+    { "roughness", GL_FLOAT, 16 },
+    { "metallic", GL_FLOAT, 20 }
+};
+constexpr GLint MATERIAL_BLOCK_SIZE = 32;
+
+constexpr GLint UNIFORM_COUNT = sizeof(s_uniforms) / sizeof(s_uniforms[0]);
+constexpr GLint BLOCK_MEMBER_COUNT = sizeof(s_blockMembers) / sizeof(s_blockMembers[0]);
+
+// Next object name handed out
+static GLuint s_nextName = 1;
+
+// Host memory behind mapped buffers
+static std::vector<unsigned char> s_mappedMemory;
+
+static void GenerateNames(GLsizei count, GLuint* names) {
+    for (GLsizei i = 0; i < count; ++i) {
+        names[i] = s_nextName++;
+    }
+}
+
+static void CopyName(const char* name, GLsizei bufSize, GLsizei* length, GLchar* buffer) {
+    const GLsizei nameLength = std::min(static_cast<GLsizei>(std::strlen(name)), bufSize > 0 ? bufSize - 1 : 0);
+    if (bufSize > 0) {
+        std::memcpy(buffer, name, static_cast<std::size_t>(nameLength));
+        buffer[nameLength] = '\0';
+    }
+    if (length) {
+        *length = nameLength;
+    }
+}
+
+// Point GLEW's entry points at the stubs
+static void Install() {
+    // Shaders and programs
+    glCreateShader = [](GLenum) -> GLuint { return s_nextName++; };
+    glShaderSource = [](GLuint, GLsizei, const GLchar* const*, const GLint*) {};
+    glCompileShader = [](GLuint) {};
+    glGetShaderiv = [](GLuint, GLenum pname, GLint* params) { *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0; };
+    glGetShaderInfoLog = [](GLuint, GLsizei, GLsizei* length, GLchar* log) { if (length) *length = 0; if (log) *log = '\0'; };
+    glDeleteShader = [](GLuint) {};
+    glCreateProgram = []() -> GLuint { return s_nextName++; };
+    glAttachShader = [](GLuint, GLuint) {};
+    glDetachShader = [](GLuint, GLuint) {};
+    glLinkProgram = [](GLuint) {};
+    glGetProgramInfoLog = [](GLuint, GLsizei, GLsizei* length, GLchar* log) { if (length) *length = 0; if (log) *log = '\0'; };
+    glDeleteProgram = [](GLuint) {};
+    glUseProgram = [](GLuint) {};
+    glGetProgramiv = [](GLuint, GLenum pname, GLint* params) {
+        switch (pname) {
+            case GL_LINK_STATUS: *params = GL_TRUE; break;
+            case GL_ACTIVE_UNIFORMS: *params = UNIFORM_COUNT + BLOCK_MEMBER_COUNT; break;
+            case GL_ACTIVE_UNIFORM_MAX_LENGTH: *params = 32; break;
+            default: *params = 0; break;
+        }
+    };
+
+    // Uniform reflection; active uniforms list the plain uniforms, then the block members
+    glGetActiveUniform = [](GLuint, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name) {
+        const UniformInfo& info = index < static_cast<GLuint>(UNIFORM_COUNT) ? s_uniforms[index] : s_blockMembers[index - UNIFORM_COUNT];
+        CopyName(info.name, bufSize, length, name);
+        *size = 1;
+        *type = info.type;
+    };
+    glGetActiveUniformName = [](GLuint, GLuint index, GLsizei bufSize, GLsizei* length, GLchar* name) {
+        const UniformInfo& info = index < static_cast<GLuint>(UNIFORM_COUNT) ? s_uniforms[index] : s_blockMembers[index - UNIFORM_COUNT];
+        CopyName(info.name, bufSize, length, name);
+    };
+    glGetUniformLocation = [](GLuint, const GLchar* name) -> GLint {
+        for (GLint i = 0; i < UNIFORM_COUNT; ++i) {
+            if (std::strcmp(s_uniforms[i].name, name) == 0) {
+                return i + 1;
+            }
+        }
+        return -1;
+    };
+    glGetUniformBlockIndex = [](GLuint, const GLchar* name) -> GLuint {
+        return std::strcmp(name, MATERIAL_BLOCK_NAME) == 0 ? 0 : GL_INVALID_INDEX;
+    };
+    glGetActiveUniformBlockiv = [](GLuint, GLuint, GLenum pname, GLint* params) {
+        switch (pname) {
+            case GL_UNIFORM_BLOCK_DATA_SIZE: *params = MATERIAL_BLOCK_SIZE; break;
+            case GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS: *params = BLOCK_MEMBER_COUNT; break;
+            case GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES:
+                for (GLint i = 0; i < BLOCK_MEMBER_COUNT; ++i) {
+                    params[i] = UNIFORM_COUNT + i;
+                }
+                break;
+            default: *params = 0; break;
+        }
+    };
+    glGetActiveUniformsiv = [](GLuint, GLsizei count, const GLuint* indices, GLenum pname, GLint* params) {
+        for (GLsizei i = 0; i < count; ++i) {
+            const UniformInfo& info = s_blockMembers[indices[i] - UNIFORM_COUNT];
+            params[i] = pname == GL_UNIFORM_OFFSET ? info.offset : pname == GL_UNIFORM_TYPE ? static_cast<GLint>(info.type) : 0;
+        }
+    };
+    glUniformBlockBinding = [](GLuint, GLuint, GLuint) {};
+
+    // Uniform values
+    glUniform1i = [](GLint, GLint) {};
+    glUniform1f = [](GLint, GLfloat) {};
+    glUniform1fv = [](GLint, GLsizei, const GLfloat*) {};
+    glUniform2fv = [](GLint, GLsizei, const GLfloat*) {};
+    glUniform3fv = [](GLint, GLsizei, const GLfloat*) {};
+    glUniform4fv = [](GLint, GLsizei, const GLfloat*) {};
+    glUniformMatrix3fv = [](GLint, GLsizei, GLboolean, const GLfloat*) {};
+    glUniformMatrix4fv = [](GLint, GLsizei, GLboolean, const GLfloat*) {};
+
+    // Buffers and vertex arrays
+    glGenBuffers = [](GLsizei count, GLuint* buffers) { GenerateNames(count, buffers); };
+    glDeleteBuffers = [](GLsizei, const GLuint*) {};
+    glBindBuffer = [](GLenum, GLuint) {};
+    glBindBufferBase = [](GLenum, GLuint, GLuint) {};
+    glBufferData = [](GLenum, GLsizeiptr, const void*, GLenum) {};
+    glBufferSubData = [](GLenum, GLintptr, GLsizeiptr, const void*) {};
+    glBufferStorage = [](GLenum, GLsizeiptr, const void*, GLbitfield) {};
+    glMapBufferRange = [](GLenum, GLintptr offset, GLsizeiptr length, GLbitfield) -> void* {
+        s_mappedMemory.resize(static_cast<std::size_t>(offset + length));
+        return s_mappedMemory.data() + offset;
+    };
+    glUnmapBuffer = [](GLenum) -> GLboolean { return GL_TRUE; };
+    glGenVertexArrays = [](GLsizei count, GLuint* arrays) { GenerateNames(count, arrays); };
+    glDeleteVertexArrays = [](GLsizei, const GLuint*) {};
+    glBindVertexArray = [](GLuint) {};
+    glEnableVertexAttribArray = [](GLuint) {};
+    glDisableVertexAttribArray = [](GLuint) {};
+    glVertexAttribPointer = [](GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) {};
+    glVertexAttribDivisor = [](GLuint, GLuint) {};
+
+    // Textures, draws and synchronization
+    glActiveTexture = [](GLenum) {};
+    glGenerateMipmap = [](GLenum) {};
+    glDrawElementsInstanced = [](GLenum, GLsizei, GLenum, const void*, GLsizei) {};
+    glFenceSync = [](GLenum, GLbitfield) -> GLsync { return reinterpret_cast<GLsync>(static_cast<std::uintptr_t>(s_nextName++)); };
+    glClientWaitSync = [](GLsync, GLbitfield, GLuint64) -> GLenum { return GL_ALREADY_SIGNALED; };
+    glDeleteSync = [](GLsync) {};
+
+    // Take the persistently mapped instance buffer path (GLEW_ARB_buffer_storage reads this flag)
+    __GLEW_ARB_buffer_storage = GL_TRUE;
+}
+
+} // namespace NullGpuBackend
+
+// Materials and meshes in the submission benchmarks
+constexpr std::size_t BENCHMARK_MATERIAL_COUNT = 16;
+constexpr std::size_t BENCHMARK_MESH_COUNT = 8;
+
+// Draws submitted per batch
+constexpr std::size_t DRAWS_PER_BATCH = 4096;
+
+// Rendering submission benchmarks against the null GPU backend
+static void RunRenderingBenchmarks(BenchmarkRunner& runner) {
+    if (!runner.IsAnySelected({ "rendering/material_bind", "rendering/material_bind_dirty", "rendering/draw_mesh",
+                                "rendering/render_queue_submit_flush" })) {
+        return;
+    }
+
+    NullGpuBackend::Install();
+
+    // A cube's worth of interleaved position, normal and texture coordinates
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    for (int i = 0; i < 24; ++i) {
+        const float corner[3] = { (i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f };
+        vertices.insert(vertices.end(), { corner[0], corner[1], corner[2], 0.0f, 1.0f, 0.0f, 0.0f, 0.0f });
+    }
+    for (unsigned int i = 0; i < 36; ++i) {
+        indices.push_back(i % 24);
+    }
+
+    const unsigned char pixels[4 * 4 * 4] = {};
+    std::shared_ptr<Texture> texture = std::make_shared<Texture>(4, 4, 4, pixels);
+    std::shared_ptr<Shader> shader = std::make_shared<Shader>("", "");
+
+    std::vector<std::shared_ptr<Material>> materials;
+    std::vector<int> roughnessSlots;
+    for (std::size_t i = 0; i < BENCHMARK_MATERIAL_COUNT; ++i) {
+        std::shared_ptr<Material> material = std::make_shared<Material>(shader);
+        material->SetColor("baseColor", glm::vec4(1.0f));
+        material->SetFloat("roughness", 0.5f);
+        material->SetVec4("tint", glm::vec4(1.0f));
+        material->SetTexture("albedoMap", texture);
+        roughnessSlots.push_back(material->GetParameterSlot("roughness"));
+        materials.push_back(material);
+    }
+
+    std::vector<std::shared_ptr<Mesh>> meshes;
+    for (std::size_t i = 0; i < BENCHMARK_MESH_COUNT; ++i) {
+        meshes.push_back(std::make_shared<Mesh>(vertices, indices));
+    }
+
+    std::vector<glm::mat4> transforms;
+    for (std::size_t i = 0; i < DRAWS_PER_BATCH; ++i) {
+        transforms.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(i % 64), 0.0f, static_cast<float>(i / 64))));
+    }
+
+    // Rebinding materials whose block is already uploaded
+    runner.Run("rendering/material_bind", DRAWS_PER_BATCH, [&]() -> std::uint64_t {
+        for (std::size_t i = 0; i < DRAWS_PER_BATCH; ++i) {
+            materials[i % BENCHMARK_MATERIAL_COUNT]->Bind();
+        }
+        return DRAWS_PER_BATCH;
+    });
+
+    // Binding after a parameter change, which re-uploads the material block
+    runner.Run("rendering/material_bind_dirty", DRAWS_PER_BATCH, [&]() -> std::uint64_t {
+        for (std::size_t i = 0; i < DRAWS_PER_BATCH; ++i) {
+            const std::size_t index = i % BENCHMARK_MATERIAL_COUNT;
+            materials[index]->SetFloat(roughnessSlots[index], static_cast<float>(i & 0xFF) / 255.0f);
+            materials[index]->Bind();
+        }
+        return DRAWS_PER_BATCH;
+    });
+
+    Camera camera;
+    Renderer& renderer = Renderer::Instance();
+    renderer.SetMainCamera(&camera);
+
+    // Immediate draws, one material bind and draw call each
+    runner.Run("rendering/draw_mesh", DRAWS_PER_BATCH, [&]() -> std::uint64_t {
+        for (std::size_t i = 0; i < DRAWS_PER_BATCH; ++i) {
+            renderer.DrawMesh(meshes[i % BENCHMARK_MESH_COUNT], materials[i % BENCHMARK_MATERIAL_COUNT], transforms[i]);
+        }
+        return DRAWS_PER_BATCH;
+    });
+
+    // Queued draws, sorted and merged into instanced draw calls
+    RenderQueue queue;
+    runner.Run("rendering/render_queue_submit_flush", DRAWS_PER_BATCH, [&]() -> std::uint64_t {
+        MemoryManager::ResetThreadFrameArenas();
+        for (std::size_t i = 0; i < DRAWS_PER_BATCH; ++i) {
+            queue.Submit(meshes[i % BENCHMARK_MESH_COUNT].get(), materials[(i / 7) % BENCHMARK_MATERIAL_COUNT].get(), transforms[i]);
+        }
+        queue.Flush(&camera);
+        return queue.GetDrawCallCount();
+    });
+
+    renderer.SetMainCamera(nullptr);
+}
+
+// Format the current time as an ISO 8601 UTC timestamp
+static std::string GetTimestamp() {
+    const std::time_t now = std::time(nullptr);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buffer;
+}
+
+// Build the JSON report of a run
+static Json::Value BuildReport(const BenchmarkRunner& runner, const std::string& label, std::size_t threadCount) {
+    Json::Value report;
+    report["label"] = label;
+    report["timestamp"] = GetTimestamp();
+    report["threads"] = static_cast<Json::UInt64>(threadCount);
+#ifdef NDEBUG
+    report["optimized"] = true;
+#else
+    report["optimized"] = false;
+#endif
+    report["profiling"] = CHULUBME_PROFILING != 0;
+
+    Json::Value& benchmarks = report["benchmarks"];
+    benchmarks = Json::Value(Json::arrayValue);
+    for (const BenchmarkResult& result : runner.GetResults()) {
+        Json::Value entry;
+        entry["name"] = result.name;
+        entry["batches"] = static_cast<Json::UInt64>(result.batchCount);
+        entry["operationsPerBatch"] = static_cast<Json::UInt64>(result.operationsPerBatch);
+        entry["itemsPerBatch"] = static_cast<Json::UInt64>(result.itemsPerBatch);
+        entry["medianBatchNs"] = result.medianNanoseconds;
+        entry["minBatchNs"] = result.minNanoseconds;
+        entry["nsPerOperation"] = result.GetNanosecondsPerOperation();
+        entry["operationsPerSecond"] = result.GetOperationsPerSecond();
+        entry["itemsPerSecond"] = result.GetItemsPerSecond();
+        benchmarks.append(entry);
+    }
+
+    return report;
+}
+
+// Print the change of every benchmark against a report from an earlier run
+static bool CompareWithBaseline(const BenchmarkRunner& runner, const std::string& filename) {
+    std::ifstream input(filename);
+    if (!input.is_open()) {
+        return false;
+    }
+
+    Json::Value baseline;
+    Json::CharReaderBuilder reader;
+    std::string errors;
+    if (!Json::parseFromStream(reader, input, &baseline, &errors)) {
+        return false;
+    }
+
+    std::cout << std::endl << "Change against " << filename;
+    if (!baseline["label"].asString().empty()) {
+        std::cout << " (" << baseline["label"].asString() << ")";
+    }
+    std::cout << ", negative is faster:" << std::endl;
+
+    for (const BenchmarkResult& result : runner.GetResults()) {
+        for (const Json::Value& entry : baseline["benchmarks"]) {
+            if (entry["name"].asString() != result.name || entry["nsPerOperation"].asDouble() <= 0.0) {
+                continue;
+            }
+
+            const double change = (result.GetNanosecondsPerOperation() / entry["nsPerOperation"].asDouble() - 1.0) * 100.0;
+            std::cout << std::left << std::setw(40) << result.name << std::right << std::fixed << std::setprecision(1)
+                      << std::showpos << std::setw(10) << change << "%" << std::noshowpos << std::endl;
+            break;
+        }
+    }
+
+    return true;
+}
+
+// Print command line usage
+static void PrintUsage() {
+    std::cerr << "Usage: benchmark_engine [--json <report.json>] [--baseline <report.json>] [--label <name>]" << std::endl
+              << "                        [--filter <substring>] [--min-time <seconds>] [--heroes <heroes.json>]" << std::endl;
+}
+
+// Main function
+int main(int argc, char* argv[]) {
+    std::string jsonFilename;
+    std::string baselineFilename;
+    std::string label;
+    std::string filter;
+    std::string heroFilename = "sample_heroes.json";
+    double minSeconds = 0.5;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (i + 1 >= argc) {
+            PrintUsage();
+            return 1;
+        }
+
+        const std::string value = argv[++i];
+        if (option == "--json") {
+            jsonFilename = value;
+        } else if (option == "--baseline") {
+            baselineFilename = value;
+        } else if (option == "--label") {
+            label = value;
+        } else if (option == "--filter") {
+            filter = value;
+        } else if (option == "--min-time") {
+            minSeconds = std::atof(value.c_str());
+        } else if (option == "--heroes") {
+            heroFilename = value;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    // Zones would fill the per-thread rings with nothing draining them
+    Profiler::Instance().SetEnabled(false);
+
+    const std::size_t threadCount = std::max<std::size_t>(2, std::thread::hardware_concurrency());
+    JobSystem jobSystem(threadCount - 1);
+    BenchmarkRunner runner(minSeconds, filter);
+
+    std::cout << "CHULUBME Engine Benchmarks (" << threadCount << " threads)" << std::endl;
+
+    RunEcsBenchmarks(runner, jobSystem);
+    RunMemoryBenchmarks(runner, threadCount);
+    if (!RunAbilityBenchmarks(runner, heroFilename)) {
+        std::cerr << "Failed to set up ability benchmarks from " << heroFilename << std::endl;
+        return 1;
+    }
+    RunRenderingBenchmarks(runner);
+
+    if (!jsonFilename.empty()) {
+        std::ofstream output(jsonFilename);
+        if (!output.is_open()) {
+            std::cerr << "Failed to write " << jsonFilename << std::endl;
+            return 1;
+        }
+
+        Json::StreamWriterBuilder writer;
+        writer["indentation"] = "  ";
+        output << Json::writeString(writer, BuildReport(runner, label, threadCount)) << std::endl;
+    }
+
+    if (!baselineFilename.empty() && !CompareWithBaseline(runner, baselineFilename)) {
+        std::cerr << "Failed to read baseline " << baselineFilename << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace CHULUBME {
+
+/**
+ * @brief Appends bit-packed values to a byte buffer
+ *
+ * Bits are written least significant first through a 64-bit accumulator
+ * that spills whole bytes. Unsigned values are written with a 6-bit width
+ * prefix, so small numbers (e.g. deltas of quantized state) cost a few bits.
+ * Flush must be called to write the final partial byte.
+ */
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<unsigned char>& output) : m_output(output), m_scratch(0), m_scratchBits(0), m_bitCount(0) {}
+
+    // Write the low count bits of a value (count at most 32)
+    void WriteBits(std::uint32_t value, unsigned count);
+
+    // Write one bit
+    void WriteBool(bool value) { WriteBits(value ? 1u : 0u, 1); }
+
+    // Write an unsigned value prefixed with its bit width
+    void WriteUnsigned(std::uint32_t value);
+
+    // Write a signed value, zigzag encoded so small magnitudes stay short
+    void WriteSigned(std::int32_t value);
+
+    // Write the remaining bits, padding the last byte with zeros
+    void Flush();
+
+    // Get the number of bits written
+    std::size_t GetBitCount() const { return m_bitCount; }
+
+private:
+    std::vector<unsigned char>& m_output;
+    std::uint64_t m_scratch;
+    unsigned m_scratchBits;
+    std::size_t m_bitCount;
+};
+
+/**
+ * @brief Reads values written by BitWriter
+ *
+ * Reads past the end return zero and set the overflow flag, so a decoder
+ * can read a whole message and check HasOverflowed once at the end.
+ */
+class BitReader {
+public:
+    BitReader(const unsigned char* data, std::size_t size) : m_data(data), m_size(size), m_bitOffset(0), m_overflowed(false) {}
+
+    // Read count bits (count at most 32)
+    std::uint32_t ReadBits(unsigned count);
+
+    // Read one bit
+    bool ReadBool() { return ReadBits(1) != 0; }
+
+    // Read an unsigned value written by WriteUnsigned
+    std::uint32_t ReadUnsigned();
+
+    // Read a signed value written by WriteSigned
+    std::int32_t ReadSigned();
+
+    // Check if a read ran past the end of the data
+    bool HasOverflowed() const { return m_overflowed; }
+
+    // Get the number of bits not yet read (0 after an overflow)
+    std::size_t GetRemainingBits() const { return m_overflowed ? 0 : m_size * 8 - m_bitOffset; }
+
+private:
+    const unsigned char* m_data;
+    std::size_t m_size;
+    std::size_t m_bitOffset;
+    bool m_overflowed;
+};
+
+// Implementation
+
+inline void BitWriter::WriteBits(std::uint32_t value, unsigned count) {
+    if (count == 0) {
+        return;
+    }
+
+    const std::uint64_t mask = (std::uint64_t(1) << count) - 1;
+    m_scratch |= (std::uint64_t(value) & mask) << m_scratchBits;
+    m_scratchBits += count;
+    m_bitCount += count;
+
+    while (m_scratchBits >= 8) {
+        m_output.push_back(static_cast<unsigned char>(m_scratch));
+        m_scratch >>= 8;
+        m_scratchBits -= 8;
+    }
+}
+
+inline void BitWriter::WriteUnsigned(std::uint32_t value) {
+    unsigned width = 0;
+    while (width < 32 && (value >> width) != 0) {
+        ++width;
+    }
+
+    WriteBits(width, 6);
+    WriteBits(value, width);
+}
+
+inline void BitWriter::WriteSigned(std::int32_t value) {
+    const std::uint32_t bits = static_cast<std::uint32_t>(value);
+    WriteUnsigned((bits << 1) ^ (value < 0 ? 0xFFFFFFFFu : 0u));
+}
+
+inline void BitWriter::Flush() {
+    if (m_scratchBits > 0) {
+        m_output.push_back(static_cast<unsigned char>(m_scratch));
+        m_bitCount += 8 - m_scratchBits;
+        m_scratch = 0;
+        m_scratchBits = 0;
+    }
+}
+
+inline std::uint32_t BitReader::ReadBits(unsigned count) {
+    if (m_overflowed || count > m_size * 8 - m_bitOffset) {
+        m_overflowed = true;
+        return 0;
+    }
+
+    std::uint32_t value = 0;
+    for (unsigned read = 0; read < count;) {
+        // Take as many bits as remain in the current byte
+        const std::size_t byte = m_bitOffset >> 3;
+        const unsigned shift = static_cast<unsigned>(m_bitOffset & 7);
+        unsigned take = 8 - shift;
+        if (take > count - read) {
+            take = count - read;
+        }
+
+        const std::uint32_t bits = (static_cast<std::uint32_t>(m_data[byte]) >> shift) & ((1u << take) - 1);
+        value |= bits << read;
+        read += take;
+        m_bitOffset += take;
+    }
+
+    return value;
+}
+
+inline std::uint32_t BitReader::ReadUnsigned() {
+    const unsigned width = ReadBits(6);
+    if (width > 32) {
+        m_overflowed = true;
+        return 0;
+    }
+    return ReadBits(width);
+}
+
+inline std::int32_t BitReader::ReadSigned() {
+    const std::uint32_t bits = ReadUnsigned();
+    return static_cast<std::int32_t>((bits >> 1) ^ (0u - (bits & 1u)));
+}
+
+} // namespace CHULUBME
@@ -4,9 +4,13 @@
 #include <memory>
 #include <vector>
 #include <functional>
+#include <optional>
 #include <unordered_map>
 
 #include "../core/ecs.h"
+#include "blockchain_worker.h"
+#include "chain_frame.h"
+#include "nft_ownership_cache.h"
 #include "../../blockchain/custom/core/blockchain.go" // Include via wrapper
 
 namespace CHULUBME {
@@ -17,8 +21,164 @@ class NFTSystem;
 class TokenEconomics;
 class BlockchainInterface;
 
+/**
+ * @brief Published when a transaction involving the local wallet is seen
+ */
+struct TransactionEvent {
+    Transaction transaction;
+};
+
+/**
+ * @brief Published when the local wallet's balance changes
+ */
+struct BalanceChangedEvent {
+    float oldBalance;
+    float newBalance;
+};
+
+/**
+ * @brief Published when an NFT changes owner (an empty address is unknown or none)
+ */
+struct NFTTransferredEvent {
+    std::string nftId;
+    std::string fromAddress;
+    std::string toAddress;
+};
+
+/**
+ * @brief Token transfer from the local wallet
+ */
+struct TokenTransfer {
+    std::string recipient;
+    float amount;
+};
+
+/**
+ * @brief Marketplace order for an NFT
+ */
+struct NFTOrder {
+    // Order type
+    enum class Type {
+        Buy,
+        Sell
+    };
+
+    Type type;
+    std::string nftId;
+    float price;
+};
+
+/**
+ * @brief Paginated NFT query
+ *
+ * Pages are read from the node's secondary indices. Listings are ordered by
+ * price, then ID; owner and type pages by ID. A page holds at most
+ * NFT_PAGE_MAX_SIZE NFTs.
+ */
+struct NFTPageQuery {
+    // Index the page is read from
+    enum class Index {
+        Listed,
+        Owner,
+        Type
+    };
+
+    Index index;
+    std::string key;    // Owner address or NFT type (unused for listings)
+    std::string cursor; // Next cursor of the previous page (empty for the first page)
+    std::size_t limit;  // Page size (0 or more than NFT_PAGE_MAX_SIZE for the maximum)
+};
+
+// Most NFTs a page holds (matches the node's MaxPageSize)
+constexpr std::size_t NFT_PAGE_MAX_SIZE = 100;
+
+/**
+ * @brief NFTs of one page and the cursor of the next
+ */
+struct NFTPage {
+    std::vector<NFT> nfts;
+    std::string nextCursor; // Empty on the last page
+};
+
+/**
+ * @brief Chain activity a node saw since it was last polled
+ */
+struct ChainActivity {
+    std::vector<Transaction> transactions;       // Transactions involving the local wallet
+    std::vector<NFTTransferredEvent> transfers;  // NFTs that changed owner, including listed NFTs that sold
+};
+
+/**
+ * @brief Synchronous connection to a blockchain node for the local wallet
+ *
+ * Every call may block on the network, so BlockchainInterface only makes
+ * them from its worker thread. Submissions take a whole batch and return
+ * one success flag per entry, letting the node sign and send them together.
+ * A query that fails returns none, and a batched query that fails returns
+ * fewer results than it was given entries, so failures never look like data.
+ */
+class BlockchainClient {
+public:
+    virtual ~BlockchainClient() = default;
+
+    // Get the local wallet's address (known locally; may be called from any thread)
+    virtual const std::string& GetAddress() const = 0;
+
+    // Get the wallet balance
+    virtual std::optional<float> QueryBalance() = 0;
+
+    // Get the NFTs the wallet owns
+    virtual std::optional<std::vector<NFT>> QueryOwnedNFTs() = 0;
+
+    // Get the IDs of the NFTs each of several wallets owns, one list per address
+    virtual std::vector<std::vector<std::string>> QueryOwnedNFTIDs(const std::vector<std::string>& addresses) = 0;
+
+    // Get several pages of NFTs, one per query (an empty page for an invalid cursor)
+    virtual std::vector<NFTPage> QueryNFTPages(const std::vector<NFTPageQuery>& queries) = 0;
+
+    // Submit token transfers
+    virtual std::vector<bool> SubmitTransfers(const std::vector<TokenTransfer>& transfers) = 0;
+
+    // Submit marketplace orders
+    virtual std::vector<bool> SubmitNFTOrders(const std::vector<NFTOrder>& orders) = 0;
+
+    // Report play score updates to the validators (one ChainFrame::EncodePlayScores frame per call)
+    virtual std::vector<bool> SubmitPlayScores(const std::vector<PlayScoreUpdate>& updates) = 0;
+
+    // Get the transactions and NFT transfers the node saw since the last call
+    virtual std::optional<ChainActivity> PollActivity() = 0;
+};
+
 /**
  * @brief Interface to the blockchain system
+ *
+ * Chain I/O never runs on the game thread. Queries and submissions are
+ * queued to a worker thread that talks to the node through the
+ * BlockchainClient, and their callbacks run in Update, which
+ * BlockchainSystem calls once per frame. A failed query leaves the last
+ * values received and the cache unchanged and publishes nothing; its
+ * callbacks receive no result. Repeated balance and ownership
+ * queries made before the worker gets to them share one round trip, and
+ * transfers, orders and play score reports queued together are submitted
+ * as one batch. A
+ * successful submission refreshes the balance and owned NFTs. Marketplace
+ * and collection screens load NFTs a page at a time with RequestNFTPage,
+ * so each load costs the same however many NFTs exist.
+ *
+ * GetBalance and GetOwnedNFTs return the last values received. Balance
+ * changes are published as BalanceChangedEvent on the event bus set with
+ * SetEventBus, from Update. Update also polls the node for chain activity
+ * every ACTIVITY_POLL_INTERVAL seconds and publishes the transactions as
+ * TransactionEvent.
+ *
+ * Which NFTs any wallet owns is answered by the NFTOwnershipCache. Setting a
+ * client warms it for the local wallet; RequestOwnership warms other wallets
+ * (e.g. every player at champion select) with one batched query, and again
+ * once their lists are no longer fresh. Transfers polled from the node,
+ * successful purchases and sales, and owned NFT lists received all update it
+ * through ApplyNFTTransfer or SetOwnedNFTs; transfers are published as
+ * NFTTransferredEvent. With a cache file set, the cache is loaded from it and
+ * saved back on the worker while dirty.
  */
 class BlockchainInterface {
 public:
@@ -64,35 +224,60 @@ public:
     // Save wallet to file
     bool SaveWallet(const std::string& filename, const std::string& password);
 
-    // Get wallet balance
-    float GetBalance() const;
+    // Set the node connection and start the worker (none stops it once queued requests finished)
+    void SetClient(std::unique_ptr<BlockchainClient> client);
 
-    // Send ILYZ tokens
-    bool SendTokens(const std::string& recipient, float amount);
+    // Get the local wallet's address (empty without a client)
+    const std::string& GetWalletAddress() const;
 
-    // Get owned NFTs
-    std::vector<NFT> GetOwnedNFTs() const;
+    // Load the ownership cache from a file and save it back there while it changes
+    bool SetOwnershipCacheFile(const std::string& filename);
 
-    // Get NFT marketplace listings
-    std::vector<NFT> GetMarketplaceListings() const;
+    // Get the NFT ownership cache
+    const NFTOwnershipCache& GetOwnershipCache() const { return m_ownershipCache; }
 
-    // Buy NFT from marketplace
-    bool BuyNFT(const std::string& nftId);
+    // Refresh a wallet's ownership in the cache unless already fresh or requested (force refreshes anyway)
+    void RequestOwnership(const std::string& address, bool force = false);
 
-    // Sell NFT on marketplace
-    bool SellNFT(const std::string& nftId, float price);
+    // Record an NFT changing owner in the cache and publish it
+    void ApplyNFTTransfer(const std::string& nftId, const std::string& fromAddress, const std::string& toAddress);
 
-    // Calculate game rewards
-    float CalculateGameReward(int matchDuration, int playerRank, float performanceScore);
+    // Get the last wallet balance received
+    float GetBalance() const { return m_balance; }
+
+    // Get the last list of owned NFTs received
+    const std::vector<NFT>& GetOwnedNFTs() const { return m_ownedNFTs; }
+
+    // Request the wallet balance; the callback (if any) receives it, or none on failure, in Update
+    void RequestBalance(std::function<void(const std::optional<float>&)> onComplete = nullptr);
 
-    // Register transaction callback
-    void RegisterTransactionCallback(std::function<void(const Transaction&)> callback);
+    // Request the owned NFTs; the callback (if any) receives them, or none on failure, in Update
+    void RequestOwnedNFTs(std::function<void(const std::optional<std::vector<NFT>>&)> onComplete = nullptr);
 
-    // Register balance change callback
-    void RegisterBalanceChangeCallback(std::function<void(float)> callback);
+    // Request one page of NFTs (marketplace listings, or by owner or type); the callback receives it,
+    // or none on failure, in Update
+    void RequestNFTPage(const NFTPageQuery& query, std::function<void(const std::optional<NFTPage>&)> onComplete);
 
-    // Register NFT acquisition callback
-    void RegisterNFTAcquisitionCallback(std::function<void(const NFT&)> callback);
+    // Send ILYZ tokens; the callback (if any) receives whether it succeeded in Update
+    void SendTokens(const std::string& recipient, float amount, std::function<void(bool)> onComplete = nullptr);
+
+    // Buy NFT from marketplace; the callback (if any) receives whether it succeeded in Update
+    void BuyNFT(const std::string& nftId, std::function<void(bool)> onComplete = nullptr);
+
+    // Sell NFT on marketplace; the callback (if any) receives whether it succeeded in Update
+    void SellNFT(const std::string& nftId, float price, std::function<void(bool)> onComplete = nullptr);
+
+    // Report a player's activity for proof of play; updates queued together are sent as one frame
+    void ReportPlayScore(const std::string& address, double activity, std::function<void(bool)> onComplete = nullptr);
+
+    // Get the number of chain requests queued or running
+    std::size_t GetPendingRequestCount() const { return m_worker.GetPendingCount(); }
+
+    // Calculate game rewards
+    float CalculateGameReward(int matchDuration, int playerRank, float performanceScore);
+
+    // Set the bus blockchain events are published on (none to stop publishing)
+    void SetEventBus(EventBus* eventBus) { m_eventBus = eventBus; }
 
 private:
     // Private constructor for singleton
@@ -118,14 +303,63 @@ private:
     // Connection status
     bool m_connected;
 
-    // Callbacks
-    std::vector<std::function<void(const Transaction&)>> m_transactionCallbacks;
-    std::vector<std::function<void(float)>> m_balanceChangeCallbacks;
-    std::vector<std::function<void(const NFT&)>> m_nftAcquisitionCallbacks;
+    // Worker keys of coalesced queries and batched submissions
+    enum RequestKey : BlockchainWorker::RequestKey {
+        BalanceRequest = 1,
+        OwnedNFTsRequest,
+        NFTPageRequest,
+        TransferRequest,
+        NFTOrderRequest,
+        OwnershipRequest,
+        OwnershipSaveRequest,
+        PlayScoreRequest,
+        ActivityRequest
+    };
+
+    // Seconds between saves of a changed ownership cache
+    static constexpr float OWNERSHIP_SAVE_INTERVAL = 5.0f;
+
+    // Seconds between polls of the node for chain activity
+    static constexpr float ACTIVITY_POLL_INTERVAL = 2.0f;
+
+    // Queue a poll for chain activity if the interval passed
+    void PollActivity(float deltaTime);
+
+    // Queue a save of the ownership cache if it changed and the interval passed
+    void SaveOwnershipCache(float deltaTime);
+
+    // Queue a marketplace order
+    void SubmitNFTOrder(NFTOrder order, std::function<void(bool)> onComplete);
+
+    // Node connection, used only on the worker thread (replaced only while it is stopped)
+    std::unique_ptr<BlockchainClient> m_client;
+
+    // Thread running chain I/O
+    BlockchainWorker m_worker;
+
+    // Last results received
+    float m_balance = 0.0f;
+    std::vector<NFT> m_ownedNFTs;
+
+    // NFT ownership of every wallet seen, the wallets with a refresh queued, and where it is saved
+    NFTOwnershipCache m_ownershipCache;
+    FlatHashMap<std::string, bool> m_ownershipRequests;
+    std::string m_ownershipCacheFile;
+    float m_ownershipSaveTimer = 0.0f;
+
+    // Time since chain activity was last polled
+    float m_activityPollTimer = 0.0f;
+
+    // Bus blockchain events are published on
+    EventBus* m_eventBus = nullptr;
 };
 
 /**
  * @brief Wallet component for entity blockchain interaction
+ *
+ * Balance changes and NFT transfers are not reported through the component;
+ * subscribe to BalanceChangedEvent and NFTTransferredEvent on the event bus.
+ * Owned NFTs come from the blockchain interface's caches without a query.
  */
 class WalletComponent : public Component {
 public:
@@ -147,22 +381,17 @@ public:
     // Send tokens
     bool SendTokens(const std::string& recipient, float amount);
 
-    // Get owned NFTs
-    std::vector<NFT> GetOwnedNFTs() const;
-
-    // Register balance change callback
-    void RegisterBalanceChangeCallback(std::function<void(float)> callback);
+    // Get owned NFTs (last list received)
+    const std::vector<NFT>& GetOwnedNFTs() const { return m_blockchainInterface.GetOwnedNFTs(); }
 
-    // Register NFT acquisition callback
-    void RegisterNFTAcquisitionCallback(std::function<void(const NFT&)> callback);
+    // Get the IDs of owned NFTs from the ownership cache
+    const std::vector<std::string>& GetOwnedNFTIDs() const {
+        return m_blockchainInterface.GetOwnershipCache().GetOwnedNFTs(m_blockchainInterface.GetWalletAddress());
+    }
 
 private:
     // Blockchain interface reference
     BlockchainInterface& m_blockchainInterface;
-
-    // Callback handles
-    int m_balanceChangeCallbackHandle;
-    int m_nftAcquisitionCallbackHandle;
 };
 
 /**
@@ -188,10 +417,12 @@ public:
     // Get NFT data
     NFT GetNFTData() const;
 
-    // Check if NFT is owned
-    bool IsOwned() const;
+    // Check if NFT is owned by the local wallet (answered by the ownership cache)
+    bool IsOwned() const {
+        return m_blockchainInterface.GetOwnershipCache().IsOwned(m_blockchainInterface.GetWalletAddress(), m_nftId);
+    }
 
-    // Apply NFT skin to entity
+    // Apply NFT skin to entity (only if IsOwned)
     bool ApplySkin();
 
 private:
@@ -204,6 +435,10 @@ private:
 
 /**
  * @brief Blockchain system for processing blockchain interactions
+ *
+ * Its update is the point in the frame where blockchain results reach the
+ * game: it calls BlockchainInterface::Update, which runs the callbacks of
+ * finished requests.
  */
 class BlockchainSystem : public System {
 public:
@@ -222,6 +457,18 @@ public:
     // Called when an entity is removed from this system
     void OnEntityRemoved(Entity entity) override;
 
+    // Check if a wallet owns an NFT, from the ownership cache
+    bool IsNFTOwned(const std::string& address, const std::string& nftId) const {
+        return m_blockchainInterface.GetOwnershipCache().IsOwned(address, nftId);
+    }
+
+    // Warm the ownership cache for the wallets of a match's players in one query
+    void WarmOwnership(const std::vector<std::string>& addresses) {
+        for (const std::string& address : addresses) {
+            m_blockchainInterface.RequestOwnership(address);
+        }
+    }
+
 private:
     // Blockchain interface reference
     BlockchainInterface& m_blockchainInterface;
@@ -249,4 +496,228 @@ private:
     BlockchainInterface& m_blockchainInterface;
 };
 
+// Implementation of BlockchainInterface request methods
+
+inline void BlockchainInterface::Update(float deltaTime) {
+    // Hand finished requests to their callbacks on this thread
+    m_worker.DispatchCompletions();
+
+    PollActivity(deltaTime);
+    SaveOwnershipCache(deltaTime);
+}
+
+inline void BlockchainInterface::SetClient(std::unique_ptr<BlockchainClient> client) {
+    // The worker reads the client, so swap it only while the worker is stopped
+    m_worker.Stop();
+    m_client = std::move(client);
+    if (m_client) {
+        m_worker.Start();
+
+        // Warm the cache for the wallet that just logged in
+        RequestOwnership(m_client->GetAddress(), true);
+    }
+}
+
+inline const std::string& BlockchainInterface::GetWalletAddress() const {
+    static const std::string s_none;
+    return m_client ? m_client->GetAddress() : s_none;
+}
+
+inline bool BlockchainInterface::SetOwnershipCacheFile(const std::string& filename) {
+    m_ownershipCacheFile = filename;
+    m_ownershipSaveTimer = 0.0f;
+    return m_ownershipCache.Load(filename);
+}
+
+inline void BlockchainInterface::RequestOwnership(const std::string& address, bool force) {
+    if (address.empty() || (!force && m_ownershipCache.IsFresh(address)) || m_ownershipRequests.count(address) != 0) {
+        return;
+    }
+
+    m_ownershipRequests[address] = true;
+    m_worker.SubmitBatched<std::string, std::vector<std::string>>(OwnershipRequest, address,
+        [this](const std::vector<std::string>& addresses) { return m_client->QueryOwnedNFTIDs(addresses); },
+        [this, address](const std::optional<std::vector<std::string>>& nftIds) {
+            // A failed query keeps the cached list; the wallet stays stale, so the next request retries
+            m_ownershipRequests.erase(address);
+            if (nftIds) {
+                m_ownershipCache.SetOwnedNFTs(address, *nftIds);
+            }
+        });
+}
+
+inline void BlockchainInterface::ApplyNFTTransfer(const std::string& nftId, const std::string& fromAddress, const std::string& toAddress) {
+    m_ownershipCache.ApplyTransfer(nftId, fromAddress, toAddress);
+    if (m_eventBus) {
+        m_eventBus->Publish(NFTTransferredEvent{ nftId, fromAddress, toAddress });
+    }
+}
+
+inline void BlockchainInterface::PollActivity(float deltaTime) {
+    m_activityPollTimer += deltaTime;
+    if (!m_client || m_activityPollTimer < ACTIVITY_POLL_INTERVAL) {
+        return;
+    }
+    m_activityPollTimer = 0.0f;
+
+    m_worker.Query<ChainActivity>(ActivityRequest,
+        [this]() { return m_client->PollActivity(); },
+        [this](const std::optional<ChainActivity>& activity) {
+            if (!activity) {
+                return;
+            }
+            if (m_eventBus) {
+                for (const Transaction& transaction : activity->transactions) {
+                    m_eventBus->Publish(TransactionEvent{ transaction });
+                }
+            }
+            for (const NFTTransferredEvent& transfer : activity->transfers) {
+                ApplyNFTTransfer(transfer.nftId, transfer.fromAddress, transfer.toAddress);
+            }
+        });
+}
+
+inline void BlockchainInterface::SaveOwnershipCache(float deltaTime) {
+    m_ownershipSaveTimer += deltaTime;
+    if (m_ownershipCacheFile.empty() || !m_ownershipCache.IsDirty() || m_ownershipSaveTimer < OWNERSHIP_SAVE_INTERVAL) {
+        return;
+    }
+    m_ownershipSaveTimer = 0.0f;
+
+    // Serialize here, write on the worker; of several queued snapshots only the newest is written
+    std::vector<unsigned char> snapshot;
+    m_ownershipCache.Serialize(snapshot);
+    m_ownershipCache.SetDirty(false);
+
+    const std::string filename = m_ownershipCacheFile;
+    m_worker.SubmitBatched<std::vector<unsigned char>, bool>(OwnershipSaveRequest, std::move(snapshot),
+        [filename](const std::vector<std::vector<unsigned char>>& snapshots) {
+            const bool saved = NFTOwnershipCache::WriteFile(filename, snapshots.back());
+            return std::vector<bool>(snapshots.size(), saved);
+        },
+        [this](const std::optional<bool>& saved) {
+            if (!saved.value_or(false)) {
+                m_ownershipCache.SetDirty(true);
+            }
+        });
+}
+
+inline void BlockchainInterface::RequestBalance(std::function<void(const std::optional<float>&)> onComplete) {
+    m_worker.Query<float>(BalanceRequest,
+        [this]() { return m_client->QueryBalance(); },
+        [this, onComplete](const std::optional<float>& balance) {
+            // Callers joined into one query all see the change; publish it once
+            if (balance && *balance != m_balance) {
+                const float oldBalance = m_balance;
+                m_balance = *balance;
+                if (m_eventBus) {
+                    m_eventBus->Publish(BalanceChangedEvent{ oldBalance, *balance });
+                }
+            }
+            if (onComplete) {
+                onComplete(balance);
+            }
+        });
+}
+
+inline void BlockchainInterface::RequestOwnedNFTs(std::function<void(const std::optional<std::vector<NFT>>&)> onComplete) {
+    m_worker.Query<std::vector<NFT>>(OwnedNFTsRequest,
+        [this]() { return m_client->QueryOwnedNFTs(); },
+        [this, onComplete](const std::optional<std::vector<NFT>>& nfts) {
+            if (nfts) {
+                m_ownedNFTs = *nfts;
+
+                // A full list of the local wallet, so the cache takes it as a refresh
+                std::vector<std::string> nftIds;
+                nftIds.reserve(nfts->size());
+                for (const NFT& nft : *nfts) {
+                    nftIds.push_back(nft.ID);
+                }
+                if (!GetWalletAddress().empty()) {
+                    m_ownershipCache.SetOwnedNFTs(GetWalletAddress(), nftIds);
+                }
+            }
+
+            if (onComplete) {
+                onComplete(nfts);
+            }
+        });
+}
+
+inline void BlockchainInterface::RequestNFTPage(const NFTPageQuery& query, std::function<void(const std::optional<NFTPage>&)> onComplete) {
+    // Pages requested together (e.g. a marketplace screen's tabs) share one round trip
+    NFTPageQuery pageQuery = query;
+    if (pageQuery.limit == 0 || pageQuery.limit > NFT_PAGE_MAX_SIZE) {
+        pageQuery.limit = NFT_PAGE_MAX_SIZE;
+    }
+
+    m_worker.SubmitBatched<NFTPageQuery, NFTPage>(NFTPageRequest, std::move(pageQuery),
+        [this](const std::vector<NFTPageQuery>& queries) { return m_client->QueryNFTPages(queries); },
+        std::move(onComplete));
+}
+
+inline void BlockchainInterface::SendTokens(const std::string& recipient, float amount, std::function<void(bool)> onComplete) {
+    m_worker.SubmitBatched<TokenTransfer, bool>(TransferRequest, TokenTransfer{ recipient, amount },
+        [this](const std::vector<TokenTransfer>& transfers) { return m_client->SubmitTransfers(transfers); },
+        [this, onComplete](const std::optional<bool>& result) {
+            const bool success = result.value_or(false);
+            if (success) {
+                RequestBalance();
+            }
+            if (onComplete) {
+                onComplete(success);
+            }
+        });
+}
+
+inline void BlockchainInterface::BuyNFT(const std::string& nftId, std::function<void(bool)> onComplete) {
+    SubmitNFTOrder(NFTOrder{ NFTOrder::Type::Buy, nftId, 0.0f }, [this, nftId, onComplete](bool success) {
+        // The seller is not known here; their wallet is corrected by its next refresh
+        if (success) {
+            ApplyNFTTransfer(nftId, std::string(), GetWalletAddress());
+        }
+        if (onComplete) {
+            onComplete(success);
+        }
+    });
+}
+
+inline void BlockchainInterface::SellNFT(const std::string& nftId, float price, std::function<void(bool)> onComplete) {
+    SubmitNFTOrder(NFTOrder{ NFTOrder::Type::Sell, nftId, price }, [this, nftId, onComplete](bool success) {
+        // The buyer is not known here; the node reports the sale as a transfer once it happens
+        if (success) {
+            ApplyNFTTransfer(nftId, GetWalletAddress(), std::string());
+        }
+        if (onComplete) {
+            onComplete(success);
+        }
+    });
+}
+
+inline void BlockchainInterface::ReportPlayScore(const std::string& address, double activity, std::function<void(bool)> onComplete) {
+    m_worker.SubmitBatched<PlayScoreUpdate, bool>(PlayScoreRequest, PlayScoreUpdate{ address, activity },
+        [this](const std::vector<PlayScoreUpdate>& updates) { return m_client->SubmitPlayScores(updates); },
+        [onComplete](const std::optional<bool>& result) {
+            if (onComplete) {
+                onComplete(result.value_or(false));
+            }
+        });
+}
+
+inline void BlockchainInterface::SubmitNFTOrder(NFTOrder order, std::function<void(bool)> onComplete) {
+    m_worker.SubmitBatched<NFTOrder, bool>(NFTOrderRequest, std::move(order),
+        [this](const std::vector<NFTOrder>& orders) { return m_client->SubmitNFTOrders(orders); },
+        [this, onComplete](const std::optional<bool>& result) {
+            // Orders move tokens and NFTs; the refreshes coalesce across the batch
+            const bool success = result.value_or(false);
+            if (success) {
+                RequestBalance();
+                RequestOwnedNFTs();
+            }
+            if (onComplete) {
+                onComplete(success);
+            }
+        });
+}
+
 } // namespace CHULUBME
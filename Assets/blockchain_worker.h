@@ -0,0 +1,314 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace CHULUBME {
+
+/**
+ * @brief Dedicated thread running blockchain I/O off the game thread
+ *
+ * Requests are queued from the game thread and run in order on the worker,
+ * which may block on the node as long as it needs. Results are not delivered
+ * on the worker: each finished request queues its completion callbacks, and
+ * DispatchCompletions runs them on the calling thread at whatever point in
+ * the frame the owner chooses. A failed fetch, or a batch item the submission
+ * returned no result for, completes with no result.
+ *
+ * A query queued while one with the same key is still waiting joins it
+ * instead of running again, so asking for the balance every frame costs one
+ * round trip per refresh. Batched submissions with the same key queued while
+ * the worker is busy are gathered into one call, up to MAX_BATCH_SIZE items,
+ * so batches grow with node latency and an idle worker sends at once.
+ */
+class BlockchainWorker {
+public:
+    // Identifies queries that may be coalesced and submissions that may be batched
+    using RequestKey = std::uint64_t;
+
+    // Most items gathered into one batched submission
+    static constexpr std::size_t MAX_BATCH_SIZE = 64;
+
+    BlockchainWorker();
+    ~BlockchainWorker();
+
+    // Deleted copy constructor and assignment operator
+    BlockchainWorker(const BlockchainWorker&) = delete;
+    BlockchainWorker& operator=(const BlockchainWorker&) = delete;
+
+    // Start the worker thread (requests queued before this wait for it)
+    void Start();
+
+    // Stop the worker thread after it finished every queued request
+    void Stop();
+
+    // Check if the worker thread is running
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    // Queue a query run by fetch on the worker (none on failure); onComplete (if any) receives its result in DispatchCompletions
+    template<typename Result>
+    void Query(RequestKey key, std::function<std::optional<Result>()> fetch,
+               std::function<void(const std::optional<Result>&)> onComplete);
+
+    // Queue an item for a batched submission run by submit on the worker, which returns one result per item
+    // (fewer on failure; the items without one complete with none)
+    template<typename Item, typename Result>
+    void SubmitBatched(RequestKey key, Item item,
+                       std::function<std::vector<Result>(const std::vector<Item>&)> submit,
+                       std::function<void(const std::optional<Result>&)> onComplete);
+
+    // Run the callbacks of finished requests on the calling thread; returns the number of requests completed
+    std::size_t DispatchCompletions();
+
+    // Get the number of requests queued or running
+    std::size_t GetPendingCount() const;
+
+private:
+    // Queued request; executed on the worker, completed on the dispatching thread
+    struct Request {
+        Request(RequestKey requestKey, const void* requestType) : key(requestKey), type(requestType) {}
+        virtual ~Request() = default;
+
+        // Run the request's I/O
+        virtual void Execute() = 0;
+
+        // Hand the results to the callbacks
+        virtual void Complete() = 0;
+
+        // Check if another request may still join this one
+        virtual bool CanJoin() const { return true; }
+
+        RequestKey key;
+        const void* type;
+    };
+
+    template<typename Result>
+    struct QueryRequest : Request {
+        QueryRequest(RequestKey requestKey, std::function<std::optional<Result>()> requestFetch)
+            : Request(requestKey, GetRequestType<QueryRequest>()), fetch(std::move(requestFetch)), result() {}
+
+        void Execute() override { result = fetch(); }
+
+        void Complete() override {
+            for (const auto& callback : callbacks) {
+                callback(result);
+            }
+        }
+
+        std::function<std::optional<Result>()> fetch;
+        std::vector<std::function<void(const std::optional<Result>&)>> callbacks;
+        std::optional<Result> result;
+    };
+
+    template<typename Item, typename Result>
+    struct BatchRequest : Request {
+        BatchRequest(RequestKey requestKey, std::function<std::vector<Result>(const std::vector<Item>&)> requestSubmit)
+            : Request(requestKey, GetRequestType<BatchRequest>()), submit(std::move(requestSubmit)) {}
+
+        void Execute() override { results = submit(items); }
+
+        void Complete() override {
+            for (std::size_t i = 0; i < callbacks.size(); ++i) {
+                if (callbacks[i]) {
+                    // Items the submission returned no result for failed
+                    callbacks[i](i < results.size() ? std::optional<Result>(Result(results[i])) : std::nullopt);
+                }
+            }
+        }
+
+        bool CanJoin() const override { return items.size() < MAX_BATCH_SIZE; }
+
+        std::function<std::vector<Result>(const std::vector<Item>&)> submit;
+        std::vector<Item> items;
+        std::vector<std::function<void(const std::optional<Result>&)>> callbacks;
+        std::vector<Result> results;
+    };
+
+    // Get a tag unique to a request type, so requests of different types never share a key
+    template<typename T>
+    static const void* GetRequestType() {
+        static const char s_tag = 0;
+        return &s_tag;
+    }
+
+    // Find a waiting request of the given type and key that accepts more callers (mutex held)
+    template<typename T>
+    T* FindJoinable(RequestKey key);
+
+    // Queue a request and wake the worker (mutex held)
+    void Enqueue(std::unique_ptr<Request> request);
+
+    // Worker thread loop
+    void Run();
+
+    // Worker thread
+    std::thread m_thread;
+
+    // Requests waiting for the worker, and the ones among them others may join
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::unique_ptr<Request>> m_queue;
+    std::unordered_map<RequestKey, Request*> m_joinable;
+    std::size_t m_runningCount;
+    bool m_stopping;
+
+    // Finished requests waiting for DispatchCompletions
+    std::vector<std::unique_ptr<Request>> m_completed;
+
+    // Requests being completed (dispatching thread only)
+    std::vector<std::unique_ptr<Request>> m_dispatching;
+};
+
+// Implementation
+
+inline BlockchainWorker::BlockchainWorker()
+    : m_runningCount(0)
+    , m_stopping(false)
+{
+}
+
+inline BlockchainWorker::~BlockchainWorker() {
+    Stop();
+}
+
+inline void BlockchainWorker::Start() {
+    if (m_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = false;
+    }
+    m_thread = std::thread(&BlockchainWorker::Run, this);
+}
+
+inline void BlockchainWorker::Stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+}
+
+template<typename Result>
+void BlockchainWorker::Query(RequestKey key, std::function<std::optional<Result>()> fetch,
+                             std::function<void(const std::optional<Result>&)> onComplete) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Join an identical query that has not started yet
+    if (QueryRequest<Result>* waiting = FindJoinable<QueryRequest<Result>>(key)) {
+        if (onComplete) {
+            waiting->callbacks.push_back(std::move(onComplete));
+        }
+        return;
+    }
+
+    auto request = std::make_unique<QueryRequest<Result>>(key, std::move(fetch));
+    if (onComplete) {
+        request->callbacks.push_back(std::move(onComplete));
+    }
+    Enqueue(std::move(request));
+}
+
+template<typename Item, typename Result>
+void BlockchainWorker::SubmitBatched(RequestKey key, Item item,
+                                     std::function<std::vector<Result>(const std::vector<Item>&)> submit,
+                                     std::function<void(const std::optional<Result>&)> onComplete) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Add to the batch still being gathered, or start a new one
+    BatchRequest<Item, Result>* batch = FindJoinable<BatchRequest<Item, Result>>(key);
+    if (!batch) {
+        auto request = std::make_unique<BatchRequest<Item, Result>>(key, std::move(submit));
+        batch = request.get();
+        Enqueue(std::move(request));
+    }
+
+    batch->items.push_back(std::move(item));
+    batch->callbacks.push_back(std::move(onComplete));
+}
+
+inline std::size_t BlockchainWorker::DispatchCompletions() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_completed.empty()) {
+            return 0;
+        }
+        m_dispatching.swap(m_completed);
+    }
+
+    // Callbacks run unlocked, so they may queue further requests
+    for (const std::unique_ptr<Request>& request : m_dispatching) {
+        request->Complete();
+    }
+
+    const std::size_t count = m_dispatching.size();
+    m_dispatching.clear();
+    return count;
+}
+
+inline std::size_t BlockchainWorker::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size() + m_runningCount;
+}
+
+template<typename T>
+T* BlockchainWorker::FindJoinable(RequestKey key) {
+    auto it = m_joinable.find(key);
+    if (it == m_joinable.end() || it->second->type != GetRequestType<T>() || !it->second->CanJoin()) {
+        return nullptr;
+    }
+    return static_cast<T*>(it->second);
+}
+
+inline void BlockchainWorker::Enqueue(std::unique_ptr<Request> request) {
+    // The newest waiting request of a key is the one later callers join
+    m_joinable[request->key] = request.get();
+    m_queue.push_back(std::move(request));
+    m_condition.notify_one();
+}
+
+inline void BlockchainWorker::Run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_condition.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+        if (m_queue.empty()) {
+            return;
+        }
+
+        std::unique_ptr<Request> request = std::move(m_queue.front());
+        m_queue.pop_front();
+
+        // Once running, a request takes no more callers; later ones get fresh results
+        auto it = m_joinable.find(request->key);
+        if (it != m_joinable.end() && it->second == request.get()) {
+            m_joinable.erase(it);
+        }
+
+        ++m_runningCount;
+        lock.unlock();
+        request->Execute();
+        lock.lock();
+        --m_runningCount;
+
+        m_completed.push_back(std::move(request));
+    }
+}
+
+} // namespace CHULUBME
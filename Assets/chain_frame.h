@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace CHULUBME {
+
+/**
+ * @brief Play score activity of one player, reported by a game node
+ */
+struct PlayScoreUpdate {
+    std::string address;
+    double activity;
+};
+
+/**
+ * @brief Encoder for the chain network's binary frames (see framing.go)
+ *
+ * Every frame is a little-endian u32 length followed by a kind byte and its
+ * body. A message frame carries a type, sender and time with JSON content,
+ * which is only needed for the handshake and uncommon messages; a play score
+ * frame carries a whole batch of updates with no JSON at all, so a game
+ * server can report a match's activity in one compact write.
+ */
+class ChainFrame {
+public:
+    // Frame kinds
+    static constexpr std::uint8_t MESSAGE = 1;
+    static constexpr std::uint8_t PLAY_SCORES = 2;
+
+    // Largest frame a node accepts, length prefix excluded
+    static constexpr std::size_t MAX_FRAME_SIZE = 1 << 20;
+
+    // Append a message frame with already-encoded JSON content; false if a field or the frame is too large
+    static bool EncodeMessage(const std::string& type, const std::string& sender, std::int64_t time,
+                              const std::string& contentJson, std::vector<unsigned char>& output);
+
+    // Append a play score frame for a batch of updates; false if a field or the frame is too large
+    static bool EncodePlayScores(const std::string& sender, std::int64_t time,
+                                 const std::vector<PlayScoreUpdate>& updates, std::vector<unsigned char>& output);
+
+private:
+    // Check if a string fits a u16 length prefix
+    static bool FitsField(const std::string& value) {
+        return value.size() <= std::numeric_limits<std::uint16_t>::max();
+    }
+
+    // Append a little-endian value of the given width
+    static void WriteUInt(std::vector<unsigned char>& output, std::uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            output.push_back(static_cast<unsigned char>(value >> (i * 8)));
+        }
+    }
+
+    // Append a u16 length-prefixed string
+    static void WriteString(std::vector<unsigned char>& output, const std::string& value) {
+        WriteUInt(output, value.size(), 2);
+        output.insert(output.end(), value.begin(), value.end());
+    }
+};
+
+// Implementation
+
+inline bool ChainFrame::EncodeMessage(const std::string& type, const std::string& sender, std::int64_t time,
+                                      const std::string& contentJson, std::vector<unsigned char>& output) {
+    const std::size_t size = 1 + 2 + type.size() + 2 + sender.size() + 8 + contentJson.size();
+    if (!FitsField(type) || !FitsField(sender) || size > MAX_FRAME_SIZE) {
+        return false;
+    }
+
+    output.reserve(output.size() + 4 + size);
+    WriteUInt(output, size, 4);
+    output.push_back(MESSAGE);
+    WriteString(output, type);
+    WriteString(output, sender);
+    WriteUInt(output, static_cast<std::uint64_t>(time), 8);
+    output.insert(output.end(), contentJson.begin(), contentJson.end());
+    return true;
+}
+
+inline bool ChainFrame::EncodePlayScores(const std::string& sender, std::int64_t time,
+                                         const std::vector<PlayScoreUpdate>& updates, std::vector<unsigned char>& output) {
+    if (!FitsField(sender) || updates.size() > std::numeric_limits<std::uint16_t>::max()) {
+        return false;
+    }
+
+    std::size_t size = 1 + 2 + sender.size() + 8 + 2;
+    for (const PlayScoreUpdate& update : updates) {
+        if (!FitsField(update.address)) {
+            return false;
+        }
+        size += 2 + update.address.size() + 8;
+    }
+    if (size > MAX_FRAME_SIZE) {
+        return false;
+    }
+
+    output.reserve(output.size() + 4 + size);
+    WriteUInt(output, size, 4);
+    output.push_back(PLAY_SCORES);
+    WriteString(output, sender);
+    WriteUInt(output, static_cast<std::uint64_t>(time), 8);
+    WriteUInt(output, updates.size(), 2);
+    for (const PlayScoreUpdate& update : updates) {
+        WriteString(output, update.address);
+
+        // IEEE-754 bits, as Go's math.Float64bits
+        std::uint64_t bits = 0;
+        static_assert(sizeof(bits) == sizeof(update.activity), "double must be 64-bit");
+        std::memcpy(&bits, &update.activity, sizeof(bits));
+        WriteUInt(output, bits, 8);
+    }
+    return true;
+}
+
+} // namespace CHULUBME
@@ -0,0 +1,33 @@
+#include <iostream>
+#include <string>
+
+#include "gameplay/hero_data.h"
+
+using namespace CHULUBME;
+
+// Compile JSON hero data into the binary format loaded by HeroSystem
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: compile_hero_data <heroes.json> <heroes.herodata>" << std::endl;
+        return 1;
+    }
+
+    const std::string jsonFilename = argv[1];
+    const std::string outputFilename = argv[2];
+
+    if (!HeroDataCompiler::CompileFile(jsonFilename, outputFilename)) {
+        std::cerr << "Failed to compile " << jsonFilename << std::endl;
+        return 1;
+    }
+
+    // Read the output back to check it loads
+    HeroDataFile heroData;
+    if (!heroData.Open(outputFilename)) {
+        std::cerr << "Compiled file " << outputFilename << " failed validation" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Compiled " << heroData.GetHeroCount() << " heroes and "
+              << heroData.GetAbilityCount() << " abilities to " << outputFilename << std::endl;
+    return 0;
+}
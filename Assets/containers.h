@@ -0,0 +1,717 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "memory.h"
+
+namespace CHULUBME {
+
+/**
+ * @brief STL allocator drawing from a ScratchArena
+ *
+ * Default-constructed allocators use the calling thread's frame arena, so
+ * containers built with them live until the next frame begins. Pass a scratch
+ * arena (e.g. ScopedScratch::GetArena()) for shorter-lived containers.
+ * Deallocation is a no-op; memory is reclaimed when the arena is rewound.
+ */
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    // Allocate from the calling thread's frame arena
+    ArenaAllocator() : m_arena(&MemoryManager::GetThreadFrameArena()) {}
+
+    // Allocate from the given arena
+    explicit ArenaAllocator(ScratchArena& arena) : m_arena(&arena) {}
+
+    // Copy constructor
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.m_arena) {}
+
+    // Allocate memory
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(m_arena->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    // Deallocate memory (does nothing; the arena is rewound as a whole)
+    void deallocate(T*, std::size_t) {}
+
+    // Get the arena this allocator draws from
+    ScratchArena* GetArena() const { return m_arena; }
+
+    // Equality comparison
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return m_arena == other.m_arena; }
+
+    // Inequality comparison
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return m_arena != other.m_arena; }
+
+private:
+    ScratchArena* m_arena;
+
+    // Friend declaration for copy constructor
+    template<typename U>
+    friend class ArenaAllocator;
+};
+
+// Vector whose storage lives in an arena (the calling thread's frame arena by default)
+template<typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+/**
+ * @brief Vector storing up to N elements inline before spilling to the heap
+ */
+template<typename T, std::size_t N>
+class SmallVector {
+    static_assert(N > 0, "SmallVector needs inline capacity");
+    static_assert(alignof(T) <= alignof(std::max_align_t), "SmallVector does not support over-aligned types");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() : m_data(InlineData()), m_size(0), m_capacity(N) {}
+    SmallVector(const SmallVector& other);
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value);
+    ~SmallVector();
+
+    SmallVector& operator=(const SmallVector& other);
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+    // Append an element
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    // Construct an element at the end
+    template<typename... Args>
+    T& emplace_back(Args&&... args);
+
+    // Remove the last element
+    void pop_back();
+
+    // Remove an element, keeping the order of the remaining ones
+    iterator erase(const_iterator position);
+
+    // Remove all elements (heap storage is kept)
+    void clear();
+
+    // Make room for at least capacity elements
+    void reserve(size_type capacity);
+
+    // Element access
+    T& operator[](size_type index) { return m_data[index]; }
+    const T& operator[](size_type index) const { return m_data[index]; }
+    T& front() { return m_data[0]; }
+    const T& front() const { return m_data[0]; }
+    T& back() { return m_data[m_size - 1]; }
+    const T& back() const { return m_data[m_size - 1]; }
+    T* data() { return m_data; }
+    const T* data() const { return m_data; }
+
+    // Iteration
+    iterator begin() { return m_data; }
+    iterator end() { return m_data + m_size; }
+    const_iterator begin() const { return m_data; }
+    const_iterator end() const { return m_data + m_size; }
+
+    // Size queries
+    size_type size() const { return m_size; }
+    size_type capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+
+    // Check if the elements are stored inline
+    bool IsInline() const { return m_data == InlineData(); }
+
+private:
+    T* InlineData() { return reinterpret_cast<T*>(m_inline); }
+    const T* InlineData() const { return reinterpret_cast<const T*>(m_inline); }
+
+    // Move the elements into new heap storage of the given capacity
+    void Reallocate(size_type capacity);
+
+    // Destroy the elements and release heap storage
+    void Release();
+
+    alignas(T) unsigned char m_inline[sizeof(T) * N];
+    T* m_data;
+    size_type m_size;
+    size_type m_capacity;
+};
+
+/**
+ * @brief Open-addressing hash map with linear probing
+ *
+ * Entries are stored in one contiguous array and erased with backward-shift
+ * deletion, so lookups never walk tombstones. Iterators and references are
+ * invalidated by any insertion or erase. Keys must not be modified through
+ * iterators.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap {
+public:
+    using value_type = std::pair<Key, Value>;
+    using size_type = std::size_t;
+
+    // Forward iterator over occupied entries
+    template<bool IsConst>
+    class IteratorBase {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<Key, Value>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = typename std::conditional<IsConst, const value_type*, value_type*>::type;
+        using reference = typename std::conditional<IsConst, const value_type&, value_type&>::type;
+        using MapPointer = typename std::conditional<IsConst, const FlatHashMap*, FlatHashMap*>::type;
+
+        IteratorBase(MapPointer map, size_type index) : m_map(map), m_index(index) { SkipEmpty(); }
+
+        // Allow iterator to const_iterator conversion
+        template<bool OtherConst, typename = typename std::enable_if<IsConst && !OtherConst>::type>
+        IteratorBase(const IteratorBase<OtherConst>& other) : m_map(other.m_map), m_index(other.m_index) {}
+
+        reference operator*() const { return m_map->m_slots[m_index]; }
+        pointer operator->() const { return &m_map->m_slots[m_index]; }
+        IteratorBase& operator++() { ++m_index; SkipEmpty(); return *this; }
+        bool operator==(const IteratorBase& other) const { return m_index == other.m_index; }
+        bool operator!=(const IteratorBase& other) const { return m_index != other.m_index; }
+
+    private:
+        void SkipEmpty() {
+            while (m_index < m_map->m_capacity && !m_map->m_occupied[m_index]) {
+                ++m_index;
+            }
+        }
+
+        MapPointer m_map;
+        size_type m_index;
+
+        friend class FlatHashMap;
+        template<bool>
+        friend class IteratorBase;
+    };
+
+    using iterator = IteratorBase<false>;
+    using const_iterator = IteratorBase<true>;
+
+    FlatHashMap() : m_slots(nullptr), m_capacity(0), m_size(0) {}
+    FlatHashMap(const FlatHashMap& other);
+    FlatHashMap(FlatHashMap&& other) noexcept;
+    ~FlatHashMap();
+
+    FlatHashMap& operator=(const FlatHashMap& other);
+    FlatHashMap& operator=(FlatHashMap&& other) noexcept;
+
+    // Insert a value constructed from args unless the key exists; returns the entry and whether it was inserted
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(const Key& key, Args&&... args);
+
+    // Insert a key/value pair unless the key exists
+    std::pair<iterator, bool> insert(const value_type& value) { return emplace(value.first, value.second); }
+
+    // Get the value for a key, default-constructing it if missing
+    Value& operator[](const Key& key) { return emplace(key).first->second; }
+
+    // Find an entry
+    iterator find(const Key& key);
+    const_iterator find(const Key& key) const;
+
+    // Count entries with the key (0 or 1)
+    size_type count(const Key& key) const { return FindIndex(key) != m_capacity ? 1 : 0; }
+
+    // Erase the entry for a key; returns the number of erased entries
+    size_type erase(const Key& key);
+
+    // Remove all entries (storage is kept)
+    void clear();
+
+    // Make room for at least count entries without rehashing
+    void reserve(size_type count);
+
+    // Iteration
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, m_capacity); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_capacity); }
+
+    // Size queries
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+private:
+    // Index of an entry's preferred slot
+    size_type IdealIndex(const Key& key) const;
+
+    // Find the slot holding a key (m_capacity if absent)
+    size_type FindIndex(const Key& key) const;
+
+    // Move every entry into storage with the given capacity (a power of two)
+    void Rehash(size_type capacity);
+
+    // Destroy all entries and release storage
+    void Release();
+
+    value_type* m_slots;
+    std::vector<std::uint8_t> m_occupied;
+    size_type m_capacity;
+    size_type m_size;
+};
+
+/**
+ * @brief Bounded lock-free queue between one producer and one consumer thread
+ *
+ * Push and Pop never block or allocate; pushing to a full queue fails. The
+ * producer and consumer indices sit on separate cache lines, and each side
+ * keeps a copy of the other's index so it only reads the shared one when the
+ * copy says the queue is full or empty. Capacity must be a power of two.
+ */
+template<typename T, std::size_t Capacity>
+class SPSCRingBuffer {
+public:
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SPSCRingBuffer capacity must be a power of two");
+
+    SPSCRingBuffer() : m_head(0), m_cachedTail(0), m_tail(0), m_cachedHead(0) {}
+
+    // Deleted copy constructor and assignment operator
+    SPSCRingBuffer(const SPSCRingBuffer&) = delete;
+    SPSCRingBuffer& operator=(const SPSCRingBuffer&) = delete;
+
+    // Append a value (producer thread only); returns false if the queue is full
+    bool Push(const T& value);
+
+    // Remove the oldest value (consumer thread only); returns false if the queue is empty
+    bool Pop(T& value);
+
+    // Number of queued values (exact on the consumer thread, a lower bound elsewhere)
+    std::size_t Size() const { return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_relaxed); }
+
+    // Maximum number of queued values
+    static constexpr std::size_t GetCapacity() { return Capacity; }
+
+private:
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    // Consumer side: next value to pop, and the last tail it read
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_head;
+    std::size_t m_cachedTail;
+
+    // Producer side: next slot to fill, and the last head it read
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_tail;
+    std::size_t m_cachedHead;
+
+    alignas(CACHE_LINE_SIZE) T m_slots[Capacity];
+};
+
+// Implementation of SmallVector methods
+
+template<typename T, std::size_t N>
+SmallVector<T, N>::SmallVector(const SmallVector& other)
+    : SmallVector() {
+    reserve(other.m_size);
+    for (const T& value : other) {
+        new (m_data + m_size) T(value);
+        ++m_size;
+    }
+}
+
+template<typename T, std::size_t N>
+SmallVector<T, N>::SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+    : SmallVector() {
+    *this = std::move(other);
+}
+
+template<typename T, std::size_t N>
+SmallVector<T, N>::~SmallVector() {
+    Release();
+}
+
+template<typename T, std::size_t N>
+SmallVector<T, N>& SmallVector<T, N>::operator=(const SmallVector& other) {
+    if (this != &other) {
+        clear();
+        reserve(other.m_size);
+        for (const T& value : other) {
+            new (m_data + m_size) T(value);
+            ++m_size;
+        }
+    }
+    return *this;
+}
+
+template<typename T, std::size_t N>
+SmallVector<T, N>& SmallVector<T, N>::operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+    if (this == &other) {
+        return *this;
+    }
+
+    Release();
+
+    if (other.IsInline()) {
+        // Inline elements have to be moved one by one
+        for (T& value : other) {
+            new (m_data + m_size) T(std::move(value));
+            ++m_size;
+        }
+        other.clear();
+    } else {
+        // Heap storage changes hands
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        other.m_data = other.InlineData();
+        other.m_size = 0;
+        other.m_capacity = N;
+    }
+
+    return *this;
+}
+
+template<typename T, std::size_t N>
+template<typename... Args>
+T& SmallVector<T, N>::emplace_back(Args&&... args) {
+    if (m_size == m_capacity) {
+        // Construct the new element first; the arguments may refer to existing elements
+        const size_type capacity = m_capacity * 2;
+        T* data = static_cast<T*>(::operator new(sizeof(T) * capacity));
+        new (data + m_size) T(std::forward<Args>(args)...);
+
+        for (size_type i = 0; i < m_size; ++i) {
+            new (data + i) T(std::move(m_data[i]));
+            m_data[i].~T();
+        }
+
+        if (!IsInline()) {
+            ::operator delete(m_data);
+        }
+
+        m_data = data;
+        m_capacity = capacity;
+    } else {
+        new (m_data + m_size) T(std::forward<Args>(args)...);
+    }
+
+    return m_data[m_size++];
+}
+
+template<typename T, std::size_t N>
+void SmallVector<T, N>::pop_back() {
+    m_data[--m_size].~T();
+}
+
+template<typename T, std::size_t N>
+typename SmallVector<T, N>::iterator SmallVector<T, N>::erase(const_iterator position) {
+    const size_type index = static_cast<size_type>(position - m_data);
+    for (size_type i = index + 1; i < m_size; ++i) {
+        m_data[i - 1] = std::move(m_data[i]);
+    }
+    pop_back();
+    return m_data + index;
+}
+
+template<typename T, std::size_t N>
+void SmallVector<T, N>::clear() {
+    for (size_type i = 0; i < m_size; ++i) {
+        m_data[i].~T();
+    }
+    m_size = 0;
+}
+
+template<typename T, std::size_t N>
+void SmallVector<T, N>::reserve(size_type capacity) {
+    if (capacity > m_capacity) {
+        Reallocate(capacity);
+    }
+}
+
+template<typename T, std::size_t N>
+void SmallVector<T, N>::Reallocate(size_type capacity) {
+    T* data = static_cast<T*>(::operator new(sizeof(T) * capacity));
+
+    for (size_type i = 0; i < m_size; ++i) {
+        new (data + i) T(std::move(m_data[i]));
+        m_data[i].~T();
+    }
+
+    if (!IsInline()) {
+        ::operator delete(m_data);
+    }
+
+    m_data = data;
+    m_capacity = capacity;
+}
+
+template<typename T, std::size_t N>
+void SmallVector<T, N>::Release() {
+    clear();
+
+    if (!IsInline()) {
+        ::operator delete(m_data);
+        m_data = InlineData();
+        m_capacity = N;
+    }
+}
+
+// Implementation of FlatHashMap methods
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+FlatHashMap<Key, Value, Hash, KeyEqual>::FlatHashMap(const FlatHashMap& other)
+    : FlatHashMap() {
+    reserve(other.m_size);
+    for (const value_type& entry : other) {
+        emplace(entry.first, entry.second);
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+FlatHashMap<Key, Value, Hash, KeyEqual>::FlatHashMap(FlatHashMap&& other) noexcept
+    : m_slots(other.m_slots)
+    , m_occupied(std::move(other.m_occupied))
+    , m_capacity(other.m_capacity)
+    , m_size(other.m_size) {
+    other.m_slots = nullptr;
+    other.m_occupied.clear();
+    other.m_capacity = 0;
+    other.m_size = 0;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+FlatHashMap<Key, Value, Hash, KeyEqual>::~FlatHashMap() {
+    Release();
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+FlatHashMap<Key, Value, Hash, KeyEqual>& FlatHashMap<Key, Value, Hash, KeyEqual>::operator=(const FlatHashMap& other) {
+    if (this != &other) {
+        clear();
+        reserve(other.m_size);
+        for (const value_type& entry : other) {
+            emplace(entry.first, entry.second);
+        }
+    }
+    return *this;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+FlatHashMap<Key, Value, Hash, KeyEqual>& FlatHashMap<Key, Value, Hash, KeyEqual>::operator=(FlatHashMap&& other) noexcept {
+    if (this != &other) {
+        Release();
+
+        m_slots = other.m_slots;
+        m_occupied = std::move(other.m_occupied);
+        m_capacity = other.m_capacity;
+        m_size = other.m_size;
+
+        other.m_slots = nullptr;
+        other.m_occupied.clear();
+        other.m_capacity = 0;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+template<typename... Args>
+std::pair<typename FlatHashMap<Key, Value, Hash, KeyEqual>::iterator, bool>
+FlatHashMap<Key, Value, Hash, KeyEqual>::emplace(const Key& key, Args&&... args) {
+    const size_type existing = FindIndex(key);
+    if (existing != m_capacity) {
+        return { iterator(this, existing), false };
+    }
+
+    // Keep the load factor at or below 7/8
+    if ((m_size + 1) * 8 > m_capacity * 7) {
+        Rehash(m_capacity ? m_capacity * 2 : 16);
+    }
+
+    const size_type mask = m_capacity - 1;
+    size_type index = IdealIndex(key);
+    while (m_occupied[index]) {
+        index = (index + 1) & mask;
+    }
+
+    new (m_slots + index) value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                                     std::forward_as_tuple(std::forward<Args>(args)...));
+    m_occupied[index] = 1;
+    ++m_size;
+
+    return { iterator(this, index), true };
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+typename FlatHashMap<Key, Value, Hash, KeyEqual>::iterator FlatHashMap<Key, Value, Hash, KeyEqual>::find(const Key& key) {
+    return iterator(this, FindIndex(key));
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+typename FlatHashMap<Key, Value, Hash, KeyEqual>::const_iterator FlatHashMap<Key, Value, Hash, KeyEqual>::find(const Key& key) const {
+    return const_iterator(this, FindIndex(key));
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+typename FlatHashMap<Key, Value, Hash, KeyEqual>::size_type FlatHashMap<Key, Value, Hash, KeyEqual>::erase(const Key& key) {
+    size_type hole = FindIndex(key);
+    if (hole == m_capacity) {
+        return 0;
+    }
+
+    m_slots[hole].~value_type();
+    m_occupied[hole] = 0;
+    --m_size;
+
+    // Shift following entries back into the hole unless that would move them before their ideal slot
+    const size_type mask = m_capacity - 1;
+    size_type index = (hole + 1) & mask;
+    while (m_occupied[index]) {
+        const size_type ideal = IdealIndex(m_slots[index].first);
+        if (((index - ideal) & mask) >= ((index - hole) & mask)) {
+            new (m_slots + hole) value_type(std::move(m_slots[index]));
+            m_slots[index].~value_type();
+            m_occupied[hole] = 1;
+            m_occupied[index] = 0;
+            hole = index;
+        }
+        index = (index + 1) & mask;
+    }
+
+    return 1;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+void FlatHashMap<Key, Value, Hash, KeyEqual>::clear() {
+    for (size_type i = 0; i < m_capacity; ++i) {
+        if (m_occupied[i]) {
+            m_slots[i].~value_type();
+            m_occupied[i] = 0;
+        }
+    }
+    m_size = 0;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+void FlatHashMap<Key, Value, Hash, KeyEqual>::reserve(size_type count) {
+    size_type capacity = m_capacity ? m_capacity : 16;
+    while (count * 8 > capacity * 7) {
+        capacity *= 2;
+    }
+
+    if (capacity > m_capacity) {
+        Rehash(capacity);
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+typename FlatHashMap<Key, Value, Hash, KeyEqual>::size_type FlatHashMap<Key, Value, Hash, KeyEqual>::IdealIndex(const Key& key) const {
+    // Mix the hash so identity hashes of sequential keys still spread across slots
+    std::uint64_t hash = static_cast<std::uint64_t>(Hash()(key));
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return static_cast<size_type>(hash) & (m_capacity - 1);
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+typename FlatHashMap<Key, Value, Hash, KeyEqual>::size_type FlatHashMap<Key, Value, Hash, KeyEqual>::FindIndex(const Key& key) const {
+    if (m_size == 0) {
+        return m_capacity;
+    }
+
+    const size_type mask = m_capacity - 1;
+    for (size_type index = IdealIndex(key); m_occupied[index]; index = (index + 1) & mask) {
+        if (KeyEqual()(m_slots[index].first, key)) {
+            return index;
+        }
+    }
+
+    return m_capacity;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+void FlatHashMap<Key, Value, Hash, KeyEqual>::Rehash(size_type capacity) {
+    value_type* oldSlots = m_slots;
+    std::vector<std::uint8_t> oldOccupied = std::move(m_occupied);
+    const size_type oldCapacity = m_capacity;
+
+    m_slots = std::allocator<value_type>().allocate(capacity);
+    m_occupied.assign(capacity, 0);
+    m_capacity = capacity;
+
+    const size_type mask = capacity - 1;
+    for (size_type i = 0; i < oldCapacity; ++i) {
+        if (oldOccupied[i]) {
+            size_type index = IdealIndex(oldSlots[i].first);
+            while (m_occupied[index]) {
+                index = (index + 1) & mask;
+            }
+
+            new (m_slots + index) value_type(std::move(oldSlots[i]));
+            m_occupied[index] = 1;
+            oldSlots[i].~value_type();
+        }
+    }
+
+    if (oldSlots) {
+        std::allocator<value_type>().deallocate(oldSlots, oldCapacity);
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+void FlatHashMap<Key, Value, Hash, KeyEqual>::Release() {
+    if (m_slots) {
+        clear();
+        std::allocator<value_type>().deallocate(m_slots, m_capacity);
+    }
+
+    m_slots = nullptr;
+    m_occupied.clear();
+    m_capacity = 0;
+}
+
+// Implementation of SPSCRingBuffer methods
+
+template<typename T, std::size_t Capacity>
+bool SPSCRingBuffer<T, Capacity>::Push(const T& value) {
+    const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_cachedHead == Capacity) {
+        m_cachedHead = m_head.load(std::memory_order_acquire);
+        if (tail - m_cachedHead == Capacity) {
+            return false;
+        }
+    }
+
+    m_slots[tail & MASK] = value;
+
+    // Publish the slot to the consumer
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T, std::size_t Capacity>
+bool SPSCRingBuffer<T, Capacity>::Pop(T& value) {
+    const std::size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_cachedTail) {
+        m_cachedTail = m_tail.load(std::memory_order_acquire);
+        if (head == m_cachedTail) {
+            return false;
+        }
+    }
+
+    value = m_slots[head & MASK];
+
+    // Hand the slot back to the producer
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace CHULUBME
@@ -0,0 +1,227 @@
+#include "culling.h"
+#include "renderer.h"
+#include "../physics/spatial_grid.h"
+#include "../gameplay/vision_system.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace CHULUBME {
+
+// Mesh bounds implementation
+BoundingSphere Mesh::ComputeBounds(const std::vector<float>& vertices, std::size_t stride, std::size_t positionOffset) {
+    BoundingSphere bounds;
+    if (stride < positionOffset + 3 || vertices.size() < stride) {
+        return bounds;
+    }
+
+    const std::size_t vertexCount = vertices.size() / stride;
+    const float* first = vertices.data() + positionOffset;
+
+    glm::vec3 minimum(first[0], first[1], first[2]);
+    glm::vec3 maximum = minimum;
+    for (std::size_t vertex = 1; vertex < vertexCount; ++vertex) {
+        const float* position = first + vertex * stride;
+        minimum = glm::vec3(std::min(minimum.x, position[0]), std::min(minimum.y, position[1]), std::min(minimum.z, position[2]));
+        maximum = glm::vec3(std::max(maximum.x, position[0]), std::max(maximum.y, position[1]), std::max(maximum.z, position[2]));
+    }
+
+    // Center the sphere on the box and grow it to the farthest vertex
+    bounds.center = (minimum + maximum) * 0.5f;
+    float radiusSquared = 0.0f;
+    for (std::size_t vertex = 0; vertex < vertexCount; ++vertex) {
+        const float* position = first + vertex * stride;
+        const glm::vec3 offset = glm::vec3(position[0], position[1], position[2]) - bounds.center;
+        radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+    }
+    bounds.radius = std::sqrt(radiusSquared);
+
+    return bounds;
+}
+
+// Frustum implementation
+Frustum Frustum::FromMatrix(const glm::mat4& viewProjection) {
+    // Rows of the matrix (glm stores columns)
+    glm::vec4 rows[4];
+    for (int row = 0; row < 4; ++row) {
+        rows[row] = glm::vec4(viewProjection[0][row], viewProjection[1][row], viewProjection[2][row], viewProjection[3][row]);
+    }
+
+    // Left, right, bottom, top, near, far
+    Frustum frustum;
+    frustum.planes[0] = rows[3] + rows[0];
+    frustum.planes[1] = rows[3] - rows[0];
+    frustum.planes[2] = rows[3] + rows[1];
+    frustum.planes[3] = rows[3] - rows[1];
+    frustum.planes[4] = rows[3] + rows[2];
+    frustum.planes[5] = rows[3] - rows[2];
+
+    for (glm::vec4& plane : frustum.planes) {
+        const float length = glm::length(glm::vec3(plane.x, plane.y, plane.z));
+        if (length > 0.0f) {
+            plane = plane * (1.0f / length);
+        }
+    }
+
+    return frustum;
+}
+
+bool Frustum::IntersectsSphere(const glm::vec3& center, float radius) const {
+    for (const glm::vec4& plane : planes) {
+        if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// CullingSystem implementation
+CullingSystem::CullingSystem(EntityManager* manager)
+    : System(manager)
+    , m_maxBoundsReach(0.0f)
+    , m_candidateCount(0)
+    , m_visibleCount(0)
+{
+    RequireComponent<Transform>(ComponentAccess::Read);
+    RequireComponent<MeshRenderer>(ComponentAccess::Read);
+}
+
+void CullingSystem::OnEntityAdded(Entity entity) {
+    Transform* transform = entity.GetComponent<Transform>();
+    MeshRenderer* meshRenderer = entity.GetComponent<MeshRenderer>();
+    if (!transform || !meshRenderer || !meshRenderer->m_mesh) {
+        return;
+    }
+
+    glm::vec3 center;
+    float radius;
+    GetWorldBounds(*transform, *meshRenderer->m_mesh, center, radius);
+    m_maxBoundsReach = std::max(m_maxBoundsReach, glm::length(center - transform->GetWorldPosition()) + radius);
+}
+
+void CullingSystem::Cull(const Camera* camera, FrameVector<EntityID>& visible) {
+    m_candidateCount = 0;
+    m_visibleCount = 0;
+
+    ScopedScratch scratch;
+    FrameVector<EntityID> candidates{ ArenaAllocator<EntityID>(scratch.GetArena()) };
+
+    Frustum frustum;
+    const SpatialSystem* spatial = m_manager->GetSystem<SpatialSystem>();
+    if (camera) {
+        const glm::mat4 viewProjection = camera->GetProjectionMatrix() * camera->GetViewMatrix();
+        frustum = Frustum::FromMatrix(viewProjection);
+
+        if (spatial) {
+            // XZ footprint of the eight corners of the view volume
+            const glm::mat4 inverseViewProjection = glm::inverse(viewProjection);
+            float minX = std::numeric_limits<float>::max();
+            float minZ = std::numeric_limits<float>::max();
+            float maxX = -std::numeric_limits<float>::max();
+            float maxZ = -std::numeric_limits<float>::max();
+            for (int corner = 0; corner < 8; ++corner) {
+                const glm::vec4 clip((corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f, (corner & 4) ? 1.0f : -1.0f, 1.0f);
+                const glm::vec4 world = inverseViewProjection * clip;
+                const float x = world.x / world.w;
+                const float z = world.z / world.w;
+
+                minX = std::min(minX, x);
+                minZ = std::min(minZ, z);
+                maxX = std::max(maxX, x);
+                maxZ = std::max(maxZ, z);
+            }
+
+            const float margin = m_maxBoundsReach;
+            spatial->GetGrid().QueryRect(glm::vec3(minX - margin, 0.0f, minZ - margin),
+                                         glm::vec3(maxX + margin, 0.0f, maxZ + margin), candidates);
+        }
+    }
+
+    if (!camera || !spatial) {
+        m_manager->View<Transform, MeshRenderer>().ForEach([&](EntityID entity, Transform&, MeshRenderer&) {
+            candidates.push_back(entity);
+        });
+    }
+
+    const std::size_t count = candidates.size();
+    m_candidateCount = count;
+    if (count == 0) {
+        return;
+    }
+
+    std::uint8_t* visibleFlags = scratch.AllocateArray<std::uint8_t>(count);
+    const std::size_t batchCount = (count + CULL_BATCH_SIZE - 1) / CULL_BATCH_SIZE;
+    float* batchReach = scratch.AllocateArray<float>(batchCount);
+    std::fill(batchReach, batchReach + batchCount, 0.0f);
+
+    const VisionSystem* vision = m_manager->GetSystem<VisionSystem>();
+    const bool testFrustum = camera != nullptr;
+
+    // Each batch only touches its own candidates, flags and reach entry
+    auto cullBatch = [&](std::size_t begin, std::size_t end) {
+        float reach = 0.0f;
+
+        for (std::size_t i = begin; i < end; ++i) {
+            visibleFlags[i] = 0;
+
+            const EntityID entity = candidates[i];
+            Transform* transform = m_manager->GetComponent<Transform>(entity);
+            MeshRenderer* meshRenderer = m_manager->GetComponent<MeshRenderer>(entity);
+            if (!transform || !meshRenderer || !meshRenderer->m_mesh || !meshRenderer->m_material) {
+                continue;
+            }
+
+            if (vision && !vision->IsRevealed(entity)) {
+                continue;
+            }
+
+            glm::vec3 center;
+            float radius;
+            GetWorldBounds(*transform, *meshRenderer->m_mesh, center, radius);
+            reach = std::max(reach, glm::length(center - transform->GetWorldPosition()) + radius);
+
+            if (testFrustum && !frustum.IntersectsSphere(center, radius)) {
+                continue;
+            }
+
+            visibleFlags[i] = 1;
+        }
+
+        batchReach[begin / CULL_BATCH_SIZE] = std::max(batchReach[begin / CULL_BATCH_SIZE], reach);
+    };
+
+    JobSystem* jobSystem = m_manager->GetJobSystem();
+    if (jobSystem) {
+        jobSystem->ParallelFor(count, CULL_BATCH_SIZE, cullBatch);
+    } else {
+        cullBatch(0, count);
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (visibleFlags[i]) {
+            visible.push_back(candidates[i]);
+        }
+    }
+    m_visibleCount = visible.size();
+
+    for (std::size_t batch = 0; batch < batchCount; ++batch) {
+        m_maxBoundsReach = std::max(m_maxBoundsReach, batchReach[batch]);
+    }
+}
+
+void CullingSystem::GetWorldBounds(Transform& transform, const Mesh& mesh, glm::vec3& center, float& radius) {
+    const glm::mat4 model = transform.GetModelMatrix();
+    const BoundingSphere& bounds = mesh.GetBounds();
+
+    const glm::vec4 worldCenter = model * glm::vec4(bounds.center, 1.0f);
+    center = glm::vec3(worldCenter.x, worldCenter.y, worldCenter.z);
+
+    // Scale the radius by the longest basis vector of the model matrix
+    const float scaleX = glm::length(glm::vec3(model[0].x, model[0].y, model[0].z));
+    const float scaleY = glm::length(glm::vec3(model[1].x, model[1].y, model[1].z));
+    const float scaleZ = glm::length(glm::vec3(model[2].x, model[2].y, model[2].z));
+    radius = bounds.radius * std::max(scaleX, std::max(scaleY, scaleZ));
+}
+
+} // namespace CHULUBME
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+#include "../core/ecs.h"
+#include "../core/containers.h"
+
+namespace CHULUBME {
+
+// Forward declarations
+class Camera;
+class Transform;
+class Mesh;
+
+/**
+ * @brief Six clip planes of a camera's view volume
+ *
+ * Planes are stored as (normal, distance) with normals pointing into the
+ * volume, so a point p is inside a plane when dot(normal, p) + distance >= 0.
+ */
+struct Frustum {
+    glm::vec4 planes[6];
+
+    // Extract the planes of a combined projection and view matrix
+    static Frustum FromMatrix(const glm::mat4& viewProjection);
+
+    // Check if a sphere is at least partly inside the volume
+    bool IntersectsSphere(const glm::vec3& center, float radius) const;
+};
+
+/**
+ * @brief System deciding which mesh renderers are drawn each frame
+ *
+ * Culling asks the SpatialSystem for the entities under the XZ footprint of
+ * the camera volume, then tests the world bounding sphere of each candidate
+ * against the frustum and, when a VisionSystem is registered, skips enemies
+ * hidden by the fog of war. Candidates are tested in parallel batches on the
+ * entity manager's job system. Without a SpatialSystem every mesh renderer is
+ * a candidate.
+ *
+ * The footprint is widened by the largest bounds reach (sphere offset from
+ * the entity position plus radius) seen so far; an entity whose bounds grew
+ * past it is found from the next frame on.
+ */
+class CullingSystem : public System {
+public:
+    CullingSystem(EntityManager* manager);
+    ~CullingSystem() = default;
+
+    // Called when an entity is added to this system
+    void OnEntityAdded(Entity entity) override;
+
+    // Append the visible mesh renderers to visible (frustum culling is skipped without a camera)
+    void Cull(const Camera* camera, FrameVector<EntityID>& visible);
+
+    // Get the number of candidates tested by the last cull
+    std::size_t GetCandidateCount() const { return m_candidateCount; }
+
+    // Get the number of entities found visible by the last cull
+    std::size_t GetVisibleCount() const { return m_visibleCount; }
+
+private:
+    // Number of candidates tested per job
+    static constexpr std::size_t CULL_BATCH_SIZE = 256;
+
+    // World bounding sphere of a mesh placed by a transform
+    static void GetWorldBounds(Transform& transform, const Mesh& mesh, glm::vec3& center, float& radius);
+
+    // Largest distance from an entity position to the far side of its bounds
+    float m_maxBoundsReach;
+
+    // Statistics of the last cull
+    std::size_t m_candidateCount;
+    std::size_t m_visibleCount;
+};
+
+} // namespace CHULUBME
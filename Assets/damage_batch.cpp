@@ -0,0 +1,78 @@
+#include "damage_batch.h"
+#include "hero_system.h"
+#include <algorithm>
+
+namespace CHULUBME {
+
+DamageBatch::DamageBatch(EntityManager* manager)
+    : m_manager(manager)
+{
+}
+
+void DamageBatch::Add(EntityID source, EntityID target, float amount, bool isMagical) {
+    if (amount > 0.0f && target != INVALID_ENTITY) {
+        m_events.push_back({ source, target, amount, isMagical });
+    }
+}
+
+float DamageBatch::Resolve() {
+    const std::size_t count = m_events.size();
+    if (count == 0 || !m_manager) {
+        m_events.clear();
+        return 0.0f;
+    }
+
+    // Group events by target, keeping the order of events on the same target
+    std::stable_sort(m_events.begin(), m_events.end(), [](const DamageEvent& a, const DamageEvent& b) {
+        return a.target < b.target;
+    });
+
+    ScopedScratch scratch;
+    HeroComponent** heroes = scratch.AllocateArray<HeroComponent*>(count);
+    float* multipliers = scratch.AllocateArray<float>(count);
+    float* amounts = scratch.AllocateArray<float>(count);
+
+    // Look up each target and its cached damage multipliers once
+    for (std::size_t begin = 0; begin < count;) {
+        const EntityID target = m_events[begin].target;
+        std::size_t end = begin + 1;
+        while (end < count && m_events[end].target == target) {
+            ++end;
+        }
+
+        HeroComponent* hero = m_manager->GetComponent<HeroComponent>(target);
+        float armorMultiplier = 0.0f;
+        float magicMultiplier = 0.0f;
+        if (hero) {
+            const CombatStats& stats = hero->GetCombatStats();
+            armorMultiplier = stats.armorMultiplier;
+            magicMultiplier = stats.magicMultiplier;
+        }
+
+        for (std::size_t i = begin; i < end; ++i) {
+            heroes[i] = hero;
+            multipliers[i] = m_events[i].isMagical ? magicMultiplier : armorMultiplier;
+            amounts[i] = m_events[i].amount;
+        }
+
+        begin = end;
+    }
+
+    // Mitigate the whole batch at once
+    for (std::size_t i = 0; i < count; ++i) {
+        amounts[i] *= multipliers[i];
+    }
+
+    // Apply damage; events on targets with no health left are dropped
+    float totalDamage = 0.0f;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (heroes[i] && heroes[i]->GetCurrentHealth() > 0.0f) {
+            totalDamage += heroes[i]->ApplyMitigatedDamage(amounts[i], m_events[i].isMagical, m_events[i].source);
+        }
+    }
+
+    m_events.clear();
+    return totalDamage;
+}
+
+} // namespace CHULUBME
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+
+#include "../core/ecs.h"
+#include "../core/containers.h"
+
+namespace CHULUBME {
+
+/**
+ * @brief Damage dealt by one source to one target, waiting to be resolved
+ */
+struct DamageEvent {
+    EntityID source;
+    EntityID target;
+    float amount;
+    bool isMagical;
+};
+
+/**
+ * @brief Batch of damage events resolved in a single pass
+ *
+ * Resolving groups the events by target so each hero component and its
+ * damage multipliers are looked up once, computes armor and magic resist
+ * mitigation for the whole batch in one flat loop, then applies the results.
+ * Events live in the frame arena, so a batch must be resolved within the
+ * frame it was filled.
+ */
+class DamageBatch {
+public:
+    explicit DamageBatch(EntityManager* manager);
+    ~DamageBatch() = default;
+
+    // Queue damage before mitigation
+    void Add(EntityID source, EntityID target, float amount, bool isMagical);
+
+    // Get the number of queued events
+    std::size_t GetCount() const { return m_events.size(); }
+
+    // Check if no events are queued
+    bool IsEmpty() const { return m_events.empty(); }
+
+    // Apply every queued event and clear the batch; returns the total damage dealt
+    float Resolve();
+
+    // Drop every queued event
+    void Clear() { m_events.clear(); }
+
+private:
+    // Entity manager owning the targets
+    EntityManager* m_manager;
+
+    // Queued events
+    FrameVector<DamageEvent> m_events;
+};
+
+} // namespace CHULUBME
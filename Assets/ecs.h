@@ -8,8 +8,28 @@
 #include <vector>
 #include <bitset>
 #include <array>
-#include <queue>
-#include <set>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <tuple>
+#include <iterator>
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <algorithm>
+#include <cstdlib>
+#include <typeinfo>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+#include "event_bus.h"
+#include "job_system.h"
+#include "memory.h"
+#include "profiler.h"
 
 namespace CHULUBME {
 
@@ -18,6 +38,7 @@ class Entity;
 class Component;
 class System;
 class EntityManager;
+class Archetype;
 
 // Type definitions
 using EntityID = std::uint32_t;
@@ -31,6 +52,38 @@ constexpr std::size_t MAX_ENTITIES = 10000;
 // Component mask to determine which components an entity has
 using ComponentMask = std::bitset<MAX_COMPONENTS>;
 
+// How a system accesses a component type
+enum class ComponentAccess {
+    Read,
+    Write
+};
+
+// Archetype storage definitions
+using ArchetypeID = std::uint32_t;
+constexpr EntityID INVALID_ENTITY = std::numeric_limits<EntityID>::max();
+constexpr ArchetypeID INVALID_ARCHETYPE = std::numeric_limits<ArchetypeID>::max();
+
+// Entity IDs pack a slot index (low bits) with the generation of that slot (high bits).
+// A slot's generation changes whenever it is freed, so handles to destroyed entities
+// never match the entity that reuses the slot.
+constexpr std::uint32_t ENTITY_INDEX_BITS = 20;
+constexpr std::uint32_t ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+constexpr std::uint32_t ENTITY_GENERATION_MASK = (1u << (32 - ENTITY_INDEX_BITS)) - 1;
+
+// Freed slots are only reused once this many are waiting, to delay generation wrap-around
+constexpr std::size_t MIN_FREE_ENTITY_SLOTS = 1024;
+
+// Entity ID helpers
+constexpr std::uint32_t GetEntityIndex(EntityID entity) { return entity & ENTITY_INDEX_MASK; }
+constexpr std::uint32_t GetEntityGeneration(EntityID entity) { return entity >> ENTITY_INDEX_BITS; }
+constexpr EntityID MakeEntityID(std::uint32_t index, std::uint32_t generation) {
+    return ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK);
+}
+
+// Target size and alignment of a single archetype chunk
+constexpr std::size_t ARCHETYPE_CHUNK_SIZE = 16 * 1024;
+constexpr std::size_t ARCHETYPE_CHUNK_ALIGNMENT = 64;
+
 /**
  * @brief Base class for all components
  */
@@ -61,6 +114,12 @@ public:
     // Get the entity's unique ID
     EntityID GetID() const { return m_id; }
     
+    // Get the manager that owns this entity
+    EntityManager* GetManager() const { return m_manager; }
+    
+    // Check if the handle refers to an entity that still exists
+    bool IsValid() const;
+    
     // Check if entity is active
     bool IsActive() const { return m_active; }
     
@@ -87,16 +146,225 @@ public:
     void Destroy();
 };
 
+/**
+ * @brief Range over the entity IDs stored in a list of archetypes
+ */
+class EntityRange {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = EntityID;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const EntityID*;
+        using reference = EntityID;
+        
+        Iterator(const EntityManager* manager, const std::vector<ArchetypeID>* archetypes, std::size_t archetypeIndex);
+        
+        EntityID operator*() const { return m_entities[m_row]; }
+        Iterator& operator++();
+        bool operator==(const Iterator& other) const;
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+        
+        // Position of the current entity inside archetype storage
+        const Archetype* GetArchetype() const { return m_archetype; }
+        std::size_t GetChunk() const { return m_chunk; }
+        std::uint32_t GetRow() const { return m_row; }
+        
+    private:
+        // Advance to the next non-empty chunk, starting at the current one
+        void SkipEmptyChunks();
+        
+        const EntityManager* m_manager;
+        const std::vector<ArchetypeID>* m_archetypes;
+        std::size_t m_archetypeIndex;
+        const Archetype* m_archetype;
+        std::size_t m_chunk;
+        std::uint32_t m_row;
+        std::uint32_t m_rowCount;
+        const EntityID* m_entities;
+    };
+    
+    EntityRange(const EntityManager* manager, const std::vector<ArchetypeID>& archetypes)
+        : m_manager(manager), m_archetypes(&archetypes) {}
+    
+    Iterator begin() const { return Iterator(m_manager, m_archetypes, 0); }
+    Iterator end() const { return Iterator(m_manager, m_archetypes, m_archetypes->size()); }
+    
+    // Get the number of entities in the range
+    std::size_t size() const;
+    
+    // Check if the range is empty
+    bool empty() const { return size() == 0; }
+    
+private:
+    const EntityManager* m_manager;
+    const std::vector<ArchetypeID>* m_archetypes;
+};
+
+/**
+ * @brief Records structural changes to be applied later at a sync point
+ *
+ * Commands are fixed-size records; component constructor arguments are stored
+ * in a linear arena owned by the buffer. Clearing a buffer keeps its memory,
+ * so recording does not allocate once the buffer has warmed up.
+ *
+ * Commands are tagged with a sort key; merged playback of several buffers
+ * applies commands ordered by key (and by recording order within a key), so
+ * the result does not depend on which thread recorded which commands.
+ * Destructions are collected during playback and applied last, batched per
+ * archetype.
+ */
+class EntityCommandBuffer {
+public:
+    // Handle to an entity created by this buffer, resolved during playback
+    struct DeferredEntity {
+        std::uint32_t index;
+    };
+    
+    EntityCommandBuffer() : m_createdCount(0), m_sortKey(0), m_blockIndex(0), m_blockOffset(0) {}
+    ~EntityCommandBuffer();
+    
+    // Buffers are movable but not copyable
+    EntityCommandBuffer(EntityCommandBuffer&& other) noexcept;
+    EntityCommandBuffer& operator=(EntityCommandBuffer&& other) noexcept;
+    EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+    EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+    
+    // Record the creation of an entity
+    DeferredEntity CreateEntity();
+    
+    // Record the destruction of an entity
+    void DestroyEntity(EntityID entity);
+    
+    // Record adding a component to an existing entity
+    template<typename T, typename... Args>
+    void AddComponent(EntityID entity, Args&&... args);
+    
+    // Record adding a component to an entity created by this buffer
+    template<typename T, typename... Args>
+    void AddComponent(DeferredEntity entity, Args&&... args);
+    
+    // Record removing a component from an entity
+    template<typename T>
+    void RemoveComponent(EntityID entity);
+    
+    // Set the sort key attached to subsequently recorded commands
+    void SetSortKey(std::uint32_t key) { m_sortKey = key; }
+    
+    // Get the sort key attached to subsequently recorded commands
+    std::uint32_t GetSortKey() const { return m_sortKey; }
+    
+    // Check if no commands are recorded
+    bool IsEmpty() const { return m_commands.empty(); }
+    
+    // Get the number of recorded commands
+    std::size_t GetCommandCount() const { return m_commands.size(); }
+    
+    // Discard all recorded commands, keeping the arena memory for reuse
+    void Clear();
+    
+    // Apply all recorded commands and clear the buffer
+    void Playback(EntityManager& manager);
+    
+    // Apply the commands of several buffers merged by sort key and clear them
+    static void Playback(EntityManager& manager, std::vector<EntityCommandBuffer>& buffers);
+    
+private:
+    enum class CommandType : std::uint8_t {
+        Create,
+        Destroy,
+        Add,
+        Remove
+    };
+    
+    // Applies a typed add/remove command to the resolved entity
+    using ApplyFunction = void (*)(EntityManager& manager, EntityID entity, void* payload);
+    
+    // Destroys the arguments stored for an add command
+    using DestroyFunction = void (*)(void* payload);
+    
+    struct Command {
+        CommandType type;
+        bool deferred;
+        std::uint32_t sortKey;
+        std::uint32_t entity;
+        ApplyFunction apply;
+        DestroyFunction destroy;
+        void* payload;
+    };
+    
+    struct ArenaBlock {
+        unsigned char* data;
+        std::size_t size;
+    };
+    
+    // Size of the arena blocks holding command arguments
+    static constexpr std::size_t ARENA_BLOCK_SIZE = 16 * 1024;
+    
+    // Record an add command with its arguments stored in the arena
+    template<typename T, typename... Args>
+    void RecordAdd(std::uint32_t entity, bool deferred, Args&&... args);
+    
+    // Reserve arena memory for command arguments
+    void* Allocate(std::size_t size, std::size_t alignment);
+    
+    // Apply a single non-destroy command; destroyed entities are appended to the batch
+    void Apply(Command& command, EntityManager& manager, std::vector<EntityID>& destroyed);
+    
+    // Destroy stored arguments and release arena blocks
+    void Release();
+    
+    // Recorded commands
+    std::vector<Command> m_commands;
+    
+    // Entities created during playback, indexed by DeferredEntity::index
+    std::vector<EntityID> m_createdEntities;
+    std::uint32_t m_createdCount;
+    
+    // Sort key for new commands
+    std::uint32_t m_sortKey;
+    
+    // Linear arena for command arguments
+    std::vector<ArenaBlock> m_blocks;
+    std::size_t m_blockIndex;
+    std::size_t m_blockOffset;
+};
+
 /**
  * @brief System base class - processes entities with specific component combinations
+ *
+ * Membership is tracked per archetype: a system processes every entity stored
+ * in an archetype whose mask contains the system's component mask.
+ *
+ * Systems declare the components they read and write so the scheduler can run
+ * non-conflicting systems concurrently. Declarations must be made before the
+ * system is registered (typically in its constructor). Systems whose Update
+ * touches undeclared shared state or makes structural changes should be
+ * marked exclusive. That includes systems owning data that other systems
+ * read through them rather than through components, such as a spatial
+ * index: no other system's Update can then see it half rebuilt.
+ *
+ * Systems marked fixed-step (also before registration) are updated by
+ * FixedUpdateSystems with a constant time step instead of by UpdateSystems,
+ * which keeps simulation deterministic regardless of frame rate.
  */
 class System {
 protected:
     EntityManager* m_manager;
     ComponentMask m_componentMask;
-    std::set<EntityID> m_entities;
+    ComponentMask m_readMask;
+    ComponentMask m_writeMask;
+    std::vector<ArchetypeID> m_archetypes;
     SystemID m_id;
+    const char* m_name;
     bool m_active;
+    bool m_exclusive;
+    bool m_fixedStep;
+    
+    // Per-thread command buffers, applied after all systems have updated
+    std::vector<EntityCommandBuffer> m_commandBuffers;
+    std::uint32_t m_nextSortKey;
 
 public:
     System(EntityManager* manager);
@@ -120,6 +388,9 @@ public:
     // Get the system's unique ID
     SystemID GetID() const { return m_id; }
     
+    // Get the system's type name (used to label its profiling zones)
+    const char* GetName() const { return m_name; }
+    
     // Check if system is active
     bool IsActive() const { return m_active; }
     
@@ -129,62 +400,457 @@ public:
     // Get the component mask for this system
     const ComponentMask& GetComponentMask() const { return m_componentMask; }
     
-    // Add a component type requirement to this system
+    // Add a component type requirement to this system (written unless declared read-only)
     template<typename T>
-    System* RequireComponent();
+    System* RequireComponent(ComponentAccess access = ComponentAccess::Write);
+    
+    // Declare read access to a component type without requiring it
+    template<typename T>
+    System* ReadComponent();
+    
+    // Declare write access to a component type without requiring it
+    template<typename T>
+    System* WriteComponent();
+    
+    // Get the component types this system reads
+    const ComponentMask& GetReadMask() const { return m_readMask; }
+    
+    // Get the component types this system writes
+    const ComponentMask& GetWriteMask() const { return m_writeMask; }
+    
+    // Check if this system must never run concurrently with another system
+    bool IsExclusive() const { return m_exclusive; }
+    
+    // Mark this system as exclusive
+    void SetExclusive(bool exclusive) { m_exclusive = exclusive; }
+    
+    // Check if this system is updated on the fixed time step
+    bool IsFixedStep() const { return m_fixedStep; }
+    
+    // Move this system to the fixed time step
+    void SetFixedStep(bool fixedStep) { m_fixedStep = fixedStep; }
+    
+    // Check if this system and another system may not run concurrently
+    bool ConflictsWith(const System& other) const;
     
     // Get all entities processed by this system
-    const std::set<EntityID>& GetEntities() const { return m_entities; }
+    EntityRange GetEntities() const { return EntityRange(m_manager, m_archetypes); }
+    
+    // Get the archetypes processed by this system
+    const std::vector<ArchetypeID>& GetArchetypes() const { return m_archetypes; }
+    
+    // Get a command buffer for structural changes made from Update.
+    // Commands are applied once all systems have finished updating.
+    EntityCommandBuffer& GetCommandBuffer();
+    
+    // Call func(EntityCommandBuffer&, EntityID, Ts&...) for every entity of this
+    // system that has Ts, splitting the work by chunk across the job system
+    template<typename... Ts, typename Func>
+    void ParallelForEach(Func&& func);
+
+private:
+    // Size the per-thread command buffers for the current job system
+    void PrepareCommandBuffers();
+    
+    // Apply and clear recorded commands
+    void PlaybackCommands();
+
+    // Friend classes
+    friend class EntityManager;
+};
+
+/**
+ * @brief Type-erased description of a component type used by archetype storage
+ */
+struct ComponentTypeInfo {
+    std::size_t size = 0;
+    std::size_t alignment = 0;
+    
+    // Move-construct a component from source into uninitialized destination memory
+    void (*moveConstruct)(void* destination, void* source) = nullptr;
+    
+    // Destroy a component in place
+    void (*destroy)(void* component) = nullptr;
+    
+    // Build the type info for a component type
+    template<typename T>
+    static ComponentTypeInfo Create();
+};
+
+/**
+ * @brief Location of an entity inside archetype storage
+ */
+struct EntityLocation {
+    ArchetypeID archetype;
+    std::uint32_t row;
+};
+
+/**
+ * @brief Free-list pool of archetype chunks shared by all archetypes
+ *
+ * Chunks released by shrinking archetypes are reused by any archetype, so
+ * steady-state spawning and despawning does not touch the system heap.
+ * Chunks larger than ARCHETYPE_CHUNK_SIZE (single rows that do not fit)
+ * bypass the pool. Activity is reported through MemoryManager::GetComponentCounters.
+ */
+class ChunkPool {
+public:
+    // Singleton instance
+    static ChunkPool& Instance();
+    
+    // Allocate a chunk of at least the given size
+    unsigned char* Allocate(std::size_t size);
+    
+    // Return a chunk obtained from Allocate with the same size
+    void Free(unsigned char* chunk, std::size_t size);
+    
+    // Release all pooled chunks back to the system heap
+    void Trim();
+    
+    // Get the number of chunks waiting for reuse
+    std::size_t GetFreeChunkCount() const;
+    
+private:
+    ChunkPool();
+    ~ChunkPool();
+    
+    // Deleted copy constructor and assignment operator
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool& operator=(const ChunkPool&) = delete;
+    
+    // Chunks waiting for reuse
+    std::vector<unsigned char*> m_freeChunks;
+    
+    // Mutex guarding the free list (archetypes of different worlds may share the pool)
+    mutable std::mutex m_mutex;
+};
+
+/**
+ * @brief Storage for all entities sharing the same component mask
+ *
+ * Components are laid out structure-of-arrays inside fixed-size chunks: each
+ * chunk holds the entity IDs followed by one contiguous array per component
+ * type. Rows are kept dense, so removing a row moves the last row into the hole.
+ */
+class Archetype {
+public:
+    Archetype(ArchetypeID id, const ComponentMask& mask, const std::array<ComponentTypeInfo, MAX_COMPONENTS>& typeInfos);
+    ~Archetype();
+    
+    // Deleted copy constructor and assignment operator
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+    
+    // Get the archetype's unique ID
+    ArchetypeID GetID() const { return m_id; }
+    
+    // Get the component mask shared by all entities in this archetype
+    const ComponentMask& GetMask() const { return m_mask; }
+    
+    // Get the component IDs stored in this archetype, one per column
+    const std::vector<ComponentID>& GetComponentIDs() const { return m_componentIDs; }
+    
+    // Get the column for a component ID (-1 if not stored here)
+    int GetColumn(ComponentID componentID) const { return m_columnIndices[componentID]; }
+    
+    // Get the type info for a column
+    const ComponentTypeInfo& GetColumnTypeInfo(int column) const { return m_columnTypeInfos[column]; }
+    
+    // Get the number of entities stored in this archetype
+    std::uint32_t GetEntityCount() const { return m_entityCount; }
+    
+    // Get the number of allocated chunks
+    std::size_t GetChunkCount() const { return m_chunks.size(); }
+    
+    // Get the number of rows a single chunk can hold
+    std::uint32_t GetChunkCapacity() const { return m_chunkCapacity; }
+    
+    // Get the number of entities stored in a chunk
+    std::uint32_t GetChunkEntityCount(std::size_t chunk) const;
+    
+    // Get the entity IDs stored in a chunk
+    const EntityID* GetChunkEntities(std::size_t chunk) const;
+    
+    // Get the contiguous component array for a column in a chunk
+    void* GetChunkColumn(std::size_t chunk, int column) const;
+    
+    // Get the entity stored at a row
+    EntityID GetEntity(std::uint32_t row) const;
+    
+    // Get the component stored at a row and column
+    void* GetComponent(std::uint32_t row, int column) const;
+    
+    // Append a row for an entity; its components are left unconstructed
+    std::uint32_t AddRow(EntityID entity);
     
-    // Add an entity to this system
-    void AddEntity(EntityID entity);
+    // Remove a row whose components have already been destroyed or moved out.
+    // Returns the entity moved into the row, or INVALID_ENTITY if none moved.
+    EntityID RemoveRow(std::uint32_t row);
     
-    // Remove an entity from this system
-    void RemoveEntity(EntityID entity);
+    // Cached archetype transitions when adding or removing a component
+    ArchetypeID GetAddEdge(ComponentID componentID) const { return m_addEdges[componentID]; }
+    ArchetypeID GetRemoveEdge(ComponentID componentID) const { return m_removeEdges[componentID]; }
+    void SetAddEdge(ComponentID componentID, ArchetypeID archetype) { m_addEdges[componentID] = archetype; }
+    void SetRemoveEdge(ComponentID componentID, ArchetypeID archetype) { m_removeEdges[componentID] = archetype; }
+    
+    // Get the systems that process the entities in this archetype
+    const std::vector<System*>& GetSystems() const { return m_systems; }
+    
+    // Register a system that processes the entities in this archetype
+    void AddSystem(System* system) { m_systems.push_back(system); }
+    
+private:
+    // Allocate a new empty chunk
+    void AllocateChunk();
+    
+    // Release chunks beyond the one spare chunk kept past the last row
+    void ReleaseEmptyChunks();
+    
+    ArchetypeID m_id;
+    ComponentMask m_mask;
+    
+    // Column layout
+    std::vector<ComponentID> m_componentIDs;
+    std::vector<ComponentTypeInfo> m_columnTypeInfos;
+    std::vector<std::size_t> m_columnOffsets;
+    std::array<int, MAX_COMPONENTS> m_columnIndices;
+    
+    // Chunk storage
+    std::vector<unsigned char*> m_chunks;
+    std::size_t m_chunkSize;
+    std::uint32_t m_chunkCapacity;
+    std::uint32_t m_entityCount;
+    
+    // Archetype graph edges
+    std::array<ArchetypeID, MAX_COMPONENTS> m_addEdges;
+    std::array<ArchetypeID, MAX_COMPONENTS> m_removeEdges;
+    
+    // Systems matching this archetype's mask
+    std::vector<System*> m_systems;
+};
+
+/**
+ * @brief Typed query over all entities that have every component in Ts
+ *
+ * Range-for yields std::tuple<Ts&...>. ForEach and ForEachChunk walk the chunk
+ * arrays directly and should be preferred in hot loops. Entities must not
+ * change archetype while a view is being iterated.
+ */
+template<typename... Ts>
+class EntityView {
+public:
+    class Iterator {
+    public:
+        explicit Iterator(const EntityRange::Iterator& it) : m_it(it) {}
+        
+        std::tuple<Ts&...> operator*() const;
+        Iterator& operator++() { ++m_it; return *this; }
+        bool operator==(const Iterator& other) const { return m_it == other.m_it; }
+        bool operator!=(const Iterator& other) const { return m_it != other.m_it; }
+        
+        // Get the entity the iterator points at
+        EntityID GetEntity() const { return *m_it; }
+        
+    private:
+        EntityRange::Iterator m_it;
+    };
+    
+    EntityView(EntityManager* manager, const std::vector<ArchetypeID>& archetypes)
+        : m_manager(manager), m_archetypes(&archetypes), m_entities(manager, archetypes) {}
+    
+    Iterator begin() const { return Iterator(m_entities.begin()); }
+    Iterator end() const { return Iterator(m_entities.end()); }
+    
+    // Get the number of matching entities
+    std::size_t size() const { return m_entities.size(); }
+    
+    // Check if no entities match
+    bool empty() const { return m_entities.empty(); }
+    
+    // Get the matching entity IDs
+    const EntityRange& GetEntities() const { return m_entities; }
+    
+    // Get the matching archetypes
+    const std::vector<ArchetypeID>& GetArchetypes() const { return *m_archetypes; }
+    
+    // Call func(EntityID, Ts&...) for every matching entity
+    template<typename Func>
+    void ForEach(Func&& func) const;
+    
+    // Call func(const EntityID*, Ts*..., std::uint32_t count) for every non-empty chunk
+    template<typename Func>
+    void ForEachChunk(Func&& func) const;
+    
+    // Call func(EntityID, Ts&...) for every matching entity, one chunk per job
+    template<typename Func>
+    void ParallelForEach(JobSystem* jobSystem, Func&& func) const;
+    
+    // Call func(std::size_t chunkIndex, const EntityID*, Ts*..., std::uint32_t count)
+    // for every non-empty chunk, one chunk per job. Chunks are numbered in
+    // iteration order. Returns the number of chunks processed.
+    template<typename Func>
+    std::size_t ParallelForEachChunk(JobSystem* jobSystem, Func&& func) const;
+    
+private:
+    template<typename Func, std::size_t... Is>
+    static void InvokeChunk(Func& func, const Archetype& archetype, std::size_t chunk, std::uint32_t count,
+                            const std::array<int, sizeof...(Ts)>& columns, std::index_sequence<Is...>);
+    
+    EntityManager* m_manager;
+    const std::vector<ArchetypeID>* m_archetypes;
+    EntityRange m_entities;
 };
 
 /**
  * @brief Manages all entities, components, and systems
+ *
+ * Components are stored by value in archetype chunks. Component pointers
+ * returned by AddComponent/GetComponent stay valid only until the next
+ * structural change (add/remove component, destruction) that touches the
+ * entity's archetype.
  */
 class EntityManager {
 private:
     // Component type counter for generating unique component IDs
-    static ComponentID s_componentTypeCounter;
+    static std::atomic<ComponentID> s_componentTypeCounter;
     
     // System type counter for generating unique system IDs
-    static SystemID s_systemTypeCounter;
+    static std::atomic<SystemID> s_systemTypeCounter;
     
-    // Map of entity IDs to component masks
-    std::unordered_map<EntityID, ComponentMask> m_entityMasks;
+    // Type info for every component type that has been added to an entity
+    static std::array<ComponentTypeInfo, MAX_COMPONENTS> s_componentTypeInfos;
     
-    // Map of entity IDs to components
-    std::unordered_map<EntityID, std::unordered_map<ComponentID, std::shared_ptr<Component>>> m_entityComponents;
+    // Archetypes indexed by archetype ID (index 0 is the empty archetype)
+    std::vector<std::unique_ptr<Archetype>> m_archetypes;
     
-    // Queue of entity IDs that are available for reuse
-    std::queue<EntityID> m_availableEntityIDs;
+    // Map of component masks to archetype IDs
+    std::unordered_map<ComponentMask, ArchetypeID> m_archetypeLookup;
     
-    // Next entity ID to assign if no recycled IDs are available
-    EntityID m_nextEntityID;
+    // Entity slot, indexed by the index part of an entity ID
+    struct EntitySlot {
+        EntityLocation location;
+        std::uint32_t generation;
+        std::uint32_t nextFree;
+    };
+    
+    // Storage locations of all entities; rows in archetype storage form the dense side
+    std::vector<EntitySlot> m_entitySlots;
+    
+    // Matching archetypes for each queried component mask, extended as archetypes are created
+    std::unordered_map<ComponentMask, std::vector<ArchetypeID>> m_queryCache;
+    
+    // Mutex guarding query cache lookups from concurrently running systems
+    std::mutex m_queryMutex;
+    
+    // FIFO list of freed slots threaded through EntitySlot::nextFree
+    std::uint32_t m_freeSlotHead;
+    std::uint32_t m_freeSlotTail;
+    std::size_t m_freeSlotCount;
     
     // Map of system IDs to systems
     std::unordered_map<SystemID, std::shared_ptr<System>> m_systems;
     
-    // Set of entities pending destruction
-    std::set<EntityID> m_entitiesToDestroy;
+    // Systems in registration order
+    std::vector<System*> m_systemOrder;
+    
+    // Node of the system dependency graph
+    struct ScheduleNode {
+        System* system;
+        std::vector<std::size_t> dependents;
+        std::size_t dependencyCount;
+    };
+    
+    // System dependency graph of one update phase
+    struct Schedule {
+        std::vector<ScheduleNode> nodes;
+        std::unique_ptr<std::atomic<std::size_t>[]> remaining;
+    };
+    
+    // Dependency graphs of variable-step and fixed-step systems, rebuilt when systems are registered
+    Schedule m_schedule;
+    Schedule m_fixedSchedule;
+    bool m_scheduleDirty;
+    
+    // Fraction of a fixed step elapsed since the last fixed update
+    float m_interpolationAlpha;
+    
+    // Thread pool used to run systems concurrently (sequential if null)
+    JobSystem* m_jobSystem;
+    
+    // Events published during updates, dispatched by the engine once per phase
+    EventBus m_eventBus;
+    
+    // Destructions requested through DestroyEntity, applied by ProcessDestructions
+    EntityCommandBuffer m_pendingCommands;
+    
+    // Commands being applied by ProcessDestructions (swapped with the pending buffer)
+    EntityCommandBuffer m_flushingCommands;
+    
+    // Mutex guarding the pending destruction buffer
+    std::mutex m_destructionMutex;
+    
+    // Entity pending destruction, resolved to its storage location
+    struct PendingDestruction {
+        ArchetypeID archetype;
+        std::uint32_t row;
+        EntityID entity;
+    };
+    
+    // Scratch storage for batched destruction, reused across flushes
+    std::vector<EntityID> m_playbackDestructions;
+    std::vector<PendingDestruction> m_destructionBatch;
+
+    // Find the storage location of a live entity (nullptr for stale or invalid IDs)
+    EntityLocation* FindLocation(EntityID entity);
+    const EntityLocation* FindLocation(EntityID entity) const;
+    
+    // Release an entity slot and make its ID stale
+    void FreeSlot(EntityID entity);
+    
+    // Find or create the archetype for a component mask
+    ArchetypeID GetOrCreateArchetype(const ComponentMask& mask);
+    
+    // Move an entity's components into another archetype, destroying the
+    // components the target archetype does not store. Returns the new row.
+    std::uint32_t MoveEntity(EntityID entity, ArchetypeID target);
+    
+    // Notify systems gained or lost when an entity moves between archetypes
+    void NotifyEntityAdded(EntityID entity, const Archetype& from, const Archetype& to);
+    void NotifyEntityRemoved(EntityID entity, const Archetype& from, const Archetype& to);
+    
+    // Build the dependency graph of one update phase from declared component access
+    void BuildSchedule(Schedule& schedule, bool fixedStep);
+    
+    // Update the systems of one phase, then apply their deferred structural changes
+    void UpdatePhase(Schedule& schedule, bool fixedStep, float deltaTime);
+    
+    // Update systems concurrently following the dependency graph
+    void RunSchedule(Schedule& schedule, float deltaTime);
+    
+    // Run a scheduled system and release the systems waiting on it
+    void RunScheduledSystem(Schedule& schedule, std::size_t node, float deltaTime, JobCounter& counter);
+    
+    // Destroy a batch of entities grouped by archetype; unknown and duplicate IDs are skipped
+    void DestroyEntities(const std::vector<EntityID>& entities);
+    
+    friend class EntityCommandBuffer;
 
 public:
     EntityManager();
     ~EntityManager() = default;
     
-    // Create a new entity
+    // Create a new entity (with an INVALID_ENTITY ID if every slot is in use)
     Entity CreateEntity();
     
-    // Destroy an entity
+    // Queue an entity for destruction at the next ProcessDestructions call
     void DestroyEntity(EntityID entity);
     
-    // Process pending entity destructions
+    // Destroy all queued entities in one batch
     void ProcessDestructions();
     
+    // Check if an entity exists (including entities queued for destruction)
+    bool IsAlive(EntityID entity) const { return FindLocation(entity) != nullptr; }
+    
     // Add a component to an entity
     template<typename T, typename... Args>
     T* AddComponent(EntityID entity, Args&&... args);
@@ -209,15 +875,47 @@ public:
     template<typename T>
     T* GetSystem() const;
     
-    // Update all active systems
+    // Update all active variable-step systems; conflicting systems run in registration order
     void UpdateSystems(float deltaTime);
     
+    // Update all active fixed-step systems by one fixed time step
+    void FixedUpdateSystems(float fixedDeltaTime);
+    
     // Render all active systems
     void RenderSystems();
     
+    // Set the fraction of a fixed step elapsed since the last fixed update
+    void SetInterpolationAlpha(float alpha) { m_interpolationAlpha = alpha; }
+    
+    // Get the fraction of a fixed step elapsed since the last fixed update (for interpolating rendered state)
+    float GetInterpolationAlpha() const { return m_interpolationAlpha; }
+    
     // Get the component mask for an entity
     const ComponentMask& GetComponentMask(EntityID entity) const;
     
+    // Set the thread pool used to update systems concurrently (and to run worker event listeners)
+    void SetJobSystem(JobSystem* jobSystem) { m_jobSystem = jobSystem; m_eventBus.SetJobSystem(jobSystem); }
+    
+    // Get the thread pool used to update systems
+    JobSystem* GetJobSystem() const { return m_jobSystem; }
+    
+    // Get the bus that systems and components publish gameplay events to
+    EventBus& GetEventBus() { return m_eventBus; }
+    
+    // Get all archetypes
+    const std::vector<std::unique_ptr<Archetype>>& GetArchetypes() const { return m_archetypes; }
+    
+    // Get the archetypes whose masks contain the given mask (cached per mask)
+    const std::vector<ArchetypeID>& GetMatchingArchetypes(const ComponentMask& mask);
+    
+    // Query all entities that have every listed component
+    template<typename... Ts>
+    EntityView<Ts...> View();
+    
+    // Build the component mask for a list of component types
+    template<typename... Ts>
+    static ComponentMask MakeComponentMask();
+    
     // Helper function to get component ID for a type
     template<typename T>
     static ComponentID GetComponentTypeID();
@@ -225,6 +923,13 @@ public:
     // Helper function to get system ID for a type
     template<typename T>
     static SystemID GetSystemTypeID();
+    
+    // Helper function to get the readable name of a system type (static storage)
+    template<typename T>
+    static const char* GetSystemTypeName();
+    
+    // Turn a compiler type name into a readable one without the engine namespace
+    static std::string DemangleTypeName(const char* name);
 };
 
 // Implementation of Entity methods
@@ -244,12 +949,16 @@ void Entity::RemoveComponent() {
 
 template<typename T>
 bool Entity::HasComponent() const {
-    return m_manager->HasComponent<T>(m_id);
+    return m_manager && m_manager->HasComponent<T>(m_id);
 }
 
 template<typename T>
 T* Entity::GetComponent() const {
-    return m_manager->GetComponent<T>(m_id);
+    return m_manager ? m_manager->GetComponent<T>(m_id) : nullptr;
+}
+
+inline bool Entity::IsValid() const {
+    return m_manager && m_manager->IsAlive(m_id);
 }
 
 inline void Entity::Destroy() {
@@ -259,165 +968,980 @@ inline void Entity::Destroy() {
 // Implementation of System methods
 
 inline System::System(EntityManager* manager)
-    : m_manager(manager), m_id(0), m_active(true) {}
+    : m_manager(manager), m_id(0), m_name("System"), m_active(true), m_exclusive(false), m_fixedStep(false), m_nextSortKey(0) {}
 
 template<typename T>
-System* System::RequireComponent() {
+System* System::RequireComponent(ComponentAccess access) {
     m_componentMask.set(EntityManager::GetComponentTypeID<T>());
+    return access == ComponentAccess::Write ? WriteComponent<T>() : ReadComponent<T>();
+}
+
+template<typename T>
+System* System::ReadComponent() {
+    m_readMask.set(EntityManager::GetComponentTypeID<T>());
     return this;
 }
 
-inline void System::AddEntity(EntityID entity) {
-    m_entities.insert(entity);
-    OnEntityAdded(Entity(entity, m_manager));
+template<typename T>
+System* System::WriteComponent() {
+    m_writeMask.set(EntityManager::GetComponentTypeID<T>());
+    return this;
 }
 
-inline void System::RemoveEntity(EntityID entity) {
-    if (m_entities.erase(entity) > 0) {
-        OnEntityRemoved(Entity(entity, m_manager));
+inline bool System::ConflictsWith(const System& other) const {
+    if (m_exclusive || other.m_exclusive) {
+        return true;
     }
+    
+    // Write/write and read/write overlaps conflict; read/read overlaps do not
+    return (m_writeMask & (other.m_writeMask | other.m_readMask)).any() ||
+           (other.m_writeMask & m_readMask).any();
 }
 
-// Implementation of EntityManager methods
-
-// Static member initialization
-inline ComponentID EntityManager::s_componentTypeCounter = 0;
-inline SystemID EntityManager::s_systemTypeCounter = 0;
+inline EntityCommandBuffer& System::GetCommandBuffer() {
+    PrepareCommandBuffers();
+    
+    JobSystem* jobSystem = m_manager->GetJobSystem();
+    EntityCommandBuffer& commands = m_commandBuffers[jobSystem ? jobSystem->GetCurrentThreadIndex() : 0];
+    commands.SetSortKey(m_nextSortKey++);
+    
+    return commands;
+}
 
-inline EntityManager::EntityManager()
-    : m_nextEntityID(0) {}
+template<typename... Ts, typename Func>
+void System::ParallelForEach(Func&& func) {
+    PrepareCommandBuffers();
+    
+    JobSystem* jobSystem = m_manager->GetJobSystem();
+    const std::uint32_t baseSortKey = m_nextSortKey;
+    
+    // Entities of this system that also have every component in Ts
+    EntityView<Ts...> view(m_manager, m_manager->GetMatchingArchetypes(m_componentMask | EntityManager::MakeComponentMask<Ts...>()));
+    
+    const std::size_t chunkCount = view.ParallelForEachChunk(jobSystem,
+        [this, jobSystem, baseSortKey, &func](std::size_t chunkIndex, const EntityID* entities, Ts*... components, std::uint32_t count) {
+            // Commands are keyed by chunk so playback order is independent of thread assignment
+            EntityCommandBuffer& commands = m_commandBuffers[jobSystem ? jobSystem->GetCurrentThreadIndex() : 0];
+            
+            // A chunk job run on this thread while func waits shares the buffer, so hand back
+            // the key of whatever chunk it interrupted
+            const std::uint32_t interruptedSortKey = commands.GetSortKey();
+            commands.SetSortKey(baseSortKey + static_cast<std::uint32_t>(chunkIndex));
+            
+            for (std::uint32_t i = 0; i < count; ++i) {
+                func(commands, entities[i], components[i]...);
+            }
+            
+            commands.SetSortKey(interruptedSortKey);
+        });
+    
+    m_nextSortKey = baseSortKey + static_cast<std::uint32_t>(chunkCount);
+}
 
-inline Entity EntityManager::CreateEntity() {
-    EntityID id;
+inline void System::PrepareCommandBuffers() {
+    JobSystem* jobSystem = m_manager->GetJobSystem();
+    const std::size_t threadCount = jobSystem ? jobSystem->GetThreadCount() : 1;
     
-    if (!m_availableEntityIDs.empty()) {
-        id = m_availableEntityIDs.front();
-        m_availableEntityIDs.pop();
-    } else {
-        id = m_nextEntityID++;
+    if (m_commandBuffers.size() < threadCount) {
+        m_commandBuffers.resize(threadCount);
     }
-    
-    m_entityMasks[id].reset();
-    m_entityComponents[id].clear();
-    
-    return Entity(id, this);
 }
 
-inline void EntityManager::DestroyEntity(EntityID entity) {
-    m_entitiesToDestroy.insert(entity);
+inline void System::PlaybackCommands() {
+    EntityCommandBuffer::Playback(*m_manager, m_commandBuffers);
+    m_nextSortKey = 0;
 }
 
-inline void EntityManager::ProcessDestructions() {
-    for (EntityID entity : m_entitiesToDestroy) {
-        // Remove entity from all systems
-        for (auto& systemPair : m_systems) {
-            systemPair.second->RemoveEntity(entity);
-        }
+// Implementation of EntityCommandBuffer methods
+
+inline EntityCommandBuffer::~EntityCommandBuffer() {
+    Release();
+}
+
+inline EntityCommandBuffer::EntityCommandBuffer(EntityCommandBuffer&& other) noexcept
+    : m_commands(std::move(other.m_commands))
+    , m_createdEntities(std::move(other.m_createdEntities))
+    , m_createdCount(other.m_createdCount)
+    , m_sortKey(other.m_sortKey)
+    , m_blocks(std::move(other.m_blocks))
+    , m_blockIndex(other.m_blockIndex)
+    , m_blockOffset(other.m_blockOffset) {
+    other.m_commands.clear();
+    other.m_blocks.clear();
+    other.m_createdCount = 0;
+    other.m_blockIndex = 0;
+    other.m_blockOffset = 0;
+}
+
+inline EntityCommandBuffer& EntityCommandBuffer::operator=(EntityCommandBuffer&& other) noexcept {
+    if (this != &other) {
+        Release();
         
-        // Clear entity components
-        m_entityComponents.erase(entity);
-        m_entityMasks.erase(entity);
+        m_commands = std::move(other.m_commands);
+        m_createdEntities = std::move(other.m_createdEntities);
+        m_createdCount = other.m_createdCount;
+        m_sortKey = other.m_sortKey;
+        m_blocks = std::move(other.m_blocks);
+        m_blockIndex = other.m_blockIndex;
+        m_blockOffset = other.m_blockOffset;
         
-        // Add entity ID back to available pool
-        m_availableEntityIDs.push(entity);
+        other.m_commands.clear();
+        other.m_blocks.clear();
+        other.m_createdCount = 0;
+        other.m_blockIndex = 0;
+        other.m_blockOffset = 0;
     }
-    
-    m_entitiesToDestroy.clear();
+    return *this;
+}
+
+inline EntityCommandBuffer::DeferredEntity EntityCommandBuffer::CreateEntity() {
+    const std::uint32_t index = m_createdCount++;
+    m_commands.push_back({ CommandType::Create, true, m_sortKey, index, nullptr, nullptr, nullptr });
+    return DeferredEntity{ index };
+}
+
+inline void EntityCommandBuffer::DestroyEntity(EntityID entity) {
+    m_commands.push_back({ CommandType::Destroy, false, m_sortKey, entity, nullptr, nullptr, nullptr });
 }
 
 template<typename T, typename... Args>
-T* EntityManager::AddComponent(EntityID entity, Args&&... args) {
-    const ComponentID componentID = GetComponentTypeID<T>();
-    
-    // Create the component
-    auto component = std::make_shared<T>(std::forward<Args>(args)...);
-    m_entityComponents[entity][componentID] = component;
-    
-    // Update the entity's component mask
-    m_entityMasks[entity].set(componentID);
-    
-    // Initialize the component
-    component->Initialize();
-    
-    // Check if entity should be added to any systems
-    for (auto& systemPair : m_systems) {
-        const ComponentMask& systemMask = systemPair.second->GetComponentMask();
-        
-        if ((m_entityMasks[entity] & systemMask) == systemMask) {
-            systemPair.second->AddEntity(entity);
+void EntityCommandBuffer::AddComponent(EntityID entity, Args&&... args) {
+    RecordAdd<T>(entity, false, std::forward<Args>(args)...);
+}
+
+template<typename T, typename... Args>
+void EntityCommandBuffer::AddComponent(DeferredEntity entity, Args&&... args) {
+    RecordAdd<T>(entity.index, true, std::forward<Args>(args)...);
+}
+
+template<typename T>
+void EntityCommandBuffer::RemoveComponent(EntityID entity) {
+    ApplyFunction apply = [](EntityManager& manager, EntityID target, void*) {
+        manager.RemoveComponent<T>(target);
+    };
+    m_commands.push_back({ CommandType::Remove, false, m_sortKey, entity, apply, nullptr, nullptr });
+}
+
+template<typename T, typename... Args>
+void EntityCommandBuffer::RecordAdd(std::uint32_t entity, bool deferred, Args&&... args) {
+    using Arguments = std::tuple<std::decay_t<Args>...>;
+    static_assert(alignof(Arguments) <= ARCHETYPE_CHUNK_ALIGNMENT, "Command argument alignment exceeds arena alignment");
+    
+    // Copy the constructor arguments into the arena
+    void* payload = new (Allocate(sizeof(Arguments), alignof(Arguments))) Arguments(std::forward<Args>(args)...);
+    
+    ApplyFunction apply = [](EntityManager& manager, EntityID target, void* arguments) {
+        std::apply([&manager, target](auto&... values) {
+            manager.AddComponent<T>(target, std::move(values)...);
+        }, *static_cast<Arguments*>(arguments));
+    };
+    DestroyFunction destroy = [](void* arguments) {
+        static_cast<Arguments*>(arguments)->~Arguments();
+    };
+    
+    m_commands.push_back({ CommandType::Add, deferred, m_sortKey, entity, apply, destroy, payload });
+}
+
+inline void* EntityCommandBuffer::Allocate(std::size_t size, std::size_t alignment) {
+    // Bump allocate from the current block, moving on to the next one when it is full
+    while (m_blockIndex < m_blocks.size()) {
+        const ArenaBlock& block = m_blocks[m_blockIndex];
+        const std::size_t offset = (m_blockOffset + alignment - 1) & ~(alignment - 1);
+        if (offset + size <= block.size) {
+            m_blockOffset = offset + size;
+            return block.data + offset;
         }
+        
+        ++m_blockIndex;
+        m_blockOffset = 0;
     }
     
-    return static_cast<T*>(component.get());
+    // Every block is in use; add one large enough for this allocation
+    const std::size_t blockSize = std::max(ARENA_BLOCK_SIZE, size);
+    ArenaBlock block;
+    block.data = static_cast<unsigned char*>(::operator new(blockSize, std::align_val_t(ARCHETYPE_CHUNK_ALIGNMENT)));
+    block.size = blockSize;
+    m_blocks.push_back(block);
+    
+    m_blockIndex = m_blocks.size() - 1;
+    m_blockOffset = size;
+    return block.data;
 }
 
+inline void EntityCommandBuffer::Apply(Command& command, EntityManager& manager, std::vector<EntityID>& destroyed) {
+    switch (command.type) {
+        case CommandType::Create:
+            m_createdEntities[command.entity] = manager.CreateEntity().GetID();
+            break;
+            
+        case CommandType::Destroy:
+            destroyed.push_back(command.entity);
+            break;
+            
+        case CommandType::Add:
+        case CommandType::Remove: {
+            const EntityID target = command.deferred ? m_createdEntities[command.entity] : command.entity;
+            
+            // Commands on entities destroyed before playback are dropped
+            if (manager.IsAlive(target)) {
+                command.apply(manager, target, command.payload);
+            }
+            break;
+        }
+    }
+}
+
+inline void EntityCommandBuffer::Clear() {
+    for (Command& command : m_commands) {
+        if (command.destroy) {
+            command.destroy(command.payload);
+        }
+    }
+    
+    m_commands.clear();
+    m_createdEntities.clear();
+    m_createdCount = 0;
+    m_sortKey = 0;
+    m_blockIndex = 0;
+    m_blockOffset = 0;
+}
+
+inline void EntityCommandBuffer::Release() {
+    Clear();
+    
+    for (ArenaBlock& block : m_blocks) {
+        ::operator delete(block.data, std::align_val_t(ARCHETYPE_CHUNK_ALIGNMENT));
+    }
+    m_blocks.clear();
+}
+
+inline void EntityCommandBuffer::Playback(EntityManager& manager) {
+    if (m_commands.empty()) {
+        return;
+    }
+    
+    m_createdEntities.clear();
+    
+    std::vector<EntityID>& destroyed = manager.m_playbackDestructions;
+    
+    // Hooks run by playback can record into this buffer, so play back in rounds until none are left
+    std::size_t played = 0;
+    while (played < m_commands.size()) {
+        m_createdEntities.resize(m_createdCount, INVALID_ENTITY);
+        destroyed.clear();
+        
+        const std::size_t end = m_commands.size();
+        for (; played < end; ++played) {
+            // Copied, as recording during Apply can reallocate m_commands
+            Command command = m_commands[played];
+            Apply(command, manager, destroyed);
+        }
+        
+        manager.DestroyEntities(destroyed);
+    }
+    
+    Clear();
+}
+
+inline void EntityCommandBuffer::Playback(EntityManager& manager, std::vector<EntityCommandBuffer>& buffers) {
+    struct Entry {
+        std::uint32_t sortKey;
+        std::uint32_t buffer;
+        std::uint32_t command;
+    };
+    
+    std::size_t commandCount = 0;
+    for (const EntityCommandBuffer& commands : buffers) {
+        commandCount += commands.m_commands.size();
+    }
+    
+    if (commandCount == 0) {
+        return;
+    }
+    
+    for (EntityCommandBuffer& commands : buffers) {
+        commands.m_createdEntities.clear();
+    }
+    
+    std::vector<Entry> entries;
+    entries.reserve(commandCount);
+    
+    std::vector<EntityID>& destroyed = manager.m_playbackDestructions;
+    
+    // Hooks run by playback can record into these buffers (or add buffers), so play back in
+    // rounds until a round records nothing; buffers are indexed afresh as the vector can grow
+    std::vector<std::size_t> played;
+    while (true) {
+        played.resize(buffers.size(), 0);
+        entries.clear();
+        
+        for (std::size_t buffer = 0; buffer < buffers.size(); ++buffer) {
+            EntityCommandBuffer& commands = buffers[buffer];
+            commands.m_createdEntities.resize(commands.m_createdCount, INVALID_ENTITY);
+            
+            for (std::size_t command = played[buffer]; command < commands.m_commands.size(); ++command) {
+                entries.push_back({ commands.m_commands[command].sortKey,
+                                    static_cast<std::uint32_t>(buffer), static_cast<std::uint32_t>(command) });
+            }
+            played[buffer] = commands.m_commands.size();
+        }
+        
+        if (entries.empty()) {
+            break;
+        }
+        
+        // A sort key is only ever recorded by one thread, so a stable sort keeps recording order within a key
+        std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            return a.sortKey < b.sortKey;
+        });
+        
+        destroyed.clear();
+        
+        for (const Entry& entry : entries) {
+            // Copied, as recording during Apply can reallocate the buffer's commands
+            Command command = buffers[entry.buffer].m_commands[entry.command];
+            buffers[entry.buffer].Apply(command, manager, destroyed);
+        }
+        
+        manager.DestroyEntities(destroyed);
+    }
+    
+    for (EntityCommandBuffer& commands : buffers) {
+        commands.Clear();
+    }
+}
+
+// Implementation of ComponentTypeInfo methods
+
 template<typename T>
-void EntityManager::RemoveComponent(EntityID entity) {
-    const ComponentID componentID = GetComponentTypeID<T>();
+ComponentTypeInfo ComponentTypeInfo::Create() {
+    static_assert(std::is_base_of<Component, T>::value, "Components must derive from Component");
+    static_assert(alignof(T) <= ARCHETYPE_CHUNK_ALIGNMENT, "Component alignment exceeds chunk alignment");
+    static_assert(std::is_move_constructible<T>::value, "Components must be move constructible");
+    
+    ComponentTypeInfo info;
+    info.size = sizeof(T);
+    info.alignment = alignof(T);
+    info.moveConstruct = [](void* destination, void* source) {
+        new (destination) T(std::move(*static_cast<T*>(source)));
+    };
+    info.destroy = [](void* component) {
+        static_cast<T*>(component)->~T();
+    };
+    return info;
+}
+
+// Implementation of Archetype methods
+
+inline Archetype::Archetype(ArchetypeID id, const ComponentMask& mask, const std::array<ComponentTypeInfo, MAX_COMPONENTS>& typeInfos)
+    : m_id(id), m_mask(mask), m_chunkSize(0), m_chunkCapacity(1), m_entityCount(0) {
+    // Construct the chunk pool first so it outlives archetypes owned by static objects
+    ChunkPool::Instance();
+    
+    m_columnIndices.fill(-1);
+    m_addEdges.fill(INVALID_ARCHETYPE);
+    m_removeEdges.fill(INVALID_ARCHETYPE);
+    
+    // Build columns in component ID order
+    std::size_t rowSize = sizeof(EntityID);
+    for (ComponentID componentID = 0; componentID < MAX_COMPONENTS; ++componentID) {
+        if (mask.test(componentID)) {
+            m_columnIndices[componentID] = static_cast<int>(m_componentIDs.size());
+            m_componentIDs.push_back(componentID);
+            m_columnTypeInfos.push_back(typeInfos[componentID]);
+            rowSize += typeInfos[componentID].size;
+        }
+    }
     
-    // Check if entity has this component
-    if (!m_entityMasks[entity].test(componentID)) {
+    // Fit as many rows as possible into a chunk, accounting for column alignment
+    std::uint32_t capacity = static_cast<std::uint32_t>(ARCHETYPE_CHUNK_SIZE / rowSize);
+    if (capacity == 0) {
+        capacity = 1;
+    }
+    
+    for (;;) {
+        std::size_t offset = sizeof(EntityID) * capacity;
+        m_columnOffsets.clear();
+        for (const ComponentTypeInfo& info : m_columnTypeInfos) {
+            offset = (offset + info.alignment - 1) & ~(info.alignment - 1);
+            m_columnOffsets.push_back(offset);
+            offset += info.size * capacity;
+        }
+        
+        if (offset <= ARCHETYPE_CHUNK_SIZE || capacity == 1) {
+            m_chunkCapacity = capacity;
+            m_chunkSize = (offset + ARCHETYPE_CHUNK_ALIGNMENT - 1) & ~(ARCHETYPE_CHUNK_ALIGNMENT - 1);
+            break;
+        }
+        
+        --capacity;
+    }
+}
+
+inline Archetype::~Archetype() {
+    // Destroy all live components
+    for (std::uint32_t row = 0; row < m_entityCount; ++row) {
+        for (std::size_t column = 0; column < m_columnTypeInfos.size(); ++column) {
+            m_columnTypeInfos[column].destroy(GetComponent(row, static_cast<int>(column)));
+        }
+    }
+    
+    for (unsigned char* chunk : m_chunks) {
+        ChunkPool::Instance().Free(chunk, m_chunkSize);
+    }
+}
+
+inline std::uint32_t Archetype::GetChunkEntityCount(std::size_t chunk) const {
+    const std::size_t first = chunk * m_chunkCapacity;
+    if (first >= m_entityCount) {
+        return 0;
+    }
+    
+    const std::size_t remaining = m_entityCount - first;
+    return static_cast<std::uint32_t>(remaining < m_chunkCapacity ? remaining : m_chunkCapacity);
+}
+
+inline const EntityID* Archetype::GetChunkEntities(std::size_t chunk) const {
+    return reinterpret_cast<const EntityID*>(m_chunks[chunk]);
+}
+
+inline void* Archetype::GetChunkColumn(std::size_t chunk, int column) const {
+    return m_chunks[chunk] + m_columnOffsets[column];
+}
+
+inline EntityID Archetype::GetEntity(std::uint32_t row) const {
+    return GetChunkEntities(row / m_chunkCapacity)[row % m_chunkCapacity];
+}
+
+inline void* Archetype::GetComponent(std::uint32_t row, int column) const {
+    unsigned char* columnData = static_cast<unsigned char*>(GetChunkColumn(row / m_chunkCapacity, column));
+    return columnData + (row % m_chunkCapacity) * m_columnTypeInfos[column].size;
+}
+
+inline std::uint32_t Archetype::AddRow(EntityID entity) {
+    const std::uint32_t row = m_entityCount;
+    
+    if (row / m_chunkCapacity >= m_chunks.size()) {
+        AllocateChunk();
+    }
+    
+    reinterpret_cast<EntityID*>(m_chunks[row / m_chunkCapacity])[row % m_chunkCapacity] = entity;
+    ++m_entityCount;
+    
+    return row;
+}
+
+inline EntityID Archetype::RemoveRow(std::uint32_t row) {
+    const std::uint32_t last = m_entityCount - 1;
+    EntityID movedEntity = INVALID_ENTITY;
+    
+    // Fill the hole with the last row to keep storage dense
+    if (row != last) {
+        for (std::size_t column = 0; column < m_columnTypeInfos.size(); ++column) {
+            const ComponentTypeInfo& info = m_columnTypeInfos[column];
+            void* source = GetComponent(last, static_cast<int>(column));
+            info.moveConstruct(GetComponent(row, static_cast<int>(column)), source);
+            info.destroy(source);
+        }
+        
+        movedEntity = GetEntity(last);
+        reinterpret_cast<EntityID*>(m_chunks[row / m_chunkCapacity])[row % m_chunkCapacity] = movedEntity;
+    }
+    
+    --m_entityCount;
+    ReleaseEmptyChunks();
+    
+    return movedEntity;
+}
+
+inline void Archetype::AllocateChunk() {
+    m_chunks.push_back(ChunkPool::Instance().Allocate(m_chunkSize));
+}
+
+inline void Archetype::ReleaseEmptyChunks() {
+    // Keep one empty chunk so rows added and removed at a chunk boundary do not thrash the pool
+    const std::size_t usedChunks = (m_entityCount + m_chunkCapacity - 1) / m_chunkCapacity;
+    while (m_chunks.size() > usedChunks + 1) {
+        ChunkPool::Instance().Free(m_chunks.back(), m_chunkSize);
+        m_chunks.pop_back();
+    }
+}
+
+// Implementation of ChunkPool methods
+
+inline ChunkPool& ChunkPool::Instance() {
+    static ChunkPool instance;
+    return instance;
+}
+
+inline ChunkPool::ChunkPool() {
+    // Construct the counters first so they outlive the pool during static destruction
+    MemoryManager::GetComponentCounters();
+}
+
+inline ChunkPool::~ChunkPool() {
+    Trim();
+}
+
+inline unsigned char* ChunkPool::Allocate(std::size_t size) {
+    AllocationCounters& counters = MemoryManager::GetComponentCounters();
+    
+    if (size <= ARCHETYPE_CHUNK_SIZE) {
+        size = ARCHETYPE_CHUNK_SIZE;
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_freeChunks.empty()) {
+            unsigned char* chunk = m_freeChunks.back();
+            m_freeChunks.pop_back();
+            counters.pooledAllocations.fetch_add(1, std::memory_order_relaxed);
+            counters.bytesInUse.fetch_add(size, std::memory_order_relaxed);
+            return chunk;
+        }
+    }
+    
+    counters.heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.bytesInUse.fetch_add(size, std::memory_order_relaxed);
+    return static_cast<unsigned char*>(::operator new(size, std::align_val_t(ARCHETYPE_CHUNK_ALIGNMENT)));
+}
+
+inline void ChunkPool::Free(unsigned char* chunk, std::size_t size) {
+    AllocationCounters& counters = MemoryManager::GetComponentCounters();
+    
+    if (size <= ARCHETYPE_CHUNK_SIZE) {
+        counters.bytesInUse.fetch_sub(ARCHETYPE_CHUNK_SIZE, std::memory_order_relaxed);
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_freeChunks.push_back(chunk);
         return;
     }
     
-    // Finalize the component
-    auto component = static_cast<T*>(m_entityComponents[entity][componentID].get());
-    component->Finalize();
+    counters.bytesInUse.fetch_sub(size, std::memory_order_relaxed);
+    counters.heapFrees.fetch_add(1, std::memory_order_relaxed);
+    ::operator delete(chunk, std::align_val_t(ARCHETYPE_CHUNK_ALIGNMENT));
+}
+
+inline void ChunkPool::Trim() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (unsigned char* chunk : m_freeChunks) {
+        ::operator delete(chunk, std::align_val_t(ARCHETYPE_CHUNK_ALIGNMENT));
+    }
+    
+    MemoryManager::GetComponentCounters().heapFrees.fetch_add(m_freeChunks.size(), std::memory_order_relaxed);
+    m_freeChunks.clear();
+}
+
+inline std::size_t ChunkPool::GetFreeChunkCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_freeChunks.size();
+}
+
+// Implementation of EntityManager methods
+
+// Static member initialization
+inline std::atomic<ComponentID> EntityManager::s_componentTypeCounter{0};
+inline std::atomic<SystemID> EntityManager::s_systemTypeCounter{0};
+inline std::array<ComponentTypeInfo, MAX_COMPONENTS> EntityManager::s_componentTypeInfos = {};
+
+inline EntityManager::EntityManager()
+    : m_freeSlotHead(INVALID_ENTITY), m_freeSlotTail(INVALID_ENTITY), m_freeSlotCount(0)
+    , m_scheduleDirty(false), m_interpolationAlpha(1.0f), m_jobSystem(nullptr) {
+    m_entitySlots.reserve(MAX_ENTITIES);
+    
+    // Create the empty archetype that new entities start in
+    GetOrCreateArchetype(ComponentMask());
+}
+
+inline Entity EntityManager::CreateEntity() {
+    // The all-ones index is reserved for INVALID_ENTITY
+    const bool slotsExhausted = m_entitySlots.size() >= ENTITY_INDEX_MASK;
+    std::uint32_t index;
+    
+    if (m_freeSlotCount >= MIN_FREE_ENTITY_SLOTS || (slotsExhausted && m_freeSlotCount > 0)) {
+        // Reuse the oldest freed slot
+        index = m_freeSlotHead;
+        m_freeSlotHead = m_entitySlots[index].nextFree;
+        if (--m_freeSlotCount == 0) {
+            m_freeSlotTail = INVALID_ENTITY;
+        }
+    } else if (!slotsExhausted) {
+        index = static_cast<std::uint32_t>(m_entitySlots.size());
+        m_entitySlots.push_back({ { INVALID_ARCHETYPE, 0 }, 0, INVALID_ENTITY });
+    } else {
+        return Entity(INVALID_ENTITY, this);
+    }
+    
+    EntitySlot& slot = m_entitySlots[index];
+    const EntityID id = MakeEntityID(index, slot.generation);
+    slot.location = { 0, m_archetypes[0]->AddRow(id) };
+    slot.nextFree = INVALID_ENTITY;
+    
+    return Entity(id, this);
+}
+
+inline EntityLocation* EntityManager::FindLocation(EntityID entity) {
+    const std::uint32_t index = GetEntityIndex(entity);
+    if (index >= m_entitySlots.size()) {
+        return nullptr;
+    }
+    
+    EntitySlot& slot = m_entitySlots[index];
+    if (slot.generation != GetEntityGeneration(entity) || slot.location.archetype == INVALID_ARCHETYPE) {
+        return nullptr;
+    }
+    
+    return &slot.location;
+}
+
+inline const EntityLocation* EntityManager::FindLocation(EntityID entity) const {
+    return const_cast<EntityManager*>(this)->FindLocation(entity);
+}
+
+inline void EntityManager::FreeSlot(EntityID entity) {
+    const std::uint32_t index = GetEntityIndex(entity);
+    EntitySlot& slot = m_entitySlots[index];
+    
+    slot.location = { INVALID_ARCHETYPE, 0 };
+    slot.generation = (slot.generation + 1) & ENTITY_GENERATION_MASK;
+    slot.nextFree = INVALID_ENTITY;
+    
+    // Append to the back of the free list
+    if (m_freeSlotTail != INVALID_ENTITY) {
+        m_entitySlots[m_freeSlotTail].nextFree = index;
+    } else {
+        m_freeSlotHead = index;
+    }
+    m_freeSlotTail = index;
+    ++m_freeSlotCount;
+}
+
+inline void EntityManager::DestroyEntity(EntityID entity) {
+    std::lock_guard<std::mutex> lock(m_destructionMutex);
+    m_pendingCommands.DestroyEntity(entity);
+}
+
+inline void EntityManager::ProcessDestructions() {
+    // Swap buffers so destructions requested by removal callbacks wait for the next flush
+    {
+        std::lock_guard<std::mutex> lock(m_destructionMutex);
+        std::swap(m_pendingCommands, m_flushingCommands);
+    }
+    
+    m_flushingCommands.Playback(*this);
+}
+
+inline void EntityManager::DestroyEntities(const std::vector<EntityID>& entities) {
+    if (entities.empty()) {
+        return;
+    }
+    
+    m_destructionBatch.clear();
+    for (EntityID entity : entities) {
+        if (const EntityLocation* location = FindLocation(entity)) {
+            m_destructionBatch.push_back({ location->archetype, location->row, entity });
+        }
+    }
+    
+    // Group by archetype with rows in descending order: swap-removal then only
+    // ever moves rows that are not pending destruction, so the resolved rows stay valid
+    std::sort(m_destructionBatch.begin(), m_destructionBatch.end(),
+              [](const PendingDestruction& a, const PendingDestruction& b) {
+        return a.archetype != b.archetype ? a.archetype < b.archetype : a.row > b.row;
+    });
+    m_destructionBatch.erase(std::unique(m_destructionBatch.begin(), m_destructionBatch.end(),
+                                         [](const PendingDestruction& a, const PendingDestruction& b) {
+        return a.entity == b.entity;
+    }), m_destructionBatch.end());
+    
+    std::size_t begin = 0;
+    while (begin < m_destructionBatch.size()) {
+        const ArchetypeID archetypeID = m_destructionBatch[begin].archetype;
+        std::size_t end = begin;
+        while (end < m_destructionBatch.size() && m_destructionBatch[end].archetype == archetypeID) {
+            ++end;
+        }
+        
+        Archetype& archetype = *m_archetypes[archetypeID];
+        
+        // Remove the batch from the systems processing this archetype; callbacks
+        // must not make structural changes (they may still call DestroyEntity)
+        for (System* system : archetype.GetSystems()) {
+            for (std::size_t i = begin; i < end; ++i) {
+                system->OnEntityRemoved(Entity(m_destructionBatch[i].entity, this));
+            }
+        }
+        
+        for (std::size_t i = begin; i < end; ++i) {
+            const PendingDestruction& pending = m_destructionBatch[i];
+            
+            // Destroy entity components
+            for (std::size_t column = 0; column < archetype.GetComponentIDs().size(); ++column) {
+                archetype.GetColumnTypeInfo(static_cast<int>(column)).destroy(
+                    archetype.GetComponent(pending.row, static_cast<int>(column)));
+            }
+            
+            const EntityID movedEntity = archetype.RemoveRow(pending.row);
+            if (movedEntity != INVALID_ENTITY) {
+                m_entitySlots[GetEntityIndex(movedEntity)].location.row = pending.row;
+            }
+            
+            // Release the slot; the destroyed ID becomes stale
+            FreeSlot(pending.entity);
+        }
+        
+        begin = end;
+    }
+}
+
+inline ArchetypeID EntityManager::GetOrCreateArchetype(const ComponentMask& mask) {
+    auto it = m_archetypeLookup.find(mask);
+    if (it != m_archetypeLookup.end()) {
+        return it->second;
+    }
     
-    // Remove the component
-    m_entityComponents[entity].erase(componentID);
+    const ArchetypeID id = static_cast<ArchetypeID>(m_archetypes.size());
+    m_archetypes.push_back(std::make_unique<Archetype>(id, mask, s_componentTypeInfos));
+    m_archetypeLookup[mask] = id;
     
-    // Update the entity's component mask
-    m_entityMasks[entity].reset(componentID);
+    // Extend cached queries that match the new archetype
+    for (auto& queryPair : m_queryCache) {
+        if ((mask & queryPair.first) == queryPair.first) {
+            queryPair.second.push_back(id);
+        }
+    }
     
-    // Check if entity should be removed from any systems
-    for (auto& systemPair : m_systems) {
-        const ComponentMask& systemMask = systemPair.second->GetComponentMask();
+    // Attach systems that process the new archetype
+    for (System* system : m_systemOrder) {
+        const ComponentMask& systemMask = system->GetComponentMask();
         
-        if ((m_entityMasks[entity] & systemMask) != systemMask) {
-            systemPair.second->RemoveEntity(entity);
+        if ((mask & systemMask) == systemMask) {
+            system->m_archetypes.push_back(id);
+            m_archetypes[id]->AddSystem(system);
+        }
+    }
+    
+    return id;
+}
+
+inline const std::vector<ArchetypeID>& EntityManager::GetMatchingArchetypes(const ComponentMask& mask) {
+    std::lock_guard<std::mutex> lock(m_queryMutex);
+    
+    auto it = m_queryCache.find(mask);
+    if (it != m_queryCache.end()) {
+        return it->second;
+    }
+    
+    std::vector<ArchetypeID>& archetypes = m_queryCache[mask];
+    for (const auto& archetype : m_archetypes) {
+        if ((archetype->GetMask() & mask) == mask) {
+            archetypes.push_back(archetype->GetID());
+        }
+    }
+    
+    return archetypes;
+}
+
+inline void EntityManager::NotifyEntityAdded(EntityID entity, const Archetype& from, const Archetype& to) {
+    for (System* system : to.GetSystems()) {
+        const ComponentMask& systemMask = system->GetComponentMask();
+        
+        if ((from.GetMask() & systemMask) != systemMask) {
+            system->OnEntityAdded(Entity(entity, this));
+        }
+    }
+}
+
+inline void EntityManager::NotifyEntityRemoved(EntityID entity, const Archetype& from, const Archetype& to) {
+    for (System* system : from.GetSystems()) {
+        const ComponentMask& systemMask = system->GetComponentMask();
+        
+        if ((to.GetMask() & systemMask) != systemMask) {
+            system->OnEntityRemoved(Entity(entity, this));
+        }
+    }
+}
+
+inline std::uint32_t EntityManager::MoveEntity(EntityID entity, ArchetypeID target) {
+    EntityLocation& location = m_entitySlots[GetEntityIndex(entity)].location;
+    Archetype& sourceArchetype = *m_archetypes[location.archetype];
+    Archetype& targetArchetype = *m_archetypes[target];
+    
+    const std::uint32_t sourceRow = location.row;
+    const std::uint32_t targetRow = targetArchetype.AddRow(entity);
+    
+    // Move shared components across and destroy the ones being dropped
+    const std::vector<ComponentID>& componentIDs = sourceArchetype.GetComponentIDs();
+    for (std::size_t column = 0; column < componentIDs.size(); ++column) {
+        const ComponentTypeInfo& info = sourceArchetype.GetColumnTypeInfo(static_cast<int>(column));
+        void* source = sourceArchetype.GetComponent(sourceRow, static_cast<int>(column));
+        
+        const int targetColumn = targetArchetype.GetColumn(componentIDs[column]);
+        if (targetColumn >= 0) {
+            info.moveConstruct(targetArchetype.GetComponent(targetRow, targetColumn), source);
+        }
+        
+        info.destroy(source);
+    }
+    
+    const EntityID movedEntity = sourceArchetype.RemoveRow(sourceRow);
+    if (movedEntity != INVALID_ENTITY) {
+        m_entitySlots[GetEntityIndex(movedEntity)].location.row = sourceRow;
+    }
+    
+    location.archetype = target;
+    location.row = targetRow;
+    
+    return targetRow;
+}
+
+template<typename T, typename... Args>
+T* EntityManager::AddComponent(EntityID entity, Args&&... args) {
+    const ComponentID componentID = GetComponentTypeID<T>();
+    
+    // Register the component type layout on first use (once per process, as several worlds may add components concurrently)
+    static const bool s_registered = (s_componentTypeInfos[componentID] = ComponentTypeInfo::Create<T>(), true);
+    (void)s_registered;
+    
+    // Stale or invalid handles are ignored
+    const EntityLocation* found = FindLocation(entity);
+    if (!found) {
+        return nullptr;
+    }
+    
+    const EntityLocation location = *found;
+    Archetype* archetype = m_archetypes[location.archetype].get();
+    T* component;
+    
+    if (archetype->GetMask().test(componentID)) {
+        // Replace the existing component in place
+        void* slot = archetype->GetComponent(location.row, archetype->GetColumn(componentID));
+        static_cast<T*>(slot)->~T();
+        component = new (slot) T(std::forward<Args>(args)...);
+    } else {
+        // Find the archetype with this component added
+        ArchetypeID targetID = archetype->GetAddEdge(componentID);
+        if (targetID == INVALID_ARCHETYPE) {
+            ComponentMask mask = archetype->GetMask();
+            mask.set(componentID);
+            targetID = GetOrCreateArchetype(mask);
+            archetype->SetAddEdge(componentID, targetID);
         }
+        
+        // Move the entity and construct the component in its new row
+        const std::uint32_t row = MoveEntity(entity, targetID);
+        Archetype* source = archetype;
+        archetype = m_archetypes[targetID].get();
+        component = new (archetype->GetComponent(row, archetype->GetColumn(componentID))) T(std::forward<Args>(args)...);
+        
+        // Initialize the component before systems see the entity
+        component->Initialize();
+        
+        // Notify systems that start processing this entity
+        NotifyEntityAdded(entity, *source, *archetype);
+        
+        return component;
     }
+    
+    // Initialize the component
+    component->Initialize();
+    
+    return component;
+}
+
+template<typename T>
+void EntityManager::RemoveComponent(EntityID entity) {
+    const ComponentID componentID = GetComponentTypeID<T>();
+    const EntityLocation* found = FindLocation(entity);
+    if (!found) {
+        return;
+    }
+    
+    const EntityLocation location = *found;
+    Archetype* archetype = m_archetypes[location.archetype].get();
+    
+    // Check if entity has this component
+    if (!archetype->GetMask().test(componentID)) {
+        return;
+    }
+    
+    // Find the archetype with this component removed
+    ArchetypeID targetID = archetype->GetRemoveEdge(componentID);
+    if (targetID == INVALID_ARCHETYPE) {
+        ComponentMask mask = archetype->GetMask();
+        mask.reset(componentID);
+        targetID = GetOrCreateArchetype(mask);
+        archetype->SetRemoveEdge(componentID, targetID);
+    }
+    
+    // Notify systems that stop processing this entity while its components are still intact
+    NotifyEntityRemoved(entity, *archetype, *m_archetypes[targetID]);
+    
+    // Finalize the component
+    auto component = static_cast<T*>(archetype->GetComponent(location.row, archetype->GetColumn(componentID)));
+    component->Finalize();
+    
+    // Move the entity; the removed component is destroyed during the move
+    MoveEntity(entity, targetID);
 }
 
 template<typename T>
 bool EntityManager::HasComponent(EntityID entity) const {
     const ComponentID componentID = GetComponentTypeID<T>();
-    return m_entityMasks.at(entity).test(componentID);
+    const EntityLocation* location = FindLocation(entity);
+    return location && m_archetypes[location->archetype]->GetMask().test(componentID);
 }
 
 template<typename T>
 T* EntityManager::GetComponent(EntityID entity) const {
     const ComponentID componentID = GetComponentTypeID<T>();
+    const EntityLocation* location = FindLocation(entity);
+    if (!location) {
+        return nullptr;
+    }
+    
+    const Archetype& archetype = *m_archetypes[location->archetype];
     
     // Check if entity has this component
-    if (!m_entityMasks.at(entity).test(componentID)) {
+    const int column = archetype.GetColumn(componentID);
+    if (column < 0) {
         return nullptr;
     }
     
-    return static_cast<T*>(m_entityComponents.at(entity).at(componentID).get());
+    return static_cast<T*>(archetype.GetComponent(location->row, column));
 }
 
 template<typename T, typename... Args>
 T* EntityManager::RegisterSystem(Args&&... args) {
     const SystemID systemID = GetSystemTypeID<T>();
     
+    // Systems are registered once per type
+    auto existing = m_systems.find(systemID);
+    if (existing != m_systems.end()) {
+        return static_cast<T*>(existing->second.get());
+    }
+    
     // Create the system
     auto system = std::make_shared<T>(this, std::forward<Args>(args)...);
     system->m_id = systemID;
+    system->m_name = GetSystemTypeName<T>();
     m_systems[systemID] = system;
+    m_systemOrder.push_back(system.get());
+    m_scheduleDirty = true;
     
     // Initialize the system
     system->Initialize();
     
-    // Check existing entities to see if they match this system
-    for (const auto& entityPair : m_entityMasks) {
-        const EntityID entity = entityPair.first;
-        const ComponentMask& entityMask = entityPair.second;
-        const ComponentMask& systemMask = system->GetComponentMask();
+    // Check existing archetypes to see if their entities match this system
+    const ComponentMask& systemMask = system->GetComponentMask();
+    for (const auto& archetype : m_archetypes) {
+        if ((archetype->GetMask() & systemMask) != systemMask) {
+            continue;
+        }
+        
+        system->m_archetypes.push_back(archetype->GetID());
+        archetype->AddSystem(system.get());
         
-        if ((entityMask & systemMask) == systemMask) {
-            system->AddEntity(entity);
+        for (std::uint32_t row = 0; row < archetype->GetEntityCount(); ++row) {
+            system->OnEntityAdded(Entity(archetype->GetEntity(row), this));
         }
     }
     
@@ -437,23 +1961,127 @@ T* EntityManager::GetSystem() const {
 }
 
 inline void EntityManager::UpdateSystems(float deltaTime) {
-    for (auto& systemPair : m_systems) {
-        if (systemPair.second->IsActive()) {
-            systemPair.second->Update(deltaTime);
+    UpdatePhase(m_schedule, false, deltaTime);
+}
+
+inline void EntityManager::FixedUpdateSystems(float fixedDeltaTime) {
+    UpdatePhase(m_fixedSchedule, true, fixedDeltaTime);
+}
+
+inline void EntityManager::UpdatePhase(Schedule& schedule, bool fixedStep, float deltaTime) {
+    CHULUBME_PROFILE_ZONE(fixedStep ? "FixedUpdateSystems" : "UpdateSystems");
+    
+    // Run sequentially in registration order without a thread pool
+    if (!m_jobSystem || m_jobSystem->GetThreadCount() <= 1) {
+        for (System* system : m_systemOrder) {
+            if (system->IsActive() && system->IsFixedStep() == fixedStep) {
+                CHULUBME_PROFILE_ZONE(system->GetName());
+                system->Update(deltaTime);
+            }
+        }
+    } else {
+        if (m_scheduleDirty) {
+            BuildSchedule(m_schedule, false);
+            BuildSchedule(m_fixedSchedule, true);
+            m_scheduleDirty = false;
+        }
+        RunSchedule(schedule, deltaTime);
+    }
+    
+    // Sync point: apply deferred structural changes in registration order
+    CHULUBME_PROFILE_ZONE("PlaybackCommands");
+    for (System* system : m_systemOrder) {
+        if (system->IsFixedStep() == fixedStep) {
+            system->PlaybackCommands();
         }
     }
 }
 
+inline void EntityManager::RunSchedule(Schedule& schedule, float deltaTime) {
+    // Start every system without unfinished dependencies
+    JobCounter counter;
+    for (std::size_t node = 0; node < schedule.nodes.size(); ++node) {
+        schedule.remaining[node].store(schedule.nodes[node].dependencyCount, std::memory_order_relaxed);
+    }
+    
+    for (std::size_t node = 0; node < schedule.nodes.size(); ++node) {
+        if (schedule.nodes[node].dependencyCount == 0) {
+            m_jobSystem->Schedule([this, &schedule, node, deltaTime, &counter]() {
+                RunScheduledSystem(schedule, node, deltaTime, counter);
+            }, &counter);
+        }
+    }
+    
+    m_jobSystem->Wait(counter);
+}
+
 inline void EntityManager::RenderSystems() {
-    for (auto& systemPair : m_systems) {
-        if (systemPair.second->IsActive()) {
-            systemPair.second->Render();
+    CHULUBME_PROFILE_ZONE("RenderSystems");
+    
+    for (System* system : m_systemOrder) {
+        if (system->IsActive()) {
+            CHULUBME_PROFILE_ZONE(system->GetName());
+            system->Render();
         }
     }
 }
 
+inline void EntityManager::BuildSchedule(Schedule& schedule, bool fixedStep) {
+    schedule.nodes.clear();
+    
+    for (System* system : m_systemOrder) {
+        if (system->IsFixedStep() == fixedStep) {
+            schedule.nodes.push_back({ system, {}, 0 });
+        }
+    }
+    
+    // Conflicting systems run in registration order
+    std::vector<ScheduleNode>& nodes = schedule.nodes;
+    for (std::size_t later = 0; later < nodes.size(); ++later) {
+        for (std::size_t earlier = 0; earlier < later; ++earlier) {
+            if (nodes[earlier].system->ConflictsWith(*nodes[later].system)) {
+                nodes[earlier].dependents.push_back(later);
+                ++nodes[later].dependencyCount;
+            }
+        }
+    }
+    
+    schedule.remaining.reset(new std::atomic<std::size_t>[nodes.size()]);
+}
+
+inline void EntityManager::RunScheduledSystem(Schedule& schedule, std::size_t node, float deltaTime, JobCounter& counter) {
+    System* system = schedule.nodes[node].system;
+    if (system->IsActive()) {
+        CHULUBME_PROFILE_ZONE(system->GetName());
+        system->Update(deltaTime);
+    }
+    
+    // Release dependents whose last dependency just finished
+    for (std::size_t dependent : schedule.nodes[node].dependents) {
+        if (schedule.remaining[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            m_jobSystem->Schedule([this, &schedule, dependent, deltaTime, &counter]() {
+                RunScheduledSystem(schedule, dependent, deltaTime, counter);
+            }, &counter);
+        }
+    }
+}
+
+template<typename... Ts>
+EntityView<Ts...> EntityManager::View() {
+    return EntityView<Ts...>(this, GetMatchingArchetypes(MakeComponentMask<Ts...>()));
+}
+
+template<typename... Ts>
+ComponentMask EntityManager::MakeComponentMask() {
+    ComponentMask mask;
+    (mask.set(GetComponentTypeID<Ts>()), ...);
+    return mask;
+}
+
 inline const ComponentMask& EntityManager::GetComponentMask(EntityID entity) const {
-    return m_entityMasks.at(entity);
+    // Stale or invalid handles report the empty archetype's mask
+    const EntityLocation* location = FindLocation(entity);
+    return m_archetypes[location ? location->archetype : 0]->GetMask();
 }
 
 template<typename T>
@@ -468,4 +2096,188 @@ SystemID EntityManager::GetSystemTypeID() {
     return typeID;
 }
 
+template<typename T>
+const char* EntityManager::GetSystemTypeName() {
+    static const std::string name = DemangleTypeName(typeid(T).name());
+    return name.c_str();
+}
+
+inline std::string EntityManager::DemangleTypeName(const char* name) {
+#if defined(__GNUG__)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    std::string result = status == 0 && demangled ? demangled : name;
+    std::free(demangled);
+#else
+    // MSVC names are readable already, apart from the class keyword
+    std::string result = name;
+    if (result.compare(0, 6, "class ") == 0) {
+        result.erase(0, 6);
+    }
+#endif
+    
+    const std::string prefix = "CHULUBME::";
+    if (result.compare(0, prefix.size(), prefix) == 0) {
+        result.erase(0, prefix.size());
+    }
+    return result;
+}
+
+// Implementation of EntityRange methods
+
+inline EntityRange::Iterator::Iterator(const EntityManager* manager, const std::vector<ArchetypeID>* archetypes, std::size_t archetypeIndex)
+    : m_manager(manager)
+    , m_archetypes(archetypes)
+    , m_archetypeIndex(archetypeIndex)
+    , m_archetype(nullptr)
+    , m_chunk(0)
+    , m_row(0)
+    , m_rowCount(0)
+    , m_entities(nullptr)
+{
+    SkipEmptyChunks();
+}
+
+inline EntityRange::Iterator& EntityRange::Iterator::operator++() {
+    if (++m_row >= m_rowCount) {
+        m_row = 0;
+        ++m_chunk;
+        SkipEmptyChunks();
+    }
+    return *this;
+}
+
+inline bool EntityRange::Iterator::operator==(const Iterator& other) const {
+    return m_archetypeIndex == other.m_archetypeIndex && m_chunk == other.m_chunk && m_row == other.m_row;
+}
+
+inline void EntityRange::Iterator::SkipEmptyChunks() {
+    while (m_archetypeIndex < m_archetypes->size()) {
+        m_archetype = m_manager->GetArchetypes()[(*m_archetypes)[m_archetypeIndex]].get();
+        m_rowCount = m_archetype->GetChunkEntityCount(m_chunk);
+        
+        if (m_rowCount > 0) {
+            m_entities = m_archetype->GetChunkEntities(m_chunk);
+            return;
+        }
+        
+        // Rows are dense, so an empty chunk ends the archetype
+        ++m_archetypeIndex;
+        m_chunk = 0;
+    }
+    
+    m_archetype = nullptr;
+    m_chunk = 0;
+    m_row = 0;
+    m_rowCount = 0;
+    m_entities = nullptr;
+}
+
+inline std::size_t EntityRange::size() const {
+    std::size_t count = 0;
+    for (ArchetypeID archetype : *m_archetypes) {
+        count += m_manager->GetArchetypes()[archetype]->GetEntityCount();
+    }
+    return count;
+}
+
+// Implementation of EntityView methods
+
+template<typename... Ts>
+std::tuple<Ts&...> EntityView<Ts...>::Iterator::operator*() const {
+    const Archetype* archetype = m_it.GetArchetype();
+    return std::tuple<Ts&...>(
+        static_cast<Ts*>(archetype->GetChunkColumn(m_it.GetChunk(), archetype->GetColumn(EntityManager::GetComponentTypeID<Ts>())))[m_it.GetRow()]...);
+}
+
+template<typename... Ts>
+template<typename Func>
+void EntityView<Ts...>::ForEach(Func&& func) const {
+    ForEachChunk([&func](const EntityID* entities, Ts*... components, std::uint32_t count) {
+        for (std::uint32_t i = 0; i < count; ++i) {
+            func(entities[i], components[i]...);
+        }
+    });
+}
+
+template<typename... Ts>
+template<typename Func>
+void EntityView<Ts...>::ForEachChunk(Func&& func) const {
+    for (ArchetypeID archetypeID : *m_archetypes) {
+        const Archetype& archetype = *m_manager->GetArchetypes()[archetypeID];
+        const std::array<int, sizeof...(Ts)> columns = { { archetype.GetColumn(EntityManager::GetComponentTypeID<Ts>())... } };
+        
+        for (std::size_t chunk = 0; chunk < archetype.GetChunkCount(); ++chunk) {
+            const std::uint32_t count = archetype.GetChunkEntityCount(chunk);
+            if (count == 0) {
+                break;
+            }
+            
+            InvokeChunk(func, archetype, chunk, count, columns, std::index_sequence_for<Ts...>{});
+        }
+    }
+}
+
+template<typename... Ts>
+template<typename Func>
+void EntityView<Ts...>::ParallelForEach(JobSystem* jobSystem, Func&& func) const {
+    ParallelForEachChunk(jobSystem, [&func](std::size_t, const EntityID* entities, Ts*... components, std::uint32_t count) {
+        for (std::uint32_t i = 0; i < count; ++i) {
+            func(entities[i], components[i]...);
+        }
+    });
+}
+
+template<typename... Ts>
+template<typename Func>
+std::size_t EntityView<Ts...>::ParallelForEachChunk(JobSystem* jobSystem, Func&& func) const {
+    struct ChunkWork {
+        const Archetype* archetype;
+        std::size_t chunk;
+        std::uint32_t count;
+        std::array<int, sizeof...(Ts)> columns;
+    };
+    
+    // Each chunk is a cache-sized unit of work
+    std::vector<ChunkWork> work;
+    for (ArchetypeID archetypeID : *m_archetypes) {
+        const Archetype& archetype = *m_manager->GetArchetypes()[archetypeID];
+        const std::array<int, sizeof...(Ts)> columns = { { archetype.GetColumn(EntityManager::GetComponentTypeID<Ts>())... } };
+        
+        for (std::size_t chunk = 0; chunk < archetype.GetChunkCount(); ++chunk) {
+            const std::uint32_t count = archetype.GetChunkEntityCount(chunk);
+            if (count == 0) {
+                break;
+            }
+            
+            work.push_back({ &archetype, chunk, count, columns });
+        }
+    }
+    
+    auto runRange = [&work, &func](std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; ++index) {
+            const ChunkWork& item = work[index];
+            auto chunkFunc = [&func, index](const EntityID* entities, Ts*... components, std::uint32_t count) {
+                func(index, entities, components..., count);
+            };
+            InvokeChunk(chunkFunc, *item.archetype, item.chunk, item.count, item.columns, std::index_sequence_for<Ts...>{});
+        }
+    };
+    
+    if (jobSystem) {
+        jobSystem->ParallelFor(work.size(), 1, runRange);
+    } else {
+        runRange(0, work.size());
+    }
+    
+    return work.size();
+}
+
+template<typename... Ts>
+template<typename Func, std::size_t... Is>
+void EntityView<Ts...>::InvokeChunk(Func& func, const Archetype& archetype, std::size_t chunk, std::uint32_t count,
+                                    const std::array<int, sizeof...(Ts)>& columns, std::index_sequence<Is...>) {
+    func(archetype.GetChunkEntities(chunk), static_cast<Ts*>(archetype.GetChunkColumn(chunk, columns[Is]))..., count);
+}
+
 } // namespace CHULUBME
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <thread>
@@ -8,11 +9,42 @@
 #include <memory>
 
 #include "ecs.h"
+#include "frame_pacer.h"
+#include "job_system.h"
+#include "memory.h"
+#include "profiler.h"
 
 namespace CHULUBME {
 
 /**
  * @brief Game engine class that manages the main game loop and timing
+ *
+ * Each frame updates the variable-step systems with the measured frame time,
+ * then runs the fixed ticks that are due: fixed-step systems advance by a
+ * constant time step, counted by an integer tick number. When a frame falls
+ * more than the catch-up limit behind, the backlog is dropped instead of
+ * being simulated, so a slow frame cannot snowball. The fraction of a step
+ * left over is published to systems as the interpolation alpha.
+ *
+ * A headless engine skips rendering. With no target frame rate it also
+ * bypasses the FramePacer, so the loop reads no clock outside profiling,
+ * and runs one tick per frame as fast as it can, which suits authoritative
+ * servers, replays and simulation farms.
+ *
+ * Frames are paced by a FramePacer, and variable-step systems see its
+ * smoothed frame time. A pipelined engine simulates the next frame on the
+ * job system while the main thread runs the submit callback for the frame
+ * it just rendered, hiding GPU submission and buffer swaps behind
+ * simulation at the cost of one frame of latency.
+ *
+ * Each frame is marked on the Profiler, whose zones time the engine phases
+ * and every system, so frame time percentiles and a trace of recent frames
+ * are available whenever profiling is compiled in.
+ *
+ * Events published on the entity manager's event bus are dispatched after
+ * the variable update, after the tick-begin callback (delivering the tick's
+ * input before any system runs) and after the fixed-step systems of each
+ * tick. Undelivered events are dropped when frame memory is recycled.
  */
 class Engine {
 public:
@@ -34,23 +66,59 @@ public:
     // Get the entity manager
     EntityManager* GetEntityManager() { return m_entityManager.get(); }
 
-    // Get the current delta time (time between frames)
+    // Get the job system shared by engine subsystems
+    JobSystem* GetJobSystem() { return m_jobSystem.get(); }
+
+    // Get the current delta time (smoothed time between frames)
     float GetDeltaTime() const { return m_deltaTime; }
 
     // Get the current frame rate
     float GetFrameRate() const { return m_frameRate; }
 
+    // Get rolling frame time statistics (empty when profiling is compiled out)
+    FrameTimeStats GetFrameTimeStats() const { return Profiler::Instance().GetFrameTimeStats(); }
+
     // Get the target frame rate
-    float GetTargetFrameRate() const { return m_targetFrameRate; }
+    float GetTargetFrameRate() const { return m_framePacer.GetTargetFrameRate(); }
 
     // Set the target frame rate (0 for unlimited)
-    void SetTargetFrameRate(float targetFrameRate) { m_targetFrameRate = targetFrameRate; }
+    void SetTargetFrameRate(float targetFrameRate) { m_framePacer.SetTargetFrameRate(targetFrameRate); }
 
     // Get the fixed update rate (for physics and gameplay logic)
     float GetFixedUpdateRate() const { return m_fixedUpdateRate; }
 
-    // Set the fixed update rate
-    void SetFixedUpdateRate(float fixedUpdateRate) { m_fixedUpdateRate = fixedUpdateRate; }
+    // Set the fixed update rate (ignored unless positive)
+    void SetFixedUpdateRate(float fixedUpdateRate) { if (fixedUpdateRate > 0.0f) m_fixedUpdateRate = fixedUpdateRate; }
+
+    // Get the fixed time step in seconds
+    float GetFixedDeltaTime() const { return 1.0f / m_fixedUpdateRate; }
+
+    // Get the number of fixed ticks run since initialization
+    std::uint64_t GetTick() const { return m_tick; }
+
+    // Get the most fixed ticks run in one frame
+    int GetMaxFixedStepsPerFrame() const { return m_maxFixedStepsPerFrame; }
+
+    // Set the most fixed ticks run in one frame before the backlog is dropped
+    void SetMaxFixedStepsPerFrame(int maxSteps) { m_maxFixedStepsPerFrame = maxSteps > 0 ? maxSteps : 1; }
+
+    // Get the fraction of a fixed step elapsed since the last tick
+    float GetInterpolationAlpha() const { return m_entityManager->GetInterpolationAlpha(); }
+
+    // Check if the engine runs without rendering
+    bool IsHeadless() const { return m_headless; }
+
+    // Run without rendering (set before Run)
+    void SetHeadless(bool headless) { m_headless = headless; }
+
+    // Check if simulation overlaps submission of the previous frame
+    bool IsPipelined() const { return m_pipelined; }
+
+    // Simulate the next frame while the submit callback runs (set before Run)
+    void SetPipelined(bool pipelined) { m_pipelined = pipelined; }
+
+    // Advance the simulation by fixed ticks without waiting on the clock (does nothing while running)
+    void Step(std::uint64_t tickCount = 1);
 
     // Register update callback
     void RegisterUpdateCallback(std::function<void(float)> callback) { m_updateCallback = callback; }
@@ -58,9 +126,16 @@ public:
     // Register render callback
     void RegisterRenderCallback(std::function<void()> callback) { m_renderCallback = callback; }
 
+    // Register submit callback (GPU submission and buffer swap; when pipelined it runs
+    // alongside the next simulation and must not touch entities or frame arena memory)
+    void RegisterSubmitCallback(std::function<void()> callback) { m_submitCallback = callback; }
+
     // Register fixed update callback
     void RegisterFixedUpdateCallback(std::function<void(float)> callback) { m_fixedUpdateCallback = callback; }
 
+    // Register tick begin callback (runs with the tick number before the fixed-step systems, e.g. to drain input)
+    void RegisterTickBeginCallback(std::function<void(std::uint64_t)> callback) { m_tickBeginCallback = callback; }
+
     // Register initialization callback
     void RegisterInitCallback(std::function<bool()> callback) { m_initCallback = callback; }
 
@@ -82,28 +157,52 @@ private:
     // Render game state
     void Render();
 
+    // Submit the rendered frame
+    void Submit();
+
+    // Publish frame timing and recycle frame memory (no jobs may be running)
+    void PrepareSimulation(std::chrono::nanoseconds frameTime, bool freeRunning);
+
+    // Advance game state by one frame
+    void Simulate(std::chrono::nanoseconds frameTime);
+
     // Fixed update for physics and gameplay logic
     void FixedUpdate(float fixedDeltaTime);
 
+    // Release event storage and reset the per-thread frame arenas
+    void RecycleFrameMemory();
+
+    // Get the fixed time step as a clock duration
+    std::chrono::nanoseconds GetFixedStepDuration() const;
+
+    // Job system (declared before the entity manager so it outlives it)
+    std::unique_ptr<JobSystem> m_jobSystem;
+
     // Entity manager
     std::unique_ptr<EntityManager> m_entityManager;
 
     // Time tracking
-    std::chrono::high_resolution_clock::time_point m_lastFrameTime;
-    std::chrono::high_resolution_clock::time_point m_lastFixedUpdateTime;
+    FramePacer m_framePacer;
     float m_deltaTime;
     float m_frameRate;
-    float m_targetFrameRate;
     float m_fixedUpdateRate;
-    float m_fixedUpdateAccumulator;
+    std::chrono::nanoseconds m_fixedUpdateAccumulator;
+
+    // Fixed ticks run since initialization, and the catch-up limit per frame
+    std::uint64_t m_tick;
+    int m_maxFixedStepsPerFrame;
 
     // Running state
     std::atomic<bool> m_running;
+    bool m_headless;
+    bool m_pipelined;
 
     // Callbacks
     std::function<void(float)> m_updateCallback;
     std::function<void()> m_renderCallback;
+    std::function<void()> m_submitCallback;
     std::function<void(float)> m_fixedUpdateCallback;
+    std::function<void(std::uint64_t)> m_tickBeginCallback;
     std::function<bool()> m_initCallback;
     std::function<void()> m_shutdownCallback;
 };
@@ -116,14 +215,20 @@ inline Engine& Engine::Instance() {
 }
 
 inline Engine::Engine()
-    : m_entityManager(std::make_unique<EntityManager>())
+    : m_jobSystem(std::make_unique<JobSystem>())
+    , m_entityManager(std::make_unique<EntityManager>())
     , m_deltaTime(0.0f)
     , m_frameRate(0.0f)
-    , m_targetFrameRate(60.0f)
     , m_fixedUpdateRate(60.0f)
-    , m_fixedUpdateAccumulator(0.0f)
+    , m_fixedUpdateAccumulator(0)
+    , m_tick(0)
+    , m_maxFixedStepsPerFrame(5)
     , m_running(false)
+    , m_headless(false)
+    , m_pipelined(false)
 {
+    m_framePacer.SetTargetFrameRate(60.0f);
+    m_entityManager->SetJobSystem(m_jobSystem.get());
 }
 
 inline Engine::~Engine() {
@@ -132,11 +237,11 @@ inline Engine::~Engine() {
 
 inline bool Engine::Initialize() {
     // Reset time tracking
-    m_lastFrameTime = std::chrono::high_resolution_clock::now();
-    m_lastFixedUpdateTime = m_lastFrameTime;
+    m_framePacer.Reset();
     m_deltaTime = 0.0f;
     m_frameRate = 0.0f;
-    m_fixedUpdateAccumulator = 0.0f;
+    m_fixedUpdateAccumulator = std::chrono::nanoseconds(0);
+    m_tick = 0;
 
     // Call initialization callback if registered
     if (m_initCallback) {
@@ -157,6 +262,7 @@ inline void Engine::Shutdown() {
 
     // Clear entity manager
     m_entityManager.reset(new EntityManager());
+    m_entityManager->SetJobSystem(m_jobSystem.get());
 }
 
 inline void Engine::Run() {
@@ -165,50 +271,64 @@ inline void Engine::Run() {
     }
 
     m_running = true;
-    m_lastFrameTime = std::chrono::high_resolution_clock::now();
-    m_lastFixedUpdateTime = m_lastFrameTime;
+    m_framePacer.Reset();
+    CHULUBME_PROFILE_THREAD("Main");
+
+    // Simulation of the next frame started during the last submit
+    JobCounter simulation;
+    bool simulationPending = false;
+
+    // Set while frames run unpaced, so the pacer's schedule is stale
+    bool pacerIdle = false;
 
     // Main game loop
     while (m_running) {
-        // Calculate delta time
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        auto frameTimeDuration = std::chrono::duration_cast<std::chrono::microseconds>(currentTime - m_lastFrameTime);
-        m_deltaTime = frameTimeDuration.count() / 1000000.0f;
-        m_lastFrameTime = currentTime;
-
-        // Calculate frame rate
-        m_frameRate = 1.0f / m_deltaTime;
-
-        // Process entity destructions
-        m_entityManager->ProcessDestructions();
-
-        // Update game state
-        Update(m_deltaTime);
-
-        // Accumulate fixed update time
-        m_fixedUpdateAccumulator += m_deltaTime;
-        
-        // Fixed time step for physics and gameplay logic
-        const float fixedDeltaTime = 1.0f / m_fixedUpdateRate;
-        while (m_fixedUpdateAccumulator >= fixedDeltaTime) {
-            FixedUpdate(fixedDeltaTime);
-            m_fixedUpdateAccumulator -= fixedDeltaTime;
+        // A free-running headless engine advances simulated time by exactly one tick per frame, without the pacer
+        const bool freeRunning = m_headless && m_framePacer.GetTargetFrameRate() <= 0.0f;
+        std::chrono::nanoseconds frameTime = GetFixedStepDuration();
+        if (freeRunning) {
+            pacerIdle = true;
+        } else {
+            // Restart the schedule when pacing resumes, then wait until the frame is due
+            if (pacerIdle) {
+                m_framePacer.Reset();
+                pacerIdle = false;
+            }
+            frameTime = m_framePacer.BeginFrame();
+        }
+        CHULUBME_PROFILE_FRAME();
+
+        // Update game state, unless it was updated while the previous frame was submitted
+        if (simulationPending) {
+            CHULUBME_PROFILE_ZONE("Wait for simulation");
+            m_jobSystem->Wait(simulation);
+            simulationPending = false;
+        } else {
+            PrepareSimulation(frameTime, freeRunning);
+            Simulate(frameTime);
+        }
+
+        if (m_headless) {
+            continue;
         }
 
         // Render game state
         Render();
 
-        // Frame rate limiting
-        if (m_targetFrameRate > 0) {
-            const float targetFrameTime = 1.0f / m_targetFrameRate;
-            const float elapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(
-                std::chrono::high_resolution_clock::now() - currentTime).count() / 1000000.0f;
-            
-            if (elapsedTime < targetFrameTime) {
-                std::this_thread::sleep_for(std::chrono::microseconds(
-                    static_cast<int>((targetFrameTime - elapsedTime) * 1000000)));
-            }
+        // Simulate the next frame while this one is submitted
+        if (m_pipelined && m_running) {
+            PrepareSimulation(frameTime, freeRunning);
+            m_jobSystem->Schedule([this, frameTime]() { Simulate(frameTime); }, &simulation);
+            simulationPending = true;
         }
+
+        // Submit the frame
+        Submit();
+    }
+
+    // Finish a simulation still in flight
+    if (simulationPending) {
+        m_jobSystem->Wait(simulation);
     }
 }
 
@@ -216,10 +336,66 @@ inline void Engine::Stop() {
     m_running = false;
 }
 
+inline void Engine::Step(std::uint64_t tickCount) {
+    if (m_running) {
+        return;
+    }
+
+    const float fixedDeltaTime = GetFixedDeltaTime();
+    for (std::uint64_t i = 0; i < tickCount; ++i) {
+        RecycleFrameMemory();
+        FixedUpdate(fixedDeltaTime);
+    }
+}
+
+inline void Engine::PrepareSimulation(std::chrono::nanoseconds frameTime, bool freeRunning) {
+    // Calculate delta time and frame rate
+    m_deltaTime = freeRunning ? frameTime.count() / 1000000000.0f : m_framePacer.GetSmoothedDeltaTime();
+    m_frameRate = m_deltaTime > 0.0f ? 1.0f / m_deltaTime : 0.0f;
+
+    // Recycle last frame's per-thread frame arenas
+    RecycleFrameMemory();
+}
+
+inline void Engine::Simulate(std::chrono::nanoseconds frameTime) {
+    CHULUBME_PROFILE_ZONE("Simulate");
+
+    // Process entity destructions
+    m_entityManager->ProcessDestructions();
+
+    // Update game state
+    Update(m_deltaTime);
+
+    // Accumulate fixed update time
+    m_fixedUpdateAccumulator += frameTime;
+
+    // Fixed time step for physics and gameplay logic, dropping what exceeds the catch-up limit
+    const std::chrono::nanoseconds fixedStep = GetFixedStepDuration();
+    const float fixedDeltaTime = GetFixedDeltaTime();
+    int steps = 0;
+    while (m_fixedUpdateAccumulator >= fixedStep) {
+        if (steps == m_maxFixedStepsPerFrame) {
+            m_fixedUpdateAccumulator %= fixedStep;
+            break;
+        }
+
+        FixedUpdate(fixedDeltaTime);
+        m_fixedUpdateAccumulator -= fixedStep;
+        ++steps;
+    }
+
+    m_entityManager->SetInterpolationAlpha(static_cast<float>(m_fixedUpdateAccumulator.count()) / fixedStep.count());
+}
+
 inline void Engine::Update(float deltaTime) {
+    CHULUBME_PROFILE_ZONE("Update");
+
     // Update all systems
     m_entityManager->UpdateSystems(deltaTime);
 
+    // Deliver the events the systems published
+    m_entityManager->GetEventBus().Dispatch();
+
     // Call update callback if registered
     if (m_updateCallback) {
         m_updateCallback(deltaTime);
@@ -227,6 +403,8 @@ inline void Engine::Update(float deltaTime) {
 }
 
 inline void Engine::Render() {
+    CHULUBME_PROFILE_ZONE("Render");
+
     // Render all systems
     m_entityManager->RenderSystems();
 
@@ -236,11 +414,49 @@ inline void Engine::Render() {
     }
 }
 
+inline void Engine::Submit() {
+    CHULUBME_PROFILE_ZONE("Submit");
+
+    // Call submit callback if registered
+    if (m_submitCallback) {
+        m_submitCallback();
+    }
+}
+
 inline void Engine::FixedUpdate(float fixedDeltaTime) {
+    CHULUBME_PROFILE_ZONE("FixedUpdate");
+
+    // Every tick starts with the destructions requested before it
+    m_entityManager->ProcessDestructions();
+
+    // Gather the tick's input before any system reads it
+    if (m_tickBeginCallback) {
+        m_tickBeginCallback(m_tick);
+    }
+    m_entityManager->GetEventBus().Dispatch();
+
+    // Update fixed-step systems
+    m_entityManager->FixedUpdateSystems(fixedDeltaTime);
+
+    // Deliver the events published during the tick
+    m_entityManager->GetEventBus().Dispatch();
+
     // Call fixed update callback if registered
     if (m_fixedUpdateCallback) {
         m_fixedUpdateCallback(fixedDeltaTime);
     }
+
+    ++m_tick;
+}
+
+inline void Engine::RecycleFrameMemory() {
+    // Event streams hold frame arena storage
+    m_entityManager->GetEventBus().ReleaseFrameStorage();
+    MemoryManager::ResetThreadFrameArenas();
+}
+
+inline std::chrono::nanoseconds Engine::GetFixedStepDuration() const {
+    return std::chrono::nanoseconds(static_cast<std::int64_t>(1000000000.0 / m_fixedUpdateRate));
 }
 
 } // namespace CHULUBME
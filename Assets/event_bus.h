@@ -0,0 +1,487 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "containers.h"
+#include "job_system.h"
+#include "profiler.h"
+
+namespace CHULUBME {
+
+// Identifies a listener registered with an EventBus
+using ListenerID = std::uint32_t;
+constexpr ListenerID INVALID_LISTENER = 0;
+
+// Where a listener runs when its events are dispatched
+enum class EventDelivery {
+    Dispatcher,     // On the dispatching thread, in subscription order
+    Worker          // As a job, concurrently with other worker listeners
+};
+
+/**
+ * @brief Contiguous run of events of one type handed to a listener
+ */
+template<typename Event>
+class EventBatch {
+public:
+    EventBatch(const Event* events, std::size_t count) : m_events(events), m_count(count) {}
+
+    // Iteration
+    const Event* begin() const { return m_events; }
+    const Event* end() const { return m_events + m_count; }
+
+    // Element access
+    const Event& operator[](std::size_t index) const { return m_events[index]; }
+    const Event* data() const { return m_events; }
+
+    // Size queries
+    std::size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+
+private:
+    const Event* m_events;
+    std::size_t m_count;
+};
+
+/**
+ * @brief Events of one type published since the last dispatch, and their listeners
+ *
+ * Each publishing thread appends to its own buffer in its frame arena, so
+ * publishing takes no lock. The first publishers get a buffer each; threads
+ * beyond MAX_PUBLISHER_THREADS share a locked one. Events of a type with no
+ * listeners are dropped when published.
+ */
+class EventStreamBase {
+public:
+    virtual ~EventStreamBase() = default;
+
+    // Move the published events aside for delivery; returns false if there are none
+    virtual bool Collect() = 0;
+
+    // Run dispatcher listeners on the collected events and schedule worker listeners with the counter
+    virtual void Deliver(JobSystem* jobSystem, JobCounter& counter) = 0;
+
+    // Drop the delivered events (after every listener finished)
+    virtual void FinishDelivery() = 0;
+
+    // Drop all events and their storage (before the frame arenas are reset)
+    virtual void ReleaseStorage() = 0;
+
+    // Remove a listener; returns false if it is not registered here
+    virtual bool RemoveListener(ListenerID listener) = 0;
+
+protected:
+    // Publishing threads with a lock-free buffer of their own
+    static constexpr std::size_t MAX_PUBLISHER_THREADS = 64;
+
+    // Get the calling thread's publisher index, handed out on first use
+    static std::size_t GetPublisherIndex() {
+        static std::atomic<std::size_t> s_nextIndex{ 0 };
+        thread_local const std::size_t t_index = s_nextIndex.fetch_add(1, std::memory_order_relaxed);
+        return t_index;
+    }
+};
+
+/**
+ * @brief Stream of events of one type
+ */
+template<typename Event>
+class EventStream : public EventStreamBase {
+public:
+    using Listener = std::function<void(const EventBatch<Event>&)>;
+
+    EventStream();
+    ~EventStream() override;
+
+    // Append an event (any thread that follows the frame; no listener runs now)
+    void Publish(const Event& event);
+
+    // Add a listener
+    void AddListener(ListenerID id, Listener listener, EventDelivery delivery);
+
+    bool Collect() override;
+    void Deliver(JobSystem* jobSystem, JobCounter& counter) override;
+    void FinishDelivery() override;
+    void ReleaseStorage() override;
+    bool RemoveListener(ListenerID listener) override;
+
+private:
+    // Buffers of one publishing thread, in that thread's frame arena
+    struct Buffer {
+        FrameVector<Event> published;
+        FrameVector<Event> collected;
+    };
+
+    struct ListenerEntry {
+        ListenerID id;
+        Listener listener;
+        EventDelivery delivery;
+    };
+
+    // Per-thread buffers; a slot is only created and appended to by its thread
+    std::array<std::atomic<Buffer*>, MAX_PUBLISHER_THREADS> m_buffers;
+    std::atomic<std::size_t> m_bufferCount;
+
+    // Buffer shared by threads without a slot
+    std::mutex m_overflowMutex;
+    std::vector<Event> m_overflowPublished;
+    std::vector<Event> m_overflowCollected;
+
+    // Collected events of several threads copied together for delivery
+    std::vector<Event> m_merged;
+    const Event* m_batchEvents;
+    std::size_t m_batchCount;
+
+    // Listeners (changed only while no dispatch is running)
+    std::vector<ListenerEntry> m_listeners;
+    std::atomic<bool> m_hasListeners;
+};
+
+/**
+ * @brief Central bus of typed event streams
+ *
+ * Publishing appends an event to the stream of its type and returns; nothing
+ * is called. Dispatch then hands each listener all events of its type
+ * published since the previous dispatch as one batch, so a burst of events
+ * costs one call per listener rather than one per event. Events from one
+ * thread keep their order; the order between threads is unspecified.
+ *
+ * Dispatch first sets aside the events of every stream, so events published
+ * by listeners are delivered by the next dispatch. Worker listeners run on
+ * the job system, concurrently with each other and with dispatcher
+ * listeners; they must only read the batch and state nothing else writes
+ * during dispatch. Dispatch, Subscribe and Unsubscribe must not overlap.
+ *
+ * Event storage lives in the frame arenas of the publishing threads, so only
+ * threads that follow the engine frame (the simulation thread and job
+ * workers) may publish, and ReleaseFrameStorage must run before the frame
+ * arenas are reset. Events not dispatched by then are dropped.
+ */
+class EventBus {
+public:
+    EventBus();
+    ~EventBus() = default;
+
+    // Deleted copy constructor and assignment operator
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    // Set the thread pool that runs worker listeners (without one they run on the dispatching thread)
+    void SetJobSystem(JobSystem* jobSystem) { m_jobSystem = jobSystem; }
+
+    // Publish an event
+    template<typename Event>
+    void Publish(const Event& event);
+
+    // Register a listener for batches of an event type (INVALID_LISTENER if there are too many event types)
+    template<typename Event>
+    ListenerID Subscribe(std::function<void(const EventBatch<Event>&)> listener, EventDelivery delivery = EventDelivery::Dispatcher);
+
+    // Remove a listener
+    void Unsubscribe(ListenerID listener);
+
+    // Deliver every published event to its listeners; returns the number of streams with events
+    std::size_t Dispatch();
+
+    // Drop undelivered events and their storage; call before the frame arenas are reset
+    void ReleaseFrameStorage();
+
+private:
+    // Maximum number of event types
+    static constexpr std::size_t MAX_EVENT_TYPES = 64;
+
+    // Get the ID of an event type
+    template<typename Event>
+    static std::size_t GetEventTypeID();
+
+    // Streams by event type (null until the first listener subscribes)
+    std::array<std::atomic<EventStreamBase*>, MAX_EVENT_TYPES> m_streamTable;
+    std::vector<std::unique_ptr<EventStreamBase>> m_streams;
+
+    // Thread pool for worker listeners
+    JobSystem* m_jobSystem;
+
+    // Last listener ID handed out
+    ListenerID m_lastListenerID;
+
+    // Counter for event type IDs
+    static std::atomic<std::size_t> s_eventTypeCounter;
+};
+
+// Implementation of EventStream methods
+
+template<typename Event>
+EventStream<Event>::EventStream()
+    : m_bufferCount(0)
+    , m_batchEvents(nullptr)
+    , m_batchCount(0)
+    , m_hasListeners(false)
+{
+    for (std::atomic<Buffer*>& buffer : m_buffers) {
+        buffer.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template<typename Event>
+EventStream<Event>::~EventStream() {
+    for (std::atomic<Buffer*>& buffer : m_buffers) {
+        delete buffer.load(std::memory_order_acquire);
+    }
+}
+
+template<typename Event>
+void EventStream<Event>::Publish(const Event& event) {
+    if (!m_hasListeners.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    const std::size_t index = GetPublisherIndex();
+    if (index >= MAX_PUBLISHER_THREADS) {
+        std::lock_guard<std::mutex> lock(m_overflowMutex);
+        m_overflowPublished.push_back(event);
+        return;
+    }
+
+    Buffer* buffer = m_buffers[index].load(std::memory_order_acquire);
+    if (!buffer) {
+        // Built on this thread, so its storage comes from this thread's frame arena
+        buffer = new Buffer();
+        m_buffers[index].store(buffer, std::memory_order_release);
+
+        std::size_t count = m_bufferCount.load(std::memory_order_relaxed);
+        while (count < index + 1 && !m_bufferCount.compare_exchange_weak(count, index + 1, std::memory_order_release)) {
+        }
+    }
+
+    buffer->published.push_back(event);
+}
+
+template<typename Event>
+void EventStream<Event>::AddListener(ListenerID id, Listener listener, EventDelivery delivery) {
+    m_listeners.push_back({ id, std::move(listener), delivery });
+    m_hasListeners.store(true, std::memory_order_relaxed);
+}
+
+template<typename Event>
+bool EventStream<Event>::Collect() {
+    const std::size_t bufferCount = m_bufferCount.load(std::memory_order_acquire);
+    std::size_t collectedCount = 0;
+    Buffer* single = nullptr;
+
+    for (std::size_t i = 0; i < bufferCount; ++i) {
+        Buffer* buffer = m_buffers[i].load(std::memory_order_acquire);
+        if (buffer && !buffer->published.empty()) {
+            buffer->collected.swap(buffer->published);
+            single = collectedCount == 0 ? buffer : nullptr;
+            collectedCount += buffer->collected.size();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_overflowMutex);
+        if (!m_overflowPublished.empty()) {
+            m_overflowCollected.swap(m_overflowPublished);
+            single = nullptr;
+            collectedCount += m_overflowCollected.size();
+        }
+    }
+
+    m_batchCount = collectedCount;
+    if (collectedCount == 0) {
+        m_batchEvents = nullptr;
+        return false;
+    }
+
+    // Events of one thread are delivered in place; several threads' are copied together
+    if (single) {
+        m_batchEvents = single->collected.data();
+        return true;
+    }
+
+    m_merged.clear();
+    m_merged.reserve(collectedCount);
+    for (std::size_t i = 0; i < bufferCount; ++i) {
+        Buffer* buffer = m_buffers[i].load(std::memory_order_acquire);
+        if (buffer) {
+            m_merged.insert(m_merged.end(), buffer->collected.begin(), buffer->collected.end());
+        }
+    }
+    m_merged.insert(m_merged.end(), m_overflowCollected.begin(), m_overflowCollected.end());
+    m_batchEvents = m_merged.data();
+    return true;
+}
+
+template<typename Event>
+void EventStream<Event>::Deliver(JobSystem* jobSystem, JobCounter& counter) {
+    const EventBatch<Event> batch(m_batchEvents, m_batchCount);
+    const bool useWorkers = jobSystem && jobSystem->GetThreadCount() > 1;
+
+    // Start the worker listeners first so they overlap the dispatcher listeners
+    if (useWorkers) {
+        for (const ListenerEntry& entry : m_listeners) {
+            if (entry.delivery == EventDelivery::Worker) {
+                const Listener* listener = &entry.listener;
+                jobSystem->Schedule([listener, batch]() { (*listener)(batch); }, &counter);
+            }
+        }
+    }
+
+    for (const ListenerEntry& entry : m_listeners) {
+        if (entry.delivery == EventDelivery::Dispatcher || !useWorkers) {
+            entry.listener(batch);
+        }
+    }
+}
+
+template<typename Event>
+void EventStream<Event>::FinishDelivery() {
+    const std::size_t bufferCount = m_bufferCount.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < bufferCount; ++i) {
+        Buffer* buffer = m_buffers[i].load(std::memory_order_acquire);
+        if (buffer) {
+            buffer->collected.clear();
+        }
+    }
+
+    m_overflowCollected.clear();
+    m_merged.clear();
+    m_batchEvents = nullptr;
+    m_batchCount = 0;
+}
+
+template<typename Event>
+void EventStream<Event>::ReleaseStorage() {
+    const std::size_t bufferCount = m_bufferCount.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < bufferCount; ++i) {
+        Buffer* buffer = m_buffers[i].load(std::memory_order_acquire);
+        if (buffer) {
+            // Keep each buffer bound to its thread's arena
+            FrameVector<Event>(buffer->published.get_allocator()).swap(buffer->published);
+            FrameVector<Event>(buffer->collected.get_allocator()).swap(buffer->collected);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_overflowMutex);
+    m_overflowPublished.clear();
+    m_overflowCollected.clear();
+    m_merged.clear();
+    m_batchEvents = nullptr;
+    m_batchCount = 0;
+}
+
+template<typename Event>
+bool EventStream<Event>::RemoveListener(ListenerID listener) {
+    for (auto it = m_listeners.begin(); it != m_listeners.end(); ++it) {
+        if (it->id == listener) {
+            m_listeners.erase(it);
+            m_hasListeners.store(!m_listeners.empty(), std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Implementation of EventBus methods
+
+inline std::atomic<std::size_t> EventBus::s_eventTypeCounter{ 0 };
+
+inline EventBus::EventBus()
+    : m_jobSystem(nullptr)
+    , m_lastListenerID(INVALID_LISTENER)
+{
+    for (std::atomic<EventStreamBase*>& stream : m_streamTable) {
+        stream.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template<typename Event>
+std::size_t EventBus::GetEventTypeID() {
+    static const std::size_t typeID = s_eventTypeCounter.fetch_add(1, std::memory_order_relaxed);
+    return typeID;
+}
+
+template<typename Event>
+void EventBus::Publish(const Event& event) {
+    const std::size_t typeID = GetEventTypeID<Event>();
+    if (typeID >= MAX_EVENT_TYPES) {
+        return;
+    }
+
+    // Types nobody subscribed to have no stream
+    EventStreamBase* stream = m_streamTable[typeID].load(std::memory_order_acquire);
+    if (stream) {
+        static_cast<EventStream<Event>*>(stream)->Publish(event);
+    }
+}
+
+template<typename Event>
+ListenerID EventBus::Subscribe(std::function<void(const EventBatch<Event>&)> listener, EventDelivery delivery) {
+    const std::size_t typeID = GetEventTypeID<Event>();
+    if (typeID >= MAX_EVENT_TYPES || !listener) {
+        return INVALID_LISTENER;
+    }
+
+    EventStreamBase* stream = m_streamTable[typeID].load(std::memory_order_acquire);
+    if (!stream) {
+        m_streams.push_back(std::make_unique<EventStream<Event>>());
+        stream = m_streams.back().get();
+        m_streamTable[typeID].store(stream, std::memory_order_release);
+    }
+
+    const ListenerID id = ++m_lastListenerID;
+    static_cast<EventStream<Event>*>(stream)->AddListener(id, std::move(listener), delivery);
+    return id;
+}
+
+inline void EventBus::Unsubscribe(ListenerID listener) {
+    for (std::unique_ptr<EventStreamBase>& stream : m_streams) {
+        if (stream->RemoveListener(listener)) {
+            return;
+        }
+    }
+}
+
+inline std::size_t EventBus::Dispatch() {
+    CHULUBME_PROFILE_ZONE("Dispatch events");
+
+    // Set every stream's events aside before any listener can publish more
+    SmallVector<EventStreamBase*, 16> ready;
+    for (std::unique_ptr<EventStreamBase>& stream : m_streams) {
+        if (stream->Collect()) {
+            ready.push_back(stream.get());
+        }
+    }
+
+    if (ready.empty()) {
+        return 0;
+    }
+
+    JobCounter counter;
+    for (EventStreamBase* stream : ready) {
+        stream->Deliver(m_jobSystem, counter);
+    }
+    if (m_jobSystem) {
+        m_jobSystem->Wait(counter);
+    }
+
+    for (EventStreamBase* stream : ready) {
+        stream->FinishDelivery();
+    }
+
+    return ready.size();
+}
+
+inline void EventBus::ReleaseFrameStorage() {
+    for (std::unique_ptr<EventStreamBase>& stream : m_streams) {
+        stream->ReleaseStorage();
+    }
+}
+
+} // namespace CHULUBME
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+namespace CHULUBME {
+
+/**
+ * @brief Paces frames to a target rate on a steady clock
+ *
+ * Frames are scheduled against fixed deadlines one period apart, so a late
+ * wake-up shortens the next wait instead of shifting every later frame; a
+ * stall longer than a period restarts the schedule from the current time.
+ * Waiting sleeps until the deadline is within the spin threshold and yields
+ * for the rest. The threshold follows how far sleeps have overshot their
+ * request, growing at once and shrinking slowly, so the coarse OS sleep
+ * never runs past the deadline.
+ *
+ * Measured frame times are also averaged over a short window to give a
+ * smoothed delta time that does not carry the scheduling noise of single
+ * frames.
+ */
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    FramePacer();
+
+    // Set the target frame rate (0 for unlimited)
+    void SetTargetFrameRate(float targetFrameRate);
+
+    // Get the target frame rate
+    float GetTargetFrameRate() const { return m_targetFrameRate; }
+
+    // Restart the frame schedule and discard the smoothing history
+    void Reset();
+
+    // Wait until the next frame is due and return the time since the previous frame began
+    std::chrono::nanoseconds BeginFrame();
+
+    // Get the average duration of recent frames in seconds
+    float GetSmoothedDeltaTime() const { return m_smoothedDeltaTime; }
+
+    // Get how close to a deadline sleeping stops
+    std::chrono::nanoseconds GetSpinThreshold() const { return m_spinThreshold; }
+
+private:
+    // Number of frames averaged for the smoothed delta time
+    static constexpr std::size_t SMOOTHING_WINDOW = 8;
+
+    // Longest frame time fed to smoothing, so one stall does not linger for a whole window
+    static constexpr float MAX_SMOOTHED_FRAME_TIME = 0.25f;
+
+    // Sleep a little less than the worst overshoot seen, and keep the spin window within bounds
+    static constexpr std::chrono::nanoseconds SPIN_MARGIN{ 200000 };
+    static constexpr std::chrono::nanoseconds MIN_SPIN_THRESHOLD{ 500000 };
+    static constexpr std::chrono::nanoseconds MAX_SPIN_THRESHOLD{ 4000000 };
+
+    // Sleep, then yield, until a point in time
+    void WaitUntil(Clock::time_point deadline);
+
+    // Add a frame time to the smoothing window
+    void AddFrameTime(float frameTime);
+
+    // Target frame rate and the matching period (zero for unlimited)
+    float m_targetFrameRate;
+    std::chrono::nanoseconds m_period;
+
+    // Start of the current frame and deadline of the next one
+    Clock::time_point m_frameStart;
+    Clock::time_point m_nextDeadline;
+
+    // Remaining time below which waiting stops sleeping
+    std::chrono::nanoseconds m_spinThreshold;
+
+    // Recent frame times in seconds
+    std::array<float, SMOOTHING_WINDOW> m_frameTimes;
+    std::size_t m_frameTimeIndex;
+    std::size_t m_frameTimeCount;
+    float m_smoothedDeltaTime;
+};
+
+// Implementation
+
+inline FramePacer::FramePacer()
+    : m_targetFrameRate(0.0f)
+    , m_period(0)
+    , m_spinThreshold(MIN_SPIN_THRESHOLD)
+    , m_frameTimes()
+    , m_frameTimeIndex(0)
+    , m_frameTimeCount(0)
+    , m_smoothedDeltaTime(0.0f)
+{
+    Reset();
+}
+
+inline void FramePacer::SetTargetFrameRate(float targetFrameRate) {
+    m_targetFrameRate = targetFrameRate > 0.0f ? targetFrameRate : 0.0f;
+    m_period = m_targetFrameRate > 0.0f
+        ? std::chrono::nanoseconds(static_cast<long long>(1000000000.0 / m_targetFrameRate))
+        : std::chrono::nanoseconds(0);
+    m_nextDeadline = m_frameStart + m_period;
+}
+
+inline void FramePacer::Reset() {
+    m_frameStart = Clock::now();
+    m_nextDeadline = m_frameStart + m_period;
+    m_frameTimeIndex = 0;
+    m_frameTimeCount = 0;
+    m_smoothedDeltaTime = 0.0f;
+}
+
+inline std::chrono::nanoseconds FramePacer::BeginFrame() {
+    if (m_period.count() > 0) {
+        WaitUntil(m_nextDeadline);
+
+        // Keep the cadence after a late wake-up, but restart it after a stall
+        m_nextDeadline += m_period;
+        const Clock::time_point now = Clock::now();
+        if (m_nextDeadline < now) {
+            m_nextDeadline = now + m_period;
+        }
+    }
+
+    const Clock::time_point frameStart = Clock::now();
+    const std::chrono::nanoseconds frameTime = std::chrono::duration_cast<std::chrono::nanoseconds>(frameStart - m_frameStart);
+    m_frameStart = frameStart;
+
+    AddFrameTime(frameTime.count() / 1000000000.0f);
+    return frameTime;
+}
+
+inline void FramePacer::WaitUntil(Clock::time_point deadline) {
+    for (;;) {
+        const Clock::time_point now = Clock::now();
+        const std::chrono::nanoseconds remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+        if (remaining.count() <= 0) {
+            return;
+        }
+
+        if (remaining <= m_spinThreshold) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const std::chrono::nanoseconds request = remaining - m_spinThreshold;
+        std::this_thread::sleep_for(request);
+
+        // Grow the spin window to the overshoot at once, shrink it by 1/16 per sleep
+        const std::chrono::nanoseconds slept = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - now);
+        const std::chrono::nanoseconds wanted = std::max(slept - request + SPIN_MARGIN, m_spinThreshold - m_spinThreshold / 16);
+        m_spinThreshold = std::clamp(wanted, MIN_SPIN_THRESHOLD, MAX_SPIN_THRESHOLD);
+    }
+}
+
+inline void FramePacer::AddFrameTime(float frameTime) {
+    m_frameTimes[m_frameTimeIndex] = std::min(frameTime, MAX_SMOOTHED_FRAME_TIME);
+    m_frameTimeIndex = (m_frameTimeIndex + 1) % SMOOTHING_WINDOW;
+    m_frameTimeCount = std::min(m_frameTimeCount + 1, SMOOTHING_WINDOW);
+
+    float total = 0.0f;
+    for (std::size_t i = 0; i < m_frameTimeCount; ++i) {
+        total += m_frameTimes[i];
+    }
+    m_smoothedDeltaTime = total / m_frameTimeCount;
+}
+
+} // namespace CHULUBME
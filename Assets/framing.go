@@ -0,0 +1,223 @@
+package network
+
+import (
+    "bufio"
+    "encoding/binary"
+    "encoding/json"
+    "errors"
+    "io"
+    "math"
+)
+
+// Frame layout (little-endian), shared with the C++ client's chain_frame.h:
+//
+//   u32 length of everything after it
+//   u8  frame kind
+//   body
+//
+// Message body:     u16-prefixed type, u16-prefixed sender, i64 time, content as JSON (rest of frame)
+// Play score body:  u16-prefixed sender, i64 time, u16 count, count x (u16-prefixed address, f64 activity)
+const (
+    FrameMessage    byte = 1
+    FramePlayScores byte = 2
+)
+
+// MessageTypePlayScores is the message type decoded play score frames are delivered as
+const MessageTypePlayScores = "play_scores"
+
+// maxFrameSize bounds the frames a peer may send
+const maxFrameSize = 1 << 20
+
+// maxFieldLength bounds strings written with a u16 prefix
+const maxFieldLength = math.MaxUint16
+
+var (
+    ErrFrameTooLarge = errors.New("frame too large")
+    ErrFieldTooLong  = errors.New("frame field too long")
+    ErrInvalidFrame  = errors.New("invalid frame")
+)
+
+// PlayScoreUpdate is one player's activity reported by a game node
+type PlayScoreUpdate struct {
+    Address  string  `json:"address"`
+    Activity float64 `json:"activity"`
+}
+
+// EncodeMessage encodes a message as one complete frame
+func EncodeMessage(message Message) ([]byte, error) {
+    content := message.rawContent
+    if content == nil {
+        var err error
+        content, err = json.Marshal(message.Content)
+        if err != nil {
+            return nil, err
+        }
+    }
+    
+    if len(message.Type) > maxFieldLength || len(message.Sender) > maxFieldLength {
+        return nil, ErrFieldTooLong
+    }
+    
+    size := 1 + 2 + len(message.Type) + 2 + len(message.Sender) + 8 + len(content)
+    if size > maxFrameSize {
+        return nil, ErrFrameTooLarge
+    }
+    
+    frame := make([]byte, 0, 4+size)
+    frame = binary.LittleEndian.AppendUint32(frame, uint32(size))
+    frame = append(frame, FrameMessage)
+    frame = appendString(frame, message.Type)
+    frame = appendString(frame, message.Sender)
+    frame = binary.LittleEndian.AppendUint64(frame, uint64(message.Time))
+    frame = append(frame, content...)
+    
+    return frame, nil
+}
+
+// EncodePlayScores encodes a batch of play score updates as one compact frame
+func EncodePlayScores(sender string, time int64, updates []PlayScoreUpdate) ([]byte, error) {
+    if len(sender) > maxFieldLength || len(updates) > maxFieldLength {
+        return nil, ErrFieldTooLong
+    }
+    
+    size := 1 + 2 + len(sender) + 8 + 2
+    for _, update := range updates {
+        if len(update.Address) > maxFieldLength {
+            return nil, ErrFieldTooLong
+        }
+        size += 2 + len(update.Address) + 8
+    }
+    if size > maxFrameSize {
+        return nil, ErrFrameTooLarge
+    }
+    
+    frame := make([]byte, 0, 4+size)
+    frame = binary.LittleEndian.AppendUint32(frame, uint32(size))
+    frame = append(frame, FramePlayScores)
+    frame = appendString(frame, sender)
+    frame = binary.LittleEndian.AppendUint64(frame, uint64(time))
+    frame = binary.LittleEndian.AppendUint16(frame, uint16(len(updates)))
+    for _, update := range updates {
+        frame = appendString(frame, update.Address)
+        frame = binary.LittleEndian.AppendUint64(frame, math.Float64bits(update.Activity))
+    }
+    
+    return frame, nil
+}
+
+// readFrame reads one frame, reusing buffer when it is large enough; returns the frame and the buffer to reuse
+func readFrame(reader *bufio.Reader, buffer []byte) ([]byte, []byte, error) {
+    var header [4]byte
+    if _, err := io.ReadFull(reader, header[:]); err != nil {
+        return nil, buffer, err
+    }
+    
+    size := binary.LittleEndian.Uint32(header[:])
+    if size == 0 || size > maxFrameSize {
+        return nil, buffer, ErrFrameTooLarge
+    }
+    
+    if cap(buffer) < int(size) {
+        buffer = make([]byte, size)
+    }
+    frame := buffer[:size]
+    if _, err := io.ReadFull(reader, frame); err != nil {
+        return nil, buffer, err
+    }
+    
+    return frame, buffer, nil
+}
+
+// decodeFrame decodes a frame read by readFrame; the message does not reference the frame
+func decodeFrame(frame []byte) (Message, error) {
+    decoder := frameDecoder{data: frame[1:]}
+    
+    switch frame[0] {
+    case FrameMessage:
+        message := Message{
+            Type:   decoder.string(),
+            Sender: decoder.string(),
+            Time:   int64(decoder.uint64()),
+        }
+        if decoder.failed {
+            return Message{}, ErrInvalidFrame
+        }
+        
+        // Keep the encoded content so it can be forwarded without encoding it again
+        message.rawContent = append(json.RawMessage{}, decoder.data...)
+        if len(message.rawContent) > 0 {
+            if err := json.Unmarshal(message.rawContent, &message.Content); err != nil {
+                return Message{}, err
+            }
+        }
+        return message, nil
+    
+    case FramePlayScores:
+        message := Message{
+            Type:   MessageTypePlayScores,
+            Sender: decoder.string(),
+            Time:   int64(decoder.uint64()),
+        }
+        count := int(decoder.uint16())
+        
+        updates := make([]PlayScoreUpdate, 0, count)
+        for i := 0; i < count && !decoder.failed; i++ {
+            address := decoder.string()
+            activity := math.Float64frombits(decoder.uint64())
+            updates = append(updates, PlayScoreUpdate{Address: address, Activity: activity})
+        }
+        if decoder.failed || len(decoder.data) != 0 {
+            return Message{}, ErrInvalidFrame
+        }
+        
+        message.Content = updates
+        return message, nil
+    }
+    
+    return Message{}, ErrInvalidFrame
+}
+
+// appendString appends a u16 length-prefixed string
+func appendString(frame []byte, value string) []byte {
+    frame = binary.LittleEndian.AppendUint16(frame, uint16(len(value)))
+    return append(frame, value...)
+}
+
+// frameDecoder reads frame fields, failing once any read runs past the end
+type frameDecoder struct {
+    data   []byte
+    failed bool
+}
+
+// take returns the next size bytes
+func (d *frameDecoder) take(size int) []byte {
+    if d.failed || len(d.data) < size {
+        d.failed = true
+        return nil
+    }
+    
+    value := d.data[:size]
+    d.data = d.data[size:]
+    return value
+}
+
+// uint16 reads a little-endian u16
+func (d *frameDecoder) uint16() uint16 {
+    if value := d.take(2); value != nil {
+        return binary.LittleEndian.Uint16(value)
+    }
+    return 0
+}
+
+// uint64 reads a little-endian u64
+func (d *frameDecoder) uint64() uint64 {
+    if value := d.take(8); value != nil {
+        return binary.LittleEndian.Uint64(value)
+    }
+    return 0
+}
+
+// string reads a u16 length-prefixed string
+func (d *frameDecoder) string() string {
+    return string(d.take(int(d.uint16())))
+}
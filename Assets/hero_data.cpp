@@ -0,0 +1,215 @@
+#include "hero_data.h"
+#include <algorithm>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CHULUBME {
+
+namespace {
+
+// Check that a table of count elements of a type fits at an offset
+template<typename T>
+bool IsValidTable(std::size_t size, std::uint32_t offset, std::uint32_t count) {
+    return offset % alignof(std::uint32_t) == 0 &&
+           offset <= size &&
+           static_cast<std::uint64_t>(count) * sizeof(T) <= size - offset;
+}
+
+} // namespace
+
+// HeroDataFile implementation
+HeroDataFile::HeroDataFile()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_mapping(nullptr)
+    , m_header(nullptr)
+    , m_heroes(nullptr)
+    , m_abilities(nullptr)
+    , m_abilityIndex(nullptr)
+    , m_strings(nullptr)
+{
+}
+
+HeroDataFile::~HeroDataFile() {
+    Close();
+}
+
+bool HeroDataFile::Open(const std::string& filename) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    CloseHandle(file);
+    if (!mapping) {
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view) {
+        return false;
+    }
+
+    m_size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    const int file = open(filename.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+
+    struct stat fileStat;
+    void* view = MAP_FAILED;
+    if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0) {
+        view = mmap(nullptr, static_cast<std::size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    }
+
+    // The mapping keeps the file alive
+    close(file);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+
+    m_size = static_cast<std::size_t>(fileStat.st_size);
+#endif
+
+    m_mapping = view;
+    m_data = static_cast<const unsigned char*>(view);
+
+    if (!Validate()) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool HeroDataFile::Open(std::vector<unsigned char> data) {
+    Close();
+
+    m_buffer = std::move(data);
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+
+    if (!Validate()) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void HeroDataFile::Close() {
+    if (m_mapping) {
+#ifdef _WIN32
+        UnmapViewOfFile(m_mapping);
+#else
+        munmap(m_mapping, m_size);
+#endif
+        m_mapping = nullptr;
+    }
+
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+    m_data = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_heroes = nullptr;
+    m_abilities = nullptr;
+    m_abilityIndex = nullptr;
+    m_strings = nullptr;
+}
+
+const HeroRecord* HeroDataFile::FindHero(std::string_view heroId) const {
+    const HeroRecord* end = m_heroes + GetHeroCount();
+    const HeroRecord* it = std::lower_bound(m_heroes, end, heroId, [this](const HeroRecord& hero, std::string_view id) {
+        return GetString(hero.id) < id;
+    });
+    return it != end && GetString(it->id) == heroId ? it : nullptr;
+}
+
+const AbilityRecord* HeroDataFile::FindAbility(std::string_view abilityId) const {
+    const std::uint32_t* end = m_abilityIndex + GetAbilityCount();
+    const std::uint32_t* it = std::lower_bound(m_abilityIndex, end, abilityId, [this](std::uint32_t index, std::string_view id) {
+        return GetString(m_abilities[index].id) < id;
+    });
+    return it != end && GetString(m_abilities[*it].id) == abilityId ? &m_abilities[*it] : nullptr;
+}
+
+bool HeroDataFile::IsCompiledFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    std::uint32_t magic = 0;
+    if (!file.read(reinterpret_cast<char*>(&magic), sizeof(magic))) {
+        return false;
+    }
+    return magic == HERO_DATA_MAGIC;
+}
+
+bool HeroDataFile::Validate() {
+    if (m_size < sizeof(HeroDataHeader)) {
+        return false;
+    }
+
+    const HeroDataHeader* header = reinterpret_cast<const HeroDataHeader*>(m_data);
+    if (header->magic != HERO_DATA_MAGIC || header->version != HERO_DATA_VERSION || header->fileSize != m_size) {
+        return false;
+    }
+
+    // Every table must lie inside the file
+    if (!IsValidTable<HeroRecord>(m_size, header->heroOffset, header->heroCount) ||
+        !IsValidTable<AbilityRecord>(m_size, header->abilityOffset, header->abilityCount) ||
+        !IsValidTable<std::uint32_t>(m_size, header->abilityIndexOffset, header->abilityCount) ||
+        !IsValidTable<char>(m_size, header->stringTableOffset, header->stringTableSize)) {
+        return false;
+    }
+
+    m_heroes = reinterpret_cast<const HeroRecord*>(m_data + header->heroOffset);
+    m_abilities = reinterpret_cast<const AbilityRecord*>(m_data + header->abilityOffset);
+    m_abilityIndex = reinterpret_cast<const std::uint32_t*>(m_data + header->abilityIndexOffset);
+    m_strings = reinterpret_cast<const char*>(m_data + header->stringTableOffset);
+    m_header = header;
+
+    // Check every reference up front so the accessors need no checks
+    for (std::uint32_t i = 0; i < header->heroCount; ++i) {
+        const HeroRecord& hero = m_heroes[i];
+        if (!IsValidString(hero.id) || !IsValidString(hero.name) || !IsValidString(hero.description) ||
+            hero.firstAbility > header->abilityCount || hero.abilityCount > header->abilityCount - hero.firstAbility) {
+            return false;
+        }
+    }
+
+    for (std::uint32_t i = 0; i < header->abilityCount; ++i) {
+        const AbilityRecord& ability = m_abilities[i];
+        if (!IsValidString(ability.id) || !IsValidString(ability.name) ||
+            !IsValidString(ability.description) || !IsValidString(ability.type) ||
+            m_abilityIndex[i] >= header->abilityCount) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool HeroDataFile::IsValidString(const HeroDataString& string) const {
+    const std::uint32_t tableSize = m_header->stringTableSize;
+    return string.offset < tableSize &&
+           string.length < tableSize - string.offset &&
+           m_strings[string.offset + string.length] == '\0';
+}
+
+} // namespace CHULUBME
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "hero_system.h"
+
+namespace CHULUBME {
+
+// First four bytes of a compiled hero data file ("CHHD")
+constexpr std::uint32_t HERO_DATA_MAGIC = 0x44484843u;
+
+// Layout version; files written with another version must be recompiled
+constexpr std::uint32_t HERO_DATA_VERSION = 1;
+
+/**
+ * @brief String in the string table of compiled hero data
+ *
+ * Strings are stored NUL-terminated; the length excludes the terminator.
+ */
+struct HeroDataString {
+    std::uint32_t offset;
+    std::uint32_t length;
+};
+
+/**
+ * @brief Header at the start of compiled hero data
+ *
+ * Offsets are in bytes from the start of the file. Tables are 4-byte aligned
+ * and stored in native (little-endian) byte order.
+ */
+struct HeroDataHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t fileSize;
+
+    // Heroes, sorted by ID
+    std::uint32_t heroCount;
+    std::uint32_t heroOffset;
+
+    // Abilities, grouped by hero, and their indices sorted by ID
+    std::uint32_t abilityCount;
+    std::uint32_t abilityOffset;
+    std::uint32_t abilityIndexOffset;
+
+    // String table
+    std::uint32_t stringTableOffset;
+    std::uint32_t stringTableSize;
+};
+
+/**
+ * @brief Hero definition in compiled hero data
+ */
+struct HeroRecord {
+    HeroDataString id;
+    HeroDataString name;
+    HeroDataString description;
+    std::int32_t role;
+    std::int32_t difficulty;
+    HeroStats stats;
+
+    // Range of this hero's abilities in the ability table
+    std::uint32_t firstAbility;
+    std::uint32_t abilityCount;
+};
+
+/**
+ * @brief Ability definition in compiled hero data
+ */
+struct AbilityRecord {
+    HeroDataString id;
+    HeroDataString name;
+    HeroDataString description;
+    HeroDataString type;
+    float cooldown;
+    float manaCost;
+    float range;
+    std::int32_t level;
+    AbilityParameters parameters;
+};
+
+static_assert(std::is_trivially_copyable<HeroRecord>::value && std::is_standard_layout<HeroRecord>::value,
+              "HeroRecord is read in place from mapped files");
+static_assert(std::is_trivially_copyable<AbilityRecord>::value && std::is_standard_layout<AbilityRecord>::value,
+              "AbilityRecord is read in place from mapped files");
+
+/**
+ * @brief Read-only view of compiled hero data
+ *
+ * The file is memory-mapped and its records are used in place: opening it
+ * validates the header, table bounds and string references once, and the
+ * accessors then read without copying or parsing. Heroes are looked up by ID
+ * with a binary search over the sorted hero table, abilities through a
+ * sorted index. Strings returned by the accessors stay valid until the file
+ * is closed.
+ *
+ * Compiled files are replaced by renaming a new file over them, so a mapping
+ * that is still open keeps reading the old contents until it is closed.
+ */
+class HeroDataFile {
+public:
+    HeroDataFile();
+    ~HeroDataFile();
+
+    // Deleted copy constructor and assignment operator
+    HeroDataFile(const HeroDataFile&) = delete;
+    HeroDataFile& operator=(const HeroDataFile&) = delete;
+
+    // Map and validate a compiled file
+    bool Open(const std::string& filename);
+
+    // Validate compiled data held in memory (the file keeps the buffer)
+    bool Open(std::vector<unsigned char> data);
+
+    // Unmap the file
+    void Close();
+
+    // Check if a file is open
+    bool IsOpen() const { return m_header != nullptr; }
+
+    // Get the number of heroes
+    std::uint32_t GetHeroCount() const { return m_header ? m_header->heroCount : 0; }
+
+    // Get a hero by index (in ID order)
+    const HeroRecord& GetHero(std::uint32_t index) const { return m_heroes[index]; }
+
+    // Find a hero by ID
+    const HeroRecord* FindHero(std::string_view heroId) const;
+
+    // Get the number of abilities
+    std::uint32_t GetAbilityCount() const { return m_header ? m_header->abilityCount : 0; }
+
+    // Get an ability by index
+    const AbilityRecord& GetAbility(std::uint32_t index) const { return m_abilities[index]; }
+
+    // Find an ability by ID
+    const AbilityRecord* FindAbility(std::string_view abilityId) const;
+
+    // Get a string from the string table
+    std::string_view GetString(const HeroDataString& string) const { return std::string_view(m_strings + string.offset, string.length); }
+
+    // Check if a file starts with the compiled hero data magic
+    static bool IsCompiledFile(const std::string& filename);
+
+private:
+    // Check the data and set the table pointers
+    bool Validate();
+
+    // Check a string reference against the string table
+    bool IsValidString(const HeroDataString& string) const;
+
+    // Mapped file or in-memory copy
+    const unsigned char* m_data;
+    std::size_t m_size;
+    void* m_mapping;
+    std::vector<unsigned char> m_buffer;
+
+    // Tables inside the data
+    const HeroDataHeader* m_header;
+    const HeroRecord* m_heroes;
+    const AbilityRecord* m_abilities;
+    const std::uint32_t* m_abilityIndex;
+    const char* m_strings;
+};
+
+/**
+ * @brief Offline compiler from the JSON hero schema to compiled hero data
+ *
+ * JSON stays the authoring format (HeroEditor reads and writes it); servers
+ * and clients load the compiled output. Unknown keys are ignored and missing
+ * ones take the defaults of HeroStats and AbilityParameters.
+ */
+class HeroDataCompiler {
+public:
+    // Compile JSON hero data text into a compiled image
+    static bool Compile(const std::string& json, std::vector<unsigned char>& output);
+
+    // Compile a JSON file; the output is written beside the target and renamed over it
+    static bool CompileFile(const std::string& jsonFilename, const std::string& outputFilename);
+};
+
+} // namespace CHULUBME
@@ -0,0 +1,250 @@
+#include "hero_data.h"
+#include <json/json.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace CHULUBME {
+
+namespace {
+
+/**
+ * @brief Builds the string table, storing each distinct string once
+ */
+class StringTableBuilder {
+public:
+    // Add a string and get its reference
+    HeroDataString Add(const std::string& value) {
+        const std::uint32_t length = static_cast<std::uint32_t>(value.size());
+        auto it = m_offsets.find(value);
+        if (it != m_offsets.end()) {
+            return HeroDataString{ it->second, length };
+        }
+
+        const std::uint32_t offset = static_cast<std::uint32_t>(m_data.size());
+        m_data.insert(m_data.end(), value.begin(), value.end());
+        m_data.push_back('\0');
+        m_offsets.emplace(value, offset);
+        return HeroDataString{ offset, length };
+    }
+
+    // Get the table contents
+    const std::vector<char>& GetData() const { return m_data; }
+
+private:
+    std::vector<char> m_data;
+    std::unordered_map<std::string, std::uint32_t> m_offsets;
+};
+
+// Round an offset up to the table alignment
+std::size_t AlignOffset(std::size_t offset) {
+    return (offset + alignof(std::uint32_t) - 1) & ~(alignof(std::uint32_t) - 1);
+}
+
+// Read hero stats, keeping the defaults for missing keys
+HeroStats ReadStats(const Json::Value& statsData) {
+    HeroStats stats;
+    stats.health = statsData.get("health", stats.health).asFloat();
+    stats.mana = statsData.get("mana", stats.mana).asFloat();
+    stats.attackDamage = statsData.get("attackDamage", stats.attackDamage).asFloat();
+    stats.abilityPower = statsData.get("abilityPower", stats.abilityPower).asFloat();
+    stats.armor = statsData.get("armor", stats.armor).asFloat();
+    stats.magicResist = statsData.get("magicResist", stats.magicResist).asFloat();
+    stats.attackSpeed = statsData.get("attackSpeed", stats.attackSpeed).asFloat();
+    stats.movementSpeed = statsData.get("movementSpeed", stats.movementSpeed).asFloat();
+    stats.healthRegen = statsData.get("healthRegen", stats.healthRegen).asFloat();
+    stats.manaRegen = statsData.get("manaRegen", stats.manaRegen).asFloat();
+    stats.critChance = statsData.get("critChance", stats.critChance).asFloat();
+    stats.critDamage = statsData.get("critDamage", stats.critDamage).asFloat();
+    stats.lifeSteal = statsData.get("lifeSteal", stats.lifeSteal).asFloat();
+    stats.cooldownReduction = statsData.get("cooldownReduction", stats.cooldownReduction).asFloat();
+
+    stats.healthPerLevel = statsData.get("healthPerLevel", stats.healthPerLevel).asFloat();
+    stats.manaPerLevel = statsData.get("manaPerLevel", stats.manaPerLevel).asFloat();
+    stats.attackDamagePerLevel = statsData.get("attackDamagePerLevel", stats.attackDamagePerLevel).asFloat();
+    stats.abilityPowerPerLevel = statsData.get("abilityPowerPerLevel", stats.abilityPowerPerLevel).asFloat();
+    stats.armorPerLevel = statsData.get("armorPerLevel", stats.armorPerLevel).asFloat();
+    stats.magicResistPerLevel = statsData.get("magicResistPerLevel", stats.magicResistPerLevel).asFloat();
+    stats.attackSpeedPerLevel = statsData.get("attackSpeedPerLevel", stats.attackSpeedPerLevel).asFloat();
+    return stats;
+}
+
+// Read an ability definition
+AbilityRecord ReadAbility(const Json::Value& abilityData, StringTableBuilder& strings) {
+    AbilityRecord record{};
+    record.id = strings.Add(abilityData["id"].asString());
+    record.name = strings.Add(abilityData["name"].asString());
+    record.description = strings.Add(abilityData["description"].asString());
+    record.type = strings.Add(abilityData["type"].asString());
+    record.cooldown = abilityData.get("cooldown", 0.0f).asFloat();
+    record.manaCost = abilityData.get("manaCost", 0.0f).asFloat();
+    record.range = abilityData.get("range", 0.0f).asFloat();
+    record.level = abilityData.get("level", 1).asInt();
+
+    AbilityParameters& parameters = record.parameters;
+    parameters.baseDamage = abilityData.get("baseDamage", parameters.baseDamage).asFloat();
+    parameters.damagePerLevel = abilityData.get("damagePerLevel", parameters.damagePerLevel).asFloat();
+    parameters.apRatio = abilityData.get("apRatio", parameters.apRatio).asFloat();
+    parameters.adRatio = abilityData.get("adRatio", parameters.adRatio).asFloat();
+    parameters.isMagicalDamage = abilityData.get("isMagicalDamage", parameters.isMagicalDamage != 0).asBool() ? 1 : 0;
+    parameters.baseHealing = abilityData.get("baseHealing", parameters.baseHealing).asFloat();
+    parameters.healingPerLevel = abilityData.get("healingPerLevel", parameters.healingPerLevel).asFloat();
+    parameters.radius = abilityData.get("radius", parameters.radius).asFloat();
+    parameters.width = abilityData.get("width", parameters.width).asFloat();
+    parameters.speed = abilityData.get("speed", parameters.speed).asFloat();
+    parameters.duration = abilityData.get("duration", parameters.duration).asFloat();
+    parameters.attackDamageBonus = abilityData.get("attackDamageBonus", parameters.attackDamageBonus).asFloat();
+    parameters.movementSpeedBonus = abilityData.get("movementSpeedBonus", parameters.movementSpeedBonus).asFloat();
+    return record;
+}
+
+} // namespace
+
+// HeroDataCompiler implementation
+bool HeroDataCompiler::Compile(const std::string& json, std::vector<unsigned char>& output) {
+    // Parse JSON
+    Json::Value root;
+    Json::CharReaderBuilder builder;
+    std::string errors;
+    std::istringstream stream(json);
+    if (!Json::parseFromStream(builder, stream, &root, &errors)) {
+        return false;
+    }
+
+    const Json::Value& heroes = root["heroes"];
+    if (!heroes.isArray()) {
+        return false;
+    }
+
+    // Heroes are stored in ID order for binary search; IDs must be unique
+    std::vector<Json::ArrayIndex> heroOrder(heroes.size());
+    std::iota(heroOrder.begin(), heroOrder.end(), 0u);
+    std::stable_sort(heroOrder.begin(), heroOrder.end(), [&heroes](Json::ArrayIndex a, Json::ArrayIndex b) {
+        return heroes[a]["id"].asString() < heroes[b]["id"].asString();
+    });
+    for (std::size_t i = 1; i < heroOrder.size(); ++i) {
+        if (heroes[heroOrder[i - 1]]["id"].asString() == heroes[heroOrder[i]]["id"].asString()) {
+            return false;
+        }
+    }
+
+    StringTableBuilder strings;
+    std::vector<HeroRecord> heroRecords;
+    std::vector<AbilityRecord> abilityRecords;
+    heroRecords.reserve(heroOrder.size());
+
+    for (Json::ArrayIndex index : heroOrder) {
+        const Json::Value& heroData = heroes[index];
+
+        HeroRecord record{};
+        record.id = strings.Add(heroData["id"].asString());
+        record.name = strings.Add(heroData["name"].asString());
+        record.description = strings.Add(heroData["description"].asString());
+        record.role = heroData.get("role", 0).asInt();
+        record.difficulty = heroData.get("difficulty", 1).asInt();
+        record.stats = ReadStats(heroData["stats"]);
+
+        // A hero's abilities are stored together, in authored order
+        const Json::Value& abilities = heroData["abilities"];
+        record.firstAbility = static_cast<std::uint32_t>(abilityRecords.size());
+        record.abilityCount = abilities.isArray() ? abilities.size() : 0;
+        for (Json::ArrayIndex i = 0; i < record.abilityCount; ++i) {
+            abilityRecords.push_back(ReadAbility(abilities[i], strings));
+        }
+
+        heroRecords.push_back(record);
+    }
+
+    // Index of abilities by ID, for lookups outside a hero
+    std::vector<std::uint32_t> abilityIndex(abilityRecords.size());
+    std::iota(abilityIndex.begin(), abilityIndex.end(), 0u);
+    const std::vector<char>& stringData = strings.GetData();
+    std::stable_sort(abilityIndex.begin(), abilityIndex.end(), [&](std::uint32_t a, std::uint32_t b) {
+        return std::strcmp(stringData.data() + abilityRecords[a].id.offset, stringData.data() + abilityRecords[b].id.offset) < 0;
+    });
+
+    // Lay out the tables
+    HeroDataHeader header{};
+    header.magic = HERO_DATA_MAGIC;
+    header.version = HERO_DATA_VERSION;
+
+    std::size_t size = AlignOffset(sizeof(HeroDataHeader));
+    header.heroCount = static_cast<std::uint32_t>(heroRecords.size());
+    header.heroOffset = static_cast<std::uint32_t>(size);
+    size = AlignOffset(size + heroRecords.size() * sizeof(HeroRecord));
+    header.abilityCount = static_cast<std::uint32_t>(abilityRecords.size());
+    header.abilityOffset = static_cast<std::uint32_t>(size);
+    size = AlignOffset(size + abilityRecords.size() * sizeof(AbilityRecord));
+    header.abilityIndexOffset = static_cast<std::uint32_t>(size);
+    size = AlignOffset(size + abilityIndex.size() * sizeof(std::uint32_t));
+    header.stringTableOffset = static_cast<std::uint32_t>(size);
+    header.stringTableSize = static_cast<std::uint32_t>(stringData.size());
+    size += stringData.size();
+
+    if (size > std::numeric_limits<std::uint32_t>::max()) {
+        return false;
+    }
+    header.fileSize = static_cast<std::uint32_t>(size);
+
+    // Write the tables; the gaps stay zero
+    output.assign(size, 0);
+    std::memcpy(output.data(), &header, sizeof(header));
+    if (!heroRecords.empty()) {
+        std::memcpy(output.data() + header.heroOffset, heroRecords.data(), heroRecords.size() * sizeof(HeroRecord));
+    }
+    if (!abilityRecords.empty()) {
+        std::memcpy(output.data() + header.abilityOffset, abilityRecords.data(), abilityRecords.size() * sizeof(AbilityRecord));
+        std::memcpy(output.data() + header.abilityIndexOffset, abilityIndex.data(), abilityIndex.size() * sizeof(std::uint32_t));
+    }
+    if (!stringData.empty()) {
+        std::memcpy(output.data() + header.stringTableOffset, stringData.data(), stringData.size());
+    }
+
+    return true;
+}
+
+bool HeroDataCompiler::CompileFile(const std::string& jsonFilename, const std::string& outputFilename) {
+    // Read the JSON source
+    std::ifstream input(jsonFilename);
+    if (!input.is_open()) {
+        return false;
+    }
+    std::stringstream json;
+    json << input.rdbuf();
+
+    std::vector<unsigned char> output;
+    if (!Compile(json.str(), output)) {
+        return false;
+    }
+
+    // Write beside the target, then replace it, so open mappings never see a partial file
+    const std::string tempFilename = outputFilename + ".tmp";
+    {
+        std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !file.write(reinterpret_cast<const char*>(output.data()), output.size())) {
+            return false;
+        }
+    }
+
+#ifdef _WIN32
+    if (!MoveFileExA(tempFilename.c_str(), outputFilename.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+#else
+    if (std::rename(tempFilename.c_str(), outputFilename.c_str()) != 0) {
+#endif
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace CHULUBME
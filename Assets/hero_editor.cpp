@@ -14,7 +14,7 @@ HeroEditor::HeroEditor()
     : m_entityManager(nullptr)
     , m_heroSystem(nullptr)
     , m_abilitySystem(nullptr)
-    , m_selectedHero(0, nullptr)
+    , m_selectedHero(INVALID_ENTITY, nullptr)
     , m_selectedAbility(nullptr)
     , m_showNewHeroPopup(false)
     , m_showNewAbilityPopup(false)
@@ -29,7 +29,7 @@ HeroEditor::~HeroEditor() {
 
 bool HeroEditor::Initialize() {
     // Reset editor state
-    m_selectedHero = Entity(0, nullptr);
+    m_selectedHero = Entity(INVALID_ENTITY, nullptr);
     m_selectedAbility = nullptr;
     m_showNewHeroPopup = false;
     m_showNewAbilityPopup = false;
@@ -130,7 +130,7 @@ void HeroEditor::Render() {
             ImGui::InputFloat("Range", &m_newAbilityData.range);
             
             if (ImGui::Button("Create")) {
-                if (m_selectedHero.IsActive()) {
+                if (m_selectedHero.IsValid()) {
                     HeroComponent* heroComponent = m_selectedHero.GetComponent<HeroComponent>();
                     if (heroComponent) {
                         // Show ability type selector
@@ -183,7 +183,7 @@ void HeroEditor::RenderHeroList() {
         HeroComponent* heroComponent = hero.GetComponent<HeroComponent>();
         if (heroComponent) {
             std::string label = heroComponent->GetHeroName() + " (" + heroComponent->GetHeroID() + ")";
-            bool isSelected = (m_selectedHero.IsActive() && m_selectedHero.GetID() == hero.GetID());
+            bool isSelected = (m_selectedHero.IsValid() && m_selectedHero.GetID() == hero.GetID());
             
             if (ImGui::Selectable(label.c_str(), isSelected)) {
                 m_selectedHero = hero;
@@ -196,7 +196,7 @@ void HeroEditor::RenderHeroList() {
 }
 
 void HeroEditor::RenderHeroDetails() {
-    if (!m_selectedHero.IsActive()) {
+    if (!m_selectedHero.IsValid()) {
         ImGui::Text("No hero selected");
         return;
     }
@@ -261,7 +261,7 @@ void HeroEditor::RenderHeroDetails() {
 }
 
 void HeroEditor::RenderHeroStats() {
-    if (!m_selectedHero.IsActive()) {
+    if (!m_selectedHero.IsValid()) {
         return;
     }
     
@@ -361,7 +361,7 @@ void HeroEditor::RenderHeroStats() {
 }
 
 void HeroEditor::RenderHeroAbilities() {
-    if (!m_selectedHero.IsActive()) {
+    if (!m_selectedHero.IsValid()) {
         return;
     }
     
@@ -1,10 +1,18 @@
 #include "hero_system.h"
+#include "hero_data.h"
 #include "../core/engine.h"
 #include <json/json.h>
 #include <fstream>
 
 namespace CHULUBME {
 
+namespace {
+
+// Directory holding skin textures, named after their skin IDs
+constexpr const char* SKIN_TEXTURE_DIRECTORY = "assets/skins/";
+
+} // namespace
+
 // HeroComponent implementation
 HeroComponent::HeroComponent(const std::string& heroId, const std::string& heroName)
     : m_heroId(heroId)
@@ -17,24 +25,24 @@ HeroComponent::HeroComponent(const std::string& heroId, const std::string& heroN
     , m_currentHealth(0)
     , m_currentMana(0)
     , m_skinId("")
+    , m_entity(INVALID_ENTITY)
+    , m_eventBus(nullptr)
 {
+    RecalculateStats();
 }
 
 void HeroComponent::Initialize() {
     // Initialize current health and mana to max values
-    m_currentHealth = m_baseStats.health;
-    m_currentMana = m_baseStats.mana;
+    m_currentHealth = m_currentStats.health;
+    m_currentMana = m_currentStats.mana;
 }
 
 void HeroComponent::Finalize() {
     // Clear abilities
     m_abilities.clear();
     
-    // Clear callbacks
-    m_damageCallbacks.clear();
-    m_healCallbacks.clear();
-    m_deathCallbacks.clear();
-    m_levelUpCallbacks.clear();
+    // Stop publishing events
+    m_eventBus = nullptr;
 }
 
 void HeroComponent::SetLevel(int level) {
@@ -43,20 +51,22 @@ void HeroComponent::SetLevel(int level) {
     
     int oldLevel = m_level;
     m_level = level;
+    RecalculateStats();
     
     // Notify level change
-    for (auto& callback : m_levelUpCallbacks) {
-        callback(m_level);
+    if (m_eventBus) {
+        m_eventBus->Publish(HeroLevelUpEvent{ m_entity, m_level });
     }
 }
 
 void HeroComponent::LevelUp() {
     if (m_level < 18) { // Max level in most MOBAs
         m_level++;
+        RecalculateStats();
         
         // Update health and mana based on level
-        float maxHealth = GetCurrentStats().health;
-        float maxMana = GetCurrentStats().mana;
+        float maxHealth = m_currentStats.health;
+        float maxMana = m_currentStats.mana;
         
         // Heal for 30% of missing health and mana on level up
         float missingHealth = maxHealth - m_currentHealth;
@@ -66,30 +76,106 @@ void HeroComponent::LevelUp() {
         m_currentMana += missingMana * 0.3f;
         
         // Notify level up
-        for (auto& callback : m_levelUpCallbacks) {
-            callback(m_level);
+        if (m_eventBus) {
+            m_eventBus->Publish(HeroLevelUpEvent{ m_entity, m_level });
+        }
+    }
+}
+
+void HeroComponent::AddStatModifier(const StatModifier& modifier) {
+    if (modifier.stat >= StatType::Count) {
+        return;
+    }
+    
+    m_statModifiers.push_back(modifier);
+    RecalculateStats();
+}
+
+void HeroComponent::RemoveStatModifiers(const void* source) {
+    bool removed = false;
+    for (std::size_t i = m_statModifiers.size(); i-- > 0;) {
+        if (m_statModifiers[i].source == source) {
+            m_statModifiers.erase(m_statModifiers.begin() + i);
+            removed = true;
         }
     }
+    
+    if (removed) {
+        RecalculateStats();
+    }
 }
 
-HeroStats HeroComponent::GetCurrentStats() const {
-    HeroStats currentStats = m_baseStats;
+void HeroComponent::RecalculateStats() {
+    // Modifiable stats in StatType order
+    static float HeroStats::* const statFields[] = {
+        &HeroStats::health,
+        &HeroStats::mana,
+        &HeroStats::attackDamage,
+        &HeroStats::abilityPower,
+        &HeroStats::armor,
+        &HeroStats::magicResist,
+        &HeroStats::attackSpeed,
+        &HeroStats::movementSpeed,
+        &HeroStats::healthRegen,
+        &HeroStats::manaRegen,
+        &HeroStats::critChance,
+        &HeroStats::critDamage,
+        &HeroStats::lifeSteal,
+        &HeroStats::cooldownReduction
+    };
+    static_assert(sizeof(statFields) / sizeof(statFields[0]) == static_cast<std::size_t>(StatType::Count),
+                  "Every StatType needs a HeroStats field");
+    
+    m_currentStats = m_baseStats;
     
     // Apply level-based stat growth
     int levelGrowth = m_level - 1;
     if (levelGrowth > 0) {
-        currentStats.health += m_baseStats.healthPerLevel * levelGrowth;
-        currentStats.mana += m_baseStats.manaPerLevel * levelGrowth;
-        currentStats.attackDamage += m_baseStats.attackDamagePerLevel * levelGrowth;
-        currentStats.abilityPower += m_baseStats.abilityPowerPerLevel * levelGrowth;
-        currentStats.armor += m_baseStats.armorPerLevel * levelGrowth;
-        currentStats.magicResist += m_baseStats.magicResistPerLevel * levelGrowth;
-        currentStats.attackSpeed += m_baseStats.attackSpeedPerLevel * levelGrowth;
+        m_currentStats.health += m_baseStats.healthPerLevel * levelGrowth;
+        m_currentStats.mana += m_baseStats.manaPerLevel * levelGrowth;
+        m_currentStats.attackDamage += m_baseStats.attackDamagePerLevel * levelGrowth;
+        m_currentStats.abilityPower += m_baseStats.abilityPowerPerLevel * levelGrowth;
+        m_currentStats.armor += m_baseStats.armorPerLevel * levelGrowth;
+        m_currentStats.magicResist += m_baseStats.magicResistPerLevel * levelGrowth;
+        m_currentStats.attackSpeed += m_baseStats.attackSpeedPerLevel * levelGrowth;
     }
     
-    // TODO: Apply item stats and buffs
+    // Apply item and buff modifiers: flat bonuses first, then percent bonuses
+    if (!m_statModifiers.empty()) {
+        float flat[static_cast<std::size_t>(StatType::Count)] = {};
+        float percent[static_cast<std::size_t>(StatType::Count)] = {};
+        for (const StatModifier& modifier : m_statModifiers) {
+            const std::size_t stat = static_cast<std::size_t>(modifier.stat);
+            if (modifier.type == StatModifierType::Flat) {
+                flat[stat] += modifier.value;
+            } else {
+                percent[stat] += modifier.value;
+            }
+        }
+        
+        for (std::size_t stat = 0; stat < static_cast<std::size_t>(StatType::Count); ++stat) {
+            float& value = m_currentStats.*statFields[stat];
+            value = (value + flat[stat]) * (1.0f + percent[stat]);
+        }
+    }
     
-    return currentStats;
+    // Refresh the combat fields
+    m_combatStats.attackDamage = m_currentStats.attackDamage;
+    m_combatStats.abilityPower = m_currentStats.abilityPower;
+    m_combatStats.armorMultiplier = GetDamageMultiplier(m_currentStats.armor);
+    m_combatStats.magicMultiplier = GetDamageMultiplier(m_currentStats.magicResist);
+    m_combatStats.maxHealth = m_currentStats.health;
+    m_combatStats.critChance = m_currentStats.critChance;
+    m_combatStats.critDamage = m_currentStats.critDamage;
+    m_combatStats.lifeSteal = m_currentStats.lifeSteal;
+    
+    // Keep health and mana within the new maximums
+    if (m_currentHealth > m_currentStats.health) {
+        m_currentHealth = m_currentStats.health;
+    }
+    if (m_currentMana > m_currentStats.mana) {
+        m_currentMana = m_currentStats.mana;
+    }
 }
 
 void HeroComponent::AddAbility(std::shared_ptr<Ability> ability) {
@@ -103,48 +189,58 @@ std::shared_ptr<Ability> HeroComponent::GetAbility(int index) const {
     return nullptr;
 }
 
+void HeroComponent::LoadPortrait(const std::string& filename) {
+    m_portrait.reset();
+    m_portraitHandle = AssetManager::Instance().LoadTexture(filename);
+}
+
+std::shared_ptr<Texture> HeroComponent::GetPortrait() const {
+    return m_portraitHandle.IsValid() ? AssetManager::Instance().GetTexture(m_portraitHandle) : m_portrait;
+}
+
 void HeroComponent::SetSkin(const std::string& skinId) {
     m_skinId = skinId;
     
-    // TODO: Load skin model and materials
+    // Request the skin texture now so it is resident by the time the hero spawns
+    m_skinTexture = skinId.empty() ? TextureHandle() : AssetManager::Instance().LoadTexture(SKIN_TEXTURE_DIRECTORY + skinId + ".tga");
+    
+    // TODO: Load skin model
 }
 
-float HeroComponent::TakeDamage(float amount, bool isMagical) {
+std::shared_ptr<Texture> HeroComponent::GetSkinTexture() const {
+    return m_skinTexture.IsValid() ? AssetManager::Instance().GetTexture(m_skinTexture) : nullptr;
+}
+
+float HeroComponent::TakeDamage(float amount, bool isMagical, EntityID source) {
     if (amount <= 0) return 0;
     
-    // Calculate damage reduction based on armor or magic resist
-    HeroStats currentStats = GetCurrentStats();
-    float damageReduction;
-    
-    if (isMagical) {
-        // Magic damage reduction formula
-        damageReduction = currentStats.magicResist / (100.0f + currentStats.magicResist);
-    } else {
-        // Physical damage reduction formula
-        damageReduction = currentStats.armor / (100.0f + currentStats.armor);
-    }
-    
-    // Apply damage reduction
-    float actualDamage = amount * (1.0f - damageReduction);
+    // Apply damage reduction based on armor or magic resist
+    float multiplier = isMagical ? m_combatStats.magicMultiplier : m_combatStats.armorMultiplier;
+    return ApplyMitigatedDamage(amount * multiplier, isMagical, source);
+}
+
+float HeroComponent::ApplyMitigatedDamage(float actualDamage, bool isMagical, EntityID source) {
+    if (actualDamage <= 0) return 0;
     
     // Apply damage
+    const bool wasAlive = m_currentHealth > 0;
     m_currentHealth -= actualDamage;
     
+    // Notify damage
+    if (m_eventBus) {
+        m_eventBus->Publish(HeroDamagedEvent{ m_entity, source, actualDamage, isMagical });
+    }
+    
     // Check for death
     if (m_currentHealth <= 0) {
         m_currentHealth = 0;
         
-        // Notify death
-        for (auto& callback : m_deathCallbacks) {
-            callback();
+        // Notify death, once per life
+        if (m_eventBus && wasAlive) {
+            m_eventBus->Publish(HeroDiedEvent{ m_entity, source });
         }
     }
     
-    // Notify damage
-    for (auto& callback : m_damageCallbacks) {
-        callback(actualDamage, isMagical);
-    }
-    
     return actualDamage;
 }
 
@@ -152,7 +248,7 @@ void HeroComponent::Heal(float amount) {
     if (amount <= 0) return;
     
     // Calculate max health
-    float maxHealth = GetCurrentStats().health;
+    float maxHealth = m_currentStats.health;
     
     // Apply healing
     float actualHeal = amount;
@@ -162,9 +258,9 @@ void HeroComponent::Heal(float amount) {
     
     m_currentHealth += actualHeal;
     
-    // Notify healing
-    for (auto& callback : m_healCallbacks) {
-        callback(actualHeal);
+    // Notify healing (regeneration at full health is not reported)
+    if (m_eventBus && actualHeal > 0) {
+        m_eventBus->Publish(HeroHealedEvent{ m_entity, actualHeal });
     }
 }
 
@@ -185,7 +281,7 @@ void HeroComponent::RestoreMana(float amount) {
     if (amount <= 0) return;
     
     // Calculate max mana
-    float maxMana = GetCurrentStats().mana;
+    float maxMana = m_currentStats.mana;
     
     // Apply mana restoration
     float actualRestore = amount;
@@ -196,22 +292,6 @@ void HeroComponent::RestoreMana(float amount) {
     m_currentMana += actualRestore;
 }
 
-void HeroComponent::RegisterDamageCallback(std::function<void(float, bool)> callback) {
-    m_damageCallbacks.push_back(callback);
-}
-
-void HeroComponent::RegisterHealCallback(std::function<void(float)> callback) {
-    m_healCallbacks.push_back(callback);
-}
-
-void HeroComponent::RegisterDeathCallback(std::function<void()> callback) {
-    m_deathCallbacks.push_back(callback);
-}
-
-void HeroComponent::RegisterLevelUpCallback(std::function<void(int)> callback) {
-    m_levelUpCallbacks.push_back(callback);
-}
-
 // Ability implementation
 Ability::Ability(const std::string& abilityId, const std::string& abilityName)
     : m_abilityId(abilityId)
@@ -223,7 +303,7 @@ Ability::Ability(const std::string& abilityId, const std::string& abilityName)
     , m_range(0.0f)
     , m_level(1)
     , m_abilityType(AbilityType::Targeted)
-    , m_owner(0, nullptr)
+    , m_owner(INVALID_ENTITY, nullptr)
 {
 }
 
@@ -254,6 +334,11 @@ bool Ability::Use(Entity caster, Entity target) {
         return false;
     }
     
+    // Check if the caster still exists
+    if (!caster.IsValid()) {
+        return false;
+    }
+    
     // Check if caster has enough mana
     HeroComponent* heroComponent = caster.GetComponent<HeroComponent>();
     if (heroComponent && !heroComponent->UseMana(m_manaCost)) {
@@ -281,6 +366,9 @@ HeroSystem::HeroSystem(EntityManager* manager)
     : System(manager)
 {
     RequireComponent<HeroComponent>();
+
+    // Hero state is simulation state, so it advances on the fixed time step
+    SetFixedStep(true);
 }
 
 void HeroSystem::Initialize() {
@@ -289,18 +377,13 @@ void HeroSystem::Initialize() {
 
 void HeroSystem::Update(float deltaTime) {
     // Update all heroes
-    for (EntityID entityID : GetEntities()) {
-        Entity entity(entityID, m_manager);
-        HeroComponent* heroComponent = entity.GetComponent<HeroComponent>();
-        
+    m_manager->View<HeroComponent>().ForEach([deltaTime](EntityID, HeroComponent& heroComponent) {
         // Update hero logic here
         // For example, health and mana regeneration
-        if (heroComponent) {
-            HeroStats currentStats = heroComponent->GetCurrentStats();
-            heroComponent->Heal(currentStats.healthRegen * deltaTime);
-            heroComponent->RestoreMana(currentStats.manaRegen * deltaTime);
-        }
-    }
+        const HeroStats& currentStats = heroComponent.GetCurrentStats();
+        heroComponent.Heal(currentStats.healthRegen * deltaTime);
+        heroComponent.RestoreMana(currentStats.manaRegen * deltaTime);
+    });
 }
 
 void HeroSystem::OnEntityAdded(Entity entity) {
@@ -308,6 +391,7 @@ void HeroSystem::OnEntityAdded(Entity entity) {
     HeroComponent* heroComponent = entity.GetComponent<HeroComponent>();
     if (heroComponent) {
         m_heroes[heroComponent->GetHeroID()] = entity.GetID();
+        heroComponent->BindEvents(entity.GetID(), &m_manager->GetEventBus());
     }
 }
 
@@ -340,7 +424,7 @@ Entity HeroSystem::GetHeroByID(const std::string& heroId) const {
     if (it != m_heroes.end()) {
         return Entity(it->second, m_manager);
     }
-    return Entity(0, nullptr);
+    return Entity(INVALID_ENTITY, nullptr);
 }
 
 std::vector<Entity> HeroSystem::GetAllHeroes() const {
@@ -352,6 +436,18 @@ std::vector<Entity> HeroSystem::GetAllHeroes() const {
 }
 
 bool HeroSystem::LoadHeroData(const std::string& filename) {
+    // Compiled hero data is mapped instead of parsed
+    if (HeroDataFile::IsCompiledFile(filename)) {
+        if (!LoadCompiledHeroData(filename)) {
+            return false;
+        }
+        
+        for (std::uint32_t i = 0; i < m_heroData->GetHeroCount(); ++i) {
+            CreateHeroFromDefinition(std::string(m_heroData->GetString(m_heroData->GetHero(i).id)));
+        }
+        return true;
+    }
+
     // Open file
     std::ifstream file(filename);
     if (!file.is_open()) {
@@ -475,11 +571,54 @@ bool HeroSystem::SaveHeroData(const std::string& filename) const {
     return true;
 }
 
+bool HeroSystem::LoadCompiledHeroData(const std::string& filename) {
+    std::shared_ptr<HeroDataFile> heroData = std::make_shared<HeroDataFile>();
+    if (!heroData->Open(filename)) {
+        return false;
+    }
+    
+    m_heroData = heroData;
+    return true;
+}
+
+Entity HeroSystem::CreateHeroFromDefinition(const std::string& heroId) {
+    const HeroRecord* record = m_heroData ? m_heroData->FindHero(heroId) : nullptr;
+    if (!record) {
+        return Entity(INVALID_ENTITY, nullptr);
+    }
+    
+    const HeroDataFile& heroData = *m_heroData;
+    Entity hero = CreateHero(heroId, std::string(heroData.GetString(record->name)));
+    HeroComponent* heroComponent = hero.GetComponent<HeroComponent>();
+    
+    // Set hero properties
+    heroComponent->SetDescription(std::string(heroData.GetString(record->description)));
+    heroComponent->SetRole(static_cast<HeroComponent::HeroRole>(record->role));
+    heroComponent->SetDifficulty(record->difficulty);
+    heroComponent->SetBaseStats(record->stats);
+    
+    // Create abilities, skipping types that are not registered
+    AbilitySystem* abilitySystem = m_manager->GetSystem<AbilitySystem>();
+    if (abilitySystem) {
+        for (std::uint32_t i = 0; i < record->abilityCount; ++i) {
+            std::shared_ptr<Ability> ability = abilitySystem->CreateAbility(heroData, heroData.GetAbility(record->firstAbility + i));
+            if (ability) {
+                heroComponent->AddAbility(ability);
+            }
+        }
+    }
+    
+    return hero;
+}
+
 // AbilitySystem implementation
 AbilitySystem::AbilitySystem(EntityManager* manager)
     : System(manager)
 {
     RequireComponent<HeroComponent>();
+
+    // Cooldowns and effects must tick identically on every peer
+    SetFixedStep(true);
 }
 
 void AbilitySystem::Initialize() {
@@ -487,18 +626,13 @@ void AbilitySystem::Initialize() {
 }
 
 void AbilitySystem::Update(float deltaTime) {
-    // Update all abilities
-    for (EntityID entityID : GetEntities()) {
-        Entity entity(entityID, m_manager);
-        HeroComponent* heroComponent = entity.GetComponent<HeroComponent>();
-        
-        if (heroComponent) {
-            // Update all abilities for this hero
-            for (auto& ability : heroComponent->GetAbilities()) {
-                ability->Update(deltaTime);
-            }
+    // Update all abilities, one chunk of heroes per job
+    ParallelForEach<HeroComponent>([deltaTime](EntityCommandBuffer&, EntityID, HeroComponent& heroComponent) {
+        // Update all abilities for this hero
+        for (auto& ability : heroComponent.GetAbilities()) {
+            ability->Update(deltaTime);
         }
-    }
+    });
 }
 
 void AbilitySystem::OnEntityAdded(Entity entity) {
@@ -509,6 +643,24 @@ void AbilitySystem::OnEntityRemoved(Entity entity) {
     // Nothing to do here
 }
 
+std::shared_ptr<Ability> AbilitySystem::CreateAbility(const HeroDataFile& data, const AbilityRecord& record) {
+    std::shared_ptr<Ability> ability = CreateAbility(std::string(data.GetString(record.type)),
+                                                     std::string(data.GetString(record.id)),
+                                                     std::string(data.GetString(record.name)));
+    if (!ability) {
+        return nullptr;
+    }
+    
+    ability->SetDescription(std::string(data.GetString(record.description)));
+    ability->SetCooldown(record.cooldown);
+    ability->SetManaCost(record.manaCost);
+    ability->SetRange(record.range);
+    ability->SetLevel(record.level);
+    ability->SetParameters(record.parameters);
+    
+    return ability;
+}
+
 std::shared_ptr<Ability> AbilitySystem::CreateAbility(const std::string& typeName, const std::string& abilityId, const std::string& abilityName) {
     auto it = m_abilityFactories.find(typeName);
     if (it != m_abilityFactories.end()) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
@@ -7,13 +8,17 @@
 #include <unordered_map>
 
 #include "../core/ecs.h"
+#include "../core/containers.h"
 #include "../rendering/renderer.h"
+#include "../resource/asset_manager.h"
 
 namespace CHULUBME {
 
 // Forward declarations
 class Ability;
 class AbilitySystem;
+class HeroDataFile;
+struct AbilityRecord;
 
 /**
  * @brief Stats for heroes
@@ -70,8 +75,115 @@ struct HeroStats {
     {}
 };
 
+/**
+ * @brief Stats that buffs and items can modify
+ */
+enum class StatType : std::uint8_t {
+    Health,
+    Mana,
+    AttackDamage,
+    AbilityPower,
+    Armor,
+    MagicResist,
+    AttackSpeed,
+    MovementSpeed,
+    HealthRegen,
+    ManaRegen,
+    CritChance,
+    CritDamage,
+    LifeSteal,
+    CooldownReduction,
+    Count
+};
+
+/**
+ * @brief How a modifier changes a stat
+ */
+enum class StatModifierType : std::uint8_t {
+    Flat,       // Added to the leveled base value
+    Percent     // Fraction of the modified value added on top (0.1 = +10%)
+};
+
+/**
+ * @brief Change to one stat from a buff or item
+ */
+struct StatModifier {
+    StatType stat;
+    StatModifierType type;
+    float value;
+    const void* source;
+    
+    // Constructor with default values
+    StatModifier(StatType stat = StatType::Health, StatModifierType type = StatModifierType::Flat,
+                 float value = 0.0f, const void* source = nullptr) :
+        stat(stat),
+        type(type),
+        value(value),
+        source(source)
+    {}
+};
+
+/**
+ * @brief Final stats read on every hit, packed together
+ *
+ * The damage multipliers are the fraction of physical and magic damage that
+ * gets through armor and magic resist.
+ */
+struct CombatStats {
+    float attackDamage;
+    float abilityPower;
+    float armorMultiplier;
+    float magicMultiplier;
+    float maxHealth;
+    float critChance;
+    float critDamage;
+    float lifeSteal;
+};
+
+/**
+ * @brief Published when a hero takes damage
+ */
+struct HeroDamagedEvent {
+    EntityID hero;
+    EntityID source;
+    float amount;
+    bool isMagical;
+};
+
+/**
+ * @brief Published when a hero is healed
+ */
+struct HeroHealedEvent {
+    EntityID hero;
+    float amount;
+};
+
+/**
+ * @brief Published when a hero's health drops to zero
+ */
+struct HeroDiedEvent {
+    EntityID hero;
+    EntityID killer;
+};
+
+/**
+ * @brief Published when a hero's level changes
+ */
+struct HeroLevelUpEvent {
+    EntityID hero;
+    int level;
+};
+
 /**
  * @brief Hero component for MOBA heroes
+ *
+ * Current stats are cached. They are recomputed from the base stats, level
+ * growth and stat modifiers only when one of those changes.
+ *
+ * Damage, healing, death and level changes are published on the event bus
+ * the component is bound to (by HeroSystem when the entity is added), so
+ * listeners subscribe there and receive them in batches. An unbound
+ * component publishes nothing.
  */
 class HeroComponent : public Component {
 public:
@@ -132,13 +244,25 @@ public:
     void LevelUp();
     
     // Set base stats
-    void SetBaseStats(const HeroStats& stats) { m_baseStats = stats; }
+    void SetBaseStats(const HeroStats& stats) { m_baseStats = stats; RecalculateStats(); }
     
     // Get base stats
     const HeroStats& GetBaseStats() const { return m_baseStats; }
     
     // Get current stats (base + items + buffs)
-    HeroStats GetCurrentStats() const;
+    const HeroStats& GetCurrentStats() const { return m_currentStats; }
+    
+    // Get the current stats used in damage calculations
+    const CombatStats& GetCombatStats() const { return m_combatStats; }
+    
+    // Add a stat modifier
+    void AddStatModifier(const StatModifier& modifier);
+    
+    // Remove every stat modifier added by a source
+    void RemoveStatModifiers(const void* source);
+    
+    // Get all stat modifiers
+    const SmallVector<StatModifier, 4>& GetStatModifiers() const { return m_statModifiers; }
     
     // Add ability
     void AddAbility(std::shared_ptr<Ability> ability);
@@ -162,19 +286,37 @@ public:
     std::shared_ptr<Material> GetMaterial() const { return m_material; }
     
     // Set hero portrait
-    void SetPortrait(std::shared_ptr<Texture> portrait) { m_portrait = portrait; }
+    void SetPortrait(std::shared_ptr<Texture> portrait) { m_portrait = portrait; m_portraitHandle = TextureHandle(); }
+    
+    // Load the hero portrait in the background (GetPortrait returns a placeholder until it is ready)
+    void LoadPortrait(const std::string& filename);
     
     // Get hero portrait
-    std::shared_ptr<Texture> GetPortrait() const { return m_portrait; }
+    std::shared_ptr<Texture> GetPortrait() const;
     
-    // Set hero skin (NFT)
+    // Set hero skin (NFT); its texture starts loading in the background
     void SetSkin(const std::string& skinId);
     
     // Get hero skin ID
     std::string GetSkinID() const { return m_skinId; }
     
+    // Get the skin texture, or a placeholder while it loads (nullptr without a skin)
+    std::shared_ptr<Texture> GetSkinTexture() const;
+    
+    // Get current health
+    float GetCurrentHealth() const { return m_currentHealth; }
+    
+    // Get current mana
+    float GetCurrentMana() const { return m_currentMana; }
+    
     // Take damage
-    float TakeDamage(float amount, bool isMagical = false);
+    float TakeDamage(float amount, bool isMagical = false, EntityID source = INVALID_ENTITY);
+    
+    // Take damage already reduced by armor or magic resist
+    float ApplyMitigatedDamage(float actualDamage, bool isMagical, EntityID source = INVALID_ENTITY);
+    
+    // Get the fraction of damage that gets through an armor or magic resist value
+    static float GetDamageMultiplier(float resistance) { return 100.0f / (100.0f + resistance); }
     
     // Heal
     void Heal(float amount);
@@ -185,17 +327,11 @@ public:
     // Restore mana
     void RestoreMana(float amount);
     
-    // Register damage callback
-    void RegisterDamageCallback(std::function<void(float, bool)> callback);
-    
-    // Register heal callback
-    void RegisterHealCallback(std::function<void(float)> callback);
+    // Set health and mana as received from an authoritative server (no events published)
+    void SetReplicatedVitals(float health, float mana) { m_currentHealth = health; m_currentMana = mana; }
     
-    // Register death callback
-    void RegisterDeathCallback(std::function<void()> callback);
-    
-    // Register level up callback
-    void RegisterLevelUpCallback(std::function<void(int)> callback);
+    // Bind the component to its entity and the bus its events are published on
+    void BindEvents(EntityID entity, EventBus* eventBus) { m_entity = entity; m_eventBus = eventBus; }
     
 private:
     // Hero identification
@@ -209,8 +345,14 @@ private:
     int m_level;
     int m_experience;
     
+    // Recompute current stats after base stats, level or modifiers changed
+    void RecalculateStats();
+    
     // Hero stats
     HeroStats m_baseStats;
+    HeroStats m_currentStats;
+    CombatStats m_combatStats;
+    SmallVector<StatModifier, 4> m_statModifiers;
     float m_currentHealth;
     float m_currentMana;
     
@@ -221,13 +363,59 @@ private:
     std::shared_ptr<Mesh> m_model;
     std::shared_ptr<Material> m_material;
     std::shared_ptr<Texture> m_portrait;
+    TextureHandle m_portraitHandle;
     std::string m_skinId;
+    TextureHandle m_skinTexture;
     
-    // Callbacks
-    std::vector<std::function<void(float, bool)>> m_damageCallbacks;
-    std::vector<std::function<void(float)>> m_healCallbacks;
-    std::vector<std::function<void()>> m_deathCallbacks;
-    std::vector<std::function<void(int)>> m_levelUpCallbacks;
+    // Entity and bus the hero's events are published with (none until bound)
+    EntityID m_entity;
+    EventBus* m_eventBus;
+};
+
+/**
+ * @brief Type-specific ability parameters as authored in hero data
+ *
+ * Every ability type reads the fields it uses and ignores the rest. The
+ * struct is stored as is in compiled hero data, so fields are fixed-width.
+ */
+struct AbilityParameters {
+    // Damage
+    float baseDamage;
+    float damagePerLevel;
+    float apRatio;
+    float adRatio;
+    std::uint32_t isMagicalDamage;
+    
+    // Healing (scales with apRatio)
+    float baseHealing;
+    float healingPerLevel;
+    
+    // Shape and travel
+    float radius;
+    float width;
+    float speed;
+    
+    // Buffs
+    float duration;
+    float attackDamageBonus;
+    float movementSpeedBonus;
+    
+    // Constructor with default values
+    AbilityParameters() :
+        baseDamage(0.0f),
+        damagePerLevel(0.0f),
+        apRatio(0.0f),
+        adRatio(0.0f),
+        isMagicalDamage(1),
+        baseHealing(0.0f),
+        healingPerLevel(0.0f),
+        radius(0.0f),
+        width(0.0f),
+        speed(0.0f),
+        duration(0.0f),
+        attackDamageBonus(0.0f),
+        movementSpeedBonus(0.0f)
+    {}
 };
 
 /**
@@ -274,6 +462,9 @@ public:
     // Get current cooldown remaining
     float GetCooldownRemaining() const { return m_cooldownRemaining; }
     
+    // Set remaining cooldown (e.g. as received from an authoritative server)
+    void SetCooldownRemaining(float remaining) { m_cooldownRemaining = remaining > 0.0f ? remaining : 0.0f; }
+    
     // Set ability mana cost
     void SetManaCost(float manaCost) { m_manaCost = manaCost; }
     
@@ -295,6 +486,9 @@ public:
     // Level up the ability
     virtual void LevelUp();
     
+    // Apply the type-specific parameters this ability uses
+    virtual void SetParameters(const AbilityParameters& parameters) {}
+    
     // Check if ability is ready to use
     bool IsReady() const { return m_cooldownRemaining <= 0.0f; }
     
@@ -302,7 +496,7 @@ public:
     virtual void Update(float deltaTime);
     
     // Use the ability
-    virtual bool Use(Entity caster, Entity target = Entity(0, nullptr));
+    virtual bool Use(Entity caster, Entity target = Entity(INVALID_ENTITY, nullptr));
     
     // Use the ability at a position
     virtual bool UseAtPosition(Entity caster, const glm::vec3& position);
@@ -376,9 +570,24 @@ public:
     // Save hero data to file
     bool SaveHeroData(const std::string& filename) const;
     
+    // Map compiled hero definitions without creating heroes (replaces the loaded definitions)
+    bool LoadCompiledHeroData(const std::string& filename);
+    
+    // Create a hero and its abilities from a loaded definition (invalid if the ID is unknown)
+    Entity CreateHeroFromDefinition(const std::string& heroId);
+    
+    // Get the loaded hero definitions (null until compiled data is loaded)
+    std::shared_ptr<const HeroDataFile> GetHeroData() const { return m_heroData; }
+    
+    // Use hero definitions loaded elsewhere (e.g. shared by every match a server hosts)
+    void SetHeroData(std::shared_ptr<const HeroDataFile> heroData) { m_heroData = std::move(heroData); }
+    
 private:
     // Map of hero IDs to entities
     std::unordered_map<std::string, EntityID> m_heroes;
+    
+    // Compiled hero definitions; shared so a reload leaves earlier readers a valid mapping
+    std::shared_ptr<const HeroDataFile> m_heroData;
 };
 
 /**
@@ -408,6 +617,9 @@ public:
     // Create an ability by type name
     std::shared_ptr<Ability> CreateAbility(const std::string& typeName, const std::string& abilityId, const std::string& abilityName);
     
+    // Create an ability from a compiled definition (null if its type is not registered)
+    std::shared_ptr<Ability> CreateAbility(const HeroDataFile& data, const AbilityRecord& record);
+    
     // Load ability data from file
     bool LoadAbilityData(const std::string& filename);
     
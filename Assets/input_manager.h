@@ -1,6 +1,10 @@
 #pragma once
 
-#include <unordered_map>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <vector>
 #include <string>
@@ -8,6 +12,7 @@
 #include <glm/glm.hpp>
 
 #include "../core/ecs.h"
+#include "../core/containers.h"
 
 namespace CHULUBME {
 
@@ -59,8 +64,58 @@ enum class InputMod {
     NumLock = 32
 };
 
+/**
+ * @brief Input event captured by the platform layer
+ */
+struct InputEvent {
+    // Event type
+    enum class Type : std::uint8_t {
+        Key,
+        MouseButton,
+        MouseMove,
+        MouseScroll
+    };
+
+    Type type;
+    InputAction action;
+    InputMod mods;
+    KeyCode key;
+    MouseButton button;
+
+    // Cursor position for moves, offsets for scrolls
+    double x;
+    double y;
+
+    // When the platform layer received the event
+    std::chrono::steady_clock::time_point timestamp;
+
+    // Constructor with default values
+    InputEvent() :
+        type(Type::Key),
+        action(InputAction::Press),
+        mods(InputMod::None),
+        key(KeyCode::Unknown),
+        button(MouseButton::Left),
+        x(0.0),
+        y(0.0),
+        timestamp()
+    {}
+};
+
 /**
  * @brief Input manager class for handling keyboard and mouse input
+ *
+ * Key and button state is kept in bitsets indexed by code. Events can be
+ * applied directly with the Process functions, or buffered: the platform
+ * thread pushes timestamped events into a lock-free queue without blocking,
+ * and the simulation drains it at the start of each fixed tick, so every
+ * tick sees the same input however the frames fall. The drained events stay
+ * available with their timestamps for lag compensation until the next drain.
+ *
+ * Every applied event is also published as an InputEvent on the event bus
+ * set with SetEventBus, so listeners receive a tick's input as one batch.
+ * The Process functions and DrainEvents therefore run on the simulation
+ * thread; the platform thread only pushes.
  */
 class InputManager {
 public:
@@ -76,6 +131,33 @@ public:
     // Update the input state
     void Update();
 
+    // Queue a key event from the platform thread (false if the queue is full)
+    bool PushKeyEvent(KeyCode key, InputAction action, InputMod mods);
+
+    // Queue a mouse button event from the platform thread (false if the queue is full)
+    bool PushMouseButtonEvent(MouseButton button, InputAction action, InputMod mods);
+
+    // Queue a mouse move event from the platform thread (false if the queue is full)
+    bool PushMouseMoveEvent(double xpos, double ypos);
+
+    // Queue a mouse scroll event from the platform thread (false if the queue is full)
+    bool PushMouseScrollEvent(double xoffset, double yoffset);
+
+    // Queue an event with its own timestamp from the platform thread (false if the queue is full)
+    bool PushEvent(const InputEvent& event);
+
+    // Update the input state and apply the events queued so far (once per fixed tick)
+    void DrainEvents();
+
+    // Get the events applied by the last drain, oldest first
+    const std::vector<InputEvent>& GetDrainedEvents() const { return m_drainedEvents; }
+
+    // Get when the last drain ran
+    std::chrono::steady_clock::time_point GetDrainTime() const { return m_drainTime; }
+
+    // Get the number of events dropped because the queue was full
+    std::size_t GetDroppedEventCount() const { return m_droppedEventCount.load(std::memory_order_relaxed); }
+
     // Process a key event
     void ProcessKeyEvent(KeyCode key, InputAction action, InputMod mods);
 
@@ -121,17 +203,8 @@ public:
     // Set whether the cursor is visible
     void SetCursorVisible(bool visible);
 
-    // Register a key callback
-    void RegisterKeyCallback(std::function<void(KeyCode, InputAction, InputMod)> callback);
-
-    // Register a mouse button callback
-    void RegisterMouseButtonCallback(std::function<void(MouseButton, InputAction, InputMod)> callback);
-
-    // Register a mouse move callback
-    void RegisterMouseMoveCallback(std::function<void(double, double)> callback);
-
-    // Register a mouse scroll callback
-    void RegisterMouseScrollCallback(std::function<void(double, double)> callback);
+    // Set the bus applied events are published on (none to stop publishing)
+    void SetEventBus(EventBus* eventBus) { m_eventBus = eventBus; }
 
 private:
     // Private constructor for singleton
@@ -142,15 +215,35 @@ private:
     InputManager(const InputManager&) = delete;
     InputManager& operator=(const InputManager&) = delete;
 
-    // Key state maps
-    std::unordered_map<KeyCode, bool> m_keyStates;
-    std::unordered_map<KeyCode, bool> m_keyJustPressed;
-    std::unordered_map<KeyCode, bool> m_keyJustReleased;
+    // Number of key and mouse button codes with state
+    static constexpr std::size_t KEY_COUNT = 512;
+    static constexpr std::size_t MOUSE_BUTTON_COUNT = 8;
+
+    // Events the platform thread can queue between two drains
+    static constexpr std::size_t EVENT_QUEUE_CAPACITY = 1024;
+
+    // Get the state index of a key or button (out of range for codes without state)
+    static std::size_t KeyIndex(KeyCode key) { return static_cast<std::size_t>(key); }
+    static std::size_t ButtonIndex(MouseButton button) { return static_cast<std::size_t>(button); }
 
-    // Mouse button state maps
-    std::unordered_map<MouseButton, bool> m_mouseButtonStates;
-    std::unordered_map<MouseButton, bool> m_mouseButtonJustPressed;
-    std::unordered_map<MouseButton, bool> m_mouseButtonJustReleased;
+    // Build timestamped events
+    static InputEvent MakeKeyEvent(KeyCode key, InputAction action, InputMod mods);
+    static InputEvent MakeMouseButtonEvent(MouseButton button, InputAction action, InputMod mods);
+    static InputEvent MakeMouseMoveEvent(double xpos, double ypos);
+    static InputEvent MakeMouseScrollEvent(double xoffset, double yoffset);
+
+    // Update the input state with an event and publish it
+    void ApplyEvent(const InputEvent& event);
+
+    // Key states
+    std::bitset<KEY_COUNT> m_keyStates;
+    std::bitset<KEY_COUNT> m_keyJustPressed;
+    std::bitset<KEY_COUNT> m_keyJustReleased;
+
+    // Mouse button states
+    std::bitset<MOUSE_BUTTON_COUNT> m_mouseButtonStates;
+    std::bitset<MOUSE_BUTTON_COUNT> m_mouseButtonJustPressed;
+    std::bitset<MOUSE_BUTTON_COUNT> m_mouseButtonJustReleased;
 
     // Mouse position
     glm::vec2 m_mousePosition;
@@ -160,11 +253,16 @@ private:
     // Mouse scroll
     glm::vec2 m_mouseScrollDelta;
 
-    // Callbacks
-    std::vector<std::function<void(KeyCode, InputAction, InputMod)>> m_keyCallbacks;
-    std::vector<std::function<void(MouseButton, InputAction, InputMod)>> m_mouseButtonCallbacks;
-    std::vector<std::function<void(double, double)>> m_mouseMoveCallbacks;
-    std::vector<std::function<void(double, double)>> m_mouseScrollCallbacks;
+    // Events queued by the platform thread
+    SPSCRingBuffer<InputEvent, EVENT_QUEUE_CAPACITY> m_eventQueue;
+    std::atomic<std::size_t> m_droppedEventCount;
+
+    // Events applied by the last drain, and when it ran
+    std::vector<InputEvent> m_drainedEvents;
+    std::chrono::steady_clock::time_point m_drainTime;
+
+    // Bus applied events are published on
+    EventBus* m_eventBus;
 };
 
 /**
@@ -238,7 +336,10 @@ inline InputManager::InputManager()
     , m_lastMousePosition(0.0f, 0.0f)
     , m_mouseDelta(0.0f, 0.0f)
     , m_mouseScrollDelta(0.0f, 0.0f)
+    , m_droppedEventCount(0)
+    , m_eventBus(nullptr)
 {
+    m_drainedEvents.reserve(EVENT_QUEUE_CAPACITY);
 }
 
 inline InputManager::~InputManager() {
@@ -246,13 +347,20 @@ inline InputManager::~InputManager() {
 }
 
 inline bool InputManager::Initialize() {
-    // Clear all state maps
-    m_keyStates.clear();
-    m_keyJustPressed.clear();
-    m_keyJustReleased.clear();
-    m_mouseButtonStates.clear();
-    m_mouseButtonJustPressed.clear();
-    m_mouseButtonJustReleased.clear();
+    // Clear all states
+    m_keyStates.reset();
+    m_keyJustPressed.reset();
+    m_keyJustReleased.reset();
+    m_mouseButtonStates.reset();
+    m_mouseButtonJustPressed.reset();
+    m_mouseButtonJustReleased.reset();
+
+    // Discard events queued before initialization
+    InputEvent event;
+    while (m_eventQueue.Pop(event)) {
+    }
+    m_drainedEvents.clear();
+    m_droppedEventCount.store(0, std::memory_order_relaxed);
 
     // Reset mouse position and delta
     m_mousePosition = glm::vec2(0.0f, 0.0f);
@@ -264,11 +372,8 @@ inline bool InputManager::Initialize() {
 }
 
 inline void InputManager::Shutdown() {
-    // Clear all callbacks
-    m_keyCallbacks.clear();
-    m_mouseButtonCallbacks.clear();
-    m_mouseMoveCallbacks.clear();
-    m_mouseScrollCallbacks.clear();
+    // Stop publishing events
+    m_eventBus = nullptr;
 }
 
 inline void InputManager::Update() {
@@ -277,95 +382,181 @@ inline void InputManager::Update() {
     m_lastMousePosition = m_mousePosition;
 
     // Clear just pressed and just released flags
-    m_keyJustPressed.clear();
-    m_keyJustReleased.clear();
-    m_mouseButtonJustPressed.clear();
-    m_mouseButtonJustReleased.clear();
+    m_keyJustPressed.reset();
+    m_keyJustReleased.reset();
+    m_mouseButtonJustPressed.reset();
+    m_mouseButtonJustReleased.reset();
 
     // Reset scroll delta
     m_mouseScrollDelta = glm::vec2(0.0f, 0.0f);
 }
 
-inline void InputManager::ProcessKeyEvent(KeyCode key, InputAction action, InputMod mods) {
-    // Update key state
-    if (action == InputAction::Press) {
-        m_keyStates[key] = true;
-        m_keyJustPressed[key] = true;
-    } else if (action == InputAction::Release) {
-        m_keyStates[key] = false;
-        m_keyJustReleased[key] = true;
+inline bool InputManager::PushKeyEvent(KeyCode key, InputAction action, InputMod mods) {
+    return PushEvent(MakeKeyEvent(key, action, mods));
+}
+
+inline bool InputManager::PushMouseButtonEvent(MouseButton button, InputAction action, InputMod mods) {
+    return PushEvent(MakeMouseButtonEvent(button, action, mods));
+}
+
+inline bool InputManager::PushMouseMoveEvent(double xpos, double ypos) {
+    return PushEvent(MakeMouseMoveEvent(xpos, ypos));
+}
+
+inline bool InputManager::PushMouseScrollEvent(double xoffset, double yoffset) {
+    return PushEvent(MakeMouseScrollEvent(xoffset, yoffset));
+}
+
+inline bool InputManager::PushEvent(const InputEvent& event) {
+    if (!m_eventQueue.Push(event)) {
+        m_droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
     }
+    return true;
+}
 
-    // Call key callbacks
-    for (const auto& callback : m_keyCallbacks) {
-        callback(key, action, mods);
+inline void InputManager::DrainEvents() {
+    Update();
+    m_drainedEvents.clear();
+    m_drainTime = std::chrono::steady_clock::now();
+
+    // Only take what was queued when the tick began, so a busy producer cannot stall it
+    std::size_t count = m_eventQueue.Size();
+    InputEvent event;
+    while (count-- > 0 && m_eventQueue.Pop(event)) {
+        m_drainedEvents.push_back(event);
+        ApplyEvent(event);
     }
 }
 
-inline void InputManager::ProcessMouseButtonEvent(MouseButton button, InputAction action, InputMod mods) {
-    // Update mouse button state
-    if (action == InputAction::Press) {
-        m_mouseButtonStates[button] = true;
-        m_mouseButtonJustPressed[button] = true;
-    } else if (action == InputAction::Release) {
-        m_mouseButtonStates[button] = false;
-        m_mouseButtonJustReleased[button] = true;
+inline InputEvent InputManager::MakeKeyEvent(KeyCode key, InputAction action, InputMod mods) {
+    InputEvent event;
+    event.type = InputEvent::Type::Key;
+    event.action = action;
+    event.mods = mods;
+    event.key = key;
+    event.timestamp = std::chrono::steady_clock::now();
+    return event;
+}
+
+inline InputEvent InputManager::MakeMouseButtonEvent(MouseButton button, InputAction action, InputMod mods) {
+    InputEvent event;
+    event.type = InputEvent::Type::MouseButton;
+    event.action = action;
+    event.mods = mods;
+    event.button = button;
+    event.timestamp = std::chrono::steady_clock::now();
+    return event;
+}
+
+inline InputEvent InputManager::MakeMouseMoveEvent(double xpos, double ypos) {
+    InputEvent event;
+    event.type = InputEvent::Type::MouseMove;
+    event.x = xpos;
+    event.y = ypos;
+    event.timestamp = std::chrono::steady_clock::now();
+    return event;
+}
+
+inline InputEvent InputManager::MakeMouseScrollEvent(double xoffset, double yoffset) {
+    InputEvent event;
+    event.type = InputEvent::Type::MouseScroll;
+    event.x = xoffset;
+    event.y = yoffset;
+    event.timestamp = std::chrono::steady_clock::now();
+    return event;
+}
+
+inline void InputManager::ApplyEvent(const InputEvent& event) {
+    switch (event.type) {
+        case InputEvent::Type::Key: {
+            // Update key state
+            const std::size_t index = KeyIndex(event.key);
+            if (index < KEY_COUNT) {
+                if (event.action == InputAction::Press) {
+                    m_keyStates.set(index);
+                    m_keyJustPressed.set(index);
+                } else if (event.action == InputAction::Release) {
+                    m_keyStates.reset(index);
+                    m_keyJustReleased.set(index);
+                }
+            }
+            break;
+        }
+        case InputEvent::Type::MouseButton: {
+            // Update mouse button state
+            const std::size_t index = ButtonIndex(event.button);
+            if (index < MOUSE_BUTTON_COUNT) {
+                if (event.action == InputAction::Press) {
+                    m_mouseButtonStates.set(index);
+                    m_mouseButtonJustPressed.set(index);
+                } else if (event.action == InputAction::Release) {
+                    m_mouseButtonStates.reset(index);
+                    m_mouseButtonJustReleased.set(index);
+                }
+            }
+            break;
+        }
+        case InputEvent::Type::MouseMove:
+            // Update mouse position
+            m_mousePosition = glm::vec2(static_cast<float>(event.x), static_cast<float>(event.y));
+            break;
+        case InputEvent::Type::MouseScroll:
+            // Accumulate the scroll delta until the next update
+            m_mouseScrollDelta += glm::vec2(static_cast<float>(event.x), static_cast<float>(event.y));
+            break;
     }
 
-    // Call mouse button callbacks
-    for (const auto& callback : m_mouseButtonCallbacks) {
-        callback(button, action, mods);
+    // Listeners receive the event with the next dispatch
+    if (m_eventBus) {
+        m_eventBus->Publish(event);
     }
 }
 
-inline void InputManager::ProcessMouseMoveEvent(double xpos, double ypos) {
-    // Update mouse position
-    m_mousePosition = glm::vec2(static_cast<float>(xpos), static_cast<float>(ypos));
+inline void InputManager::ProcessKeyEvent(KeyCode key, InputAction action, InputMod mods) {
+    ApplyEvent(MakeKeyEvent(key, action, mods));
+}
 
-    // Call mouse move callbacks
-    for (const auto& callback : m_mouseMoveCallbacks) {
-        callback(xpos, ypos);
-    }
+inline void InputManager::ProcessMouseButtonEvent(MouseButton button, InputAction action, InputMod mods) {
+    ApplyEvent(MakeMouseButtonEvent(button, action, mods));
 }
 
-inline void InputManager::ProcessMouseScrollEvent(double xoffset, double yoffset) {
-    // Update mouse scroll delta
-    m_mouseScrollDelta = glm::vec2(static_cast<float>(xoffset), static_cast<float>(yoffset));
+inline void InputManager::ProcessMouseMoveEvent(double xpos, double ypos) {
+    ApplyEvent(MakeMouseMoveEvent(xpos, ypos));
+}
 
-    // Call mouse scroll callbacks
-    for (const auto& callback : m_mouseScrollCallbacks) {
-        callback(xoffset, yoffset);
-    }
+inline void InputManager::ProcessMouseScrollEvent(double xoffset, double yoffset) {
+    ApplyEvent(MakeMouseScrollEvent(xoffset, yoffset));
 }
 
 inline bool InputManager::IsKeyPressed(KeyCode key) const {
-    auto it = m_keyStates.find(key);
-    return (it != m_keyStates.end()) ? it->second : false;
+    const std::size_t index = KeyIndex(key);
+    return index < KEY_COUNT && m_keyStates[index];
 }
 
 inline bool InputManager::IsKeyJustPressed(KeyCode key) const {
-    auto it = m_keyJustPressed.find(key);
-    return (it != m_keyJustPressed.end()) ? it->second : false;
+    const std::size_t index = KeyIndex(key);
+    return index < KEY_COUNT && m_keyJustPressed[index];
 }
 
 inline bool InputManager::IsKeyJustReleased(KeyCode key) const {
-    auto it = m_keyJustReleased.find(key);
-    return (it != m_keyJustReleased.end()) ? it->second : false;
+    const std::size_t index = KeyIndex(key);
+    return index < KEY_COUNT && m_keyJustReleased[index];
 }
 
 inline bool InputManager::IsMouseButtonPressed(MouseButton button) const {
-    auto it = m_mouseButtonStates.find(button);
-    return (it != m_mouseButtonStates.end()) ? it->second : false;
+    const std::size_t index = ButtonIndex(button);
+    return index < MOUSE_BUTTON_COUNT && m_mouseButtonStates[index];
 }
 
 inline bool InputManager::IsMouseButtonJustPressed(MouseButton button) const {
-    auto it = m_mouseButtonJustPressed.find(button);
-    return (it != m_mouseButtonJustPressed.end()) ? it->second : false;
+    const std::size_t index = ButtonIndex(button);
+    return index < MOUSE_BUTTON_COUNT && m_mouseButtonJustPressed[index];
 }
 
 inline bool InputManager::IsMouseButtonJustReleased(MouseButton button) const {
-    auto it = m_mouseButtonJustReleased.find(button);
-    return (it != m_mouseButtonJustReleased.end()) ? it->second : false;
+    const std::size_t index = ButtonIndex(button);
+    return index < MOUSE_BUTTON_COUNT && m_mouseButtonJustReleased[index];
 }
 
 inline glm::vec2 InputManager::GetMousePosition() const {
@@ -385,20 +576,4 @@ inline void InputManager::SetMousePosition(double xpos, double ypos) {
     m_lastMousePosition = m_mousePosition;
 }
 
-inline void InputManager::RegisterKeyCallback(std::function<void(KeyCode, InputAction, InputMod)> callback) {
-    m_keyCallbacks.push_back(callback);
-}
-
-inline void InputManager::RegisterMouseButtonCallback(std::function<void(MouseButton, InputAction, InputMod)> callback) {
-    m_mouseButtonCallbacks.push_back(callback);
-}
-
-inline void InputManager::RegisterMouseMoveCallback(std::function<void(double, double)> callback) {
-    m_mouseMoveCallbacks.push_back(callback);
-}
-
-inline void InputManager::RegisterMouseScrollCallback(std::function<void(double, double)> callback) {
-    m_mouseScrollCallbacks.push_back(callback);
-}
-
 } // namespace CHULUBME
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "memory.h"
+#include "profiler.h"
+
+namespace CHULUBME {
+
+/**
+ * @brief Counter tracking the number of unfinished jobs in a group
+ */
+struct JobCounter {
+    std::atomic<std::size_t> pending{0};
+
+    // Check if every job in the group has finished
+    bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+/**
+ * @brief Work-stealing thread pool
+ *
+ * Every worker owns a job queue; it pops its own newest job first and steals
+ * the oldest job from other queues when it runs dry. Threads that do not
+ * belong to the pool submit to a shared queue (index 0). Waiting on a counter
+ * executes pending jobs instead of blocking, so jobs may schedule and wait on
+ * nested jobs.
+ *
+ * A job runs with the frame arena set that was bound where it was scheduled
+ * (see ScopedFrameArenas), so the jobs of several worlds sharing one pool
+ * each allocate frame memory from their own world's arenas.
+ */
+class JobSystem {
+public:
+    // Create a pool with the given number of worker threads (0 for one per extra hardware thread)
+    explicit JobSystem(std::size_t workerThreadCount = 0);
+    ~JobSystem();
+
+    // Deleted copy constructor and assignment operator
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Schedule a job; the counter (if any) is incremented now and decremented when the job finishes
+    void Schedule(std::function<void()> job, JobCounter* counter = nullptr);
+
+    // Wait for every job in a group, executing pending jobs meanwhile
+    void Wait(const JobCounter& counter);
+
+    // Run func(begin, end) over [0, count) split into ranges of at most granularity items
+    template<typename Func>
+    void ParallelFor(std::size_t count, std::size_t granularity, Func&& func);
+
+    // Get the number of threads executing jobs (worker threads plus the submitting thread)
+    std::size_t GetThreadCount() const { return m_queues.size(); }
+
+    // Get the index of the calling thread in this pool (0 for threads outside the pool)
+    std::size_t GetCurrentThreadIndex() const;
+
+private:
+    struct Job {
+        std::function<void()> function;
+        JobCounter* counter;
+        FrameArenaSet* frameArenas;
+    };
+
+    struct JobQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    // Worker thread entry point
+    void WorkerLoop(std::size_t index);
+
+    // Pop a job from the given queue or steal one from another queue
+    bool TryExecuteJob(std::size_t index);
+
+    // Job queues (index 0 is shared by threads outside the pool)
+    std::vector<std::unique_ptr<JobQueue>> m_queues;
+
+    // Worker threads
+    std::vector<std::thread> m_workers;
+
+    // Number of queued jobs not yet picked up
+    std::atomic<std::size_t> m_queuedJobs;
+
+    // Running state
+    std::atomic<bool> m_running;
+
+    // Sleep state for idle workers
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+
+    // Pool membership of the calling thread
+    static thread_local const JobSystem* t_jobSystem;
+    static thread_local std::size_t t_threadIndex;
+};
+
+// Implementation
+
+inline thread_local const JobSystem* JobSystem::t_jobSystem = nullptr;
+inline thread_local std::size_t JobSystem::t_threadIndex = 0;
+
+inline JobSystem::JobSystem(std::size_t workerThreadCount)
+    : m_queuedJobs(0)
+    , m_running(true)
+{
+    if (workerThreadCount == 0) {
+        const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workerThreadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    for (std::size_t i = 0; i <= workerThreadCount; ++i) {
+        m_queues.push_back(std::make_unique<JobQueue>());
+    }
+
+    for (std::size_t i = 1; i <= workerThreadCount; ++i) {
+        m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+inline JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_running = false;
+    }
+    m_sleepCondition.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+inline void JobSystem::Schedule(std::function<void()> job, JobCounter* counter) {
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    JobQueue& queue = *m_queues[GetCurrentThreadIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back({ std::move(job), counter, MemoryManager::GetThreadFrameArenaSet() });
+    }
+
+    m_queuedJobs.fetch_add(1, std::memory_order_release);
+
+    // Take the sleep lock so a worker about to sleep cannot miss the wakeup
+    { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+    m_sleepCondition.notify_one();
+}
+
+inline void JobSystem::Wait(const JobCounter& counter) {
+    const std::size_t index = GetCurrentThreadIndex();
+
+    while (!counter.IsDone()) {
+        if (!TryExecuteJob(index)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+template<typename Func>
+void JobSystem::ParallelFor(std::size_t count, std::size_t granularity, Func&& func) {
+    if (count == 0) {
+        return;
+    }
+
+    if (granularity == 0) {
+        granularity = 1;
+    }
+
+    // Run inline when there is nothing to split
+    if (count <= granularity || m_queues.size() == 1) {
+        func(std::size_t(0), count);
+        return;
+    }
+
+    JobCounter counter;
+    for (std::size_t begin = granularity; begin < count; begin += granularity) {
+        const std::size_t end = begin + granularity < count ? begin + granularity : count;
+        Schedule([&func, begin, end]() { func(begin, end); }, &counter);
+    }
+
+    // The calling thread takes the first range itself
+    func(std::size_t(0), granularity);
+
+    Wait(counter);
+}
+
+inline std::size_t JobSystem::GetCurrentThreadIndex() const {
+    return t_jobSystem == this ? t_threadIndex : 0;
+}
+
+inline void JobSystem::WorkerLoop(std::size_t index) {
+    t_jobSystem = this;
+    t_threadIndex = index;
+    CHULUBME_PROFILE_THREAD("Job worker");
+
+    while (m_running) {
+        if (TryExecuteJob(index)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.wait(lock, [this]() {
+            return !m_running || m_queuedJobs.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+inline bool JobSystem::TryExecuteJob(std::size_t index) {
+    Job job;
+    bool found = false;
+
+    // Newest job from our own queue first
+    {
+        JobQueue& queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            found = true;
+        }
+    }
+
+    // Then steal the oldest job from the other queues
+    for (std::size_t offset = 1; !found && offset < m_queues.size(); ++offset) {
+        JobQueue& queue = *m_queues[(index + offset) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            found = true;
+        }
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    m_queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+
+    {
+        ScopedFrameArenas frameArenas(job.frameArenas, index);
+        job.function();
+    }
+
+    if (job.counter) {
+        job.counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    return true;
+}
+
+} // namespace CHULUBME
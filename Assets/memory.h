@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <memory>
 #include <vector>
 #include <unordered_map>
@@ -154,6 +157,10 @@ private:
 
 /**
  * @brief Heap allocator that wraps system malloc/free
+ *
+ * Every allocation is preceded by a header recording the original pointer and
+ * size, so Free needs neither a lookup table nor a lock. Statistics are kept
+ * in relaxed atomics.
  */
 class HeapAllocator : public Allocator {
 public:
@@ -173,25 +180,148 @@ public:
     size_t GetAllocationCount() const override;
 
 private:
-    // Allocation tracking
-    struct AllocationInfo {
+    // Header stored immediately before every returned pointer
+    struct AllocationHeader {
         void* originalPtr;
         size_t size;
     };
 
-    // Allocation map
-    std::unordered_map<void*, AllocationInfo> m_allocations;
+    // Total allocated memory
+    std::atomic<size_t> m_totalAllocated;
 
-    // Mutex for thread safety
-    mutable std::mutex m_mutex;
+    // Allocation count
+    std::atomic<size_t> m_allocationCount;
+};
 
-    // Total allocated memory
-    size_t m_totalAllocated;
+/**
+ * @brief Growable linear arena used by a single thread
+ *
+ * Allocations bump an offset in the current block and new blocks are added as
+ * needed. Markers rewind the arena in LIFO order and Reset rewinds it fully.
+ * Blocks are kept for reuse, so a warmed-up arena does not touch the heap.
+ * Destructors of objects placed in the arena are never run.
+ */
+class ScratchArena : public Allocator {
+public:
+    // Arena position returned by GetMarker
+    struct Marker {
+        size_t block;
+        size_t offset;
+        size_t used;
+        size_t allocationCount;
+    };
+
+    explicit ScratchArena(size_t blockSize = 64 * 1024);
+    ~ScratchArena() override;
+
+    // Deleted copy constructor and assignment operator
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // Allocate memory
+    void* Allocate(size_t size, size_t alignment = 8) override;
+
+    // Free memory (does nothing for individual allocations)
+    void Free(void* /*ptr*/) override {}
+
+    // Get marker for current position
+    Marker GetMarker() const { return { m_blockIndex, m_offset, m_used, m_allocationCount }; }
+
+    // Free everything allocated after the marker was taken
+    void FreeToMarker(const Marker& marker);
+
+    // Reset the allocator (frees all memory but keeps the blocks)
+    void Reset();
+
+    // Get total allocated memory
+    size_t GetTotalAllocated() const override { return m_used; }
+
+    // Get allocation count
+    size_t GetAllocationCount() const override { return m_allocationCount; }
+
+    // Get the memory reserved by the arena's blocks
+    size_t GetCapacity() const;
+
+private:
+    struct Block {
+        unsigned char* data;
+        size_t size;
+    };
+
+    // Memory blocks, in allocation order
+    std::vector<Block> m_blocks;
+
+    // Default size of new blocks
+    size_t m_blockSize;
+
+    // Current block and offset inside it
+    size_t m_blockIndex;
+    size_t m_offset;
+
+    // Bytes handed out (including alignment padding)
+    size_t m_used;
 
     // Allocation count
     size_t m_allocationCount;
 };
 
+/**
+ * @brief Frame arenas of one world, one per thread of the pool that runs it
+ *
+ * The per-thread frame arenas are reset all at once, which only works while
+ * one world owns the frame. A server running several worlds on one pool
+ * gives each world its own set: while a thread runs one of the world's jobs
+ * (see ScopedFrameArenas), the set's arena for that thread is its frame
+ * arena, and the world resets its set between its own ticks without
+ * touching any other world's memory.
+ */
+class FrameArenaSet {
+public:
+    // Create one arena per pool thread
+    explicit FrameArenaSet(size_t threadCount, size_t blockSize = 256 * 1024);
+    ~FrameArenaSet() = default;
+
+    // Deleted copy constructor and assignment operator
+    FrameArenaSet(const FrameArenaSet&) = delete;
+    FrameArenaSet& operator=(const FrameArenaSet&) = delete;
+
+    // Get the arena of a pool thread (the index must be below GetThreadCount)
+    ScratchArena& GetArena(size_t threadIndex) { return *m_arenas[threadIndex]; }
+
+    // Get the number of arenas
+    size_t GetThreadCount() const { return m_arenas.size(); }
+
+    // Reset every arena; call while none of the world's jobs are running
+    void Reset();
+
+    // Get the bytes handed out by all arenas
+    size_t GetTotalAllocated() const;
+
+    // Get the memory reserved by all arenas
+    size_t GetCapacity() const;
+
+private:
+    std::vector<std::unique_ptr<ScratchArena>> m_arenas;
+};
+
+/**
+ * @brief Lock-free allocation counters for subsystems that manage their own memory
+ *
+ * Counters are cumulative; compare snapshots taken at the start and end of a
+ * frame to confirm that a steady-state frame performs no heap allocations.
+ */
+struct AllocationCounters {
+    // Blocks requested from and returned to the system heap
+    std::atomic<size_t> heapAllocations{0};
+    std::atomic<size_t> heapFrees{0};
+
+    // Blocks handed out from a free list instead of the heap
+    std::atomic<size_t> pooledAllocations{0};
+
+    // Bytes currently handed out
+    std::atomic<size_t> bytesInUse{0};
+};
+
 /**
  * @brief Memory manager that provides different allocators for different purposes
  */
@@ -214,7 +344,7 @@ public:
     // Shutdown the memory manager
     void Shutdown();
 
-    // Begin frame (resets frame allocator)
+    // Begin frame (resets frame allocator and every thread's frame arena)
     void BeginFrame();
 
     // End frame
@@ -242,9 +372,36 @@ public:
         size_t poolAllocations;
         size_t stackAllocated;
         size_t stackAllocations;
+        size_t componentAllocated;       // Bytes of archetype chunk storage in use
+        size_t componentAllocations;     // Chunks served from the chunk pool
+        size_t componentHeapAllocations; // Chunks requested from the system heap
     };
     MemoryStats GetMemoryStats() const;
 
+    // Counters for ECS component chunk storage (reported in MemoryStats::component*)
+    static AllocationCounters& GetComponentCounters() {
+        static AllocationCounters counters;
+        return counters;
+    }
+
+    // Counters for the blocks backing per-thread arenas
+    static AllocationCounters& GetArenaCounters() {
+        static AllocationCounters counters;
+        return counters;
+    }
+
+    // Get the calling thread's frame arena (its arena in the bound set, if any); contents live until the next frame begins
+    static ScratchArena& GetThreadFrameArena();
+
+    // Get the frame arena set bound on the calling thread (null if none)
+    static FrameArenaSet* GetThreadFrameArenaSet() { return GetThreadFrameBinding().arenas; }
+
+    // Get the calling thread's scratch arena (normally used through ScopedScratch)
+    static ScratchArena& GetThreadScratchArena() { return GetThreadArenas().scratch; }
+
+    // Reset every thread's frame arena; call once per frame while no jobs are running
+    static void ResetThreadFrameArenas();
+
 private:
     // Private constructor for singleton
     MemoryManager();
@@ -263,6 +420,100 @@ private:
 
     // Mutex for thread safety
     mutable std::mutex m_mutex;
+
+    // Arenas owned by one thread
+    struct ThreadArenas {
+        ScratchArena frame{ 256 * 1024 };
+        ScratchArena scratch{ 64 * 1024 };
+    };
+
+    // Arenas of all threads; arenas of exited threads are handed to new threads
+    struct ThreadArenaRegistry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadArenas>> arenas;
+        std::vector<ThreadArenas*> available;
+    };
+
+    // Get the registry (intentionally never destroyed, so exiting threads can always return their arenas)
+    static ThreadArenaRegistry& GetThreadArenaRegistry();
+
+    // Get the calling thread's arenas, acquiring them on first use
+    static ThreadArenas& GetThreadArenas();
+
+    // World frame arenas bound on one thread
+    struct FrameBinding {
+        FrameArenaSet* arenas = nullptr;
+        size_t threadIndex = 0;
+    };
+
+    // Get the calling thread's binding (changed only through ScopedFrameArenas)
+    static FrameBinding& GetThreadFrameBinding();
+
+    friend class ScopedFrameArenas;
+};
+
+/**
+ * @brief Scoped allocation from the calling thread's scratch arena
+ *
+ * Everything allocated through the scope is released when it is destroyed.
+ * Scopes nest; inner scopes must end before outer ones (which automatic
+ * storage guarantees).
+ */
+class ScopedScratch {
+public:
+    ScopedScratch()
+        : m_arena(MemoryManager::GetThreadScratchArena())
+        , m_marker(m_arena.GetMarker()) {}
+    ~ScopedScratch() { m_arena.FreeToMarker(m_marker); }
+
+    // Deleted copy constructor and assignment operator
+    ScopedScratch(const ScopedScratch&) = delete;
+    ScopedScratch& operator=(const ScopedScratch&) = delete;
+
+    // Allocate memory
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        return m_arena.Allocate(size, alignment);
+    }
+
+    // Allocate an uninitialized array
+    template<typename T>
+    T* AllocateArray(size_t count) {
+        return static_cast<T*>(m_arena.Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Get the underlying arena
+    ScratchArena& GetArena() { return m_arena; }
+
+private:
+    ScratchArena& m_arena;
+    ScratchArena::Marker m_marker;
+};
+
+/**
+ * @brief Scoped binding of a world's frame arenas on the calling thread
+ *
+ * Frame allocations made in the scope come from the set's arena for the
+ * given pool thread; a null set selects the thread's own frame arena. The
+ * previous binding is restored when the scope ends, so a thread that runs
+ * another world's job while waiting switches to that world's arenas and
+ * back.
+ */
+class ScopedFrameArenas {
+public:
+    ScopedFrameArenas(FrameArenaSet* arenas, size_t threadIndex)
+        : m_previous(MemoryManager::GetThreadFrameBinding()) {
+        MemoryManager::FrameBinding& binding = MemoryManager::GetThreadFrameBinding();
+        binding.arenas = arenas;
+        binding.threadIndex = threadIndex;
+    }
+    ~ScopedFrameArenas() { MemoryManager::GetThreadFrameBinding() = m_previous; }
+
+    // Deleted copy constructor and assignment operator
+    ScopedFrameArenas(const ScopedFrameArenas&) = delete;
+    ScopedFrameArenas& operator=(const ScopedFrameArenas&) = delete;
+
+private:
+    MemoryManager::FrameBinding m_previous;
 };
 
 /**
@@ -395,4 +646,214 @@ private:
     #define CHULUBME_FREE(ptr) do { if(ptr) { free(ptr); ptr = nullptr; } } while(0)
 #endif
 
+// Implementation of HeapAllocator methods
+
+inline HeapAllocator::HeapAllocator()
+    : m_totalAllocated(0), m_allocationCount(0) {}
+
+inline HeapAllocator::~HeapAllocator() = default;
+
+inline void* HeapAllocator::Allocate(size_t size, size_t alignment) {
+    if (alignment < alignof(AllocationHeader)) {
+        alignment = alignof(AllocationHeader);
+    }
+
+    // Reserve room for the header and worst-case alignment padding
+    void* originalPtr = std::malloc(size + sizeof(AllocationHeader) + alignment - 1);
+    if (!originalPtr) {
+        return nullptr;
+    }
+
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(originalPtr) + sizeof(AllocationHeader);
+    address = (address + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+
+    AllocationHeader* header = reinterpret_cast<AllocationHeader*>(address) - 1;
+    header->originalPtr = originalPtr;
+    header->size = size;
+
+    m_totalAllocated.fetch_add(size, std::memory_order_relaxed);
+    m_allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    return reinterpret_cast<void*>(address);
+}
+
+inline void HeapAllocator::Free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+
+    const AllocationHeader* header = static_cast<const AllocationHeader*>(ptr) - 1;
+
+    m_totalAllocated.fetch_sub(header->size, std::memory_order_relaxed);
+    m_allocationCount.fetch_sub(1, std::memory_order_relaxed);
+
+    std::free(header->originalPtr);
+}
+
+inline size_t HeapAllocator::GetTotalAllocated() const {
+    return m_totalAllocated.load(std::memory_order_relaxed);
+}
+
+inline size_t HeapAllocator::GetAllocationCount() const {
+    return m_allocationCount.load(std::memory_order_relaxed);
+}
+
+// Implementation of ScratchArena methods
+
+inline ScratchArena::ScratchArena(size_t blockSize)
+    : m_blockSize(blockSize), m_blockIndex(0), m_offset(0), m_used(0), m_allocationCount(0) {}
+
+inline ScratchArena::~ScratchArena() {
+    AllocationCounters& counters = MemoryManager::GetArenaCounters();
+    for (Block& block : m_blocks) {
+        counters.bytesInUse.fetch_sub(block.size, std::memory_order_relaxed);
+        counters.heapFrees.fetch_add(1, std::memory_order_relaxed);
+        ::operator delete(block.data);
+    }
+}
+
+inline void* ScratchArena::Allocate(size_t size, size_t alignment) {
+    for (;;) {
+        // Bump allocate from the current block, skipping blocks that are too small
+        while (m_blockIndex < m_blocks.size()) {
+            const Block& block = m_blocks[m_blockIndex];
+            const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data);
+            const std::uintptr_t aligned = (base + m_offset + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+            const size_t offset = static_cast<size_t>(aligned - base);
+
+            if (offset + size <= block.size) {
+                m_used += offset + size - m_offset;
+                m_offset = offset + size;
+                ++m_allocationCount;
+                return block.data + offset;
+            }
+
+            ++m_blockIndex;
+            m_offset = 0;
+        }
+
+        // Every block is in use; add one large enough for this allocation
+        const size_t blockSize = size + alignment > m_blockSize ? size + alignment : m_blockSize;
+        m_blocks.push_back({ static_cast<unsigned char*>(::operator new(blockSize)), blockSize });
+
+        AllocationCounters& counters = MemoryManager::GetArenaCounters();
+        counters.heapAllocations.fetch_add(1, std::memory_order_relaxed);
+        counters.bytesInUse.fetch_add(blockSize, std::memory_order_relaxed);
+    }
+}
+
+inline void ScratchArena::FreeToMarker(const Marker& marker) {
+    m_blockIndex = marker.block;
+    m_offset = marker.offset;
+    m_used = marker.used;
+    m_allocationCount = marker.allocationCount;
+}
+
+inline void ScratchArena::Reset() {
+    m_blockIndex = 0;
+    m_offset = 0;
+    m_used = 0;
+    m_allocationCount = 0;
+}
+
+inline size_t ScratchArena::GetCapacity() const {
+    size_t capacity = 0;
+    for (const Block& block : m_blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+// Implementation of FrameArenaSet methods
+
+inline FrameArenaSet::FrameArenaSet(size_t threadCount, size_t blockSize) {
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    m_arenas.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_arenas.push_back(std::make_unique<ScratchArena>(blockSize));
+    }
+}
+
+inline void FrameArenaSet::Reset() {
+    for (std::unique_ptr<ScratchArena>& arena : m_arenas) {
+        arena->Reset();
+    }
+}
+
+inline size_t FrameArenaSet::GetTotalAllocated() const {
+    size_t allocated = 0;
+    for (const std::unique_ptr<ScratchArena>& arena : m_arenas) {
+        allocated += arena->GetTotalAllocated();
+    }
+    return allocated;
+}
+
+inline size_t FrameArenaSet::GetCapacity() const {
+    size_t capacity = 0;
+    for (const std::unique_ptr<ScratchArena>& arena : m_arenas) {
+        capacity += arena->GetCapacity();
+    }
+    return capacity;
+}
+
+// Implementation of MemoryManager thread arena methods
+
+inline MemoryManager::ThreadArenaRegistry& MemoryManager::GetThreadArenaRegistry() {
+    static ThreadArenaRegistry* registry = new ThreadArenaRegistry();
+    return *registry;
+}
+
+inline MemoryManager::ThreadArenas& MemoryManager::GetThreadArenas() {
+    // Returns the thread's arenas to the registry when the thread exits
+    struct ThreadArenaHandle {
+        ThreadArenas* arenas = nullptr;
+
+        ~ThreadArenaHandle() {
+            if (arenas) {
+                ThreadArenaRegistry& registry = GetThreadArenaRegistry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                arenas->frame.Reset();
+                arenas->scratch.Reset();
+                registry.available.push_back(arenas);
+            }
+        }
+    };
+    thread_local ThreadArenaHandle t_handle;
+
+    if (!t_handle.arenas) {
+        ThreadArenaRegistry& registry = GetThreadArenaRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (!registry.available.empty()) {
+            t_handle.arenas = registry.available.back();
+            registry.available.pop_back();
+        } else {
+            registry.arenas.push_back(std::make_unique<ThreadArenas>());
+            t_handle.arenas = registry.arenas.back().get();
+        }
+    }
+
+    return *t_handle.arenas;
+}
+
+inline MemoryManager::FrameBinding& MemoryManager::GetThreadFrameBinding() {
+    thread_local FrameBinding t_binding;
+    return t_binding;
+}
+
+inline ScratchArena& MemoryManager::GetThreadFrameArena() {
+    const FrameBinding& binding = GetThreadFrameBinding();
+    return binding.arenas ? binding.arenas->GetArena(binding.threadIndex) : GetThreadArenas().frame;
+}
+
+inline void MemoryManager::ResetThreadFrameArenas() {
+    ThreadArenaRegistry& registry = GetThreadArenaRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (std::unique_ptr<ThreadArenas>& arenas : registry.arenas) {
+        arenas->frame.Reset();
+    }
+}
+
 } // namespace CHULUBME
@@ -1,6 +1,7 @@
 package network
 
 import (
+    "bufio"
     "encoding/json"
     "errors"
     "fmt"
@@ -9,23 +10,43 @@ import (
     "time"
 )
 
+// Frames a peer's write queue holds before sends to it are dropped
+const peerSendQueueSize = 256
+
+// Bytes of queued frames written to a peer per flush
+const peerWriteBufferSize = 64 * 1024
+
+var (
+    ErrPeerClosed    = errors.New("peer connection closed")
+    ErrPeerQueueFull = errors.New("peer send queue full")
+)
+
 // Node represents a node in the blockchain network
 type Node struct {
-    ID            string
-    Address       string
-    Type          string // "full", "game", "light", "master"
-    IsValidator   bool
-    Peers         map[string]*Peer
-    MessageQueue  chan Message
-    BlockQueue    chan []byte
-    TxQueue       chan []byte
-    IsRunning     bool
-    mutex         sync.Mutex
-    listener      net.Listener
-    peerDiscovery *PeerDiscovery
+    ID             string
+    Address        string
+    Type           string // "full", "game", "light", "master"
+    IsValidator    bool
+    Peers          map[string]*Peer
+    MessageQueue   chan Message
+    BlockQueue     chan []byte
+    TxQueue        chan []byte
+    
+    // Play score batches for the consensus layer; filled on validator nodes only,
+    // which must drain it with ConsumePlayScores
+    PlayScoreQueue chan []PlayScoreUpdate
+    
+    IsRunning      bool
+    mutex          sync.Mutex
+    listener       net.Listener
+    done           chan struct{} // Closed by Stop; replaced by each Start
+    peerDiscovery  *PeerDiscovery
 }
 
 // Peer represents a connection to another node
+//
+// Frames sent to a peer are queued and written by its own goroutine, which
+// gathers everything queued since its last write into one flush.
 type Peer struct {
     ID        string
     Address   string
@@ -33,6 +54,9 @@ type Peer struct {
     Conn      net.Conn
     LastSeen  int64
     IsActive  bool
+    sendQueue chan []byte
+    done      chan struct{}
+    closeOnce sync.Once
 }
 
 // Message represents a network message
@@ -41,6 +65,9 @@ type Message struct {
     Sender  string      `json:"sender"`
     Content interface{} `json:"content"`
     Time    int64       `json:"time"`
+    
+    // Content as received, forwarded without encoding it again
+    rawContent json.RawMessage
 }
 
 // PeerDiscovery handles finding and connecting to peers
@@ -54,15 +81,86 @@ type PeerDiscovery struct {
 // NewNode creates a new network node
 func NewNode(id string, address string, nodeType string, isValidator bool) *Node {
     return &Node{
-        ID:           id,
-        Address:      address,
-        Type:         nodeType,
-        IsValidator:  isValidator,
-        Peers:        make(map[string]*Peer),
-        MessageQueue: make(chan Message, 100),
-        BlockQueue:   make(chan []byte, 10),
-        TxQueue:      make(chan []byte, 100),
-        IsRunning:    false,
+        ID:             id,
+        Address:        address,
+        Type:           nodeType,
+        IsValidator:    isValidator,
+        Peers:          make(map[string]*Peer),
+        MessageQueue:   make(chan Message, 100),
+        BlockQueue:     make(chan []byte, 10),
+        TxQueue:        make(chan []byte, 100),
+        PlayScoreQueue: make(chan []PlayScoreUpdate, 100),
+        IsRunning:      false,
+    }
+}
+
+// newPeer creates a peer for an established connection and starts its writer
+func newPeer(id string, address string, peerType string, conn net.Conn) *Peer {
+    peer := &Peer{
+        ID:        id,
+        Address:   address,
+        Type:      peerType,
+        Conn:      conn,
+        LastSeen:  time.Now().Unix(),
+        IsActive:  true,
+        sendQueue: make(chan []byte, peerSendQueueSize),
+        done:      make(chan struct{}),
+    }
+    
+    go peer.writeLoop()
+    
+    return peer
+}
+
+// send queues an encoded frame for the peer's writer; the frame must not be modified afterwards
+func (p *Peer) send(frame []byte) error {
+    select {
+    case <-p.done:
+        return ErrPeerClosed
+    default:
+    }
+    
+    select {
+    case p.sendQueue <- frame:
+        return nil
+    default:
+        return ErrPeerQueueFull
+    }
+}
+
+// close marks the peer inactive, stops its writer and closes its connection
+func (p *Peer) close() {
+    p.closeOnce.Do(func() {
+        p.IsActive = false
+        close(p.done)
+        if p.Conn != nil {
+            p.Conn.Close()
+        }
+    })
+}
+
+// writeLoop writes queued frames, batching those queued together into one flush
+func (p *Peer) writeLoop() {
+    writer := bufio.NewWriterSize(p.Conn, peerWriteBufferSize)
+    
+    for {
+        select {
+        case frame := <-p.sendQueue:
+            writer.Write(frame)
+            
+            // Add whatever else is already queued, up to about one buffer
+            for len(p.sendQueue) > 0 && writer.Buffered() < peerWriteBufferSize {
+                writer.Write(<-p.sendQueue)
+            }
+            
+            if err := writer.Flush(); err != nil {
+                p.close()
+                return
+            }
+        
+        case <-p.done:
+            return
+        }
     }
 }
 
@@ -82,6 +180,7 @@ func (n *Node) Start(port int) error {
     }
     
     n.listener = listener
+    n.done = make(chan struct{})
     n.IsRunning = true
     
     // Start accepting connections
@@ -120,11 +219,11 @@ func (n *Node) Stop() error {
     
     // Close all peer connections
     for _, peer := range n.Peers {
-        if peer.Conn != nil {
-            peer.Conn.Close()
-        }
+        peer.close()
     }
     
+    // Release goroutines waiting on the node, such as ConsumePlayScores
+    close(n.done)
     n.IsRunning = false
     
     return nil
@@ -156,7 +255,7 @@ func (n *Node) Connect(address string) error {
         Time:    time.Now().Unix(),
     }
     
-    handshakeData, err := json.Marshal(handshake)
+    handshakeData, err := EncodeMessage(handshake)
     if err != nil {
         conn.Close()
         return err
@@ -169,15 +268,14 @@ func (n *Node) Connect(address string) error {
     }
     
     // Wait for handshake response
-    buffer := make([]byte, 1024)
-    n, err := conn.Read(buffer)
+    reader := bufio.NewReader(conn)
+    frame, _, err := readFrame(reader, nil)
     if err != nil {
         conn.Close()
         return err
     }
     
-    var response Message
-    err = json.Unmarshal(buffer[:n], &response)
+    response, err := decodeFrame(frame)
     if err != nil {
         conn.Close()
         return err
@@ -208,19 +306,12 @@ func (n *Node) Connect(address string) error {
     }
     
     // Add peer
-    peer := &Peer{
-        ID:       peerID,
-        Address:  address,
-        Type:     peerType,
-        Conn:     conn,
-        LastSeen: time.Now().Unix(),
-        IsActive: true,
-    }
+    peer := newPeer(peerID, address, peerType, conn)
     
     n.Peers[peerID] = peer
     
     // Start handling messages from this peer
-    go n.handlePeerMessages(peer)
+    go n.handlePeerMessages(peer, reader)
     
     return nil
 }
@@ -234,22 +325,26 @@ func (n *Node) Broadcast(messageType string, content interface{}) error {
         Time:    time.Now().Unix(),
     }
     
-    messageData, err := json.Marshal(message)
+    // Encode once; every peer's queue shares the frame
+    frame, err := EncodeMessage(message)
     if err != nil {
         return err
     }
     
-    for _, peer := range n.Peers {
-        if peer.IsActive && peer.Conn != nil {
-            _, err := peer.Conn.Write(messageData)
-            if err != nil {
-                // Mark peer as inactive
-                peer.IsActive = false
-                continue
-            }
-        }
+    n.broadcastFrame(frame)
+    
+    return nil
+}
+
+// BroadcastPlayScores sends a batch of play score updates to all connected peers in one compact frame
+func (n *Node) BroadcastPlayScores(updates []PlayScoreUpdate) error {
+    frame, err := EncodePlayScores(n.ID, time.Now().Unix(), updates)
+    if err != nil {
+        return err
     }
     
+    n.broadcastFrame(frame)
+    
     return nil
 }
 
@@ -267,18 +362,22 @@ func (n *Node) SendToPeer(peerID string, messageType string, content interface{}
         Time:    time.Now().Unix(),
     }
     
-    messageData, err := json.Marshal(message)
+    frame, err := EncodeMessage(message)
     if err != nil {
         return err
     }
     
-    _, err = peer.Conn.Write(messageData)
-    if err != nil {
-        peer.IsActive = false
-        return err
-    }
+    return peer.send(frame)
+}
     
-    return nil
+// broadcastFrame queues an encoded frame to every active peer
+func (n *Node) broadcastFrame(frame []byte) {
+    for _, peer := range n.Peers {
+        if peer.IsActive {
+            // A peer whose queue is full misses this frame rather than stalling the others
+            peer.send(frame)
+        }
+    }
 }
 
 // acceptConnections accepts incoming connections
@@ -303,15 +402,14 @@ func (n *Node) acceptConnections() {
 // handleConnection handles a new connection
 func (n *Node) handleConnection(conn net.Conn) {
     // Read handshake
-    buffer := make([]byte, 1024)
-    bytesRead, err := conn.Read(buffer)
+    reader := bufio.NewReader(conn)
+    frame, _, err := readFrame(reader, nil)
     if err != nil {
         conn.Close()
         return
     }
     
-    var message Message
-    err = json.Unmarshal(buffer[:bytesRead], &message)
+    message, err := decodeFrame(frame)
     if err != nil {
         conn.Close()
         return
@@ -352,7 +450,7 @@ func (n *Node) handleConnection(conn net.Conn) {
         Time:    time.Now().Unix(),
     }
     
-    responseData, err := json.Marshal(response)
+    responseData, err := EncodeMessage(response)
     if err != nil {
         conn.Close()
         return
@@ -365,38 +463,31 @@ func (n *Node) handleConnection(conn net.Conn) {
     }
     
     // Add peer
-    peer := &Peer{
-        ID:       message.Sender,
-        Address:  peerAddress,
-        Type:     peerType,
-        Conn:     conn,
-        LastSeen: time.Now().Unix(),
-        IsActive: true,
-    }
+    peer := newPeer(message.Sender, peerAddress, peerType, conn)
     
     n.Peers[peer.ID] = peer
     
     // Start handling messages from this peer
-    go n.handlePeerMessages(peer)
+    go n.handlePeerMessages(peer, reader)
 }
 
-// handlePeerMessages handles messages from a peer
-func (n *Node) handlePeerMessages(peer *Peer) {
+// handlePeerMessages handles messages from a peer, read from the connection's buffered reader
+func (n *Node) handlePeerMessages(peer *Peer, reader *bufio.Reader) {
     buffer := make([]byte, 4096)
     
     for {
-        bytesRead, err := peer.Conn.Read(buffer)
+        frame, nextBuffer, err := readFrame(reader, buffer)
+        buffer = nextBuffer
         if err != nil {
-            // Mark peer as inactive
-            peer.IsActive = false
+            // A broken stream cannot be resynchronized; drop the peer
+            peer.close()
             return
         }
         
         // Update last seen
         peer.LastSeen = time.Now().Unix()
         
-        var message Message
-        err = json.Unmarshal(buffer[:bytesRead], &message)
+        message, err := decodeFrame(frame)
         if err != nil {
             continue
         }
@@ -414,20 +505,26 @@ func (n *Node) processMessages() {
             // Process message based on type
             switch message.Type {
             case "block":
-                // Convert content to bytes and add to block queue
-                blockData, err := json.Marshal(message.Content)
+                // Forward the content as received and add to block queue
+                blockData, err := message.contentBytes()
                 if err != nil {
                     continue
                 }
                 n.BlockQueue <- blockData
                 
             case "transaction":
-                // Convert content to bytes and add to transaction queue
-                txData, err := json.Marshal(message.Content)
+                // Forward the content as received and add to transaction queue
+                txData, err := message.contentBytes()
                 if err != nil {
                     continue
                 }
                 n.TxQueue <- txData
+            
+            case MessageTypePlayScores:
+                // Hand decoded play score batches to the consensus layer; only validators consume them
+                if updates, ok := message.Content.([]PlayScoreUpdate); ok && n.IsValidator {
+                    n.PlayScoreQueue <- updates
+                }
                 
             case "peer_discovery":
                 // Handle peer discovery
@@ -443,6 +540,38 @@ func (n *Node) processMessages() {
     }
 }
 
+// ConsumePlayScores passes each queued play score batch to apply, typically
+// ProofOfPlay.UpdatePlayScores, until the node stops (at once if it is not running)
+// Validator nodes must run it, or a full queue stalls message processing
+func (n *Node) ConsumePlayScores(apply func(updates []PlayScoreUpdate)) {
+    n.mutex.Lock()
+    done := n.done
+    running := n.IsRunning
+    n.mutex.Unlock()
+    
+    if !running {
+        return
+    }
+    
+    for {
+        select {
+        case updates := <-n.PlayScoreQueue:
+            apply(updates)
+        case <-done:
+            return
+        }
+    }
+}
+
+// contentBytes returns the message content as JSON, reusing the received encoding
+func (m *Message) contentBytes() ([]byte, error) {
+    if m.rawContent != nil {
+        return m.rawContent, nil
+    }
+    
+    return json.Marshal(m.Content)
+}
+
 // handlePeerDiscovery handles peer discovery messages
 func (n *Node) handlePeerDiscovery(message Message) {
     content, ok := message.Content.(map[string]interface{})
@@ -566,10 +695,7 @@ func (p *PeerDiscovery) sendHeartbeats() {
         // Check for inactive peers
         for id, peer := range p.node.Peers {
             if time.Now().Unix()-peer.LastSeen > int64(p.HeartbeatInterval*2) {
-                peer.IsActive = false
-                if peer.Conn != nil {
-                    peer.Conn.Close()
-                }
+                peer.close()
                 delete(p.node.Peers, id)
             }
         }
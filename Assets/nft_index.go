@@ -0,0 +1,136 @@
+package nft
+
+import (
+    "errors"
+    "math"
+    "sort"
+    "strconv"
+    "strings"
+)
+
+// MaxPageSize is the largest number of NFTs one paginated query returns
+const MaxPageSize = 100
+
+// ErrInvalidCursor is returned for page cursors that cannot be decoded
+var ErrInvalidCursor = errors.New("invalid page cursor")
+
+// NFTPage is one page of a paginated NFT query
+type NFTPage struct {
+    NFTs       []*NFT `json:"nfts"`
+    NextCursor string `json:"nextCursor"` // Empty on the last page
+}
+
+// nftIndex keeps a set of NFTs sorted for ordered, paginated reads
+type nftIndex struct {
+    nfts []*NFT
+    less func(a *NFT, b *NFT) bool
+}
+
+// newIDIndex creates an index ordered by NFT ID
+func newIDIndex() *nftIndex {
+    return &nftIndex{
+        less: func(a *NFT, b *NFT) bool {
+            return a.ID < b.ID
+        },
+    }
+}
+
+// newPriceIndex creates an index ordered by list price, then ID
+func newPriceIndex() *nftIndex {
+    return &nftIndex{
+        less: func(a *NFT, b *NFT) bool {
+            if a.ListPrice != b.ListPrice {
+                return a.ListPrice < b.ListPrice
+            }
+            return a.ID < b.ID
+        },
+    }
+}
+
+// search returns the position of the first NFT not ordered before nft
+func (idx *nftIndex) search(nft *NFT) int {
+    return sort.Search(len(idx.nfts), func(i int) bool {
+        return !idx.less(idx.nfts[i], nft)
+    })
+}
+
+// insert adds an NFT; its sort key must not change while it is indexed
+func (idx *nftIndex) insert(nft *NFT) {
+    position := idx.search(nft)
+    if position < len(idx.nfts) && idx.nfts[position] == nft {
+        return
+    }
+    
+    idx.nfts = append(idx.nfts, nil)
+    copy(idx.nfts[position+1:], idx.nfts[position:])
+    idx.nfts[position] = nft
+}
+
+// remove deletes an NFT, found by its current sort key
+func (idx *nftIndex) remove(nft *NFT) {
+    position := idx.search(nft)
+    if position >= len(idx.nfts) || idx.nfts[position] != nft {
+        return
+    }
+    
+    copy(idx.nfts[position:], idx.nfts[position+1:])
+    idx.nfts[len(idx.nfts)-1] = nil
+    idx.nfts = idx.nfts[:len(idx.nfts)-1]
+}
+
+// all returns a copy of every indexed NFT in order
+func (idx *nftIndex) all() []*NFT {
+    return append([]*NFT{}, idx.nfts...)
+}
+
+// page returns up to limit NFTs ordered after the cursor
+func (idx *nftIndex) page(cursor string, limit int) (NFTPage, error) {
+    if limit <= 0 || limit > MaxPageSize {
+        limit = MaxPageSize
+    }
+    
+    start := 0
+    if cursor != "" {
+        after, err := decodeCursor(cursor)
+        if err != nil {
+            return NFTPage{}, err
+        }
+        
+        // The cursor NFT may have left the index since; resume after its key either way
+        start = sort.Search(len(idx.nfts), func(i int) bool {
+            return idx.less(after, idx.nfts[i])
+        })
+    }
+    
+    end := start + limit
+    if end > len(idx.nfts) {
+        end = len(idx.nfts)
+    }
+    
+    page := NFTPage{NFTs: append([]*NFT{}, idx.nfts[start:end]...)}
+    if end < len(idx.nfts) {
+        page.NextCursor = encodeCursor(idx.nfts[end-1])
+    }
+    
+    return page, nil
+}
+
+// encodeCursor records the sort key of the last NFT on a page
+func encodeCursor(nft *NFT) string {
+    return strconv.FormatUint(math.Float64bits(nft.ListPrice), 16) + ":" + nft.ID
+}
+
+// decodeCursor rebuilds the sort key recorded by encodeCursor
+func decodeCursor(cursor string) (*NFT, error) {
+    separator := strings.IndexByte(cursor, ':')
+    if separator < 0 {
+        return nil, ErrInvalidCursor
+    }
+    
+    bits, err := strconv.ParseUint(cursor[:separator], 16, 64)
+    if err != nil {
+        return nil, ErrInvalidCursor
+    }
+    
+    return &NFT{ID: cursor[separator+1:], ListPrice: math.Float64frombits(bits)}, nil
+}
@@ -0,0 +1,310 @@
+#include "nft_ownership_cache.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace CHULUBME {
+
+namespace {
+
+// Append a little-endian 32-bit value
+void WriteUInt32(std::vector<unsigned char>& output, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        output.push_back(static_cast<unsigned char>(value >> (i * 8)));
+    }
+}
+
+// Append a length-prefixed string
+void WriteString(std::vector<unsigned char>& output, const std::string& value) {
+    WriteUInt32(output, static_cast<std::uint32_t>(value.size()));
+    output.insert(output.end(), value.begin(), value.end());
+}
+
+/**
+ * @brief Bounds-checked reader over serialized cache data
+ */
+class CacheReader {
+public:
+    CacheReader(const unsigned char* data, std::size_t size) : m_data(data), m_size(size), m_offset(0) {}
+
+    // Read a little-endian 32-bit value
+    bool ReadUInt32(std::uint32_t& value) {
+        if (m_size - m_offset < 4) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<std::uint32_t>(m_data[m_offset + i]) << (i * 8);
+        }
+        m_offset += 4;
+        return true;
+    }
+
+    // Read a length-prefixed string
+    bool ReadString(std::string& value) {
+        std::uint32_t length = 0;
+        if (!ReadUInt32(length) || m_size - m_offset < length) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(m_data + m_offset), length);
+        m_offset += length;
+        return true;
+    }
+
+    // Check if every byte was read
+    bool AtEnd() const { return m_offset == m_size; }
+
+private:
+    const unsigned char* m_data;
+    std::size_t m_size;
+    std::size_t m_offset;
+};
+
+} // namespace
+
+// NFTOwnershipCache implementation
+NFTOwnershipCache::NFTOwnershipCache()
+    : m_dirty(false)
+{
+    SetFreshDuration(NFT_OWNERSHIP_FRESH_SECONDS);
+}
+
+void NFTOwnershipCache::SetOwnedNFTs(const std::string& address, const std::vector<std::string>& nftIds) {
+    // Drop the wallet's old list, then assign the new one
+    WalletEntry& wallet = m_wallets[address];
+    for (const std::string& nftId : wallet.nftIds) {
+        m_owners.erase(nftId);
+    }
+    wallet.nftIds.clear();
+    wallet.index.clear();
+    wallet.index.reserve(nftIds.size());
+
+    for (const std::string& nftId : nftIds) {
+        AssignNFT(address, nftId);
+    }
+
+    WalletEntry& refreshed = m_wallets[address];
+    refreshed.fresh = true;
+    refreshed.refreshTime = std::chrono::steady_clock::now();
+    m_dirty = true;
+}
+
+void NFTOwnershipCache::ApplyTransfer(const std::string& nftId, const std::string& fromAddress, const std::string& toAddress) {
+    if (!toAddress.empty()) {
+        // Unknown receivers are added stale: they own this NFT, the rest is unknown
+        AssignNFT(toAddress, nftId);
+        m_dirty = true;
+        return;
+    }
+
+    // Burned; remove it from whoever holds it
+    auto owner = m_owners.find(nftId);
+    const std::string holder = owner != m_owners.end() ? owner->second : fromAddress;
+    auto wallet = m_wallets.find(holder);
+    if (wallet != m_wallets.end()) {
+        RemoveNFT(wallet->second, nftId);
+    }
+    m_owners.erase(nftId);
+    m_dirty = true;
+}
+
+void NFTOwnershipCache::RemoveWallet(const std::string& address) {
+    auto it = m_wallets.find(address);
+    if (it == m_wallets.end()) {
+        return;
+    }
+
+    for (const std::string& nftId : it->second.nftIds) {
+        m_owners.erase(nftId);
+    }
+    m_wallets.erase(address);
+    m_dirty = true;
+}
+
+void NFTOwnershipCache::Clear() {
+    if (!m_wallets.empty()) {
+        m_wallets.clear();
+        m_owners.clear();
+        m_dirty = true;
+    }
+}
+
+const std::string& NFTOwnershipCache::GetOwner(const std::string& nftId) const {
+    static const std::string s_none;
+    auto it = m_owners.find(nftId);
+    return it != m_owners.end() ? it->second : s_none;
+}
+
+bool NFTOwnershipCache::IsOwned(const std::string& address, const std::string& nftId) const {
+    auto it = m_wallets.find(address);
+    return it != m_wallets.end() && it->second.index.count(nftId) != 0;
+}
+
+const std::vector<std::string>& NFTOwnershipCache::GetOwnedNFTs(const std::string& address) const {
+    static const std::vector<std::string> s_none;
+    auto it = m_wallets.find(address);
+    return it != m_wallets.end() ? it->second.nftIds : s_none;
+}
+
+bool NFTOwnershipCache::IsFresh(const std::string& address) const {
+    auto it = m_wallets.find(address);
+    return it != m_wallets.end() && it->second.fresh &&
+           std::chrono::steady_clock::now() - it->second.refreshTime < m_freshDuration;
+}
+
+void NFTOwnershipCache::SetFreshDuration(float seconds) {
+    m_freshDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<float>(seconds));
+}
+
+void NFTOwnershipCache::Serialize(std::vector<unsigned char>& output) const {
+    output.clear();
+    WriteUInt32(output, NFT_OWNERSHIP_CACHE_MAGIC);
+    WriteUInt32(output, NFT_OWNERSHIP_CACHE_VERSION);
+    WriteUInt32(output, static_cast<std::uint32_t>(m_wallets.size()));
+
+    for (const auto& entry : m_wallets) {
+        WriteString(output, entry.first);
+        WriteUInt32(output, static_cast<std::uint32_t>(entry.second.nftIds.size()));
+        for (const std::string& nftId : entry.second.nftIds) {
+            WriteString(output, nftId);
+        }
+    }
+}
+
+bool NFTOwnershipCache::Deserialize(const unsigned char* data, std::size_t size) {
+    CacheReader reader(data, size);
+    std::uint32_t magic = 0;
+    std::uint32_t version = 0;
+    std::uint32_t walletCount = 0;
+    if (!reader.ReadUInt32(magic) || magic != NFT_OWNERSHIP_CACHE_MAGIC ||
+        !reader.ReadUInt32(version) || version != NFT_OWNERSHIP_CACHE_VERSION ||
+        !reader.ReadUInt32(walletCount)) {
+        return false;
+    }
+
+    // Read into new maps so malformed data leaves the cache untouched
+    FlatHashMap<std::string, WalletEntry> wallets;
+    FlatHashMap<std::string, std::string> owners;
+    std::string address;
+    std::string nftId;
+    for (std::uint32_t i = 0; i < walletCount; ++i) {
+        std::uint32_t nftCount = 0;
+        if (!reader.ReadString(address) || !reader.ReadUInt32(nftCount)) {
+            return false;
+        }
+
+        WalletEntry& wallet = wallets[address];
+        for (std::uint32_t j = 0; j < nftCount; ++j) {
+            if (!reader.ReadString(nftId) || !owners.emplace(nftId, address).second) {
+                return false;
+            }
+            AddNFT(wallet, nftId);
+        }
+    }
+
+    if (!reader.AtEnd()) {
+        return false;
+    }
+
+    m_wallets = std::move(wallets);
+    m_owners = std::move(owners);
+    m_dirty = false;
+    return true;
+}
+
+bool NFTOwnershipCache::Load(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    const std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return Deserialize(data.data(), data.size());
+}
+
+bool NFTOwnershipCache::Save(const std::string& filename) {
+    std::vector<unsigned char> data;
+    Serialize(data);
+    if (!WriteFile(filename, data)) {
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+bool NFTOwnershipCache::WriteFile(const std::string& filename, const std::vector<unsigned char>& data) {
+    const std::string tempFilename = filename + ".tmp";
+    {
+        std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !file.write(reinterpret_cast<const char*>(data.data()), data.size())) {
+            return false;
+        }
+    }
+
+#ifdef _WIN32
+    if (!MoveFileExA(tempFilename.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+#else
+    if (std::rename(tempFilename.c_str(), filename.c_str()) != 0) {
+#endif
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void NFTOwnershipCache::AssignNFT(const std::string& address, const std::string& nftId) {
+    auto owner = m_owners.find(nftId);
+    if (owner != m_owners.end()) {
+        if (owner->second == address) {
+            return;
+        }
+
+        // Take it from its previous owner
+        auto previous = m_wallets.find(owner->second);
+        if (previous != m_wallets.end()) {
+            RemoveNFT(previous->second, nftId);
+        }
+        owner->second = address;
+    } else {
+        m_owners.emplace(nftId, address);
+    }
+
+    AddNFT(m_wallets[address], nftId);
+}
+
+bool NFTOwnershipCache::AddNFT(WalletEntry& wallet, const std::string& nftId) {
+    if (wallet.nftIds.size() >= std::numeric_limits<std::uint32_t>::max() ||
+        !wallet.index.emplace(nftId, static_cast<std::uint32_t>(wallet.nftIds.size())).second) {
+        return false;
+    }
+    wallet.nftIds.push_back(nftId);
+    return true;
+}
+
+bool NFTOwnershipCache::RemoveNFT(WalletEntry& wallet, const std::string& nftId) {
+    auto it = wallet.index.find(nftId);
+    if (it == wallet.index.end()) {
+        return false;
+    }
+
+    // Move the last NFT into the gap
+    const std::uint32_t position = it->second;
+    wallet.index.erase(nftId);
+    if (position + 1 != wallet.nftIds.size()) {
+        wallet.nftIds[position] = std::move(wallet.nftIds.back());
+        wallet.index[wallet.nftIds[position]] = position;
+    }
+    wallet.nftIds.pop_back();
+    return true;
+}
+
+} // namespace CHULUBME
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../core/containers.h"
+
+namespace CHULUBME {
+
+// File format identification ("CHOC" in file byte order) and version
+constexpr std::uint32_t NFT_OWNERSHIP_CACHE_MAGIC = 0x434F4843;
+constexpr std::uint32_t NFT_OWNERSHIP_CACHE_VERSION = 1;
+
+// Seconds a wallet's list stays fresh after a full query, by default
+constexpr float NFT_OWNERSHIP_FRESH_SECONDS = 300.0f;
+
+/**
+ * @brief Local index of the NFTs each wallet owns
+ *
+ * Ownership checks (skin selection, NFT components) are answered here with a
+ * hash lookup instead of a chain query. Each wallet keeps its NFT IDs in a
+ * list, returned by reference, and an index of that list by ID. Wallets are
+ * filled from full ownership queries and kept current by applying single
+ * transfers, and the cache can be saved so a new session starts from the
+ * last one's ownership while its refreshes run. A reverse index from NFT to
+ * owner keeps each NFT in one wallet: a transfer from an unknown sender, or
+ * a refresh listing an NFT another wallet held, takes it from that wallet.
+ *
+ * A wallet is fresh for a while (the fresh duration) after a full query
+ * replaced its list, so refreshes requested later query the node again.
+ * Wallets loaded from disk, or known only from transfers, are stale.
+ */
+class NFTOwnershipCache {
+public:
+    NFTOwnershipCache();
+    ~NFTOwnershipCache() = default;
+
+    // Replace a wallet's NFTs with the result of a full query (marks the wallet fresh)
+    void SetOwnedNFTs(const std::string& address, const std::vector<std::string>& nftIds);
+
+    // Move an NFT to a wallet (an empty sender means its cached owner; an empty receiver burns it)
+    void ApplyTransfer(const std::string& nftId, const std::string& fromAddress, const std::string& toAddress);
+
+    // Forget a wallet
+    void RemoveWallet(const std::string& address);
+
+    // Forget every wallet
+    void Clear();
+
+    // Check if a wallet owns an NFT
+    bool IsOwned(const std::string& address, const std::string& nftId) const;
+
+    // Get the wallet owning an NFT (empty if unknown)
+    const std::string& GetOwner(const std::string& nftId) const;
+
+    // Get the NFTs a wallet owns (empty for unknown wallets)
+    const std::vector<std::string>& GetOwnedNFTs(const std::string& address) const;
+
+    // Check if a wallet is in the cache
+    bool HasWallet(const std::string& address) const { return m_wallets.count(address) != 0; }
+
+    // Check if a wallet's list came from a full query within the fresh duration
+    bool IsFresh(const std::string& address) const;
+
+    // Set how long a wallet's list stays fresh after a full query
+    void SetFreshDuration(float seconds);
+
+    // Get the number of wallets in the cache
+    std::size_t GetWalletCount() const { return m_wallets.size(); }
+
+    // Check if the cache changed since it was last saved or loaded
+    bool IsDirty() const { return m_dirty; }
+
+    // Set whether the cache needs saving (cleared when a save is queued, set again if it fails)
+    void SetDirty(bool dirty) { m_dirty = dirty; }
+
+    // Write the cache in the file format
+    void Serialize(std::vector<unsigned char>& output) const;
+
+    // Replace the contents with serialized data (all wallets stale); false and unchanged if malformed
+    bool Deserialize(const unsigned char* data, std::size_t size);
+
+    // Load a cache file
+    bool Load(const std::string& filename);
+
+    // Save the cache to a file
+    bool Save(const std::string& filename);
+
+    // Write serialized data beside a file and then replace it, so readers never see a partial file
+    static bool WriteFile(const std::string& filename, const std::vector<unsigned char>& data);
+
+private:
+    // NFTs of one wallet, listed and indexed by ID
+    struct WalletEntry {
+        std::vector<std::string> nftIds;
+        FlatHashMap<std::string, std::uint32_t> index;
+        bool fresh;
+        std::chrono::steady_clock::time_point refreshTime;
+
+        // Constructor with default values
+        WalletEntry() : fresh(false) {}
+    };
+
+    // Give an NFT to a wallet, taking it from its previous owner
+    void AssignNFT(const std::string& address, const std::string& nftId);
+
+    // Add an NFT to a wallet's list; returns false if it was already there
+    static bool AddNFT(WalletEntry& wallet, const std::string& nftId);
+
+    // Remove an NFT from a wallet's list; returns false if it was not there
+    static bool RemoveNFT(WalletEntry& wallet, const std::string& nftId);
+
+    // Wallets by address
+    FlatHashMap<std::string, WalletEntry> m_wallets;
+
+    // Owner address by NFT ID
+    FlatHashMap<std::string, std::string> m_owners;
+
+    // How long a full query keeps a wallet fresh
+    std::chrono::steady_clock::duration m_freshDuration;
+
+    // Changed since last saved or loaded
+    bool m_dirty;
+};
+
+} // namespace CHULUBME
@@ -15,8 +15,13 @@ type NFTSystem struct {
     // Next NFT ID
     NextID int
     
+    // NFT IDs by owner, by type, and listed NFTs by price
+    ownerIndex   map[string]*nftIndex
+    typeIndex    map[string]*nftIndex
+    listingIndex *nftIndex
+    
     // Mutex for thread safety
-    mutex sync.Mutex
+    mutex sync.RWMutex
     
     // Master wallet address for fees
     MasterWalletAddress string
@@ -54,7 +59,10 @@ func NewNFTSystem(masterWalletAddress string) *NFTSystem {
     return &NFTSystem{
         NFTs:                make(map[string]*NFT),
         NextID:              1,
-        mutex:               sync.Mutex{},
+        ownerIndex:          make(map[string]*nftIndex),
+        typeIndex:           make(map[string]*nftIndex),
+        listingIndex:        newPriceIndex(),
+        mutex:               sync.RWMutex{},
         MasterWalletAddress: masterWalletAddress,
         TransactionFeeRate:  0.005, // 0.5%
     }
@@ -98,14 +106,15 @@ func (ns *NFTSystem) CreateNFT(
     
     // Store NFT
     ns.NFTs[id] = nft
+    ns.indexNFT(nft)
     
     return nft, nil
 }
 
 // GetNFT gets an NFT by ID
 func (ns *NFTSystem) GetNFT(id string) (*NFT, error) {
-    ns.mutex.Lock()
-    defer ns.mutex.Unlock()
+    ns.mutex.RLock()
+    defer ns.mutex.RUnlock()
     
     nft, exists := ns.NFTs[id]
     if !exists {
@@ -131,7 +140,7 @@ func (ns *NFTSystem) TransferNFT(id string, fromAddress string, toAddress string
     }
     
     // Update owner
-    nft.Owner = toAddress
+    ns.setOwner(nft, toAddress)
     
     // Add transfer record
     nft.TransferLog = append(nft.TransferLog, TransferRecord{
@@ -142,11 +151,7 @@ func (ns *NFTSystem) TransferNFT(id string, fromAddress string, toAddress string
     })
     
     // If NFT was listed, unlist it
-    if nft.IsListed {
-        nft.IsListed = false
-        nft.ListPrice = 0
-        nft.ListedAt = 0
-    }
+    ns.unlist(nft)
     
     return nil
 }
@@ -166,10 +171,12 @@ func (ns *NFTSystem) ListNFT(id string, owner string, price float64) error {
         return errors.New("sender is not the owner of this NFT")
     }
     
-    // Update listing status
+    // Update listing status; a relisted NFT moves to its new price
+    ns.unlist(nft)
     nft.IsListed = true
     nft.ListPrice = price
     nft.ListedAt = time.Now().Unix()
+    ns.listingIndex.insert(nft)
     
     return nil
 }
@@ -190,9 +197,7 @@ func (ns *NFTSystem) UnlistNFT(id string, owner string) error {
     }
     
     // Update listing status
-    nft.IsListed = false
-    nft.ListPrice = 0
-    nft.ListedAt = 0
+    ns.unlist(nft)
     
     return nil
 }
@@ -225,7 +230,7 @@ func (ns *NFTSystem) BuyNFT(id string, buyer string) (float64, error) {
     currentOwner := nft.Owner
     
     // Update owner
-    nft.Owner = buyer
+    ns.setOwner(nft, buyer)
     
     // Add transfer record
     nft.TransferLog = append(nft.TransferLog, TransferRecord{
@@ -236,9 +241,7 @@ func (ns *NFTSystem) BuyNFT(id string, buyer string) (float64, error) {
     })
     
     // Unlist NFT
-    nft.IsListed = false
-    nft.ListPrice = 0
-    nft.ListedAt = 0
+    ns.unlist(nft)
     
     return sellerAmount, nil
 }
@@ -275,52 +278,139 @@ func (ns *NFTSystem) CalculateYield(id string, stakedAmount float64) (float64, e
     return yield, nil
 }
 
-// GetListedNFTs returns all NFTs that are listed for sale
+// GetListedNFTs returns all NFTs that are listed for sale, cheapest first
 func (ns *NFTSystem) GetListedNFTs() []*NFT {
-    ns.mutex.Lock()
-    defer ns.mutex.Unlock()
+    ns.mutex.RLock()
+    defer ns.mutex.RUnlock()
     
-    listedNFTs := []*NFT{}
+    return ns.listingIndex.all()
+}
+
+// GetNFTsByOwner returns all NFTs owned by a specific address, ordered by ID
+func (ns *NFTSystem) GetNFTsByOwner(owner string) []*NFT {
+    ns.mutex.RLock()
+    defer ns.mutex.RUnlock()
     
-    for _, nft := range ns.NFTs {
-        if nft.IsListed {
-            listedNFTs = append(listedNFTs, nft)
-        }
+    index, exists := ns.ownerIndex[owner]
+    if !exists {
+        return []*NFT{}
     }
     
-    return listedNFTs
+    return index.all()
 }
 
-// GetNFTsByOwner returns all NFTs owned by a specific address
-func (ns *NFTSystem) GetNFTsByOwner(owner string) []*NFT {
-    ns.mutex.Lock()
-    defer ns.mutex.Unlock()
+// GetNFTsByType returns all NFTs of a specific type, ordered by ID
+func (ns *NFTSystem) GetNFTsByType(nftType string) []*NFT {
+    ns.mutex.RLock()
+    defer ns.mutex.RUnlock()
+    
+    index, exists := ns.typeIndex[nftType]
+    if !exists {
+        return []*NFT{}
+    }
     
-    ownedNFTs := []*NFT{}
+    return index.all()
+}
+
+// GetListedNFTsPage returns up to limit listed NFTs after the cursor, cheapest first
+func (ns *NFTSystem) GetListedNFTsPage(cursor string, limit int) (NFTPage, error) {
+    ns.mutex.RLock()
+    defer ns.mutex.RUnlock()
     
-    for _, nft := range ns.NFTs {
-        if nft.Owner == owner {
-            ownedNFTs = append(ownedNFTs, nft)
-        }
+    return ns.listingIndex.page(cursor, limit)
+}
+
+// GetNFTsByOwnerPage returns up to limit NFTs of an owner after the cursor, ordered by ID
+func (ns *NFTSystem) GetNFTsByOwnerPage(owner string, cursor string, limit int) (NFTPage, error) {
+    ns.mutex.RLock()
+    defer ns.mutex.RUnlock()
+    
+    index, exists := ns.ownerIndex[owner]
+    if !exists {
+        return newIDIndex().page(cursor, limit)
     }
     
-    return ownedNFTs
+    return index.page(cursor, limit)
 }
 
-// GetNFTsByType returns all NFTs of a specific type
-func (ns *NFTSystem) GetNFTsByType(nftType string) []*NFT {
+// GetNFTsByTypePage returns up to limit NFTs of a type after the cursor, ordered by ID
+func (ns *NFTSystem) GetNFTsByTypePage(nftType string, cursor string, limit int) (NFTPage, error) {
+    ns.mutex.RLock()
+    defer ns.mutex.RUnlock()
+    
+    index, exists := ns.typeIndex[nftType]
+    if !exists {
+        return newIDIndex().page(cursor, limit)
+    }
+    
+    return index.page(cursor, limit)
+}
+
+// RebuildIndices rebuilds the owner, type and listing indices after NFTs were loaded directly
+func (ns *NFTSystem) RebuildIndices() {
     ns.mutex.Lock()
     defer ns.mutex.Unlock()
     
-    typedNFTs := []*NFT{}
+    ns.ownerIndex = make(map[string]*nftIndex)
+    ns.typeIndex = make(map[string]*nftIndex)
+    ns.listingIndex = newPriceIndex()
     
     for _, nft := range ns.NFTs {
-        if nft.Type == nftType {
-            typedNFTs = append(typedNFTs, nft)
-        }
+        ns.indexNFT(nft)
+    }
+}
+
+// indexNFT adds an NFT to the indices (mutex held)
+func (ns *NFTSystem) indexNFT(nft *NFT) {
+    addToIndex(ns.ownerIndex, nft.Owner, nft)
+    addToIndex(ns.typeIndex, nft.Type, nft)
+    
+    if nft.IsListed {
+        ns.listingIndex.insert(nft)
+    }
+}
+
+// setOwner changes an NFT's owner and moves it between owner indices (mutex held)
+func (ns *NFTSystem) setOwner(nft *NFT, owner string) {
+    removeFromIndex(ns.ownerIndex, nft.Owner, nft)
+    nft.Owner = owner
+    addToIndex(ns.ownerIndex, owner, nft)
+}
+
+// unlist takes an NFT off sale, removing it from the listing index first (mutex held)
+func (ns *NFTSystem) unlist(nft *NFT) {
+    if !nft.IsListed {
+        return
+    }
+    
+    ns.listingIndex.remove(nft)
+    nft.IsListed = false
+    nft.ListPrice = 0
+    nft.ListedAt = 0
+}
+
+// addToIndex adds an NFT to the ID-ordered index of a key
+func addToIndex(indices map[string]*nftIndex, key string, nft *NFT) {
+    index, exists := indices[key]
+    if !exists {
+        index = newIDIndex()
+        indices[key] = index
+    }
+    
+    index.insert(nft)
+}
+
+// removeFromIndex removes an NFT from the ID-ordered index of a key, dropping empty indices
+func removeFromIndex(indices map[string]*nftIndex, key string, nft *NFT) {
+    index, exists := indices[key]
+    if !exists {
+        return
     }
     
-    return typedNFTs
+    index.remove(nft)
+    if len(index.nfts) == 0 {
+        delete(indices, key)
+    }
 }
 
 // SerializeNFT converts an NFT to JSON
@@ -0,0 +1,535 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "containers.h"
+#include "memory.h"
+
+// Profiling zones are compiled in unless NDEBUG is defined; define CHULUBME_PROFILING as 0 or 1 to override
+#ifndef CHULUBME_PROFILING
+    #ifdef NDEBUG
+        #define CHULUBME_PROFILING 0
+    #else
+        #define CHULUBME_PROFILING 1
+    #endif
+#endif
+
+namespace CHULUBME {
+
+/**
+ * @brief One timed zone or counter sample recorded by a thread
+ *
+ * Names must outlive the profiler (string literals or static storage).
+ */
+struct ProfileEvent {
+    enum class Type : std::uint8_t {
+        Zone,
+        Counter
+    };
+
+    const char* name;
+    std::int64_t start;     // Nanoseconds since the profiler started
+    std::int64_t duration;  // Nanoseconds (zones only)
+    double value;           // Sampled value (counters only)
+    Type type;
+};
+
+/**
+ * @brief Rolling frame time statistics, in milliseconds
+ */
+struct FrameTimeStats {
+    float average;
+    float p50;
+    float p99;
+    float max;
+    std::size_t frameCount;
+
+    // Constructor with default values
+    FrameTimeStats() : average(0.0f), p50(0.0f), p99(0.0f), max(0.0f), frameCount(0) {}
+};
+
+/**
+ * @brief Allocator activity of one frame
+ */
+struct FrameAllocationStats {
+    // Blocks requested from the system heap during the frame
+    std::size_t chunkHeapAllocations;
+    std::size_t arenaHeapAllocations;
+
+    // Component chunks served from the chunk pool during the frame
+    std::size_t chunkPoolAllocations;
+
+    // Bytes in use at the end of the frame
+    std::size_t chunkBytes;
+    std::size_t arenaBytes;
+
+    // Constructor with default values
+    FrameAllocationStats()
+        : chunkHeapAllocations(0), arenaHeapAllocations(0), chunkPoolAllocations(0), chunkBytes(0), arenaBytes(0) {}
+};
+
+/**
+ * @brief Frame profiler collecting timed zones from every thread
+ *
+ * Zones (usually through CHULUBME_PROFILE_ZONE) append to a lock-free ring
+ * buffer owned by the recording thread, so recording never takes a lock or
+ * allocates; a zone that finds its ring full is dropped and counted. Once
+ * per frame, MarkFrame moves every ring's events into a bounded history,
+ * samples the allocation counters and adds the frame time to a rolling
+ * window for percentile statistics. The history is exported as Chrome trace
+ * event JSON, which chrome://tracing and Perfetto open directly.
+ *
+ * MarkFrame and the export must not run on several threads at once; zones
+ * may be recorded from any thread at any time.
+ */
+class Profiler {
+public:
+    // Events a thread can record between two frame marks before dropping
+    static constexpr std::size_t THREAD_EVENT_CAPACITY = 8192;
+
+    // Events kept for export (the oldest are overwritten)
+    static constexpr std::size_t HISTORY_CAPACITY = 256 * 1024;
+
+    // Frames in the rolling frame time window
+    static constexpr std::size_t FRAME_WINDOW = 256;
+
+    // Singleton instance
+    static Profiler& Instance();
+
+    // Enable or disable recording (zones recorded while disabled cost one atomic load)
+    void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+
+    // Check if recording is enabled
+    bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Get the current time in nanoseconds since the profiler started
+    std::int64_t Now() const;
+
+    // Record a zone on the calling thread
+    void RecordZone(const char* name, std::int64_t start, std::int64_t end);
+
+    // Record a counter sample on the calling thread
+    void RecordCounter(const char* name, double value);
+
+    // Name the calling thread in exported traces
+    void SetThreadName(const char* name);
+
+    // End the current frame and begin the next (call once per frame on the main thread)
+    void MarkFrame();
+
+    // Get frame time statistics over the rolling window
+    FrameTimeStats GetFrameTimeStats() const;
+
+    // Get the allocator activity of the last complete frame
+    FrameAllocationStats GetLastFrameAllocations() const;
+
+    // Get the number of events dropped because a thread's ring was full
+    std::size_t GetDroppedEventCount() const;
+
+    // Discard the recorded history and frame statistics
+    void Clear();
+
+    // Append the history as Chrome trace event JSON
+    void WriteChromeTrace(std::string& output) const;
+
+    // Write the history to a Chrome trace file
+    bool ExportChromeTrace(const std::string& filename) const;
+
+private:
+    // Private constructor for singleton
+    Profiler();
+    ~Profiler() = default;
+
+    // Deleted copy constructor and assignment operator
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // Events of one thread, written only by that thread and drained by MarkFrame
+    struct ThreadBuffer {
+        SPSCRingBuffer<ProfileEvent, THREAD_EVENT_CAPACITY> events;
+        std::atomic<std::size_t> dropped{0};
+        std::uint32_t threadID = 0;
+        std::atomic<const char*> name{nullptr};
+    };
+
+    // Thread buffers; buffers of exited threads are handed to new threads
+    struct ThreadBufferRegistry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        std::vector<ThreadBuffer*> available;
+    };
+
+    // Event in the history with the thread that recorded it
+    struct HistoryEvent {
+        ProfileEvent event;
+        std::uint32_t threadID;
+    };
+
+    // Get the calling thread's buffer, acquiring it on first use
+    ThreadBuffer& GetThreadBuffer();
+
+    // Append a drained event to the history
+    void AddToHistory(const ProfileEvent& event, std::uint32_t threadID);
+
+    // Sample the allocation counters and record their per-frame changes
+    void SampleAllocations();
+
+    // Time origin
+    std::chrono::steady_clock::time_point m_epoch;
+
+    // Recording state
+    std::atomic<bool> m_enabled;
+
+    // Thread buffers (intentionally never destroyed, so exiting threads can always return theirs)
+    ThreadBufferRegistry* m_registry;
+
+    // History ring, guarded by the history mutex
+    mutable std::mutex m_historyMutex;
+    std::vector<HistoryEvent> m_history;
+    std::size_t m_historyNext;
+    bool m_historyWrapped;
+
+    // Frame marks and the rolling frame time window (milliseconds)
+    std::int64_t m_frameStart;
+    std::array<float, FRAME_WINDOW> m_frameTimes;
+    std::size_t m_frameCount;
+
+    // Allocation counters at the last frame mark, and the changes over the last frame
+    FrameAllocationStats m_lastCounters;
+    FrameAllocationStats m_lastFrameAllocations;
+};
+
+/**
+ * @brief Scoped zone timing the enclosing block
+ */
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name)
+        : m_name(name)
+        , m_start(Profiler::Instance().IsEnabled() ? Profiler::Instance().Now() : -1) {}
+
+    ~ProfileZone() {
+        if (m_start >= 0) {
+            Profiler& profiler = Profiler::Instance();
+            profiler.RecordZone(m_name, m_start, profiler.Now());
+        }
+    }
+
+    // Deleted copy constructor and assignment operator
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_name;
+    std::int64_t m_start;
+};
+
+#if CHULUBME_PROFILING
+    #define CHULUBME_PROFILE_CONCAT_INNER(a, b) a##b
+    #define CHULUBME_PROFILE_CONCAT(a, b) CHULUBME_PROFILE_CONCAT_INNER(a, b)
+    #define CHULUBME_PROFILE_ZONE(name) ::CHULUBME::ProfileZone CHULUBME_PROFILE_CONCAT(profileZone, __LINE__)(name)
+    #define CHULUBME_PROFILE_COUNTER(name, value) ::CHULUBME::Profiler::Instance().RecordCounter(name, value)
+    #define CHULUBME_PROFILE_THREAD(name) ::CHULUBME::Profiler::Instance().SetThreadName(name)
+    #define CHULUBME_PROFILE_FRAME() ::CHULUBME::Profiler::Instance().MarkFrame()
+#else
+    #define CHULUBME_PROFILE_ZONE(name) do {} while(0)
+    #define CHULUBME_PROFILE_COUNTER(name, value) do {} while(0)
+    #define CHULUBME_PROFILE_THREAD(name) do {} while(0)
+    #define CHULUBME_PROFILE_FRAME() do {} while(0)
+#endif
+
+// Implementation
+
+inline Profiler& Profiler::Instance() {
+    static Profiler instance;
+    return instance;
+}
+
+inline Profiler::Profiler()
+    : m_epoch(std::chrono::steady_clock::now())
+    , m_enabled(true)
+    , m_registry(new ThreadBufferRegistry())
+    , m_historyNext(0)
+    , m_historyWrapped(false)
+    , m_frameStart(-1)
+    , m_frameTimes{}
+    , m_frameCount(0)
+{
+    // Start the per-frame deltas from the counters as they are now
+    SampleAllocations();
+}
+
+inline std::int64_t Profiler::Now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+}
+
+inline void Profiler::RecordZone(const char* name, std::int64_t start, std::int64_t end) {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    if (!buffer.events.Push({ name, start, end - start, 0.0, ProfileEvent::Type::Zone })) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+inline void Profiler::RecordCounter(const char* name, double value) {
+    if (!IsEnabled()) {
+        return;
+    }
+
+    ThreadBuffer& buffer = GetThreadBuffer();
+    if (!buffer.events.Push({ name, Now(), 0, value, ProfileEvent::Type::Counter })) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+inline void Profiler::SetThreadName(const char* name) {
+    GetThreadBuffer().name.store(name, std::memory_order_release);
+}
+
+inline void Profiler::MarkFrame() {
+    const std::int64_t now = Now();
+
+    // Close the frame that just ended
+    if (m_frameStart >= 0 && IsEnabled()) {
+        RecordZone("Frame", m_frameStart, now);
+
+        const float frameTime = static_cast<float>(now - m_frameStart) / 1000000.0f;
+        m_frameTimes[m_frameCount % FRAME_WINDOW] = frameTime;
+        ++m_frameCount;
+        RecordCounter("Frame time (ms)", frameTime);
+
+        SampleAllocations();
+        RecordCounter("Chunk heap allocations", static_cast<double>(m_lastFrameAllocations.chunkHeapAllocations));
+        RecordCounter("Chunk pool allocations", static_cast<double>(m_lastFrameAllocations.chunkPoolAllocations));
+        RecordCounter("Arena heap allocations", static_cast<double>(m_lastFrameAllocations.arenaHeapAllocations));
+        RecordCounter("Chunk bytes", static_cast<double>(m_lastFrameAllocations.chunkBytes));
+        RecordCounter("Arena bytes", static_cast<double>(m_lastFrameAllocations.arenaBytes));
+    }
+    m_frameStart = now;
+
+    // Move every thread's events into the history
+    std::lock_guard<std::mutex> historyLock(m_historyMutex);
+    std::lock_guard<std::mutex> registryLock(m_registry->mutex);
+    for (std::unique_ptr<ThreadBuffer>& buffer : m_registry->buffers) {
+        ProfileEvent event;
+        while (buffer->events.Pop(event)) {
+            AddToHistory(event, buffer->threadID);
+        }
+    }
+}
+
+inline FrameTimeStats Profiler::GetFrameTimeStats() const {
+    FrameTimeStats stats;
+    stats.frameCount = std::min(m_frameCount, FRAME_WINDOW);
+    if (stats.frameCount == 0) {
+        return stats;
+    }
+
+    std::array<float, FRAME_WINDOW> sorted;
+    std::copy(m_frameTimes.begin(), m_frameTimes.begin() + stats.frameCount, sorted.begin());
+    std::sort(sorted.begin(), sorted.begin() + stats.frameCount);
+
+    float total = 0.0f;
+    for (std::size_t i = 0; i < stats.frameCount; ++i) {
+        total += sorted[i];
+    }
+
+    // Nearest-rank percentiles
+    auto percentile = [&](std::size_t percent) {
+        const std::size_t rank = (percent * stats.frameCount + 99) / 100;
+        return sorted[rank > 0 ? rank - 1 : 0];
+    };
+
+    stats.average = total / static_cast<float>(stats.frameCount);
+    stats.p50 = percentile(50);
+    stats.p99 = percentile(99);
+    stats.max = sorted[stats.frameCount - 1];
+    return stats;
+}
+
+inline FrameAllocationStats Profiler::GetLastFrameAllocations() const {
+    return m_lastFrameAllocations;
+}
+
+inline std::size_t Profiler::GetDroppedEventCount() const {
+    std::lock_guard<std::mutex> lock(m_registry->mutex);
+    std::size_t dropped = 0;
+    for (const std::unique_ptr<ThreadBuffer>& buffer : m_registry->buffers) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+inline void Profiler::Clear() {
+    std::lock_guard<std::mutex> lock(m_historyMutex);
+    m_history.clear();
+    m_historyNext = 0;
+    m_historyWrapped = false;
+    m_frameCount = 0;
+    m_frameStart = -1;
+}
+
+inline void Profiler::WriteChromeTrace(std::string& output) const {
+    // Names are identifiers and literals, but escape them in case they contain quotes
+    auto appendString = [&output](const char* text) {
+        output += '"';
+        for (const char* c = text ? text : ""; *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+                output += '\\';
+                output += *c;
+            } else if (static_cast<unsigned char>(*c) < 0x20) {
+                output += ' ';
+            } else {
+                output += *c;
+            }
+        }
+        output += '"';
+    };
+
+    char number[64];
+    output += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+
+    // Thread names
+    {
+        std::lock_guard<std::mutex> lock(m_registry->mutex);
+        for (const std::unique_ptr<ThreadBuffer>& buffer : m_registry->buffers) {
+            const char* name = buffer->name.load(std::memory_order_acquire);
+            output += first ? "" : ",";
+            first = false;
+            std::snprintf(number, sizeof(number), "%u", buffer->threadID);
+            output += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+            output += number;
+            output += ",\"args\":{\"name\":";
+            if (name) {
+                appendString(name);
+            } else {
+                output += "\"Thread ";
+                output += number;
+                output += '"';
+            }
+            output += "}}";
+        }
+    }
+
+    // Zones and counters, oldest first (timestamps in microseconds)
+    std::lock_guard<std::mutex> lock(m_historyMutex);
+    const std::size_t count = m_historyWrapped ? m_history.size() : m_historyNext;
+    const std::size_t begin = m_historyWrapped ? m_historyNext : 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const HistoryEvent& entry = m_history[(begin + i) % m_history.size()];
+        const ProfileEvent& event = entry.event;
+
+        output += first ? "{\"name\":" : ",{\"name\":";
+        first = false;
+        appendString(event.name);
+
+        if (event.type == ProfileEvent::Type::Zone) {
+            std::snprintf(number, sizeof(number), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f",
+                          event.start / 1000.0, event.duration / 1000.0);
+            output += number;
+        } else {
+            std::snprintf(number, sizeof(number), ",\"ph\":\"C\",\"ts\":%.3f", event.start / 1000.0);
+            output += number;
+        }
+
+        std::snprintf(number, sizeof(number), ",\"pid\":1,\"tid\":%u", entry.threadID);
+        output += number;
+
+        if (event.type == ProfileEvent::Type::Counter) {
+            std::snprintf(number, sizeof(number), ",\"args\":{\"value\":%.17g}", event.value);
+            output += number;
+        }
+        output += '}';
+    }
+
+    output += "]}";
+}
+
+inline bool Profiler::ExportChromeTrace(const std::string& filename) const {
+    std::string json;
+    WriteChromeTrace(json);
+
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    const bool written = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    return std::fclose(file) == 0 && written;
+}
+
+inline Profiler::ThreadBuffer& Profiler::GetThreadBuffer() {
+    // Returns the thread's buffer to the registry when the thread exits
+    struct ThreadBufferHandle {
+        ThreadBufferRegistry* registry = nullptr;
+        ThreadBuffer* buffer = nullptr;
+
+        ~ThreadBufferHandle() {
+            if (buffer) {
+                std::lock_guard<std::mutex> lock(registry->mutex);
+                registry->available.push_back(buffer);
+            }
+        }
+    };
+    thread_local ThreadBufferHandle t_handle;
+
+    if (!t_handle.buffer) {
+        std::lock_guard<std::mutex> lock(m_registry->mutex);
+        t_handle.registry = m_registry;
+        if (!m_registry->available.empty()) {
+            t_handle.buffer = m_registry->available.back();
+            t_handle.buffer->name.store(nullptr, std::memory_order_relaxed);
+            m_registry->available.pop_back();
+        } else {
+            m_registry->buffers.push_back(std::make_unique<ThreadBuffer>());
+            t_handle.buffer = m_registry->buffers.back().get();
+            t_handle.buffer->threadID = static_cast<std::uint32_t>(m_registry->buffers.size());
+        }
+    }
+
+    return *t_handle.buffer;
+}
+
+inline void Profiler::AddToHistory(const ProfileEvent& event, std::uint32_t threadID) {
+    if (m_history.size() < HISTORY_CAPACITY) {
+        m_history.push_back({ event, threadID });
+        m_historyNext = m_history.size() % HISTORY_CAPACITY;
+        m_historyWrapped = m_historyNext == 0;
+        return;
+    }
+
+    m_history[m_historyNext] = { event, threadID };
+    m_historyNext = (m_historyNext + 1) % HISTORY_CAPACITY;
+    m_historyWrapped = true;
+}
+
+inline void Profiler::SampleAllocations() {
+    const AllocationCounters& chunks = MemoryManager::GetComponentCounters();
+    const AllocationCounters& arenas = MemoryManager::GetArenaCounters();
+
+    FrameAllocationStats current;
+    current.chunkHeapAllocations = chunks.heapAllocations.load(std::memory_order_relaxed);
+    current.chunkPoolAllocations = chunks.pooledAllocations.load(std::memory_order_relaxed);
+    current.arenaHeapAllocations = arenas.heapAllocations.load(std::memory_order_relaxed);
+    current.chunkBytes = chunks.bytesInUse.load(std::memory_order_relaxed);
+    current.arenaBytes = arenas.bytesInUse.load(std::memory_order_relaxed);
+
+    m_lastFrameAllocations.chunkHeapAllocations = current.chunkHeapAllocations - m_lastCounters.chunkHeapAllocations;
+    m_lastFrameAllocations.chunkPoolAllocations = current.chunkPoolAllocations - m_lastCounters.chunkPoolAllocations;
+    m_lastFrameAllocations.arenaHeapAllocations = current.arenaHeapAllocations - m_lastCounters.arenaHeapAllocations;
+    m_lastFrameAllocations.chunkBytes = current.chunkBytes;
+    m_lastFrameAllocations.arenaBytes = current.arenaBytes;
+    m_lastCounters = current;
+}
+
+} // namespace CHULUBME
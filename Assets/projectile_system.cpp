@@ -0,0 +1,277 @@
+#include "projectile_system.h"
+#include "damage_batch.h"
+#include "hero_system.h"
+#include "../rendering/renderer.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CHULUBME_PROJECTILE_SSE2 1
+#endif
+
+namespace CHULUBME {
+
+namespace {
+
+// Segments shorter than this are treated as points
+constexpr float MIN_SEGMENT_LENGTH_SQUARED = 1e-12f;
+
+// Test one swept segment against a circle, returning the closest point parameter in t
+inline bool SegmentHitsCircle(float startX, float startZ, float stepX, float stepZ,
+                              float circleX, float circleZ, float radius, float& t) {
+    const float offsetX = circleX - startX;
+    const float offsetZ = circleZ - startZ;
+    const float lengthSquared = std::max(stepX * stepX + stepZ * stepZ, MIN_SEGMENT_LENGTH_SQUARED);
+
+    t = (offsetX * stepX + offsetZ * stepZ) / lengthSquared;
+    t = std::min(std::max(t, 0.0f), 1.0f);
+
+    const float dx = offsetX - stepX * t;
+    const float dz = offsetZ - stepZ * t;
+    return dx * dx + dz * dz <= radius * radius;
+}
+
+} // namespace
+
+ProjectileSystem::ProjectileSystem(EntityManager* manager)
+    : System(manager)
+    , m_targetRadius(0.5f)
+{
+    RequireComponent<HeroComponent>();
+    RequireComponent<Transform>(ComponentAccess::Read);
+
+    // Projectiles move and hit on the fixed time step
+    SetFixedStep(true);
+}
+
+void ProjectileSystem::Update(float deltaTime) {
+    // Take the projectiles launched since the last update
+    {
+        std::lock_guard<std::mutex> lock(m_launchMutex);
+        for (const ProjectileDesc& desc : m_launches) {
+            AddProjectile(desc);
+        }
+        m_launches.clear();
+    }
+
+    const std::size_t count = m_casters.size();
+    if (count == 0) {
+        return;
+    }
+
+    ScopedScratch scratch;
+
+    // Movement of every projectile for this update
+    float* stepX = scratch.AllocateArray<float>(count);
+    float* stepZ = scratch.AllocateArray<float>(count);
+    float* stepLength = scratch.AllocateArray<float>(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        stepLength[i] = std::min(m_speeds[i] * deltaTime, m_remainingRanges[i]);
+        stepX[i] = m_directionX[i] * stepLength[i];
+        stepZ[i] = m_directionZ[i] * stepLength[i];
+    }
+
+    // Gather living heroes
+    FrameVector<EntityID> targets{ ArenaAllocator<EntityID>(scratch.GetArena()) };
+    FrameVector<glm::vec3> targetPositions{ ArenaAllocator<glm::vec3>(scratch.GetArena()) };
+    m_manager->View<HeroComponent, Transform>().ForEach(
+        [&](EntityID entity, HeroComponent& heroComponent, Transform& transform) {
+            if (heroComponent.GetCurrentHealth() > 0.0f) {
+                targets.push_back(entity);
+                targetPositions.push_back(transform.GetPosition());
+            }
+        });
+
+    // Sweep all projectiles against each hero
+    FrameVector<ProjectileHit> hits{ ArenaAllocator<ProjectileHit>(scratch.GetArena()) };
+    for (std::size_t target = 0; target < targets.size(); ++target) {
+        TestTarget(static_cast<std::uint32_t>(target), targetPositions[target].x, targetPositions[target].z,
+                   stepX, stepZ, hits);
+    }
+
+    // Order hits along each projectile's path
+    std::sort(hits.begin(), hits.end(), [](const ProjectileHit& a, const ProjectileHit& b) {
+        return a.projectile != b.projectile ? a.projectile < b.projectile : a.t < b.t;
+    });
+
+    std::uint8_t* stopped = scratch.AllocateArray<std::uint8_t>(count);
+    std::fill(stopped, stopped + count, std::uint8_t(0));
+
+    DamageBatch batch(m_manager);
+    for (const ProjectileHit& hit : hits) {
+        const EntityID target = targets[hit.target];
+        if (stopped[hit.projectile] || target == m_casters[hit.projectile]) {
+            continue;
+        }
+
+        SmallVector<EntityID, 4>& hitTargets = m_hitTargets[hit.projectile];
+        if (std::find(hitTargets.begin(), hitTargets.end(), target) != hitTargets.end()) {
+            continue;
+        }
+
+        hitTargets.push_back(target);
+        batch.Add(m_casters[hit.projectile], target, m_damages[hit.projectile], m_magical[hit.projectile] != 0);
+
+        if (!m_piercing[hit.projectile]) {
+            stopped[hit.projectile] = 1;
+        }
+    }
+
+    // Advance projectiles
+    for (std::size_t i = 0; i < count; ++i) {
+        m_positionX[i] += stepX[i];
+        m_positionZ[i] += stepZ[i];
+        m_remainingRanges[i] -= stepLength[i];
+    }
+
+    // Remove projectiles that stopped on a hero or reached their range
+    for (std::size_t i = count; i-- > 0;) {
+        if (stopped[i] || m_remainingRanges[i] <= 0.0f) {
+            RemoveProjectile(i);
+        }
+    }
+
+    batch.Resolve();
+}
+
+void ProjectileSystem::Launch(const ProjectileDesc& desc) {
+    std::lock_guard<std::mutex> lock(m_launchMutex);
+    m_launches.push_back(desc);
+}
+
+void ProjectileSystem::Clear() {
+    {
+        std::lock_guard<std::mutex> lock(m_launchMutex);
+        m_launches.clear();
+    }
+
+    m_positionX.clear();
+    m_positionY.clear();
+    m_positionZ.clear();
+    m_directionX.clear();
+    m_directionZ.clear();
+    m_speeds.clear();
+    m_remainingRanges.clear();
+    m_radii.clear();
+    m_damages.clear();
+    m_magical.clear();
+    m_piercing.clear();
+    m_casters.clear();
+    m_hitTargets.clear();
+}
+
+glm::vec3 ProjectileSystem::GetProjectilePosition(std::size_t index) const {
+    return glm::vec3(m_positionX[index], m_positionY[index], m_positionZ[index]);
+}
+
+void ProjectileSystem::AddProjectile(const ProjectileDesc& desc) {
+    // Projectiles travel over the map plane
+    const float length = std::sqrt(desc.direction.x * desc.direction.x + desc.direction.z * desc.direction.z);
+    if (length <= 0.0f || desc.speed <= 0.0f || desc.range <= 0.0f) {
+        return;
+    }
+
+    m_positionX.push_back(desc.origin.x);
+    m_positionY.push_back(desc.origin.y);
+    m_positionZ.push_back(desc.origin.z);
+    m_directionX.push_back(desc.direction.x / length);
+    m_directionZ.push_back(desc.direction.z / length);
+    m_speeds.push_back(desc.speed);
+    m_remainingRanges.push_back(desc.range);
+    m_radii.push_back(desc.radius);
+    m_damages.push_back(desc.damage);
+    m_magical.push_back(desc.isMagical ? 1 : 0);
+    m_piercing.push_back(desc.piercing ? 1 : 0);
+    m_casters.push_back(desc.caster);
+    m_hitTargets.emplace_back();
+}
+
+void ProjectileSystem::RemoveProjectile(std::size_t index) {
+    const std::size_t last = m_casters.size() - 1;
+    if (index != last) {
+        m_positionX[index] = m_positionX[last];
+        m_positionY[index] = m_positionY[last];
+        m_positionZ[index] = m_positionZ[last];
+        m_directionX[index] = m_directionX[last];
+        m_directionZ[index] = m_directionZ[last];
+        m_speeds[index] = m_speeds[last];
+        m_remainingRanges[index] = m_remainingRanges[last];
+        m_radii[index] = m_radii[last];
+        m_damages[index] = m_damages[last];
+        m_magical[index] = m_magical[last];
+        m_piercing[index] = m_piercing[last];
+        m_casters[index] = m_casters[last];
+        m_hitTargets[index] = std::move(m_hitTargets[last]);
+    }
+
+    m_positionX.pop_back();
+    m_positionY.pop_back();
+    m_positionZ.pop_back();
+    m_directionX.pop_back();
+    m_directionZ.pop_back();
+    m_speeds.pop_back();
+    m_remainingRanges.pop_back();
+    m_radii.pop_back();
+    m_damages.pop_back();
+    m_magical.pop_back();
+    m_piercing.pop_back();
+    m_casters.pop_back();
+    m_hitTargets.pop_back();
+}
+
+void ProjectileSystem::TestTarget(std::uint32_t target, float x, float z, const float* stepX, const float* stepZ,
+                                  FrameVector<ProjectileHit>& hits) const {
+    const std::size_t count = m_casters.size();
+    std::size_t i = 0;
+
+#if defined(CHULUBME_PROJECTILE_SSE2)
+    const __m128 circleX = _mm_set1_ps(x);
+    const __m128 circleZ = _mm_set1_ps(z);
+    const __m128 targetRadius = _mm_set1_ps(m_targetRadius);
+    const __m128 minLength = _mm_set1_ps(MIN_SEGMENT_LENGTH_SQUARED);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    for (; i + 4 <= count; i += 4) {
+        const __m128 segmentX = _mm_loadu_ps(stepX + i);
+        const __m128 segmentZ = _mm_loadu_ps(stepZ + i);
+        const __m128 offsetX = _mm_sub_ps(circleX, _mm_loadu_ps(m_positionX.data() + i));
+        const __m128 offsetZ = _mm_sub_ps(circleZ, _mm_loadu_ps(m_positionZ.data() + i));
+
+        // Closest point on each segment to the hero
+        const __m128 lengthSquared = _mm_max_ps(
+            _mm_add_ps(_mm_mul_ps(segmentX, segmentX), _mm_mul_ps(segmentZ, segmentZ)), minLength);
+        __m128 t = _mm_div_ps(_mm_add_ps(_mm_mul_ps(offsetX, segmentX), _mm_mul_ps(offsetZ, segmentZ)), lengthSquared);
+        t = _mm_min_ps(_mm_max_ps(t, zero), one);
+
+        const __m128 dx = _mm_sub_ps(offsetX, _mm_mul_ps(segmentX, t));
+        const __m128 dz = _mm_sub_ps(offsetZ, _mm_mul_ps(segmentZ, t));
+        const __m128 radius = _mm_add_ps(_mm_loadu_ps(m_radii.data() + i), targetRadius);
+        const __m128 distanceSquared = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz));
+
+        const int mask = _mm_movemask_ps(_mm_cmple_ps(distanceSquared, _mm_mul_ps(radius, radius)));
+        if (mask == 0) {
+            continue;
+        }
+
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, t);
+        for (int lane = 0; lane < 4; ++lane) {
+            if (mask & (1 << lane)) {
+                hits.push_back({ static_cast<std::uint32_t>(i + lane), target, lanes[lane] });
+            }
+        }
+    }
+#endif
+
+    // Remaining projectiles (or all of them without SSE2)
+    for (; i < count; ++i) {
+        float t;
+        if (SegmentHitsCircle(m_positionX[i], m_positionZ[i], stepX[i], stepZ[i], x, z, m_radii[i] + m_targetRadius, t)) {
+            hits.push_back({ static_cast<std::uint32_t>(i), target, t });
+        }
+    }
+}
+
+} // namespace CHULUBME
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "../core/ecs.h"
+#include "../core/containers.h"
+
+namespace CHULUBME {
+
+/**
+ * @brief Parameters of a projectile launched by a skillshot
+ */
+struct ProjectileDesc {
+    EntityID caster;
+    glm::vec3 origin;
+    glm::vec3 direction;
+    float speed;
+    float range;
+    float radius;
+    float damage;
+    bool isMagical;
+    bool piercing;
+
+    // Constructor with default values
+    ProjectileDesc() :
+        caster(INVALID_ENTITY),
+        origin(0.0f),
+        direction(0.0f, 0.0f, 1.0f),
+        speed(0.0f),
+        range(0.0f),
+        radius(0.0f),
+        damage(0.0f),
+        isMagical(true),
+        piercing(false)
+    {}
+};
+
+/**
+ * @brief System simulating skillshot projectiles in flight
+ *
+ * Projectiles are stored as structure-of-arrays and move over the XZ plane.
+ * Each update sweeps every projectile along its path for the frame and tests
+ * the swept segments against each hero four projectiles at a time. Hits are
+ * ordered along each path and their damage is resolved as one DamageBatch.
+ * A projectile stops at the first hero it hits unless it is piercing, in
+ * which case it hits each hero at most once. The caster is never hit.
+ */
+class ProjectileSystem : public System {
+public:
+    ProjectileSystem(EntityManager* manager);
+    ~ProjectileSystem() = default;
+
+    // Move projectiles and resolve their hits
+    void Update(float deltaTime) override;
+
+    // Launch a projectile; safe to call from any thread, it starts moving on the next update
+    void Launch(const ProjectileDesc& desc);
+
+    // Remove all projectiles
+    void Clear();
+
+    // Get the number of projectiles in flight
+    std::size_t GetProjectileCount() const { return m_casters.size(); }
+
+    // Get the position of a projectile in flight
+    glm::vec3 GetProjectilePosition(std::size_t index) const;
+
+    // Set the collision radius of heroes
+    void SetTargetRadius(float radius) { m_targetRadius = radius; }
+
+    // Get the collision radius of heroes
+    float GetTargetRadius() const { return m_targetRadius; }
+
+private:
+    // Projectile that touched a hero during this update
+    struct ProjectileHit {
+        std::uint32_t projectile;
+        std::uint32_t target;
+        float t;
+    };
+
+    // Add a launched projectile to the arrays
+    void AddProjectile(const ProjectileDesc& desc);
+
+    // Remove a projectile by moving the last projectile into its place
+    void RemoveProjectile(std::size_t index);
+
+    // Test every swept segment against one hero, appending hits
+    void TestTarget(std::uint32_t target, float x, float z, const float* stepX, const float* stepZ,
+                    FrameVector<ProjectileHit>& hits) const;
+
+    // Projectile state
+    std::vector<float> m_positionX;
+    std::vector<float> m_positionY;
+    std::vector<float> m_positionZ;
+    std::vector<float> m_directionX;
+    std::vector<float> m_directionZ;
+    std::vector<float> m_speeds;
+    std::vector<float> m_remainingRanges;
+    std::vector<float> m_radii;
+    std::vector<float> m_damages;
+    std::vector<std::uint8_t> m_magical;
+    std::vector<std::uint8_t> m_piercing;
+    std::vector<EntityID> m_casters;
+
+    // Heroes already hit by each projectile
+    std::vector<SmallVector<EntityID, 4>> m_hitTargets;
+
+    // Collision radius of heroes
+    float m_targetRadius;
+
+    // Projectiles launched since the last update
+    std::mutex m_launchMutex;
+    std::vector<ProjectileDesc> m_launches;
+};
+
+} // namespace CHULUBME
@@ -69,6 +69,38 @@ func (pop *ProofOfPlay) UpdatePlayScore(address string, activityValue float64) e
     return errors.New("validator not found")
 }
 
+// PlayScoreUpdate is one player's activity; its fields match network.PlayScoreUpdate,
+// so batches received by a node convert element by element
+type PlayScoreUpdate struct {
+    Address  string
+    Activity float64
+}
+
+// UpdatePlayScores applies a batch of activity, summed per address, in one pass over the validators
+// Returns the number of validators updated; addresses that are not validators are ignored
+func (pop *ProofOfPlay) UpdatePlayScores(updates []PlayScoreUpdate) int {
+    if len(updates) == 0 {
+        return 0
+    }
+    
+    activity := make(map[string]float64, len(updates))
+    for _, update := range updates {
+        activity[update.Address] += update.Activity
+    }
+    
+    currentTime := time.Now().Unix()
+    updated := 0
+    for i, validator := range pop.Validators {
+        if activityValue, exists := activity[validator.Address]; exists {
+            pop.Validators[i].PlayScore += activityValue
+            pop.Validators[i].LastActivity = currentTime
+            updated++
+        }
+    }
+    
+    return updated
+}
+
 // SelectBlockProducer selects a validator to produce the next block
 // Selection is weighted by stake and play score
 func (pop *ProofOfPlay) SelectBlockProducer() (string, error) {
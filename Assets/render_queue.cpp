@@ -0,0 +1,287 @@
+#include "render_queue.h"
+#include "renderer.h"
+#include "culling.h"
+#include "transform_system.h"
+#include <GL/glew.h>
+#include <algorithm>
+
+namespace CHULUBME {
+
+RenderQueue::RenderQueue()
+    : m_instanceBuffer(0)
+    , m_mappedInstances(nullptr)
+    , m_instancesPerRegion(0)
+    , m_region(0)
+    , m_fences()
+    , m_drawCallCount(0)
+{
+}
+
+RenderQueue::~RenderQueue() {
+    Shutdown();
+}
+
+bool RenderQueue::Initialize(std::size_t instancesPerRegion) {
+    Shutdown();
+    return CreateInstanceBuffer(instancesPerRegion);
+}
+
+void RenderQueue::Shutdown() {
+    Clear();
+
+    for (std::size_t region = 0; region < REGION_COUNT; ++region) {
+        if (m_fences[region]) {
+            glDeleteSync(static_cast<GLsync>(m_fences[region]));
+            m_fences[region] = nullptr;
+        }
+    }
+
+    if (m_instanceBuffer != 0) {
+        if (m_mappedInstances) {
+            glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            m_mappedInstances = nullptr;
+        }
+
+        glDeleteBuffers(1, &m_instanceBuffer);
+        m_instanceBuffer = 0;
+    }
+
+    m_instancesPerRegion = 0;
+    m_region = 0;
+}
+
+bool RenderQueue::CreateInstanceBuffer(std::size_t instancesPerRegion) {
+    if (instancesPerRegion == 0) {
+        return false;
+    }
+
+    m_instancesPerRegion = instancesPerRegion;
+    const GLsizeiptr bufferSize = static_cast<GLsizeiptr>(sizeof(glm::mat4) * m_instancesPerRegion * REGION_COUNT);
+
+    glGenBuffers(1, &m_instanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+
+    if (GLEW_ARB_buffer_storage) {
+        // Map once and keep the mapping for the lifetime of the buffer
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, bufferSize, nullptr, flags);
+        m_mappedInstances = static_cast<glm::mat4*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, bufferSize, flags));
+    }
+
+    if (!m_mappedInstances) {
+        glBufferData(GL_ARRAY_BUFFER, bufferSize, nullptr, GL_STREAM_DRAW);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+void RenderQueue::Submit(Mesh* mesh, Material* material, const glm::mat4& transform) {
+    if (!mesh || !material) {
+        return;
+    }
+
+    RenderCommand command;
+    command.sortKey = MakeSortKey(material->GetShader().get(), material, mesh);
+    command.mesh = mesh;
+    command.material = material;
+    command.transformIndex = static_cast<std::uint32_t>(m_transforms.size());
+
+    m_commands.push_back(command);
+    m_transforms.push_back(transform);
+}
+
+void RenderQueue::SubmitEntities(EntityManager* manager, const Camera* camera) {
+    // Pick up transforms moved since the systems last updated
+    TransformSystem* transforms = manager->GetSystem<TransformSystem>();
+    if (transforms && transforms->IsActive()) {
+        transforms->UpdateWorldMatrices();
+    }
+
+    CullingSystem* culling = manager->GetSystem<CullingSystem>();
+    if (culling && culling->IsActive()) {
+        FrameVector<EntityID> visible;
+        culling->Cull(camera, visible);
+
+        for (EntityID entity : visible) {
+            Transform* transform = manager->GetComponent<Transform>(entity);
+            MeshRenderer* meshRenderer = manager->GetComponent<MeshRenderer>(entity);
+            Submit(meshRenderer->m_mesh.get(), meshRenderer->m_material.get(), transform->GetModelMatrix());
+        }
+        return;
+    }
+
+    manager->View<Transform, MeshRenderer>().ForEach(
+        [this](EntityID, Transform& transform, MeshRenderer& meshRenderer) {
+            Submit(meshRenderer.m_mesh.get(), meshRenderer.m_material.get(), transform.GetModelMatrix());
+        });
+}
+
+void RenderQueue::Flush(const Camera* camera) {
+    m_drawCallCount = 0;
+
+    if (m_commands.empty()) {
+        return;
+    }
+
+    // Create the instance buffer on first use, when a GL context is current
+    if (m_instanceBuffer == 0 && !CreateInstanceBuffer(DEFAULT_INSTANCES_PER_REGION)) {
+        Clear();
+        return;
+    }
+
+    // Group draws by shader, material and mesh; submission order breaks ties
+    std::sort(m_commands.begin(), m_commands.end(), [](const RenderCommand& a, const RenderCommand& b) {
+        return a.sortKey != b.sortKey ? a.sortKey < b.sortKey : a.transformIndex < b.transformIndex;
+    });
+
+    WaitForRegion(m_region);
+    std::size_t regionUsed = 0;
+
+    const Material* boundMaterial = nullptr;
+    const Shader* boundShader = nullptr;
+    const Mesh* boundMesh = nullptr;
+
+    const std::size_t count = m_commands.size();
+    for (std::size_t begin = 0; begin < count;) {
+        Mesh* mesh = m_commands[begin].mesh;
+        Material* material = m_commands[begin].material;
+
+        std::size_t end = begin + 1;
+        while (end < count && m_commands[end].mesh == mesh && m_commands[end].material == material) {
+            ++end;
+        }
+
+        if (material != boundMaterial) {
+            material->Bind();
+            boundMaterial = material;
+
+            // Camera matrices only change with the shader
+            const Shader* shader = material->GetShader().get();
+            if (shader && shader != boundShader && camera) {
+                shader->SetMat4(shader->GetUniformLocation("view"), camera->GetViewMatrix());
+                shader->SetMat4(shader->GetUniformLocation("projection"), camera->GetProjectionMatrix());
+            }
+            boundShader = shader;
+        }
+
+        if (mesh != boundMesh) {
+            mesh->Bind();
+            boundMesh = mesh;
+        }
+
+        // Draw the run, splitting it where it crosses the end of a region
+        for (std::size_t first = begin; first < end;) {
+            if (regionUsed == m_instancesPerRegion) {
+                FenceRegion(m_region);
+                m_region = (m_region + 1) % REGION_COUNT;
+                WaitForRegion(m_region);
+                regionUsed = 0;
+            }
+
+            const std::size_t instanceCount = std::min(end - first, m_instancesPerRegion - regionUsed);
+            const std::size_t baseInstance = m_region * m_instancesPerRegion + regionUsed;
+
+            WriteInstances(first, instanceCount, baseInstance);
+            BindInstanceAttributes(baseInstance);
+            glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(mesh->GetIndexCount()), GL_UNSIGNED_INT,
+                                    nullptr, static_cast<GLsizei>(instanceCount));
+
+            ++m_drawCallCount;
+            regionUsed += instanceCount;
+            first += instanceCount;
+        }
+
+        begin = end;
+    }
+
+    FenceRegion(m_region);
+    m_region = (m_region + 1) % REGION_COUNT;
+
+    if (boundMesh) {
+        boundMesh->Unbind();
+    }
+    if (boundMaterial) {
+        boundMaterial->Unbind();
+    }
+
+    Clear();
+}
+
+void RenderQueue::Clear() {
+    m_commands.clear();
+    m_transforms.clear();
+}
+
+std::uint64_t RenderQueue::MakeSortKey(const Shader* shader, const Material* material, const Mesh* mesh) {
+    // 16 bits of shader ID, then 24 bits each of material and mesh ID
+    const std::uint64_t shaderId = shader ? shader->GetSortID() & 0xFFFFu : 0;
+    const std::uint64_t materialId = material ? material->GetSortID() & 0xFFFFFFu : 0;
+    const std::uint64_t meshId = mesh ? mesh->GetSortID() & 0xFFFFFFu : 0;
+    return (shaderId << 48) | (materialId << 24) | meshId;
+}
+
+void RenderQueue::WaitForRegion(std::size_t region) {
+    if (!m_fences[region]) {
+        return;
+    }
+
+    GLsync fence = static_cast<GLsync>(m_fences[region]);
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    while (result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    }
+
+    glDeleteSync(fence);
+    m_fences[region] = nullptr;
+}
+
+void RenderQueue::FenceRegion(std::size_t region) {
+    // Only mapped memory can be overwritten while the GPU reads it
+    if (!m_mappedInstances) {
+        return;
+    }
+
+    if (m_fences[region]) {
+        glDeleteSync(static_cast<GLsync>(m_fences[region]));
+    }
+    m_fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void RenderQueue::WriteInstances(std::size_t firstCommand, std::size_t count, std::size_t baseInstance) {
+    if (m_mappedInstances) {
+        glm::mat4* instances = m_mappedInstances + baseInstance;
+        for (std::size_t i = 0; i < count; ++i) {
+            instances[i] = m_transforms[m_commands[firstCommand + i].transformIndex];
+        }
+        return;
+    }
+
+    // Gather the transforms and upload them in one call
+    ScopedScratch scratch;
+    glm::mat4* instances = scratch.AllocateArray<glm::mat4>(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        instances[i] = m_transforms[m_commands[firstCommand + i].transformIndex];
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(sizeof(glm::mat4) * baseInstance),
+                    static_cast<GLsizeiptr>(sizeof(glm::mat4) * count), instances);
+}
+
+void RenderQueue::BindInstanceAttributes(std::size_t baseInstance) const {
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+
+    const std::size_t offset = sizeof(glm::mat4) * baseInstance;
+    for (unsigned int column = 0; column < 4; ++column) {
+        const GLuint location = INSTANCE_TRANSFORM_ATTRIBUTE + column;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                              reinterpret_cast<const void*>(offset + sizeof(glm::vec4) * column));
+        glVertexAttribDivisor(location, 1);
+    }
+}
+
+} // namespace CHULUBME
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "../core/ecs.h"
+
+namespace CHULUBME {
+
+// Forward declarations
+class Shader;
+class Material;
+class Mesh;
+class Camera;
+
+// First vertex attribute location of the per-instance model matrix (one vec4 column per location)
+constexpr unsigned int INSTANCE_TRANSFORM_ATTRIBUTE = 4;
+
+/**
+ * @brief Draw request recorded during a frame
+ */
+struct RenderCommand {
+    std::uint64_t sortKey;
+    Mesh* mesh;
+    Material* material;
+    std::uint32_t transformIndex;
+};
+
+/**
+ * @brief Queue of draw requests submitted as instanced draws
+ *
+ * Commands are sorted by (shader, material, mesh) so each material is bound
+ * once per frame, and every run of commands sharing a mesh and material
+ * becomes one instanced draw call. Instance transforms are written straight
+ * into a persistently mapped buffer split into regions that are reused
+ * round-robin; a fence guards each region so the CPU never overwrites
+ * transforms the GPU is still reading. Without buffer storage support the
+ * transforms are uploaded with glBufferSubData instead.
+ *
+ * Shaders drawn through the queue read the model matrix from attribute
+ * locations INSTANCE_TRANSFORM_ATTRIBUTE to INSTANCE_TRANSFORM_ATTRIBUTE + 3.
+ */
+class RenderQueue {
+public:
+    RenderQueue();
+    ~RenderQueue();
+
+    // Deleted copy constructor and assignment operator
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    // Instances per region of a buffer created by the first flush
+    static constexpr std::size_t DEFAULT_INSTANCES_PER_REGION = 16384;
+
+    // Recreate the instance buffer, dropping queued commands (requires a current GL context;
+    // Flush creates it on first use without dropping them)
+    bool Initialize(std::size_t instancesPerRegion = DEFAULT_INSTANCES_PER_REGION);
+
+    // Destroy the instance buffer and drop queued commands
+    void Shutdown();
+
+    // Queue a mesh to be drawn with a material
+    void Submit(Mesh* mesh, Material* material, const glm::mat4& transform);
+
+    // Queue every entity with a Transform and a MeshRenderer, keeping only those the
+    // manager's CullingSystem (if registered) finds visible from the camera; world
+    // matrices are first brought up to date by the TransformSystem (if registered)
+    void SubmitEntities(EntityManager* manager, const Camera* camera = nullptr);
+
+    // Sort and draw every queued command, then clear the queue
+    void Flush(const Camera* camera);
+
+    // Drop every queued command
+    void Clear();
+
+    // Get the number of queued commands
+    std::size_t GetCommandCount() const { return m_commands.size(); }
+
+    // Get the number of draw calls issued by the last flush
+    std::size_t GetDrawCallCount() const { return m_drawCallCount; }
+
+    // Build the sort key of a draw
+    static std::uint64_t MakeSortKey(const Shader* shader, const Material* material, const Mesh* mesh);
+
+private:
+    // Number of instance buffer regions in flight
+    static constexpr std::size_t REGION_COUNT = 3;
+
+    // Create and map the instance buffer, leaving queued commands untouched
+    bool CreateInstanceBuffer(std::size_t instancesPerRegion);
+
+    // Wait until the GPU has finished reading a region
+    void WaitForRegion(std::size_t region);
+
+    // Mark a region as in use by the draws issued so far
+    void FenceRegion(std::size_t region);
+
+    // Copy transforms of consecutive commands into the instance buffer
+    void WriteInstances(std::size_t firstCommand, std::size_t count, std::size_t baseInstance);
+
+    // Point the instance attributes of the bound vertex array at an instance range
+    void BindInstanceAttributes(std::size_t baseInstance) const;
+
+    // Queued commands and their transforms
+    std::vector<RenderCommand> m_commands;
+    std::vector<glm::mat4> m_transforms;
+
+    // Instance buffer
+    unsigned int m_instanceBuffer;
+    glm::mat4* m_mappedInstances;
+    std::size_t m_instancesPerRegion;
+    std::size_t m_region;
+
+    // Fence per region (GLsync)
+    void* m_fences[REGION_COUNT];
+
+    // Draw calls issued by the last flush
+    std::size_t m_drawCallCount;
+};
+
+} // namespace CHULUBME
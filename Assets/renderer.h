@@ -1,13 +1,19 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
 #include <unordered_map>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 #include "../core/ecs.h"
+#include "../core/containers.h"
+#include "render_queue.h"
 
 namespace CHULUBME {
 
@@ -54,10 +60,10 @@ public:
     // Resize the renderer
     void Resize(int width, int height);
 
-    // Create a shader
+    // Create a shader (compiles immediately; AssetManager::LoadShader loads files asynchronously)
     std::shared_ptr<Shader> CreateShader(const std::string& vertexSource, const std::string& fragmentSource);
 
-    // Create a texture
+    // Create a texture (loads immediately; AssetManager::LoadTexture loads asynchronously)
     std::shared_ptr<Texture> CreateTexture(const std::string& filename);
 
     // Create a mesh
@@ -66,9 +72,18 @@ public:
     // Create a material
     std::shared_ptr<Material> CreateMaterial(std::shared_ptr<Shader> shader);
 
-    // Draw a mesh with a material
+    // Draw a mesh with a material immediately
     void DrawMesh(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material, const glm::mat4& transform);
 
+    // Get the queue of instanced draws for the current frame
+    RenderQueue& GetRenderQueue() { return m_renderQueue; }
+
+    // Allocate an ID used to order draws by shader, material and mesh
+    static std::uint32_t AllocateSortID() {
+        static std::atomic<std::uint32_t> s_nextSortId(1);
+        return s_nextSortId.fetch_add(1, std::memory_order_relaxed);
+    }
+
 private:
     // Private constructor for singleton
     Renderer();
@@ -89,12 +104,57 @@ private:
     std::unordered_map<std::string, std::shared_ptr<Shader>> m_shaderCache;
     std::unordered_map<std::string, std::shared_ptr<Texture>> m_textureCache;
 
+    // Instanced draw queue
+    RenderQueue m_renderQueue;
+
     // Friend classes
     friend class RenderSystem;
 };
 
+// Name of the std140 uniform block holding material parameters, and its binding point
+constexpr const char* MATERIAL_BLOCK_NAME = "Material";
+constexpr unsigned int MATERIAL_UNIFORM_BINDING = 1;
+
+/**
+ * @brief Value types of shader uniforms and material parameters
+ */
+enum class UniformType : std::uint8_t {
+    Unknown,
+    Int,
+    Float,
+    Vec2,
+    Vec3,
+    Vec4,
+    Mat3,
+    Mat4
+};
+
+/**
+ * @brief Member of a shader's material uniform block
+ */
+struct MaterialParameter {
+    std::string name;
+    UniformType type;
+    unsigned int offset;
+};
+
+/**
+ * @brief std140 layout of a shader's material uniform block
+ */
+struct MaterialBlockLayout {
+    std::vector<MaterialParameter> parameters;
+    unsigned int size = 0;
+
+    // Find the slot of a member (-1 if the block has no such member)
+    int FindSlot(const std::string& name) const;
+};
+
 /**
  * @brief Shader class for GPU programs
+ *
+ * Uniform locations and the layout of the material uniform block are read
+ * from the linked program once and cached, so setting a uniform by name
+ * costs one hash lookup and setting it by location costs none.
  */
 class Shader {
 public:
@@ -117,10 +177,39 @@ public:
     void SetMat3(const std::string& name, const glm::mat3& value) const;
     void SetMat4(const std::string& name, const glm::mat4& value) const;
 
+    // Set uniform values by cached location (ignored for location -1)
+    void SetInt(int location, int value) const;
+    void SetFloat(int location, float value) const;
+    void SetVec2(int location, const glm::vec2& value) const;
+    void SetVec3(int location, const glm::vec3& value) const;
+    void SetVec4(int location, const glm::vec4& value) const;
+    void SetMat3(int location, const glm::mat3& value) const;
+    void SetMat4(int location, const glm::mat4& value) const;
+
+    // Get the location of a uniform (-1 if the program has no such uniform)
+    int GetUniformLocation(const std::string& name) const;
+
+    // Get the layout of the material uniform block (empty if the program has none)
+    const MaterialBlockLayout& GetMaterialLayout() const;
+
+    // Get the ID used to order draws
+    std::uint32_t GetSortID() const { return m_sortId; }
+
 private:
+    // Read uniform locations and the material block layout from the linked program
+    void CacheUniforms() const;
+
     // Shader program ID
     unsigned int m_id;
 
+    // Cached uniform locations and material block layout
+    mutable FlatHashMap<std::string, int> m_uniformLocations;
+    mutable MaterialBlockLayout m_materialLayout;
+    mutable bool m_uniformsCached = false;
+
+    // Draw order ID
+    std::uint32_t m_sortId = Renderer::AllocateSortID();
+
     // Compile and link shader
     bool Compile(const std::string& vertexSource, const std::string& fragmentSource);
 };
@@ -131,6 +220,7 @@ private:
 class Texture {
 public:
     Texture(const std::string& filename);
+    Texture(int width, int height, int channels, const unsigned char* pixels);
     ~Texture();
 
     // Bind the texture for rendering
@@ -143,6 +233,11 @@ public:
     int GetWidth() const { return m_width; }
     int GetHeight() const { return m_height; }
 
+    // Get the video memory used by the texture and its mipmaps in bytes
+    std::size_t GetMemorySize() const {
+        return static_cast<std::size_t>(m_width) * static_cast<std::size_t>(m_height) * static_cast<std::size_t>(m_channels) * 4 / 3;
+    }
+
 private:
     // Texture ID
     unsigned int m_id;
@@ -155,11 +250,33 @@ private:
     int m_channels;
 };
 
+/**
+ * @brief Sphere enclosing a mesh, in the mesh's local space
+ */
+struct BoundingSphere {
+    glm::vec3 center;
+    float radius;
+
+    // Constructor with default values
+    BoundingSphere() :
+        center(0.0f),
+        radius(0.0f)
+    {}
+};
+
 /**
  * @brief Mesh class for 3D geometry
+ *
+ * The constructor computes a bounding sphere from the vertex positions, which
+ * are the first three floats of each vertex, so meshes can be culled without
+ * reading their vertex data back.
  */
 class Mesh {
 public:
+    // Floats per vertex (position, normal, texture coordinates) and where the position starts
+    static constexpr std::size_t VERTEX_STRIDE = 8;
+    static constexpr std::size_t POSITION_OFFSET = 0;
+
     Mesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices);
     ~Mesh();
 
@@ -172,6 +289,22 @@ public:
     // Draw the mesh
     void Draw() const;
 
+    // Get the number of indices
+    unsigned int GetIndexCount() const { return m_indexCount; }
+
+    // Get the local bounding sphere
+    const BoundingSphere& GetBounds() const { return m_bounds; }
+
+    // Override the local bounding sphere (e.g. for meshes deformed in a shader)
+    void SetBounds(const BoundingSphere& bounds) { m_bounds = bounds; }
+
+    // Compute the bounding sphere of the positions in interleaved vertices of stride floats,
+    // each position starting positionOffset floats into its vertex
+    static BoundingSphere ComputeBounds(const std::vector<float>& vertices, std::size_t stride, std::size_t positionOffset);
+
+    // Get the ID used to order draws
+    std::uint32_t GetSortID() const { return m_sortId; }
+
 private:
     // Vertex Array Object
     unsigned int m_vao;
@@ -184,15 +317,31 @@ private:
 
     // Number of indices
     unsigned int m_indexCount;
+
+    // Local bounding sphere
+    BoundingSphere m_bounds;
+
+    // Draw order ID
+    std::uint32_t m_sortId = Renderer::AllocateSortID();
 };
 
 /**
  * @brief Material class for surface properties
+ *
+ * Parameters declared in the shader's material uniform block are packed into
+ * a std140 uniform buffer that is re-uploaded on Bind only after a setter
+ * changed it. Resolve a parameter name to a slot once with GetParameterSlot
+ * and set it by slot; the name-based setters resolve the slot on every call.
+ * Parameters outside the block are kept as plain uniforms at cached locations.
  */
 class Material {
 public:
     Material(std::shared_ptr<Shader> shader);
-    ~Material() = default;
+    ~Material();
+
+    // Deleted copy constructor and assignment operator
+    Material(const Material&) = delete;
+    Material& operator=(const Material&) = delete;
 
     // Bind the material for rendering
     void Bind() const;
@@ -217,23 +366,58 @@ public:
     void SetMat3(const std::string& name, const glm::mat3& value);
     void SetMat4(const std::string& name, const glm::mat4& value);
 
+    // Get the slot of a material block parameter (-1 if the block has no such member)
+    int GetParameterSlot(const std::string& name) const;
+
+    // Set material block parameters by slot (ignored for slot -1 or a mismatched type)
+    void SetInt(int slot, int value);
+    void SetFloat(int slot, float value);
+    void SetBool(int slot, bool value);
+    void SetVec2(int slot, const glm::vec2& value);
+    void SetVec3(int slot, const glm::vec3& value);
+    void SetVec4(int slot, const glm::vec4& value);
+    void SetMat3(int slot, const glm::mat3& value);
+    void SetMat4(int slot, const glm::mat4& value);
+
+    // Get the ID used to order draws
+    std::uint32_t GetSortID() const { return m_sortId; }
+
 private:
+    // Texture bound to a sampler uniform; the texture unit is its index
+    struct TextureBinding {
+        int location;
+        std::shared_ptr<Texture> texture;
+    };
+
+    // Parameter set as a plain uniform
+    struct UniformValue {
+        int location;
+        UniformType type;
+        float data[16];
+    };
+
+    // Copy a value into the material block
+    bool WriteParameter(int slot, UniformType type, const void* data, std::size_t size);
+
+    // Set a parameter by name, in the material block or else as a plain uniform
+    void SetParameter(const std::string& name, UniformType type, const void* data, std::size_t size);
+
     // Shader
     std::shared_ptr<Shader> m_shader;
 
+    // Draw order ID
+    std::uint32_t m_sortId = Renderer::AllocateSortID();
+
     // Textures
-    std::unordered_map<std::string, std::shared_ptr<Texture>> m_textures;
-
-    // Properties
-    std::unordered_map<std::string, glm::vec4> m_colors;
-    std::unordered_map<std::string, float> m_floats;
-    std::unordered_map<std::string, int> m_ints;
-    std::unordered_map<std::string, bool> m_bools;
-    std::unordered_map<std::string, glm::vec2> m_vec2s;
-    std::unordered_map<std::string, glm::vec3> m_vec3s;
-    std::unordered_map<std::string, glm::vec4> m_vec4s;
-    std::unordered_map<std::string, glm::mat3> m_mat3s;
-    std::unordered_map<std::string, glm::mat4> m_mat4s;
+    SmallVector<TextureBinding, 4> m_textures;
+
+    // Parameters outside the material block
+    SmallVector<UniformValue, 4> m_uniforms;
+
+    // Material block contents in std140 layout, and its uniform buffer
+    std::vector<unsigned char> m_parameterData;
+    mutable unsigned int m_uniformBuffer = 0;
+    mutable bool m_parametersDirty = false;
 };
 
 /**
@@ -315,6 +499,12 @@ private:
 
 /**
  * @brief Transform component for entity positioning
+ *
+ * Position, rotation and scale are relative to the parent transform, or to
+ * the world for roots. A root's model matrix is rebuilt on demand when it
+ * changes; the world matrices of children are computed by the
+ * TransformSystem, which is also the only way to attach a transform to a
+ * parent.
  */
 class Transform : public Component {
 public:
@@ -327,40 +517,78 @@ public:
     void Initialize() override;
 
     // Set position
-    void SetPosition(const glm::vec3& position) { m_position = position; m_dirty = true; }
+    void SetPosition(const glm::vec3& position) { m_position = position; MarkDirty(); }
 
     // Get position
     glm::vec3 GetPosition() const { return m_position; }
 
     // Set rotation (Euler angles in degrees)
-    void SetRotation(const glm::vec3& rotation) { m_rotation = rotation; m_dirty = true; }
+    void SetRotation(const glm::vec3& rotation);
 
     // Get rotation (Euler angles in degrees)
-    glm::vec3 GetRotation() const { return m_rotation; }
+    glm::vec3 GetRotation() const;
+
+    // Set rotation
+    void SetOrientation(const glm::quat& orientation) { m_orientation = orientation; MarkDirty(); }
+
+    // Get rotation
+    glm::quat GetOrientation() const { return m_orientation; }
 
     // Set scale
-    void SetScale(const glm::vec3& scale) { m_scale = scale; m_dirty = true; }
+    void SetScale(const glm::vec3& scale) { m_scale = scale; MarkDirty(); }
 
     // Get scale
     glm::vec3 GetScale() const { return m_scale; }
 
-    // Get the model matrix
+    // Get the parent entity (INVALID_ENTITY for roots)
+    EntityID GetParent() const { return m_parent; }
+
+    // Get the matrix relative to the parent
+    glm::mat4 GetLocalMatrix();
+
+    // Get the model matrix (for children, as of the last TransformSystem update)
     glm::mat4 GetModelMatrix();
 
+    // Get the position in world space (for children, as of the last TransformSystem update)
+    glm::vec3 GetWorldPosition() const;
+
+    // Check if the position changed since the spatial index last saw it
+    bool IsSpatialDirty() const { return m_spatialDirty; }
+
+    // Mark the position as seen by the spatial index
+    void ClearSpatialDirty() { m_spatialDirty = false; }
+
 private:
-    // Update the model matrix if dirty
+    // Flag the local matrix for recalculation
+    void MarkDirty() { m_dirty = true; m_hierarchyDirty = true; m_spatialDirty = true; }
+
+    // Update the local matrix if dirty
     void UpdateModelMatrix();
 
     // Transform properties
     glm::vec3 m_position;
-    glm::vec3 m_rotation;
+    glm::quat m_orientation;
     glm::vec3 m_scale;
 
-    // Model matrix
-    glm::mat4 m_modelMatrix;
+    // Matrix relative to the parent, and world matrix written by the TransformSystem
+    glm::mat4 m_localMatrix;
+    glm::mat4 m_worldMatrix;
+
+    // Parent entity and slot in the TransformSystem hierarchy
+    EntityID m_parent = INVALID_ENTITY;
+    std::uint32_t m_hierarchyIndex = 0;
 
     // Dirty flag for matrix recalculation
     bool m_dirty;
+
+    // Dirty flag for the TransformSystem, cleared once it has read the local matrix
+    bool m_hierarchyDirty = true;
+
+    // Dirty flag for spatial index updates
+    bool m_spatialDirty = true;
+
+    // Friend classes
+    friend class TransformSystem;
 };
 
 /**
@@ -396,10 +624,22 @@ private:
 
     // Friend classes
     friend class RenderSystem;
+    friend class RenderQueue;
+    friend class CullingSystem;
 };
 
 /**
  * @brief RenderSystem for rendering all mesh renderers
+ *
+ * Render submits the mesh renderers visible from the main camera to the
+ * renderer's RenderQueue and flushes it with that camera, so draw calls scale
+ * with the number of distinct mesh and material pairs rather than with the
+ * entity count. Visibility comes from the CullingSystem when one is
+ * registered; otherwise every mesh renderer is submitted. When a
+ * TransformSystem is registered the world matrices of attached transforms
+ * are brought up to date before they are submitted. Systems stepping simulated
+ * state on the fixed time step can blend it for display with
+ * EntityManager::GetInterpolationAlpha.
  */
 class RenderSystem : public System {
 public:
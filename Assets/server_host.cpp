@@ -0,0 +1,192 @@
+#include "server_host.h"
+#include "../gameplay/hero_data.h"
+#include "../gameplay/hero_system.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace CHULUBME {
+
+// MatchWorld implementation
+MatchWorld::MatchWorld(MatchID id, JobSystem* jobSystem, std::shared_ptr<const HeroDataFile> heroData)
+    : m_id(id)
+    , m_jobSystem(jobSystem)
+    , m_frameArenas(jobSystem->GetThreadCount(), FRAME_ARENA_BLOCK_SIZE)
+    , m_entityManager(std::make_unique<EntityManager>())
+    , m_tick(0)
+    , m_finished(false)
+{
+    m_entityManager->SetJobSystem(m_jobSystem);
+
+    // Every match reads the host's definitions
+    ScopedFrameArenas frameArenas(&m_frameArenas, m_jobSystem->GetCurrentThreadIndex());
+    HeroSystem* heroSystem = m_entityManager->RegisterSystem<HeroSystem>();
+    heroSystem->SetHeroData(std::move(heroData));
+    m_entityManager->RegisterSystem<AbilitySystem>();
+}
+
+MatchWorld::~MatchWorld() {
+    // Event storage lives in the match's arenas, which are destroyed after the entity manager
+    m_entityManager->GetEventBus().ReleaseFrameStorage();
+}
+
+bool MatchWorld::Setup(const std::function<bool(MatchWorld&)>& setup) {
+    ScopedFrameArenas frameArenas(&m_frameArenas, m_jobSystem->GetCurrentThreadIndex());
+    return !setup || setup(*this);
+}
+
+void MatchWorld::Tick(float fixedDeltaTime) {
+    // Recycle the last tick's frame memory; no job of this match is running
+    EventBus& eventBus = m_entityManager->GetEventBus();
+    eventBus.ReleaseFrameStorage();
+    m_frameArenas.Reset();
+
+    // Frame allocations of this tick, and of the jobs it schedules, come from the match's arenas
+    ScopedFrameArenas frameArenas(&m_frameArenas, m_jobSystem->GetCurrentThreadIndex());
+    CHULUBME_PROFILE_ZONE("Match tick");
+
+    // Variable-step systems advance by the tick length, as in a free-running headless engine
+    m_entityManager->ProcessDestructions();
+    m_entityManager->UpdateSystems(fixedDeltaTime);
+    eventBus.Dispatch();
+
+    // Fixed tick
+    m_entityManager->ProcessDestructions();
+    if (m_tickBeginCallback) {
+        m_tickBeginCallback(m_tick);
+    }
+    eventBus.Dispatch();
+
+    m_entityManager->FixedUpdateSystems(fixedDeltaTime);
+    eventBus.Dispatch();
+
+    if (m_fixedUpdateCallback) {
+        m_fixedUpdateCallback(fixedDeltaTime);
+    }
+
+    ++m_tick;
+}
+
+// ServerHost implementation
+ServerHost::ServerHost(std::size_t workerThreadCount)
+    : m_jobSystem(std::make_unique<JobSystem>(workerThreadCount))
+    , m_frameArenas(m_jobSystem->GetThreadCount(), MatchWorld::FRAME_ARENA_BLOCK_SIZE)
+    , m_lastMatchID(0)
+    , m_tickRate(30.0f)
+    , m_running(false)
+{
+}
+
+ServerHost::~ServerHost() {
+    Stop();
+
+    // Matches run jobs on the job system, so they go first
+    m_matches.clear();
+}
+
+bool ServerHost::LoadHeroData(const std::string& filename) {
+    std::shared_ptr<HeroDataFile> heroData = std::make_shared<HeroDataFile>();
+
+    if (HeroDataFile::IsCompiledFile(filename)) {
+        // Compiled data is mapped once; every match reads the same pages
+        if (!heroData->Open(filename)) {
+            return false;
+        }
+    } else {
+        // JSON is compiled in memory once instead of being parsed per match
+        std::ifstream input(filename);
+        if (!input.is_open()) {
+            return false;
+        }
+        std::stringstream json;
+        json << input.rdbuf();
+
+        std::vector<unsigned char> compiled;
+        if (!HeroDataCompiler::Compile(json.str(), compiled) || !heroData->Open(std::move(compiled))) {
+            return false;
+        }
+    }
+
+    // Running matches keep the definitions they were created with
+    m_heroData = heroData;
+    return true;
+}
+
+MatchWorld* ServerHost::CreateMatch(const MatchSetup& setup) {
+    std::unique_ptr<MatchWorld> match(new MatchWorld(m_lastMatchID + 1, m_jobSystem.get(), m_heroData));
+    if (!match->Setup(setup)) {
+        return nullptr;
+    }
+
+    ++m_lastMatchID;
+    m_matches.push_back(std::move(match));
+    return m_matches.back().get();
+}
+
+bool ServerHost::DestroyMatch(MatchWorld::MatchID id) {
+    auto it = std::find_if(m_matches.begin(), m_matches.end(), [id](const std::unique_ptr<MatchWorld>& match) {
+        return match->GetID() == id;
+    });
+    if (it == m_matches.end()) {
+        return false;
+    }
+
+    m_matches.erase(it);
+    return true;
+}
+
+MatchWorld* ServerHost::GetMatch(MatchWorld::MatchID id) const {
+    for (const std::unique_ptr<MatchWorld>& match : m_matches) {
+        if (match->GetID() == id) {
+            return match.get();
+        }
+    }
+    return nullptr;
+}
+
+void ServerHost::Tick() {
+    // Frame memory of the host's previous tick; matches reset their own sets
+    m_frameArenas.Reset();
+    ScopedFrameArenas frameArenas(&m_frameArenas, m_jobSystem->GetCurrentThreadIndex());
+
+    // Every match ticks as one job; their systems' jobs share the same pool
+    const float fixedDeltaTime = 1.0f / m_tickRate;
+    JobCounter counter;
+    for (std::unique_ptr<MatchWorld>& match : m_matches) {
+        MatchWorld* world = match.get();
+        m_jobSystem->Schedule([world, fixedDeltaTime]() { world->Tick(fixedDeltaTime); }, &counter);
+    }
+    m_jobSystem->Wait(counter);
+
+    // Destroy matches that finished during the tick
+    m_matches.erase(std::remove_if(m_matches.begin(), m_matches.end(), [](const std::unique_ptr<MatchWorld>& match) {
+        return match->IsFinished();
+    }), m_matches.end());
+}
+
+void ServerHost::Run() {
+    if (m_running) {
+        return;
+    }
+
+    m_running = true;
+    m_framePacer.SetTargetFrameRate(m_tickRate);
+    m_framePacer.Reset();
+    CHULUBME_PROFILE_THREAD("Server host");
+
+    while (m_running) {
+        m_framePacer.BeginFrame();
+        CHULUBME_PROFILE_FRAME();
+        Tick();
+    }
+}
+
+std::size_t ServerHost::GetFrameArenaCapacity() const {
+    std::size_t capacity = m_frameArenas.GetCapacity();
+    for (const std::unique_ptr<MatchWorld>& match : m_matches) {
+        capacity += match->GetFrameArenas().GetCapacity();
+    }
+    return capacity;
+}
+
+} // namespace CHULUBME
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../core/ecs.h"
+#include "../core/frame_pacer.h"
+#include "../core/job_system.h"
+#include "../core/memory.h"
+
+namespace CHULUBME {
+
+// Forward declarations
+class HeroDataFile;
+
+/**
+ * @brief One match hosted by a ServerHost
+ *
+ * A match owns its entity manager and its frame arenas, and runs its systems
+ * on the host's shared job system. Its HeroSystem and AbilitySystem are
+ * registered by the host and read the host's hero definitions, so every
+ * match maps the same read-only data instead of loading its own.
+ *
+ * Each tick mirrors a free-running headless Engine frame: destructions, the
+ * variable-step systems with the tick length, then one fixed tick with the
+ * tick-begin and fixed update callbacks. A match only ever runs one tick at
+ * a time, but different matches tick concurrently, so systems must not
+ * share mutable state across matches through globals.
+ */
+class MatchWorld {
+public:
+    using MatchID = std::uint32_t;
+
+    ~MatchWorld();
+
+    // Deleted copy constructor and assignment operator
+    MatchWorld(const MatchWorld&) = delete;
+    MatchWorld& operator=(const MatchWorld&) = delete;
+
+    // Get the match ID
+    MatchID GetID() const { return m_id; }
+
+    // Get the entity manager
+    EntityManager* GetEntityManager() { return m_entityManager.get(); }
+
+    // Get the number of ticks run
+    std::uint64_t GetTick() const { return m_tick; }
+
+    // Get the match's frame arenas
+    const FrameArenaSet& GetFrameArenas() const { return m_frameArenas; }
+
+    // Register tick begin callback (runs with the tick number before the fixed-step systems, e.g. to apply client input)
+    void RegisterTickBeginCallback(std::function<void(std::uint64_t)> callback) { m_tickBeginCallback = callback; }
+
+    // Register fixed update callback (runs after the fixed-step systems, e.g. to send snapshots)
+    void RegisterFixedUpdateCallback(std::function<void(float)> callback) { m_fixedUpdateCallback = callback; }
+
+    // Ask the host to destroy the match after the current tick (any thread)
+    void Finish() { m_finished.store(true, std::memory_order_release); }
+
+    // Check if the match asked to be destroyed
+    bool IsFinished() const { return m_finished.load(std::memory_order_acquire); }
+
+private:
+    friend class ServerHost;
+
+    // Block size of the match's frame arenas (smaller than a client frame's, since every pool thread gets one per match)
+    static constexpr std::size_t FRAME_ARENA_BLOCK_SIZE = 64 * 1024;
+
+    MatchWorld(MatchID id, JobSystem* jobSystem, std::shared_ptr<const HeroDataFile> heroData);
+
+    // Run the host's setup callback with the match's arenas bound
+    bool Setup(const std::function<bool(MatchWorld&)>& setup);
+
+    // Advance the match by one tick (no other job of this match may be running)
+    void Tick(float fixedDeltaTime);
+
+    // Match ID
+    MatchID m_id;
+
+    // Shared job system
+    JobSystem* m_jobSystem;
+
+    // Frame arenas (declared before the entity manager so its event storage is released first)
+    FrameArenaSet m_frameArenas;
+
+    // Entity manager
+    std::unique_ptr<EntityManager> m_entityManager;
+
+    // Ticks run
+    std::uint64_t m_tick;
+
+    // Set when the match should be destroyed
+    std::atomic<bool> m_finished;
+
+    // Callbacks
+    std::function<void(std::uint64_t)> m_tickBeginCallback;
+    std::function<void(float)> m_fixedUpdateCallback;
+};
+
+/**
+ * @brief Headless server process hosting many independent matches
+ *
+ * The Engine singleton runs one world; a server host runs any number of
+ * MatchWorlds side by side in one process, one per match. Hero and ability
+ * definitions are loaded once and shared by every match, and all matches
+ * tick on one job system: each tick schedules every match as a job, and the
+ * systems inside a match fan out on the same pool, so idle threads of one
+ * match's tick help with another's. Each match allocates frame memory from
+ * its own FrameArenaSet, and the host's own tick work from one more set, so
+ * the host never resets arenas of matches, other hosts or an Engine in the
+ * same process.
+ *
+ * CreateMatch, DestroyMatch and Tick must not overlap; the host is driven
+ * from one thread (the one calling Run or Tick), which also takes part in
+ * running jobs. Servers do not use InputManager; client commands are applied
+ * per match through its tick-begin callback.
+ */
+class ServerHost {
+public:
+    using MatchSetup = std::function<bool(MatchWorld&)>;
+
+    // Create a host with its own job system (0 worker threads for one per extra hardware thread)
+    explicit ServerHost(std::size_t workerThreadCount = 0);
+    ~ServerHost();
+
+    // Deleted copy constructor and assignment operator
+    ServerHost(const ServerHost&) = delete;
+    ServerHost& operator=(const ServerHost&) = delete;
+
+    // Load the hero definitions shared by matches created from now on (compiled or JSON hero data)
+    bool LoadHeroData(const std::string& filename);
+
+    // Get the shared hero definitions (null until loaded)
+    std::shared_ptr<const HeroDataFile> GetHeroData() const { return m_heroData; }
+
+    // Create a match; setup registers its systems and spawns its entities (null if setup fails)
+    MatchWorld* CreateMatch(const MatchSetup& setup);
+
+    // Destroy a match; returns false if no match has the ID
+    bool DestroyMatch(MatchWorld::MatchID id);
+
+    // Find a match (nullptr if no match has the ID)
+    MatchWorld* GetMatch(MatchWorld::MatchID id) const;
+
+    // Get the number of hosted matches
+    std::size_t GetMatchCount() const { return m_matches.size(); }
+
+    // Advance every match by one tick in parallel, then destroy finished matches
+    void Tick();
+
+    // Run ticks at the tick rate until stopped
+    void Run();
+
+    // Stop Run (any thread)
+    void Stop() { m_running = false; }
+
+    // Get the tick rate
+    float GetTickRate() const { return m_tickRate; }
+
+    // Set the tick rate (ignored unless positive)
+    void SetTickRate(float tickRate) { if (tickRate > 0.0f) m_tickRate = tickRate; }
+
+    // Get the shared job system
+    JobSystem* GetJobSystem() { return m_jobSystem.get(); }
+
+    // Get the frame memory reserved by the host and all matches
+    std::size_t GetFrameArenaCapacity() const;
+
+private:
+    // Job system (declared before the matches so it outlives them)
+    std::unique_ptr<JobSystem> m_jobSystem;
+
+    // Frame arenas of the host's own tick work, outside any match
+    FrameArenaSet m_frameArenas;
+
+    // Shared hero definitions
+    std::shared_ptr<const HeroDataFile> m_heroData;
+
+    // Hosted matches
+    std::vector<std::unique_ptr<MatchWorld>> m_matches;
+
+    // Last match ID handed out
+    MatchWorld::MatchID m_lastMatchID;
+
+    // Tick rate and pacing
+    float m_tickRate;
+    FramePacer m_framePacer;
+
+    // Running state
+    std::atomic<bool> m_running;
+};
+
+} // namespace CHULUBME
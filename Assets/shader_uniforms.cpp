@@ -0,0 +1,414 @@
+#include "renderer.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cstring>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace CHULUBME {
+
+namespace {
+
+// Map a GL uniform type to a uniform type
+UniformType ToUniformType(GLenum type) {
+    switch (type) {
+        case GL_INT:
+        case GL_BOOL:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_CUBE:
+            return UniformType::Int;
+        case GL_FLOAT:
+            return UniformType::Float;
+        case GL_FLOAT_VEC2:
+            return UniformType::Vec2;
+        case GL_FLOAT_VEC3:
+            return UniformType::Vec3;
+        case GL_FLOAT_VEC4:
+            return UniformType::Vec4;
+        case GL_FLOAT_MAT3:
+            return UniformType::Mat3;
+        case GL_FLOAT_MAT4:
+            return UniformType::Mat4;
+        default:
+            return UniformType::Unknown;
+    }
+}
+
+} // namespace
+
+// MaterialBlockLayout implementation
+int MaterialBlockLayout::FindSlot(const std::string& name) const {
+    for (std::size_t slot = 0; slot < parameters.size(); ++slot) {
+        if (parameters[slot].name == name) {
+            return static_cast<int>(slot);
+        }
+    }
+    return -1;
+}
+
+// Shader uniform cache implementation
+void Shader::SetInt(int location, int value) const {
+    if (location >= 0) {
+        glUniform1i(location, value);
+    }
+}
+
+void Shader::SetFloat(int location, float value) const {
+    if (location >= 0) {
+        glUniform1f(location, value);
+    }
+}
+
+void Shader::SetVec2(int location, const glm::vec2& value) const {
+    if (location >= 0) {
+        glUniform2fv(location, 1, glm::value_ptr(value));
+    }
+}
+
+void Shader::SetVec3(int location, const glm::vec3& value) const {
+    if (location >= 0) {
+        glUniform3fv(location, 1, glm::value_ptr(value));
+    }
+}
+
+void Shader::SetVec4(int location, const glm::vec4& value) const {
+    if (location >= 0) {
+        glUniform4fv(location, 1, glm::value_ptr(value));
+    }
+}
+
+void Shader::SetMat3(int location, const glm::mat3& value) const {
+    if (location >= 0) {
+        glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(value));
+    }
+}
+
+void Shader::SetMat4(int location, const glm::mat4& value) const {
+    if (location >= 0) {
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+    }
+}
+
+int Shader::GetUniformLocation(const std::string& name) const {
+    if (!m_uniformsCached) {
+        CacheUniforms();
+    }
+
+    auto it = m_uniformLocations.find(name);
+    return it != m_uniformLocations.end() ? it->second : -1;
+}
+
+const MaterialBlockLayout& Shader::GetMaterialLayout() const {
+    if (!m_uniformsCached) {
+        CacheUniforms();
+    }
+
+    return m_materialLayout;
+}
+
+void Shader::CacheUniforms() const {
+    m_uniformsCached = true;
+    m_uniformLocations.clear();
+    m_materialLayout = MaterialBlockLayout();
+
+    GLint uniformCount = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &uniformCount);
+    glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+    std::vector<char> nameBuffer(static_cast<std::size_t>(std::max(maxNameLength, 1)));
+
+    // Plain uniforms (block members have no location)
+    for (GLint i = 0; i < uniformCount; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_id, static_cast<GLuint>(i), static_cast<GLsizei>(nameBuffer.size()), &length, &size, &type, nameBuffer.data());
+
+        std::string name(nameBuffer.data(), static_cast<std::size_t>(length));
+        const GLint location = glGetUniformLocation(m_id, name.c_str());
+        if (location < 0) {
+            continue;
+        }
+
+        m_uniformLocations[name] = location;
+
+        // Arrays are reported as "name[0]"; also accept the bare name
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+            m_uniformLocations[name.substr(0, name.size() - 3)] = location;
+        }
+    }
+
+    // Material block
+    const GLuint blockIndex = glGetUniformBlockIndex(m_id, MATERIAL_BLOCK_NAME);
+    if (blockIndex == GL_INVALID_INDEX) {
+        return;
+    }
+
+    GLint blockSize = 0;
+    GLint memberCount = 0;
+    glGetActiveUniformBlockiv(m_id, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize);
+    glGetActiveUniformBlockiv(m_id, blockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &memberCount);
+
+    std::vector<GLint> indices(static_cast<std::size_t>(memberCount));
+    std::vector<GLint> offsets(static_cast<std::size_t>(memberCount));
+    std::vector<GLint> types(static_cast<std::size_t>(memberCount));
+    if (memberCount > 0) {
+        glGetActiveUniformBlockiv(m_id, blockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, indices.data());
+        const GLuint* memberIndices = reinterpret_cast<const GLuint*>(indices.data());
+        glGetActiveUniformsiv(m_id, memberCount, memberIndices, GL_UNIFORM_OFFSET, offsets.data());
+        glGetActiveUniformsiv(m_id, memberCount, memberIndices, GL_UNIFORM_TYPE, types.data());
+    }
+
+    for (GLint i = 0; i < memberCount; ++i) {
+        GLsizei length = 0;
+        glGetActiveUniformName(m_id, static_cast<GLuint>(indices[i]), static_cast<GLsizei>(nameBuffer.size()), &length, nameBuffer.data());
+
+        // Members of a named block instance are reported as "instance.member"
+        std::string name(nameBuffer.data(), static_cast<std::size_t>(length));
+        const std::size_t dot = name.rfind('.');
+        if (dot != std::string::npos) {
+            name.erase(0, dot + 1);
+        }
+
+        MaterialParameter parameter;
+        parameter.name = name;
+        parameter.type = ToUniformType(static_cast<GLenum>(types[i]));
+        parameter.offset = static_cast<unsigned int>(offsets[i]);
+        m_materialLayout.parameters.push_back(parameter);
+    }
+
+    m_materialLayout.size = static_cast<unsigned int>(blockSize);
+    glUniformBlockBinding(m_id, blockIndex, MATERIAL_UNIFORM_BINDING);
+}
+
+// Material parameter implementation
+Material::~Material() {
+    if (m_uniformBuffer != 0) {
+        glDeleteBuffers(1, &m_uniformBuffer);
+    }
+}
+
+void Material::Bind() const {
+    if (!m_shader) {
+        return;
+    }
+
+    m_shader->Bind();
+
+    // Upload the material block only after a setter changed it
+    if (!m_parameterData.empty()) {
+        if (m_uniformBuffer == 0) {
+            glGenBuffers(1, &m_uniformBuffer);
+            glBindBuffer(GL_UNIFORM_BUFFER, m_uniformBuffer);
+            glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(m_parameterData.size()), m_parameterData.data(), GL_DYNAMIC_DRAW);
+            m_parametersDirty = false;
+        } else if (m_parametersDirty) {
+            glBindBuffer(GL_UNIFORM_BUFFER, m_uniformBuffer);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(m_parameterData.size()), m_parameterData.data());
+            m_parametersDirty = false;
+        }
+
+        glBindBufferBase(GL_UNIFORM_BUFFER, MATERIAL_UNIFORM_BINDING, m_uniformBuffer);
+    }
+
+    // Plain uniforms at cached locations
+    for (const UniformValue& uniform : m_uniforms) {
+        switch (uniform.type) {
+            case UniformType::Int: {
+                int value;
+                std::memcpy(&value, uniform.data, sizeof(value));
+                m_shader->SetInt(uniform.location, value);
+                break;
+            }
+            case UniformType::Float:
+                glUniform1fv(uniform.location, 1, uniform.data);
+                break;
+            case UniformType::Vec2:
+                glUniform2fv(uniform.location, 1, uniform.data);
+                break;
+            case UniformType::Vec3:
+                glUniform3fv(uniform.location, 1, uniform.data);
+                break;
+            case UniformType::Vec4:
+                glUniform4fv(uniform.location, 1, uniform.data);
+                break;
+            case UniformType::Mat3:
+                glUniformMatrix3fv(uniform.location, 1, GL_FALSE, uniform.data);
+                break;
+            case UniformType::Mat4:
+                glUniformMatrix4fv(uniform.location, 1, GL_FALSE, uniform.data);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Textures, one unit each
+    for (std::size_t unit = 0; unit < m_textures.size(); ++unit) {
+        m_textures[unit].texture->Bind(static_cast<unsigned int>(unit));
+        m_shader->SetInt(m_textures[unit].location, static_cast<int>(unit));
+    }
+}
+
+void Material::SetTexture(const std::string& name, std::shared_ptr<Texture> texture) {
+    if (!m_shader) {
+        return;
+    }
+
+    const int location = m_shader->GetUniformLocation(name);
+    if (location < 0) {
+        return;
+    }
+
+    for (TextureBinding& binding : m_textures) {
+        if (binding.location == location) {
+            if (texture) {
+                binding.texture = std::move(texture);
+            } else {
+                m_textures.erase(&binding);
+            }
+            return;
+        }
+    }
+
+    if (texture) {
+        m_textures.push_back({ location, std::move(texture) });
+    }
+}
+
+void Material::SetColor(const std::string& name, const glm::vec4& color) {
+    SetParameter(name, UniformType::Vec4, glm::value_ptr(color), sizeof(color));
+}
+
+void Material::SetFloat(const std::string& name, float value) {
+    SetParameter(name, UniformType::Float, &value, sizeof(value));
+}
+
+void Material::SetInt(const std::string& name, int value) {
+    SetParameter(name, UniformType::Int, &value, sizeof(value));
+}
+
+void Material::SetBool(const std::string& name, bool value) {
+    const int intValue = value ? 1 : 0;
+    SetParameter(name, UniformType::Int, &intValue, sizeof(intValue));
+}
+
+void Material::SetVec2(const std::string& name, const glm::vec2& value) {
+    SetParameter(name, UniformType::Vec2, glm::value_ptr(value), sizeof(value));
+}
+
+void Material::SetVec3(const std::string& name, const glm::vec3& value) {
+    SetParameter(name, UniformType::Vec3, glm::value_ptr(value), sizeof(value));
+}
+
+void Material::SetVec4(const std::string& name, const glm::vec4& value) {
+    SetParameter(name, UniformType::Vec4, glm::value_ptr(value), sizeof(value));
+}
+
+void Material::SetMat3(const std::string& name, const glm::mat3& value) {
+    SetParameter(name, UniformType::Mat3, glm::value_ptr(value), sizeof(value));
+}
+
+void Material::SetMat4(const std::string& name, const glm::mat4& value) {
+    SetParameter(name, UniformType::Mat4, glm::value_ptr(value), sizeof(value));
+}
+
+int Material::GetParameterSlot(const std::string& name) const {
+    return m_shader ? m_shader->GetMaterialLayout().FindSlot(name) : -1;
+}
+
+void Material::SetInt(int slot, int value) {
+    WriteParameter(slot, UniformType::Int, &value, sizeof(value));
+}
+
+void Material::SetFloat(int slot, float value) {
+    WriteParameter(slot, UniformType::Float, &value, sizeof(value));
+}
+
+void Material::SetBool(int slot, bool value) {
+    const int intValue = value ? 1 : 0;
+    WriteParameter(slot, UniformType::Int, &intValue, sizeof(intValue));
+}
+
+void Material::SetVec2(int slot, const glm::vec2& value) {
+    WriteParameter(slot, UniformType::Vec2, glm::value_ptr(value), sizeof(value));
+}
+
+void Material::SetVec3(int slot, const glm::vec3& value) {
+    WriteParameter(slot, UniformType::Vec3, glm::value_ptr(value), sizeof(value));
+}
+
+void Material::SetVec4(int slot, const glm::vec4& value) {
+    WriteParameter(slot, UniformType::Vec4, glm::value_ptr(value), sizeof(value));
+}
+
+void Material::SetMat3(int slot, const glm::mat3& value) {
+    WriteParameter(slot, UniformType::Mat3, glm::value_ptr(value), sizeof(value));
+}
+
+void Material::SetMat4(int slot, const glm::mat4& value) {
+    WriteParameter(slot, UniformType::Mat4, glm::value_ptr(value), sizeof(value));
+}
+
+bool Material::WriteParameter(int slot, UniformType type, const void* data, std::size_t size) {
+    if (!m_shader || slot < 0) {
+        return false;
+    }
+
+    const MaterialBlockLayout& layout = m_shader->GetMaterialLayout();
+    if (static_cast<std::size_t>(slot) >= layout.parameters.size() || layout.parameters[slot].type != type) {
+        return false;
+    }
+
+    if (m_parameterData.size() != layout.size) {
+        m_parameterData.assign(layout.size, 0);
+    }
+
+    unsigned char* destination = m_parameterData.data() + layout.parameters[slot].offset;
+    if (type == UniformType::Mat3) {
+        // std140 pads each mat3 column to a vec4
+        const unsigned char* columns = static_cast<const unsigned char*>(data);
+        for (std::size_t column = 0; column < 3; ++column) {
+            std::memcpy(destination + column * sizeof(glm::vec4), columns + column * sizeof(glm::vec3), sizeof(glm::vec3));
+        }
+    } else {
+        std::memcpy(destination, data, size);
+    }
+
+    m_parametersDirty = true;
+    return true;
+}
+
+void Material::SetParameter(const std::string& name, UniformType type, const void* data, std::size_t size) {
+    if (!m_shader) {
+        return;
+    }
+
+    if (WriteParameter(GetParameterSlot(name), type, data, size)) {
+        return;
+    }
+
+    // Not a material block member: keep it as a plain uniform
+    const int location = m_shader->GetUniformLocation(name);
+    if (location < 0) {
+        return;
+    }
+
+    UniformValue* uniform = nullptr;
+    for (UniformValue& existing : m_uniforms) {
+        if (existing.location == location) {
+            uniform = &existing;
+            break;
+        }
+    }
+
+    if (!uniform) {
+        m_uniforms.push_back(UniformValue());
+        uniform = &m_uniforms.back();
+        uniform->location = location;
+    }
+
+    uniform->type = type;
+    std::memcpy(uniform->data, data, std::min(size, sizeof(uniform->data)));
+}
+
+} // namespace CHULUBME
@@ -0,0 +1,582 @@
+#include "snapshot.h"
+#include "bit_stream.h"
+#include "../rendering/renderer.h"
+#include "../gameplay/hero_system.h"
+#include "../physics/spatial_grid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace CHULUBME {
+
+namespace {
+
+// Entry operations of a delta (2 bits each)
+constexpr std::uint32_t OP_END = 0;
+constexpr std::uint32_t OP_UPDATE = 1;
+constexpr std::uint32_t OP_CREATE = 2;
+constexpr std::uint32_t OP_REMOVE = 3;
+
+// Fields of a state present in an entry (7-bit mask)
+constexpr std::uint32_t FIELD_POSITION = 1 << 0;
+constexpr std::uint32_t FIELD_ORIENTATION = 1 << 1;
+constexpr std::uint32_t FIELD_SCALE = 1 << 2;
+constexpr std::uint32_t FIELD_HEALTH = 1 << 3;
+constexpr std::uint32_t FIELD_MANA = 1 << 4;
+constexpr std::uint32_t FIELD_LEVEL = 1 << 5;
+constexpr std::uint32_t FIELD_COOLDOWNS = 1 << 6;
+constexpr unsigned FIELD_BITS = 7;
+
+// Smallest-three components are at most 1/sqrt(2) in magnitude
+constexpr float ORIENTATION_RANGE = 0.70710678f;
+constexpr float ORIENTATION_STEPS = 1023.0f;
+
+// Round a value to a quantization step, clamped so deltas never overflow
+std::int32_t Quantize(float value, float scale) {
+    const float limit = 1073741824.0f;
+    const float scaled = std::max(-limit, std::min(limit, value * scale));
+    return static_cast<std::int32_t>(std::lround(scaled));
+}
+
+// Difference of two quantized values as the wire carries it (wrapping, so decoding is exact)
+std::int32_t Delta(std::int32_t value, std::int32_t base) {
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(value) - static_cast<std::uint32_t>(base));
+}
+
+// Inverse of Delta
+std::int32_t AddDelta(std::int32_t base, std::int32_t delta) {
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(base) + static_cast<std::uint32_t>(delta));
+}
+
+// Cooldown of a state, zero past its ability count
+std::int32_t GetCooldown(const ReplicatedState& state, std::size_t index) {
+    return index < state.cooldownCount ? state.cooldowns[index] : 0;
+}
+
+// Compute the mask of fields that differ between two states with the same components
+std::uint32_t GetChangedFields(const ReplicatedState& base, const ReplicatedState& state) {
+    std::uint32_t fields = 0;
+    if (state.components & REPLICATE_TRANSFORM) {
+        if (!std::equal(state.position, state.position + 3, base.position)) fields |= FIELD_POSITION;
+        if (state.orientation != base.orientation) fields |= FIELD_ORIENTATION;
+        if (!std::equal(state.scale, state.scale + 3, base.scale)) fields |= FIELD_SCALE;
+    }
+    if (state.components & REPLICATE_HERO) {
+        if (state.health != base.health) fields |= FIELD_HEALTH;
+        if (state.mana != base.mana) fields |= FIELD_MANA;
+        if (state.level != base.level) fields |= FIELD_LEVEL;
+
+        bool cooldownsChanged = state.cooldownCount != base.cooldownCount;
+        for (std::size_t i = 0; i < state.cooldownCount && !cooldownsChanged; ++i) {
+            cooldownsChanged = state.cooldowns[i] != base.cooldowns[i];
+        }
+        if (cooldownsChanged) fields |= FIELD_COOLDOWNS;
+    }
+    return fields;
+}
+
+// Write the fields that differ from a baseline, as deltas of the quantized values
+void WriteFields(BitWriter& writer, const ReplicatedState& base, const ReplicatedState& state) {
+    const std::uint32_t fields = GetChangedFields(base, state);
+    writer.WriteBits(fields, FIELD_BITS);
+
+    if (fields & FIELD_POSITION) {
+        for (int i = 0; i < 3; ++i) {
+            writer.WriteSigned(Delta(state.position[i], base.position[i]));
+        }
+    }
+    if (fields & FIELD_ORIENTATION) {
+        writer.WriteBits(state.orientation, 32);
+    }
+    if (fields & FIELD_SCALE) {
+        for (int i = 0; i < 3; ++i) {
+            writer.WriteSigned(Delta(state.scale[i], base.scale[i]));
+        }
+    }
+    if (fields & FIELD_HEALTH) {
+        writer.WriteSigned(Delta(state.health, base.health));
+    }
+    if (fields & FIELD_MANA) {
+        writer.WriteSigned(Delta(state.mana, base.mana));
+    }
+    if (fields & FIELD_LEVEL) {
+        writer.WriteSigned(Delta(state.level, base.level));
+    }
+    if (fields & FIELD_COOLDOWNS) {
+        writer.WriteBits(state.cooldownCount, 3);
+        for (std::size_t i = 0; i < state.cooldownCount; ++i) {
+            writer.WriteSigned(Delta(state.cooldowns[i], GetCooldown(base, i)));
+        }
+    }
+}
+
+// Apply fields written by WriteFields to a copy of their baseline; false if malformed
+bool ReadFields(BitReader& reader, ReplicatedState& state) {
+    const std::uint32_t fields = reader.ReadBits(FIELD_BITS);
+
+    if (fields & FIELD_POSITION) {
+        for (int i = 0; i < 3; ++i) {
+            state.position[i] = AddDelta(state.position[i], reader.ReadSigned());
+        }
+    }
+    if (fields & FIELD_ORIENTATION) {
+        state.orientation = reader.ReadBits(32);
+    }
+    if (fields & FIELD_SCALE) {
+        for (int i = 0; i < 3; ++i) {
+            state.scale[i] = AddDelta(state.scale[i], reader.ReadSigned());
+        }
+    }
+    if (fields & FIELD_HEALTH) {
+        state.health = AddDelta(state.health, reader.ReadSigned());
+    }
+    if (fields & FIELD_MANA) {
+        state.mana = AddDelta(state.mana, reader.ReadSigned());
+    }
+    if (fields & FIELD_LEVEL) {
+        state.level = AddDelta(state.level, reader.ReadSigned());
+    }
+    if (fields & FIELD_COOLDOWNS) {
+        const std::uint32_t count = reader.ReadBits(3);
+        if (count > MAX_REPLICATED_ABILITIES) {
+            return false;
+        }
+
+        std::int32_t cooldowns[MAX_REPLICATED_ABILITIES] = {};
+        for (std::size_t i = 0; i < count; ++i) {
+            cooldowns[i] = AddDelta(GetCooldown(state, i), reader.ReadSigned());
+        }
+        std::copy(cooldowns, cooldowns + MAX_REPLICATED_ABILITIES, state.cooldowns);
+        state.cooldownCount = static_cast<std::uint8_t>(count);
+    }
+
+    return !reader.HasOverflowed();
+}
+
+// Order states by entity
+bool CompareStates(const ReplicatedState& a, const ReplicatedState& b) {
+    return a.entity < b.entity;
+}
+
+} // namespace
+
+// ReplicatedComponent implementation
+ReplicatedComponent::ReplicatedComponent(bool alwaysRelevant)
+    : m_alwaysRelevant(alwaysRelevant)
+{
+}
+
+// ReplicatedState implementation
+ReplicatedState::ReplicatedState()
+    : entity(INVALID_ENTITY)
+    , components(0)
+    , position{ 0, 0, 0 }
+    , orientation(PackOrientation(glm::quat(1.0f, 0.0f, 0.0f, 0.0f)))
+    , scale{ 0, 0, 0 }
+    , health(0)
+    , mana(0)
+    , level(0)
+    , cooldownCount(0)
+    , cooldowns{}
+{
+    const std::int32_t unitScale = Quantize(1.0f, SNAPSHOT_SCALE_SCALE);
+    scale[0] = scale[1] = scale[2] = unitScale;
+}
+
+bool ReplicatedState::operator==(const ReplicatedState& other) const {
+    return components == other.components && GetChangedFields(other, *this) == 0;
+}
+
+ReplicatedState ReplicatedState::Capture(EntityID entity, const Transform* transform, const HeroComponent* hero) {
+    ReplicatedState state;
+    state.entity = entity;
+
+    if (transform) {
+        state.components |= REPLICATE_TRANSFORM;
+
+        const glm::vec3 position = transform->GetPosition();
+        const glm::vec3 scale = transform->GetScale();
+        for (int i = 0; i < 3; ++i) {
+            state.position[i] = Quantize(position[i], SNAPSHOT_POSITION_SCALE);
+            state.scale[i] = Quantize(scale[i], SNAPSHOT_SCALE_SCALE);
+        }
+        state.orientation = PackOrientation(transform->GetOrientation());
+    }
+
+    if (hero) {
+        state.components |= REPLICATE_HERO;
+        state.health = Quantize(hero->GetCurrentHealth(), SNAPSHOT_VITALS_SCALE);
+        state.mana = Quantize(hero->GetCurrentMana(), SNAPSHOT_VITALS_SCALE);
+        state.level = hero->GetLevel();
+
+        const auto& abilities = hero->GetAbilities();
+        const std::size_t count = std::min(abilities.size(), MAX_REPLICATED_ABILITIES);
+        for (std::size_t i = 0; i < count; ++i) {
+            state.cooldowns[i] = abilities[i] ? Quantize(abilities[i]->GetCooldownRemaining(), SNAPSHOT_COOLDOWN_SCALE) : 0;
+        }
+        state.cooldownCount = static_cast<std::uint8_t>(count);
+    }
+
+    return state;
+}
+
+void ReplicatedState::Apply(Transform* transform, HeroComponent* hero) const {
+    if (transform && (components & REPLICATE_TRANSFORM)) {
+        transform->SetPosition(glm::vec3(position[0], position[1], position[2]) / SNAPSHOT_POSITION_SCALE);
+        transform->SetOrientation(UnpackOrientation(orientation));
+        transform->SetScale(glm::vec3(scale[0], scale[1], scale[2]) / SNAPSHOT_SCALE_SCALE);
+    }
+
+    if (hero && (components & REPLICATE_HERO)) {
+        if (hero->GetLevel() != level) {
+            hero->SetLevel(level);
+        }
+        hero->SetReplicatedVitals(health / SNAPSHOT_VITALS_SCALE, mana / SNAPSHOT_VITALS_SCALE);
+
+        const auto& abilities = hero->GetAbilities();
+        const std::size_t count = std::min<std::size_t>(abilities.size(), cooldownCount);
+        for (std::size_t i = 0; i < count; ++i) {
+            if (abilities[i]) {
+                abilities[i]->SetCooldownRemaining(cooldowns[i] / SNAPSHOT_COOLDOWN_SCALE);
+            }
+        }
+    }
+}
+
+std::uint32_t ReplicatedState::PackOrientation(const glm::quat& orientation) {
+    const float length = std::sqrt(orientation.x * orientation.x + orientation.y * orientation.y +
+                                   orientation.z * orientation.z + orientation.w * orientation.w);
+    const float inverseLength = length > 0.0f ? 1.0f / length : 0.0f;
+    const float components[4] = { orientation.x * inverseLength, orientation.y * inverseLength,
+                                  orientation.z * inverseLength, length > 0.0f ? orientation.w * inverseLength : 1.0f };
+
+    // Drop the largest component; the other three and its sign-flipped square root rebuild it
+    std::uint32_t largest = 0;
+    for (std::uint32_t i = 1; i < 4; ++i) {
+        if (std::fabs(components[i]) > std::fabs(components[largest])) {
+            largest = i;
+        }
+    }
+    const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+    std::uint32_t packed = largest;
+    unsigned shift = 2;
+    for (std::uint32_t i = 0; i < 4; ++i) {
+        if (i == largest) {
+            continue;
+        }
+
+        const float normalized = (components[i] * sign / ORIENTATION_RANGE + 1.0f) * 0.5f;
+        const float clamped = std::max(0.0f, std::min(1.0f, normalized));
+        packed |= static_cast<std::uint32_t>(std::lround(clamped * ORIENTATION_STEPS)) << shift;
+        shift += 10;
+    }
+    return packed;
+}
+
+glm::quat ReplicatedState::UnpackOrientation(std::uint32_t packed) {
+    const std::uint32_t largest = packed & 3u;
+    float components[4];
+    float sumSquares = 0.0f;
+    unsigned shift = 2;
+    for (std::uint32_t i = 0; i < 4; ++i) {
+        if (i == largest) {
+            continue;
+        }
+
+        const float normalized = static_cast<float>((packed >> shift) & 1023u) / ORIENTATION_STEPS;
+        components[i] = (normalized * 2.0f - 1.0f) * ORIENTATION_RANGE;
+        sumSquares += components[i] * components[i];
+        shift += 10;
+    }
+    components[largest] = std::sqrt(std::max(0.0f, 1.0f - sumSquares));
+
+    return glm::quat(components[3], components[0], components[1], components[2]);
+}
+
+// WorldSnapshot implementation
+const ReplicatedState* WorldSnapshot::Find(EntityID entity) const {
+    ReplicatedState key;
+    key.entity = entity;
+    auto it = std::lower_bound(states.begin(), states.end(), key, CompareStates);
+    return it != states.end() && it->entity == entity ? &*it : nullptr;
+}
+
+// SnapshotReplicator implementation
+SnapshotReplicator::SnapshotReplicator(EntityManager* manager)
+    : m_manager(manager)
+    , m_sequence(0)
+    , m_lastEntryCount(0)
+{
+}
+
+std::uint32_t SnapshotReplicator::CaptureSnapshot() {
+    // Sequence 0 means "no snapshot" on the wire
+    if (++m_sequence == 0) {
+        m_sequence = 1;
+    }
+
+    WorldSnapshot& snapshot = m_history[m_sequence % SNAPSHOT_HISTORY_SIZE];
+    snapshot.sequence = m_sequence;
+    snapshot.states.clear();
+    snapshot.globalEntities.clear();
+
+    const SpatialSystem* spatial = m_manager->GetSystem<SpatialSystem>();
+    m_manager->View<ReplicatedComponent>().ForEach([&](EntityID entity, ReplicatedComponent& replicated) {
+        snapshot.states.push_back(ReplicatedState::Capture(entity, m_manager->GetComponent<Transform>(entity),
+                                                           m_manager->GetComponent<HeroComponent>(entity)));
+
+        if (replicated.IsAlwaysRelevant() || !spatial || !spatial->GetGrid().Contains(entity)) {
+            snapshot.globalEntities.push_back(entity);
+        }
+    });
+
+    std::sort(snapshot.states.begin(), snapshot.states.end(), CompareStates);
+    std::sort(snapshot.globalEntities.begin(), snapshot.globalEntities.end());
+    return m_sequence;
+}
+
+bool SnapshotReplicator::AddClient(ClientID client) {
+    return m_clients.emplace(client).second;
+}
+
+void SnapshotReplicator::RemoveClient(ClientID client) {
+    m_clients.erase(client);
+}
+
+void SnapshotReplicator::SetClientView(ClientID client, const glm::vec3& center, float radius) {
+    auto it = m_clients.find(client);
+    if (it != m_clients.end()) {
+        it->second.viewCenter = center;
+        it->second.viewRadius = radius;
+    }
+}
+
+void SnapshotReplicator::AcknowledgeSnapshot(ClientID client, std::uint32_t sequence) {
+    auto it = m_clients.find(client);
+    if (it == m_clients.end() || sequence > m_sequence || sequence <= it->second.acknowledged) {
+        return;
+    }
+
+    // Only deltas actually sent to this client can become its baseline
+    if (it->second.sent[sequence % SNAPSHOT_HISTORY_SIZE].sequence == sequence) {
+        it->second.acknowledged = sequence;
+    }
+}
+
+bool SnapshotReplicator::WriteDelta(ClientID client, std::vector<unsigned char>& output) {
+    auto it = m_clients.find(client);
+    if (it == m_clients.end() || m_sequence == 0) {
+        return false;
+    }
+
+    ClientState& state = it->second;
+    const WorldSnapshot& current = m_history[m_sequence % SNAPSHOT_HISTORY_SIZE];
+
+    // Diff against the acknowledged snapshot while it and what was sent with it are still known
+    const WorldSnapshot* baseline = FindSnapshot(state.acknowledged);
+    const SentRecord* baselineSent = nullptr;
+    if (baseline) {
+        const SentRecord& record = state.sent[state.acknowledged % SNAPSHOT_HISTORY_SIZE];
+        if (record.sequence == state.acknowledged) {
+            baselineSent = &record;
+        } else {
+            baseline = nullptr;
+        }
+    }
+
+    CollectRelevant(state, current, m_relevant);
+
+    BitWriter writer(output);
+    writer.WriteBits(m_sequence, 32);
+    writer.WriteBits(baseline ? baseline->sequence : 0, 32);
+
+    EntityID previous = 0;
+    std::size_t entryCount = 0;
+    auto writeEntry = [&](std::uint32_t op, EntityID entity) {
+        writer.WriteBits(op, 2);
+        writer.WriteUnsigned(entity - previous);
+        previous = entity;
+        ++entryCount;
+    };
+
+    const ReplicatedState defaults;
+    auto writeCreate = [&](const ReplicatedState& created) {
+        writeEntry(OP_CREATE, created.entity);
+        writer.WriteBits(created.components, 2);
+
+        ReplicatedState base = defaults;
+        base.components = created.components;
+        WriteFields(writer, base, created);
+    };
+
+    // Merge the entities the client holds with the ones it should hold, both sorted
+    static const std::vector<EntityID> s_none;
+    const std::vector<EntityID>& held = baselineSent ? baselineSent->entities : s_none;
+    std::size_t heldIndex = 0;
+    std::size_t relevantIndex = 0;
+    while (heldIndex < held.size() || relevantIndex < m_relevant.size()) {
+        if (relevantIndex == m_relevant.size() ||
+            (heldIndex < held.size() && held[heldIndex] < m_relevant[relevantIndex])) {
+            // Destroyed or out of view
+            writeEntry(OP_REMOVE, held[heldIndex++]);
+            continue;
+        }
+
+        const ReplicatedState& currentState = *current.Find(m_relevant[relevantIndex]);
+        if (heldIndex == held.size() || m_relevant[relevantIndex] < held[heldIndex]) {
+            // New to this client
+            writeCreate(currentState);
+            ++relevantIndex;
+            continue;
+        }
+
+        const ReplicatedState* baseState = baseline->Find(held[heldIndex]);
+        if (!baseState || baseState->components != currentState.components) {
+            writeCreate(currentState);
+        } else if (*baseState != currentState) {
+            writeEntry(OP_UPDATE, currentState.entity);
+            WriteFields(writer, *baseState, currentState);
+        }
+        ++heldIndex;
+        ++relevantIndex;
+    }
+
+    writer.WriteBits(OP_END, 2);
+    writer.Flush();
+
+    // Remember what this delta holds (after encoding, as it may share the baseline's slot)
+    SentRecord& record = state.sent[m_sequence % SNAPSHOT_HISTORY_SIZE];
+    record.sequence = m_sequence;
+    record.entities.swap(m_relevant);
+
+    m_lastEntryCount = entryCount;
+    return true;
+}
+
+const WorldSnapshot* SnapshotReplicator::FindSnapshot(std::uint32_t sequence) const {
+    if (sequence == 0) {
+        return nullptr;
+    }
+
+    const WorldSnapshot& snapshot = m_history[sequence % SNAPSHOT_HISTORY_SIZE];
+    return snapshot.sequence == sequence ? &snapshot : nullptr;
+}
+
+void SnapshotReplicator::CollectRelevant(const ClientState& client, const WorldSnapshot& snapshot,
+                                         std::vector<EntityID>& relevant) const {
+    relevant.clear();
+
+    const SpatialSystem* spatial = m_manager->GetSystem<SpatialSystem>();
+    if (client.viewRadius <= 0.0f || !spatial) {
+        relevant.reserve(snapshot.states.size());
+        for (const ReplicatedState& state : snapshot.states) {
+            relevant.push_back(state.entity);
+        }
+        return;
+    }
+
+    // Replicated entities near the view, then the global ones
+    ScopedScratch scratch;
+    FrameVector<EntityID> nearby{ ArenaAllocator<EntityID>(scratch.GetArena()) };
+    spatial->GetGrid().QueryRadius(client.viewCenter, client.viewRadius, nearby);
+
+    relevant.reserve(nearby.size() + snapshot.globalEntities.size());
+    for (EntityID entity : nearby) {
+        if (snapshot.Find(entity)) {
+            relevant.push_back(entity);
+        }
+    }
+    relevant.insert(relevant.end(), snapshot.globalEntities.begin(), snapshot.globalEntities.end());
+
+    std::sort(relevant.begin(), relevant.end());
+    relevant.erase(std::unique(relevant.begin(), relevant.end()), relevant.end());
+}
+
+// SnapshotDecoder implementation
+const WorldSnapshot* SnapshotDecoder::ReadDelta(const unsigned char* data, std::size_t size) {
+    BitReader reader(data, size);
+    const std::uint32_t sequence = reader.ReadBits(32);
+    const std::uint32_t baselineSequence = reader.ReadBits(32);
+    if (reader.HasOverflowed() || sequence == 0) {
+        return nullptr;
+    }
+
+    const WorldSnapshot* baseline = nullptr;
+    if (baselineSequence != 0) {
+        baseline = &m_history[baselineSequence % SNAPSHOT_HISTORY_SIZE];
+        if (baseline->sequence != baselineSequence) {
+            return nullptr;
+        }
+    }
+
+    static const std::vector<ReplicatedState> s_none;
+    const std::vector<ReplicatedState>& held = baseline ? baseline->states : s_none;
+    std::size_t heldIndex = 0;
+
+    m_decoding.sequence = sequence;
+    m_decoding.states.clear();
+
+    EntityID previous = 0;
+    bool first = true;
+    while (true) {
+        const std::uint32_t op = reader.ReadBits(2);
+        if (reader.HasOverflowed()) {
+            return nullptr;
+        }
+        if (op == OP_END) {
+            break;
+        }
+
+        // Entries are in increasing entity order
+        const std::uint32_t offset = reader.ReadUnsigned();
+        if (!first && offset == 0) {
+            return nullptr;
+        }
+        const EntityID entity = previous + offset;
+        previous = entity;
+        first = false;
+
+        // States the delta does not mention are unchanged
+        while (heldIndex < held.size() && held[heldIndex].entity < entity) {
+            m_decoding.states.push_back(held[heldIndex++]);
+        }
+        const ReplicatedState* base = nullptr;
+        if (heldIndex < held.size() && held[heldIndex].entity == entity) {
+            base = &held[heldIndex++];
+        }
+
+        if (op == OP_REMOVE) {
+            continue;
+        }
+
+        ReplicatedState state;
+        if (op == OP_UPDATE) {
+            if (!base) {
+                return nullptr;
+            }
+            state = *base;
+        } else {
+            state.entity = entity;
+            state.components = static_cast<std::uint8_t>(reader.ReadBits(2));
+        }
+
+        if (!ReadFields(reader, state)) {
+            return nullptr;
+        }
+        m_decoding.states.push_back(state);
+    }
+    m_decoding.states.insert(m_decoding.states.end(), held.begin() + heldIndex, held.end());
+
+    // Store it as a baseline for later deltas
+    WorldSnapshot& slot = m_history[sequence % SNAPSHOT_HISTORY_SIZE];
+    std::swap(slot, m_decoding);
+    m_latest = std::max(m_latest, sequence);
+    return &slot;
+}
+
+const WorldSnapshot* SnapshotDecoder::GetLatest() const {
+    const WorldSnapshot& snapshot = m_history[m_latest % SNAPSHOT_HISTORY_SIZE];
+    return m_latest != 0 && snapshot.sequence == m_latest ? &snapshot : nullptr;
+}
+
+} // namespace CHULUBME
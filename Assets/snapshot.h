@@ -0,0 +1,246 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "../core/ecs.h"
+#include "../core/containers.h"
+
+namespace CHULUBME {
+
+// Forward declarations
+class Transform;
+class HeroComponent;
+
+// Components a replicated state carries
+constexpr std::uint8_t REPLICATE_TRANSFORM = 1 << 0;
+constexpr std::uint8_t REPLICATE_HERO = 1 << 1;
+
+// Most ability cooldowns replicated per hero
+constexpr std::size_t MAX_REPLICATED_ABILITIES = 6;
+
+// Number of snapshots kept as delta baselines (about 1.6 s at 20 Hz)
+constexpr std::size_t SNAPSHOT_HISTORY_SIZE = 32;
+
+// Quantization steps: 1/64 unit positions, 1/256 scale, 1/4 health and mana, 1/20 s cooldowns
+constexpr float SNAPSHOT_POSITION_SCALE = 64.0f;
+constexpr float SNAPSHOT_SCALE_SCALE = 256.0f;
+constexpr float SNAPSHOT_VITALS_SCALE = 4.0f;
+constexpr float SNAPSHOT_COOLDOWN_SCALE = 20.0f;
+
+/**
+ * @brief Component marking an entity for replication to clients
+ *
+ * Only entities with this component are captured in snapshots. Entities
+ * that are not in the spatial grid, or are always relevant (e.g. every
+ * hero for the scoreboard), are sent to every client; the rest only to
+ * clients whose view contains them.
+ */
+class ReplicatedComponent : public Component {
+public:
+    ReplicatedComponent(bool alwaysRelevant = false);
+    ~ReplicatedComponent() = default;
+
+    // Set whether every client receives the entity regardless of its view
+    void SetAlwaysRelevant(bool alwaysRelevant) { m_alwaysRelevant = alwaysRelevant; }
+
+    // Check whether every client receives the entity regardless of its view
+    bool IsAlwaysRelevant() const { return m_alwaysRelevant; }
+
+private:
+    bool m_alwaysRelevant;
+};
+
+/**
+ * @brief Quantized replicated state of one entity
+ *
+ * States compare equal exactly when a client would see no change, so
+ * unchanged entities are skipped with one comparison.
+ */
+struct ReplicatedState {
+    EntityID entity;
+    std::uint8_t components;
+
+    // Transform (local position, smallest-three orientation, scale)
+    std::int32_t position[3];
+    std::uint32_t orientation;
+    std::int32_t scale[3];
+
+    // Hero
+    std::int32_t health;
+    std::int32_t mana;
+    std::int32_t level;
+    std::uint8_t cooldownCount;
+    std::int32_t cooldowns[MAX_REPLICATED_ABILITIES];
+
+    // Constructor with default values (identity transform, no components)
+    ReplicatedState();
+
+    // Check if two states would look the same to a client
+    bool operator==(const ReplicatedState& other) const;
+    bool operator!=(const ReplicatedState& other) const { return !(*this == other); }
+
+    // Quantize an entity's components (either may be null)
+    static ReplicatedState Capture(EntityID entity, const Transform* transform, const HeroComponent* hero);
+
+    // Write the state into an entity's components (either may be null)
+    void Apply(Transform* transform, HeroComponent* hero) const;
+
+    // Pack an orientation into 2 bits of largest-component index and three 10-bit components
+    static std::uint32_t PackOrientation(const glm::quat& orientation);
+
+    // Unpack an orientation written by PackOrientation
+    static glm::quat UnpackOrientation(std::uint32_t packed);
+};
+
+/**
+ * @brief Replicated states of every captured entity at one point in time
+ */
+struct WorldSnapshot {
+    // Sequence number (0 for an empty slot)
+    std::uint32_t sequence;
+
+    // States sorted by entity ID
+    std::vector<ReplicatedState> states;
+
+    // Entities sent to every client, sorted (server only)
+    std::vector<EntityID> globalEntities;
+
+    // Constructor with default values
+    WorldSnapshot() : sequence(0) {}
+
+    // Find an entity's state (nullptr if it was not captured)
+    const ReplicatedState* Find(EntityID entity) const;
+};
+
+/**
+ * @brief Server side of snapshot replication
+ *
+ * CaptureSnapshot quantizes every replicated entity into a ring of recent
+ * snapshots. WriteDelta then encodes, for one client, the difference between
+ * the latest snapshot and the last one that client acknowledged, limited to
+ * the entities relevant to it: those the SpatialSystem's grid finds within
+ * its view, plus global ones. Unchanged entities produce no bits, changed
+ * ones only the fields that changed, as bit-packed deltas of quantized
+ * values, so a delta grows with what changed near the client rather than
+ * with the world. The entities each delta was limited to are remembered per
+ * client so the next delta diffs against exactly what that client holds;
+ * an entity that leaves the view is sent as removed.
+ *
+ * Clients acknowledge the sequence of each delta they decode. A client with
+ * no acknowledged snapshot still in the history receives a full snapshot.
+ */
+class SnapshotReplicator {
+public:
+    using ClientID = std::uint32_t;
+
+    SnapshotReplicator(EntityManager* manager);
+    ~SnapshotReplicator() = default;
+
+    // Capture the state of every replicated entity; returns the new sequence number
+    std::uint32_t CaptureSnapshot();
+
+    // Get the sequence number of the latest snapshot (0 before the first capture)
+    std::uint32_t GetLatestSequence() const { return m_sequence; }
+
+    // Add a client (its first delta is a full snapshot); false if already added
+    bool AddClient(ClientID client);
+
+    // Remove a client
+    void RemoveClient(ClientID client);
+
+    // Set the area a client receives entities in (a radius of zero or less receives everything)
+    void SetClientView(ClientID client, const glm::vec3& center, float radius);
+
+    // Record that a client decoded a snapshot, making it the client's baseline
+    void AcknowledgeSnapshot(ClientID client, std::uint32_t sequence);
+
+    // Append the latest snapshot as a delta for a client; false for unknown clients or before the first capture
+    bool WriteDelta(ClientID client, std::vector<unsigned char>& output);
+
+    // Get the number of entities written by the last WriteDelta (changed, added or removed)
+    std::size_t GetLastEntryCount() const { return m_lastEntryCount; }
+
+private:
+    // Entities a delta was limited to
+    struct SentRecord {
+        std::uint32_t sequence;
+        std::vector<EntityID> entities;
+
+        // Constructor with default values
+        SentRecord() : sequence(0) {}
+    };
+
+    // Per-client view and delta history
+    struct ClientState {
+        glm::vec3 viewCenter;
+        float viewRadius;
+        std::uint32_t acknowledged;
+        std::array<SentRecord, SNAPSHOT_HISTORY_SIZE> sent;
+
+        // Constructor with default values
+        ClientState() : viewCenter(0.0f), viewRadius(0.0f), acknowledged(0) {}
+    };
+
+    // Find a snapshot still in the history (nullptr if overwritten or never captured)
+    const WorldSnapshot* FindSnapshot(std::uint32_t sequence) const;
+
+    // Collect the sorted entities of a snapshot relevant to a client
+    void CollectRelevant(const ClientState& client, const WorldSnapshot& snapshot, std::vector<EntityID>& relevant) const;
+
+    // Entity manager
+    EntityManager* m_manager;
+
+    // Recent snapshots, indexed by sequence modulo the history size
+    std::array<WorldSnapshot, SNAPSHOT_HISTORY_SIZE> m_history;
+
+    // Latest sequence number
+    std::uint32_t m_sequence;
+
+    // Connected clients
+    FlatHashMap<ClientID, ClientState> m_clients;
+
+    // Relevant entities of the delta being written (reused across clients)
+    std::vector<EntityID> m_relevant;
+
+    // Statistics of the last delta
+    std::size_t m_lastEntryCount;
+};
+
+/**
+ * @brief Client side of snapshot replication
+ *
+ * Decodes deltas against the snapshots it decoded before, which hold
+ * exactly the entities the server sent this client. The decoded snapshot
+ * lists every entity the client should show; entities missing from it were
+ * removed or left the view. Mapping server entity IDs to local entities
+ * (and applying states with ReplicatedState::Apply) is up to the caller,
+ * which acknowledges each decoded sequence to the server.
+ */
+class SnapshotDecoder {
+public:
+    SnapshotDecoder() = default;
+    ~SnapshotDecoder() = default;
+
+    // Decode a delta; returns the decoded snapshot, or nullptr if malformed or its baseline is unknown
+    const WorldSnapshot* ReadDelta(const unsigned char* data, std::size_t size);
+
+    // Get the latest decoded snapshot (nullptr before the first)
+    const WorldSnapshot* GetLatest() const;
+
+private:
+    // Decoded snapshots, indexed by sequence modulo the history size
+    std::array<WorldSnapshot, SNAPSHOT_HISTORY_SIZE> m_history;
+
+    // Latest decoded sequence
+    std::uint32_t m_latest = 0;
+
+    // Snapshot being decoded, swapped into the history once complete
+    WorldSnapshot m_decoding;
+};
+
+} // namespace CHULUBME
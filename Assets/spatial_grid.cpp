@@ -0,0 +1,319 @@
+#include "spatial_grid.h"
+#include "../rendering/renderer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace CHULUBME {
+
+// SpatialGrid implementation
+SpatialGrid::SpatialGrid(float cellSize)
+    : m_cellSize(cellSize > 0.0f ? cellSize : 1.0f)
+    , m_inverseCellSize(1.0f / m_cellSize)
+    , m_maxRadius(0.0f)
+{
+}
+
+void SpatialGrid::Insert(EntityID entity, const glm::vec3& position, float radius) {
+    if (entity == INVALID_ENTITY) {
+        return;
+    }
+
+    Remove(entity);
+
+    const std::uint32_t entityIndex = GetEntityIndex(entity);
+    if (entityIndex >= m_proxyIndices.size()) {
+        m_proxyIndices.resize(entityIndex + 1, INVALID_PROXY);
+    }
+
+    const std::uint32_t proxyIndex = static_cast<std::uint32_t>(m_proxies.size());
+    Proxy proxy;
+    proxy.entity = entity;
+    proxy.x = position.x;
+    proxy.z = position.z;
+    proxy.radius = radius;
+    proxy.cell = MakeCellKey(GetCellCoordinate(position.x), GetCellCoordinate(position.z));
+    proxy.slot = 0;
+    m_proxies.push_back(proxy);
+    m_proxyIndices[entityIndex] = proxyIndex;
+
+    LinkProxy(proxyIndex);
+    m_maxRadius = std::max(m_maxRadius, radius);
+}
+
+void SpatialGrid::Update(EntityID entity, const glm::vec3& position) {
+    const std::uint32_t proxyIndex = FindProxy(entity);
+    if (proxyIndex == INVALID_PROXY) {
+        return;
+    }
+
+    Proxy& proxy = m_proxies[proxyIndex];
+    proxy.x = position.x;
+    proxy.z = position.z;
+
+    // Only re-bucket when the entity crossed into another cell
+    const std::uint64_t cell = MakeCellKey(GetCellCoordinate(position.x), GetCellCoordinate(position.z));
+    if (cell != proxy.cell) {
+        UnlinkProxy(proxyIndex);
+        m_proxies[proxyIndex].cell = cell;
+        LinkProxy(proxyIndex);
+    }
+}
+
+void SpatialGrid::SetRadius(EntityID entity, float radius) {
+    const std::uint32_t proxyIndex = FindProxy(entity);
+    if (proxyIndex == INVALID_PROXY) {
+        return;
+    }
+
+    m_proxies[proxyIndex].radius = radius;
+    m_maxRadius = std::max(m_maxRadius, radius);
+}
+
+void SpatialGrid::Remove(EntityID entity) {
+    const std::uint32_t proxyIndex = FindProxy(entity);
+    if (proxyIndex == INVALID_PROXY) {
+        return;
+    }
+
+    UnlinkProxy(proxyIndex);
+    m_proxyIndices[GetEntityIndex(entity)] = INVALID_PROXY;
+
+    // Keep proxies dense by moving the last one into the hole
+    const std::uint32_t lastIndex = static_cast<std::uint32_t>(m_proxies.size() - 1);
+    if (proxyIndex != lastIndex) {
+        Proxy& moved = m_proxies[lastIndex];
+        m_cells.find(moved.cell)->second[moved.slot] = proxyIndex;
+        m_proxyIndices[GetEntityIndex(moved.entity)] = proxyIndex;
+        m_proxies[proxyIndex] = moved;
+    }
+    m_proxies.pop_back();
+}
+
+void SpatialGrid::Clear() {
+    m_proxies.clear();
+    m_proxyIndices.clear();
+    m_cells.clear();
+    m_maxRadius = 0.0f;
+}
+
+void SpatialGrid::QueryRadius(const glm::vec3& center, float radius, FrameVector<EntityID>& results) const {
+    const float reach = radius + m_maxRadius;
+
+    ForEachProxy(center.x - reach, center.z - reach, center.x + reach, center.z + reach, [&](const Proxy& proxy) {
+        const float dx = proxy.x - center.x;
+        const float dz = proxy.z - center.z;
+        const float combined = radius + proxy.radius;
+        if (dx * dx + dz * dz <= combined * combined) {
+            results.push_back(proxy.entity);
+        }
+    });
+}
+
+void SpatialGrid::QueryCapsule(const glm::vec3& start, const glm::vec3& end, float radius, FrameVector<EntityID>& results) const {
+    const float reach = radius + m_maxRadius;
+    const float segmentX = end.x - start.x;
+    const float segmentZ = end.z - start.z;
+    const float segmentLengthSquared = segmentX * segmentX + segmentZ * segmentZ;
+
+    ScopedScratch scratch;
+    FrameVector<Candidate> candidates{ ArenaAllocator<Candidate>(scratch.GetArena()) };
+
+    ForEachProxy(std::min(start.x, end.x) - reach, std::min(start.z, end.z) - reach,
+                 std::max(start.x, end.x) + reach, std::max(start.z, end.z) + reach, [&](const Proxy& proxy) {
+        // Closest point on the segment to the proxy center
+        float t = 0.0f;
+        if (segmentLengthSquared > 0.0f) {
+            t = ((proxy.x - start.x) * segmentX + (proxy.z - start.z) * segmentZ) / segmentLengthSquared;
+            t = std::min(std::max(t, 0.0f), 1.0f);
+        }
+
+        const float dx = proxy.x - (start.x + segmentX * t);
+        const float dz = proxy.z - (start.z + segmentZ * t);
+        const float combined = radius + proxy.radius;
+        if (dx * dx + dz * dz <= combined * combined) {
+            candidates.push_back({ t, proxy.entity });
+        }
+    });
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.key < b.key;
+    });
+
+    for (const Candidate& candidate : candidates) {
+        results.push_back(candidate.entity);
+    }
+}
+
+void SpatialGrid::QueryRect(const glm::vec3& min, const glm::vec3& max, FrameVector<EntityID>& results) const {
+    ForEachProxy(min.x - m_maxRadius, min.z - m_maxRadius, max.x + m_maxRadius, max.z + m_maxRadius, [&](const Proxy& proxy) {
+        // Distance from the proxy center to the closest point of the rectangle
+        const float dx = proxy.x - std::min(std::max(proxy.x, min.x), max.x);
+        const float dz = proxy.z - std::min(std::max(proxy.z, min.z), max.z);
+        if (dx * dx + dz * dz <= proxy.radius * proxy.radius) {
+            results.push_back(proxy.entity);
+        }
+    });
+}
+
+void SpatialGrid::QueryNearest(const glm::vec3& center, std::size_t count, float maxDistance, FrameVector<EntityID>& results) const {
+    if (count == 0 || maxDistance < 0.0f) {
+        return;
+    }
+
+    ScopedScratch scratch;
+    FrameVector<Candidate> candidates{ ArenaAllocator<Candidate>(scratch.GetArena()) };
+
+    // Grow the search radius until enough entities are found; every entity within
+    // the radius is gathered, so the closest count of them are the global nearest
+    float searchRadius = std::min(m_cellSize, maxDistance);
+    for (;;) {
+        candidates.clear();
+
+        ForEachProxy(center.x - searchRadius, center.z - searchRadius,
+                     center.x + searchRadius, center.z + searchRadius, [&](const Proxy& proxy) {
+            const float dx = proxy.x - center.x;
+            const float dz = proxy.z - center.z;
+            const float distanceSquared = dx * dx + dz * dz;
+            if (distanceSquared <= searchRadius * searchRadius) {
+                candidates.push_back({ distanceSquared, proxy.entity });
+            }
+        });
+
+        if (candidates.size() >= count || searchRadius >= maxDistance) {
+            break;
+        }
+
+        searchRadius = std::min(searchRadius * 2.0f, maxDistance);
+    }
+
+    const std::size_t resultCount = std::min(count, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + resultCount, candidates.end(),
+                      [](const Candidate& a, const Candidate& b) { return a.key < b.key; });
+
+    for (std::size_t i = 0; i < resultCount; ++i) {
+        results.push_back(candidates[i].entity);
+    }
+}
+
+std::int32_t SpatialGrid::GetCellCoordinate(float value) const {
+    return static_cast<std::int32_t>(std::floor(value * m_inverseCellSize));
+}
+
+std::uint64_t SpatialGrid::MakeCellKey(std::int32_t x, std::int32_t z) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(z);
+}
+
+std::uint32_t SpatialGrid::FindProxy(EntityID entity) const {
+    const std::uint32_t entityIndex = GetEntityIndex(entity);
+    if (entityIndex >= m_proxyIndices.size()) {
+        return INVALID_PROXY;
+    }
+
+    // Stale handles to a reused entity slot do not match the stored entity
+    const std::uint32_t proxyIndex = m_proxyIndices[entityIndex];
+    if (proxyIndex == INVALID_PROXY || m_proxies[proxyIndex].entity != entity) {
+        return INVALID_PROXY;
+    }
+
+    return proxyIndex;
+}
+
+void SpatialGrid::LinkProxy(std::uint32_t proxyIndex) {
+    Proxy& proxy = m_proxies[proxyIndex];
+    std::vector<std::uint32_t>& cell = m_cells[proxy.cell];
+    proxy.slot = static_cast<std::uint32_t>(cell.size());
+    cell.push_back(proxyIndex);
+}
+
+void SpatialGrid::UnlinkProxy(std::uint32_t proxyIndex) {
+    const Proxy& proxy = m_proxies[proxyIndex];
+    std::vector<std::uint32_t>& cell = m_cells.find(proxy.cell)->second;
+
+    // Swap-remove from the cell; empty cells keep their storage for reuse
+    const std::uint32_t movedIndex = cell.back();
+    cell[proxy.slot] = movedIndex;
+    m_proxies[movedIndex].slot = proxy.slot;
+    cell.pop_back();
+}
+
+template<typename Func>
+void SpatialGrid::ForEachProxy(float minX, float minZ, float maxX, float maxZ, Func&& func) const {
+    if (m_proxies.empty()) {
+        return;
+    }
+
+    const std::int32_t minCellX = GetCellCoordinate(minX);
+    const std::int32_t minCellZ = GetCellCoordinate(minZ);
+    const std::int32_t maxCellX = GetCellCoordinate(maxX);
+    const std::int32_t maxCellZ = GetCellCoordinate(maxZ);
+
+    // Walk the occupied cells instead when the rectangle covers more cells than exist
+    const std::uint64_t rectCellCount = (static_cast<std::uint64_t>(static_cast<std::int64_t>(maxCellX) - minCellX) + 1) *
+                                        (static_cast<std::uint64_t>(static_cast<std::int64_t>(maxCellZ) - minCellZ) + 1);
+    if (rectCellCount > m_cells.size()) {
+        for (const auto& cell : m_cells) {
+            const std::int32_t cellX = static_cast<std::int32_t>(static_cast<std::uint32_t>(cell.first >> 32));
+            const std::int32_t cellZ = static_cast<std::int32_t>(static_cast<std::uint32_t>(cell.first));
+            if (cellX < minCellX || cellX > maxCellX || cellZ < minCellZ || cellZ > maxCellZ) {
+                continue;
+            }
+
+            for (std::uint32_t proxyIndex : cell.second) {
+                func(m_proxies[proxyIndex]);
+            }
+        }
+        return;
+    }
+
+    for (std::int32_t cellX = minCellX; cellX <= maxCellX; ++cellX) {
+        for (std::int32_t cellZ = minCellZ; cellZ <= maxCellZ; ++cellZ) {
+            auto it = m_cells.find(MakeCellKey(cellX, cellZ));
+            if (it == m_cells.end()) {
+                continue;
+            }
+
+            for (std::uint32_t proxyIndex : it->second) {
+                func(m_proxies[proxyIndex]);
+            }
+        }
+    }
+}
+
+// SpatialSystem implementation
+SpatialSystem::SpatialSystem(EntityManager* manager, float cellSize)
+    : System(manager)
+    , m_grid(cellSize)
+    , m_defaultRadius(0.5f)
+{
+    RequireComponent<Transform>(ComponentAccess::Write);
+
+    // Rebuilds the grid other systems query
+    SetExclusive(true);
+
+    // The grid serves gameplay queries, so it is refreshed with the simulation
+    SetFixedStep(true);
+}
+
+void SpatialSystem::Update(float deltaTime) {
+    // Re-bucket entities whose position changed since the last update
+    m_manager->View<Transform>().ForEach([this](EntityID entity, Transform& transform) {
+        if (transform.IsSpatialDirty()) {
+            m_grid.Update(entity, transform.GetWorldPosition());
+            transform.ClearSpatialDirty();
+        }
+    });
+}
+
+void SpatialSystem::OnEntityAdded(Entity entity) {
+    Transform* transform = entity.GetComponent<Transform>();
+    if (transform) {
+        m_grid.Insert(entity.GetID(), transform->GetWorldPosition(), m_defaultRadius);
+        transform->ClearSpatialDirty();
+    }
+}
+
+void SpatialSystem::OnEntityRemoved(Entity entity) {
+    m_grid.Remove(entity.GetID());
+}
+
+} // namespace CHULUBME
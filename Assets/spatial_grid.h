@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "../core/ecs.h"
+#include "../core/containers.h"
+
+namespace CHULUBME {
+
+/**
+ * @brief Uniform grid over the XZ map plane for proximity queries
+ *
+ * Each entity is stored as a circle (position and radius) in the cell that
+ * contains its center. Queries widen their cell range by the largest radius
+ * seen, so every overlapping entity is found exactly once. Results are
+ * appended to arena-backed vectors, so queries do not touch the global heap.
+ */
+class SpatialGrid {
+public:
+    SpatialGrid(float cellSize = 4.0f);
+    ~SpatialGrid() = default;
+
+    // Add an entity (replaces its entry if already present)
+    void Insert(EntityID entity, const glm::vec3& position, float radius);
+
+    // Move an entity, changing cells only when it crosses a cell boundary
+    void Update(EntityID entity, const glm::vec3& position);
+
+    // Change the radius of an entity
+    void SetRadius(EntityID entity, float radius);
+
+    // Remove an entity
+    void Remove(EntityID entity);
+
+    // Remove all entities
+    void Clear();
+
+    // Check if an entity is in the grid
+    bool Contains(EntityID entity) const { return FindProxy(entity) != INVALID_PROXY; }
+
+    // Get the number of entities in the grid
+    std::size_t GetEntityCount() const { return m_proxies.size(); }
+
+    // Get the cell size
+    float GetCellSize() const { return m_cellSize; }
+
+    // Find entities whose circle overlaps a circle
+    void QueryRadius(const glm::vec3& center, float radius, FrameVector<EntityID>& results) const;
+
+    // Find entities whose circle overlaps a capsule (a segment swept by a radius), ordered along the segment
+    void QueryCapsule(const glm::vec3& start, const glm::vec3& end, float radius, FrameVector<EntityID>& results) const;
+
+    // Find entities whose circle overlaps an XZ rectangle (the y components are ignored)
+    void QueryRect(const glm::vec3& min, const glm::vec3& max, FrameVector<EntityID>& results) const;
+
+    // Find up to count entities closest to a point within maxDistance, nearest first
+    void QueryNearest(const glm::vec3& center, std::size_t count, float maxDistance, FrameVector<EntityID>& results) const;
+
+private:
+    static constexpr std::uint32_t INVALID_PROXY = 0xFFFFFFFFu;
+
+    // Grid entry for one entity
+    struct Proxy {
+        EntityID entity;
+        float x;
+        float z;
+        float radius;
+        std::uint64_t cell;
+        std::uint32_t slot;
+    };
+
+    // Entity with a query-specific sort key
+    struct Candidate {
+        float key;
+        EntityID entity;
+    };
+
+    // Cell coordinates of a position
+    std::int32_t GetCellCoordinate(float value) const;
+
+    // Pack cell coordinates into a cell key
+    static std::uint64_t MakeCellKey(std::int32_t x, std::int32_t z);
+
+    // Find the proxy index of an entity
+    std::uint32_t FindProxy(EntityID entity) const;
+
+    // Add or remove a proxy from its cell
+    void LinkProxy(std::uint32_t proxyIndex);
+    void UnlinkProxy(std::uint32_t proxyIndex);
+
+    // Visit every proxy in cells overlapping an XZ rectangle
+    template<typename Func>
+    void ForEachProxy(float minX, float minZ, float maxX, float maxZ, Func&& func) const;
+
+    // Cell size
+    float m_cellSize;
+    float m_inverseCellSize;
+
+    // Largest proxy radius (queries reach this far into neighbouring cells)
+    float m_maxRadius;
+
+    // Dense proxy storage
+    std::vector<Proxy> m_proxies;
+
+    // Proxy index for each entity index (INVALID_PROXY if absent)
+    std::vector<std::uint32_t> m_proxyIndices;
+
+    // Proxy indices stored in each occupied cell
+    FlatHashMap<std::uint64_t, std::vector<std::uint32_t>> m_cells;
+};
+
+/**
+ * @brief System keeping a SpatialGrid in sync with entity transforms
+ *
+ * Only transforms whose position changed since the last update are
+ * re-bucketed. The system is exclusive so grid queries made by other
+ * systems never race with its updates.
+ */
+class SpatialSystem : public System {
+public:
+    SpatialSystem(EntityManager* manager, float cellSize = 4.0f);
+    ~SpatialSystem() = default;
+
+    // Update moved entities
+    void Update(float deltaTime) override;
+
+    // Called when an entity is added to this system
+    void OnEntityAdded(Entity entity) override;
+
+    // Called when an entity is removed from this system
+    void OnEntityRemoved(Entity entity) override;
+
+    // Get the grid
+    const SpatialGrid& GetGrid() const { return m_grid; }
+    SpatialGrid& GetGrid() { return m_grid; }
+
+    // Set the radius used for newly added entities
+    void SetDefaultRadius(float radius) { m_defaultRadius = radius; }
+
+    // Get the radius used for newly added entities
+    float GetDefaultRadius() const { return m_defaultRadius; }
+
+private:
+    // Spatial grid
+    SpatialGrid m_grid;
+
+    // Radius for newly added entities
+    float m_defaultRadius;
+};
+
+} // namespace CHULUBME
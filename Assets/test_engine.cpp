@@ -1,6 +1,10 @@
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <string>
+#include <thread>
 
 #include "core/ecs.h"
 #include "core/engine.h"
@@ -72,38 +76,87 @@ public:
 // Test input handling
 class TestInputHandler {
 public:
-    TestInputHandler() {
-        // Register key callback
-        InputManager::Instance().RegisterKeyCallback(
-            [this](KeyCode key, InputAction action, InputMod mods) {
-                if (action == InputAction::Press) {
-                    std::cout << "Key pressed: " << static_cast<int>(key) << std::endl;
+    TestInputHandler(EventBus& eventBus) {
+        // Receive each tick's input as one batch
+        eventBus.Subscribe<InputEvent>([this](const EventBatch<InputEvent>& events) {
+            for (const InputEvent& event : events) {
+                switch (event.type) {
+                    case InputEvent::Type::Key:
+                        if (event.action == InputAction::Press) {
+                            std::cout << "Key pressed: " << static_cast<int>(event.key) << std::endl;
+                        }
+                        break;
+                    case InputEvent::Type::MouseButton:
+                        if (event.action == InputAction::Press) {
+                            std::cout << "Mouse button pressed: " << static_cast<int>(event.button) << std::endl;
+                        }
+                        break;
+                    case InputEvent::Type::MouseMove: {
+                        // Only log occasionally to avoid spam
+                        static int counter = 0;
+                        if (counter++ % 100 == 0) {
+                            std::cout << "Mouse moved: " << event.x << ", " << event.y << std::endl;
+                        }
+                        break;
+                    }
+                    default:
+                        break;
                 }
             }
-        );
-        
-        // Register mouse button callback
-        InputManager::Instance().RegisterMouseButtonCallback(
-            [this](MouseButton button, InputAction action, InputMod mods) {
-                if (action == InputAction::Press) {
-                    std::cout << "Mouse button pressed: " << static_cast<int>(button) << std::endl;
-                }
-            }
-        );
-        
-        // Register mouse move callback
-        InputManager::Instance().RegisterMouseMoveCallback(
-            [this](double xpos, double ypos) {
-                // Only log occasionally to avoid spam
-                static int counter = 0;
-                if (counter++ % 100 == 0) {
-                    std::cout << "Mouse moved: " << xpos << ", " << ypos << std::endl;
-                }
-            }
-        );
+        });
     }
 };
 
+// Test blockchain node connection answering every query locally and counting the round trips
+class TestBlockchainClient : public BlockchainClient {
+public:
+    static constexpr float BALANCE = 250.0f;
+
+    const std::string& GetAddress() const override { return m_address; }
+
+    std::optional<float> QueryBalance() override {
+        ++m_balanceQueries;
+        return BALANCE;
+    }
+
+    std::optional<std::vector<NFT>> QueryOwnedNFTs() override {
+        ++m_ownedNFTQueries;
+        NFT nft;
+        nft.ID = "test_skin";
+        return std::vector<NFT>{ nft };
+    }
+
+    std::vector<std::vector<std::string>> QueryOwnedNFTIDs(const std::vector<std::string>& addresses) override {
+        return std::vector<std::vector<std::string>>(addresses.size(), std::vector<std::string>{ "test_skin" });
+    }
+
+    std::vector<NFTPage> QueryNFTPages(const std::vector<NFTPageQuery>& queries) override {
+        return std::vector<NFTPage>(queries.size());
+    }
+
+    std::vector<bool> SubmitTransfers(const std::vector<TokenTransfer>& transfers) override {
+        return std::vector<bool>(transfers.size(), true);
+    }
+
+    std::vector<bool> SubmitNFTOrders(const std::vector<NFTOrder>& orders) override {
+        return std::vector<bool>(orders.size(), true);
+    }
+
+    std::vector<bool> SubmitPlayScores(const std::vector<PlayScoreUpdate>& updates) override {
+        return std::vector<bool>(updates.size(), true);
+    }
+
+    std::optional<ChainActivity> PollActivity() override { return ChainActivity(); }
+
+    int GetBalanceQueryCount() const { return m_balanceQueries; }
+    int GetOwnedNFTQueryCount() const { return m_ownedNFTQueries; }
+
+private:
+    std::string m_address = "test_wallet";
+    std::atomic<int> m_balanceQueries{ 0 };
+    std::atomic<int> m_ownedNFTQueries{ 0 };
+};
+
 // Test memory management
 void TestMemoryManagement() {
     std::cout << "Testing memory management..." << std::endl;
@@ -147,7 +200,7 @@ void TestMemoryManagement() {
 }
 
 // Test blockchain interface
-void TestBlockchainInterface() {
+bool TestBlockchainInterface() {
     std::cout << "Testing blockchain interface..." << std::endl;
     
     // Get blockchain interface
@@ -156,7 +209,7 @@ void TestBlockchainInterface() {
     // Initialize blockchain interface
     if (!blockchainInterface.Initialize()) {
         std::cout << "Failed to initialize blockchain interface" << std::endl;
-        return;
+        return false;
     }
     
     std::cout << "Blockchain interface initialized" << std::endl;
@@ -164,22 +217,55 @@ void TestBlockchainInterface() {
     // Create wallet
     if (!blockchainInterface.CreateWallet("password123")) {
         std::cout << "Failed to create wallet" << std::endl;
-        return;
+        return false;
     }
     
     std::cout << "Wallet created" << std::endl;
     
-    // Get balance
-    float balance = blockchainInterface.GetBalance();
-    std::cout << "Wallet balance: " << balance << " ILYZ" << std::endl;
+    // Queue identical queries before the worker starts, so they all join one round trip
+    const int balanceRequestCount = 10;
+    int balanceCallbacks = 0;
+    int ownedNFTCallbacks = 0;
+    for (int i = 0; i < balanceRequestCount; ++i) {
+        blockchainInterface.RequestBalance([&balanceCallbacks](const std::optional<float>& balance) {
+            if (balance && *balance == TestBlockchainClient::BALANCE) {
+                ++balanceCallbacks;
+            }
+        });
+    }
+    blockchainInterface.RequestOwnedNFTs([&ownedNFTCallbacks](const std::optional<std::vector<NFT>>& ownedNFTs) {
+        if (ownedNFTs && ownedNFTs->size() == 1) {
+            ++ownedNFTCallbacks;
+        }
+    });
     
-    // Get owned NFTs
-    std::vector<NFT> ownedNFTs = blockchainInterface.GetOwnedNFTs();
-    std::cout << "Owned NFTs: " << ownedNFTs.size() << std::endl;
+    // Connect the stub node, which starts the worker
+    auto client = std::make_unique<TestBlockchainClient>();
+    TestBlockchainClient* testClient = client.get();
+    blockchainInterface.SetClient(std::move(client));
     
-    // Shutdown blockchain interface
+    // Wait for the worker, delivering results as a frame would
+    for (int i = 0; i < 100 && blockchainInterface.GetPendingRequestCount() > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    blockchainInterface.Update(0.0f);
+    
+    const bool passed = testClient->GetBalanceQueryCount() == 1 && balanceCallbacks == balanceRequestCount &&
+                        testClient->GetOwnedNFTQueryCount() == 1 && ownedNFTCallbacks == 1 &&
+                        blockchainInterface.GetBalance() == TestBlockchainClient::BALANCE &&
+                        blockchainInterface.GetOwnershipCache().IsOwned("test_wallet", "test_skin");
+    
+    std::cout << "Balance queries: " << testClient->GetBalanceQueryCount() << " for " << balanceRequestCount
+              << " requests, " << balanceCallbacks << " callbacks" << std::endl;
+    std::cout << "Owned NFT queries: " << testClient->GetOwnedNFTQueryCount() << ", " << ownedNFTCallbacks
+              << " callbacks" << std::endl;
+    
+    // Stop the worker and shutdown blockchain interface
+    blockchainInterface.SetClient(nullptr);
     blockchainInterface.Shutdown();
     std::cout << "Blockchain interface shut down" << std::endl;
+    
+    return passed;
 }
 
 // Main function
@@ -228,21 +314,29 @@ int main() {
     
     std::cout << "Created test entities" << std::endl;
     
+    // Publish input on the entity manager's event bus
+    inputManager.SetEventBus(&entityManager->GetEventBus());
+    
     // Create test input handler
-    TestInputHandler inputHandler;
+    TestInputHandler inputHandler(entityManager->GetEventBus());
     
     // Test memory management
     TestMemoryManagement();
     
     // Test blockchain interface
-    TestBlockchainInterface();
+    if (!TestBlockchainInterface()) {
+        std::cerr << "Blockchain interface test failed" << std::endl;
+        return 1;
+    }
+    
+    // Apply buffered input at the start of every tick
+    engine.RegisterTickBeginCallback([&](std::uint64_t tick) {
+        inputManager.DrainEvents();
+    });
     
     // Set up update callback
     engine.RegisterUpdateCallback([&](float deltaTime) {
-        // Update input manager
-        inputManager.Update();
-        
-        // Simulate input
+        // Simulate input from the platform layer
         static float timer = 0.0f;
         timer += deltaTime;
         
@@ -250,15 +344,15 @@ int main() {
             timer = 0.0f;
             
             // Simulate key press
-            inputManager.ProcessKeyEvent(KeyCode::Space, InputAction::Press, InputMod::None);
-            inputManager.ProcessKeyEvent(KeyCode::Space, InputAction::Release, InputMod::None);
+            inputManager.PushKeyEvent(KeyCode::Space, InputAction::Press, InputMod::None);
+            inputManager.PushKeyEvent(KeyCode::Space, InputAction::Release, InputMod::None);
             
             // Simulate mouse movement
             static double mouseX = 0.0;
             static double mouseY = 0.0;
             mouseX += 10.0;
             mouseY += 5.0;
-            inputManager.ProcessMouseMoveEvent(mouseX, mouseY);
+            inputManager.PushMouseMoveEvent(mouseX, mouseY);
         }
     });
     
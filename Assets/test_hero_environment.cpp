@@ -16,6 +16,9 @@
 #include "gameplay/hero_system.h"
 #include "gameplay/ability_types.h"
 #include "gameplay/hero_editor.h"
+#include "gameplay/projectile_system.h"
+#include "physics/spatial_grid.h"
+#include "resource/asset_manager.h"
 
 using namespace CHULUBME;
 
@@ -114,6 +117,13 @@ public:
             return false;
         }
 
+        // Initialize asset manager
+        AssetManager& assetManager = AssetManager::Instance();
+        if (!assetManager.Initialize()) {
+            std::cerr << "Failed to initialize asset manager" << std::endl;
+            return false;
+        }
+
         // Get entity manager
         m_entityManager = engine.GetEntityManager();
 
@@ -123,6 +133,10 @@ public:
         // Register ability system
         m_abilitySystem = m_entityManager->RegisterSystem<AbilitySystem>();
 
+        // Register spatial and projectile systems used by area and skillshot abilities
+        m_entityManager->RegisterSystem<SpatialSystem>();
+        m_entityManager->RegisterSystem<ProjectileSystem>();
+
         // Register ability types
         m_abilitySystem->RegisterAbilityType<DamageAbility>("DamageAbility");
         m_abilitySystem->RegisterAbilityType<HealAbility>("HealAbility");
@@ -162,6 +176,9 @@ public:
                 }
             }
 
+            // Upload assets loaded in the background
+            AssetManager::Instance().Update();
+
             // Start ImGui frame
             ImGui_ImplOpenGL3_NewFrame();
             ImGui_ImplSDL2_NewFrame(m_window);
@@ -196,6 +213,9 @@ public:
         // Shutdown engine
         Engine::Instance().Shutdown();
 
+        // Release assets while the GL context is alive
+        AssetManager::Instance().Shutdown();
+
         // Shutdown ImGui
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplSDL2_Shutdown();
@@ -288,7 +308,7 @@ private:
                 HeroComponent* heroComponent = hero.GetComponent<HeroComponent>();
                 if (heroComponent) {
                     std::string label = heroComponent->GetHeroName() + " (" + heroComponent->GetHeroID() + ")";
-                    bool isSelected = (m_selectedTestHero.IsActive() && m_selectedTestHero.GetID() == hero.GetID());
+                    bool isSelected = (m_selectedTestHero.IsValid() && m_selectedTestHero.GetID() == hero.GetID());
                     
                     if (ImGui::Selectable(label.c_str(), isSelected)) {
                         m_selectedTestHero = hero;
@@ -299,7 +319,7 @@ private:
         }
         
         // Display selected hero details
-        if (m_selectedTestHero.IsActive()) {
+        if (m_selectedTestHero.IsValid()) {
             HeroComponent* heroComponent = m_selectedTestHero.GetComponent<HeroComponent>();
             if (heroComponent) {
                 ImGui::Separator();
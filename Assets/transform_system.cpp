@@ -0,0 +1,346 @@
+#include "transform_system.h"
+#include "renderer.h"
+#include <algorithm>
+
+namespace CHULUBME {
+
+// Transform implementation
+Transform::Transform(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
+    : m_position(position)
+    , m_orientation(glm::radians(rotation))
+    , m_scale(scale)
+    , m_localMatrix(1.0f)
+    , m_worldMatrix(1.0f)
+    , m_dirty(true)
+{
+}
+
+void Transform::Initialize() {
+    UpdateModelMatrix();
+}
+
+void Transform::SetRotation(const glm::vec3& rotation) {
+    m_orientation = glm::quat(glm::radians(rotation));
+    MarkDirty();
+}
+
+glm::vec3 Transform::GetRotation() const {
+    return glm::degrees(glm::eulerAngles(m_orientation));
+}
+
+glm::mat4 Transform::GetLocalMatrix() {
+    if (m_dirty) {
+        UpdateModelMatrix();
+    }
+    return m_localMatrix;
+}
+
+glm::mat4 Transform::GetModelMatrix() {
+    if (m_parent == INVALID_ENTITY) {
+        return GetLocalMatrix();
+    }
+    return m_worldMatrix;
+}
+
+glm::vec3 Transform::GetWorldPosition() const {
+    if (m_parent == INVALID_ENTITY) {
+        return m_position;
+    }
+    return glm::vec3(m_worldMatrix[3].x, m_worldMatrix[3].y, m_worldMatrix[3].z);
+}
+
+void Transform::UpdateModelMatrix() {
+    // Translation * rotation * scale, composed without the intermediate products
+    const glm::mat3 rotation = glm::mat3_cast(m_orientation);
+    m_localMatrix = glm::mat4(glm::vec4(rotation[0] * m_scale.x, 0.0f),
+                              glm::vec4(rotation[1] * m_scale.y, 0.0f),
+                              glm::vec4(rotation[2] * m_scale.z, 0.0f),
+                              glm::vec4(m_position, 1.0f));
+    m_dirty = false;
+}
+
+// TransformSystem implementation
+TransformSystem::TransformSystem(EntityManager* manager)
+    : System(manager)
+    , m_freeSlotCount(0)
+    , m_orderDirty(false)
+    , m_updatedCount(0)
+{
+    RequireComponent<Transform>(ComponentAccess::Write);
+
+    // Other systems reparent transforms through it
+    SetExclusive(true);
+}
+
+void TransformSystem::Update(float deltaTime) {
+    UpdateWorldMatrices();
+}
+
+void TransformSystem::OnEntityAdded(Entity entity) {
+    Transform* transform = entity.GetComponent<Transform>();
+    if (!transform) {
+        return;
+    }
+
+    AddSlot(entity.GetID(), *transform);
+
+    // The parent is linked when the slots are re-sorted
+    if (transform->m_parent != INVALID_ENTITY) {
+        m_orderDirty = true;
+    }
+}
+
+void TransformSystem::OnEntityRemoved(Entity entity) {
+    auto it = m_lookup.find(entity.GetID());
+    if (it == m_lookup.end()) {
+        return;
+    }
+
+    const std::uint32_t slot = it->second;
+    m_lookup.erase(entity.GetID());
+
+    // Children are detached when the slots are re-sorted
+    if (m_childCounts[slot] > 0) {
+        m_orderDirty = true;
+    }
+    if (m_parents[slot] != NO_PARENT) {
+        --m_childCounts[m_parents[slot]];
+    }
+
+    m_entities[slot] = INVALID_ENTITY;
+    m_parents[slot] = NO_PARENT;
+    m_childCounts[slot] = 0;
+    m_dirty[slot] = 0;
+    ++m_freeSlotCount;
+}
+
+bool TransformSystem::SetParent(EntityID child, EntityID parent) {
+    auto childIt = m_lookup.find(child);
+    Transform* childTransform = m_manager->GetComponent<Transform>(child);
+    if (childIt == m_lookup.end() || !childTransform) {
+        return false;
+    }
+
+    std::uint32_t parentSlot = NO_PARENT;
+    if (parent != INVALID_ENTITY) {
+        auto parentIt = m_lookup.find(parent);
+        if (parentIt == m_lookup.end()) {
+            return false;
+        }
+        parentSlot = parentIt->second;
+
+        // Refuse to attach a transform below itself
+        EntityID ancestor = parent;
+        while (ancestor != INVALID_ENTITY) {
+            if (ancestor == child) {
+                return false;
+            }
+            const Transform* ancestorTransform = m_manager->GetComponent<Transform>(ancestor);
+            ancestor = ancestorTransform ? ancestorTransform->m_parent : INVALID_ENTITY;
+        }
+    }
+
+    if (childTransform->m_parent == parent) {
+        return true;
+    }
+
+    childTransform->m_parent = parent;
+    childTransform->m_spatialDirty = true;
+
+    const std::uint32_t slot = childIt->second;
+    m_dirty[slot] = 1;
+
+    // Relink in place while the order holds; otherwise the re-sort links everything
+    if (!m_orderDirty) {
+        if (m_parents[slot] != NO_PARENT) {
+            --m_childCounts[m_parents[slot]];
+        }
+
+        m_parents[slot] = parentSlot;
+        if (parentSlot != NO_PARENT) {
+            ++m_childCounts[parentSlot];
+
+            // Descendants of the child follow it, so only a later parent breaks the order
+            if (parentSlot > slot) {
+                m_orderDirty = true;
+            }
+        }
+    }
+
+    return true;
+}
+
+void TransformSystem::UpdateWorldMatrices() {
+    if (m_orderDirty || m_freeSlotCount * 2 > m_entities.size()) {
+        RebuildOrder();
+    }
+
+    // Read the local matrices that changed since the last update
+    m_manager->View<Transform>().ForEach([this](EntityID, Transform& transform) {
+        if (transform.m_hierarchyDirty) {
+            m_localMatrices[transform.m_hierarchyIndex] = transform.GetLocalMatrix();
+            m_dirty[transform.m_hierarchyIndex] = 1;
+            transform.m_hierarchyDirty = false;
+        }
+    });
+
+    ScopedScratch scratch;
+    FrameVector<std::uint32_t> updated{ ArenaAllocator<std::uint32_t>(scratch.GetArena()) };
+
+    // Parents precede their children, so a parent's world matrix is final when its children read it
+    const std::size_t count = m_entities.size();
+    const std::uint32_t* parents = m_parents.data();
+    const glm::mat4* localMatrices = m_localMatrices.data();
+    glm::mat4* worldMatrices = m_worldMatrices.data();
+    std::uint8_t* dirty = m_dirty.data();
+
+    for (std::size_t slot = 0; slot < count; ++slot) {
+        const std::uint32_t parent = parents[slot];
+        if (parent != NO_PARENT) {
+            dirty[slot] |= dirty[parent];
+        }
+        if (!dirty[slot]) {
+            continue;
+        }
+
+        worldMatrices[slot] = parent == NO_PARENT ? localMatrices[slot] : worldMatrices[parent] * localMatrices[slot];
+        updated.push_back(static_cast<std::uint32_t>(slot));
+    }
+
+    for (std::uint32_t slot : updated) {
+        Transform* transform = m_manager->GetComponent<Transform>(m_entities[slot]);
+        transform->m_worldMatrix = worldMatrices[slot];
+
+        // A child's world position moves with its parent
+        if (parents[slot] != NO_PARENT) {
+            transform->m_spatialDirty = true;
+        }
+        dirty[slot] = 0;
+    }
+
+    m_updatedCount = updated.size();
+}
+
+void TransformSystem::AddSlot(EntityID entity, Transform& transform) {
+    const std::uint32_t slot = static_cast<std::uint32_t>(m_entities.size());
+
+    m_entities.push_back(entity);
+    m_parents.push_back(NO_PARENT);
+    m_childCounts.push_back(0);
+    m_localMatrices.push_back(transform.GetLocalMatrix());
+    m_worldMatrices.push_back(m_localMatrices.back());
+    m_dirty.push_back(1);
+
+    m_lookup[entity] = slot;
+    transform.m_hierarchyIndex = slot;
+    transform.m_hierarchyDirty = false;
+}
+
+void TransformSystem::RebuildOrder() {
+    constexpr std::uint32_t REMOVED = 0xFFFFFFFFu;
+
+    const std::size_t count = m_entities.size();
+    ScopedScratch scratch;
+    Transform** transforms = scratch.AllocateArray<Transform*>(count);
+    std::uint32_t* parents = scratch.AllocateArray<std::uint32_t>(count);
+    std::uint32_t* depths = scratch.AllocateArray<std::uint32_t>(count);
+    std::uint32_t* newSlots = scratch.AllocateArray<std::uint32_t>(count);
+
+    // Resolve parents from the components, which hold the hierarchy of record
+    for (std::size_t slot = 0; slot < count; ++slot) {
+        parents[slot] = NO_PARENT;
+        transforms[slot] = m_entities[slot] != INVALID_ENTITY ? m_manager->GetComponent<Transform>(m_entities[slot]) : nullptr;
+
+        Transform* transform = transforms[slot];
+        if (!transform || transform->m_parent == INVALID_ENTITY) {
+            continue;
+        }
+
+        auto parentIt = m_lookup.find(transform->m_parent);
+        if (parentIt != m_lookup.end()) {
+            parents[slot] = parentIt->second;
+        } else {
+            // The parent was removed; keep the local placement as a root
+            transform->m_parent = INVALID_ENTITY;
+            transform->m_spatialDirty = true;
+            m_dirty[slot] = 1;
+        }
+    }
+
+    // Depth of every live slot; SetParent keeps the hierarchy acyclic
+    std::uint32_t maxDepth = 0;
+    std::size_t liveCount = 0;
+    for (std::size_t slot = 0; slot < count; ++slot) {
+        if (!transforms[slot]) {
+            depths[slot] = REMOVED;
+            continue;
+        }
+
+        std::uint32_t depth = 0;
+        for (std::uint32_t parent = parents[slot]; parent != NO_PARENT; parent = parents[parent]) {
+            ++depth;
+        }
+        depths[slot] = depth;
+        maxDepth = std::max(maxDepth, depth);
+        ++liveCount;
+    }
+
+    // Counting sort by depth, stable so siblings keep their relative order
+    std::uint32_t* depthOffsets = scratch.AllocateArray<std::uint32_t>(maxDepth + 1);
+    std::fill(depthOffsets, depthOffsets + maxDepth + 1, 0u);
+    for (std::size_t slot = 0; slot < count; ++slot) {
+        if (depths[slot] != REMOVED) {
+            ++depthOffsets[depths[slot]];
+        }
+    }
+
+    std::uint32_t offset = 0;
+    for (std::uint32_t depth = 0; depth <= maxDepth; ++depth) {
+        const std::uint32_t depthCount = depthOffsets[depth];
+        depthOffsets[depth] = offset;
+        offset += depthCount;
+    }
+
+    for (std::size_t slot = 0; slot < count; ++slot) {
+        newSlots[slot] = depths[slot] != REMOVED ? depthOffsets[depths[slot]]++ : REMOVED;
+    }
+
+    std::vector<EntityID> entities(liveCount);
+    std::vector<std::uint32_t> newParents(liveCount);
+    std::vector<std::uint32_t> childCounts(liveCount, 0);
+    std::vector<glm::mat4> localMatrices(liveCount);
+    std::vector<glm::mat4> worldMatrices(liveCount);
+    std::vector<std::uint8_t> dirty(liveCount);
+
+    for (std::size_t slot = 0; slot < count; ++slot) {
+        const std::uint32_t newSlot = newSlots[slot];
+        if (newSlot == REMOVED) {
+            continue;
+        }
+
+        const std::uint32_t parent = parents[slot] != NO_PARENT ? newSlots[parents[slot]] : NO_PARENT;
+        entities[newSlot] = m_entities[slot];
+        newParents[newSlot] = parent;
+        localMatrices[newSlot] = m_localMatrices[slot];
+        worldMatrices[newSlot] = m_worldMatrices[slot];
+        dirty[newSlot] = m_dirty[slot];
+        if (parent != NO_PARENT) {
+            ++childCounts[parent];
+        }
+
+        m_lookup[m_entities[slot]] = newSlot;
+        transforms[slot]->m_hierarchyIndex = newSlot;
+    }
+
+    m_entities.swap(entities);
+    m_parents.swap(newParents);
+    m_childCounts.swap(childCounts);
+    m_localMatrices.swap(localMatrices);
+    m_worldMatrices.swap(worldMatrices);
+    m_dirty.swap(dirty);
+
+    m_freeSlotCount = 0;
+    m_orderDirty = false;
+}
+
+} // namespace CHULUBME
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "../core/ecs.h"
+#include "../core/containers.h"
+
+namespace CHULUBME {
+
+// Forward declarations
+class Transform;
+
+/**
+ * @brief System maintaining the parent/child hierarchy of transforms
+ *
+ * Every transform has a slot in structure-of-arrays storage sorted by depth,
+ * so a parent always precedes its children. UpdateWorldMatrices copies the
+ * local matrices that changed into the arrays, then makes one linear pass in
+ * which a slot is recomputed only if it changed or its parent was recomputed,
+ * so untouched subtrees cost a flag test per transform. The results are
+ * written back to the changed Transform components.
+ *
+ * Hierarchy changes that break the depth order (attaching to a later slot,
+ * removing a transform with children) re-sort the arrays on the next update.
+ * Children of a removed transform become roots.
+ */
+class TransformSystem : public System {
+public:
+    TransformSystem(EntityManager* manager);
+    ~TransformSystem() = default;
+
+    // Update the transform system
+    void Update(float deltaTime) override;
+
+    // Called when an entity is added to this system
+    void OnEntityAdded(Entity entity) override;
+
+    // Called when an entity is removed from this system
+    void OnEntityRemoved(Entity entity) override;
+
+    // Attach a transform to a parent (INVALID_ENTITY detaches it); fails if it would create a cycle
+    bool SetParent(EntityID child, EntityID parent);
+
+    // Recompute the world matrices of changed transforms and their descendants
+    void UpdateWorldMatrices();
+
+    // Get the number of transforms in the hierarchy
+    std::size_t GetTransformCount() const { return m_lookup.size(); }
+
+    // Get the number of world matrices recomputed by the last update
+    std::size_t GetUpdatedCount() const { return m_updatedCount; }
+
+private:
+    // Parent slot of a root
+    static constexpr std::uint32_t NO_PARENT = 0xFFFFFFFFu;
+
+    // Append a slot for a transform
+    void AddSlot(EntityID entity, Transform& transform);
+
+    // Re-sort the slots by depth and drop removed ones
+    void RebuildOrder();
+
+    // Hierarchy in depth order
+    std::vector<EntityID> m_entities;
+    std::vector<std::uint32_t> m_parents;
+    std::vector<std::uint32_t> m_childCounts;
+    std::vector<glm::mat4> m_localMatrices;
+    std::vector<glm::mat4> m_worldMatrices;
+    std::vector<std::uint8_t> m_dirty;
+
+    // Slot of each entity
+    FlatHashMap<EntityID, std::uint32_t> m_lookup;
+
+    // Number of slots freed by removed transforms
+    std::size_t m_freeSlotCount;
+
+    // Set when the slots are no longer in depth order
+    bool m_orderDirty;
+
+    // Statistics of the last update
+    std::size_t m_updatedCount;
+};
+
+} // namespace CHULUBME
@@ -0,0 +1,104 @@
+#include "vision_system.h"
+#include "../rendering/renderer.h"
+#include <cmath>
+
+namespace CHULUBME {
+
+// VisionComponent implementation
+VisionComponent::VisionComponent(std::uint8_t team, float sightRadius)
+    : m_team(0)
+    , m_sightRadius(0.0f)
+{
+    SetTeam(team);
+    SetSightRadius(sightRadius);
+}
+
+// FogOfWar implementation
+FogOfWar::FogOfWar(float cellSize)
+    : m_cellSize(cellSize > 0.0f ? cellSize : 1.0f)
+    , m_inverseCellSize(1.0f / m_cellSize)
+{
+}
+
+void FogOfWar::Reveal(std::uint8_t team, const glm::vec3& center, float radius) {
+    if (team >= MAX_VISION_TEAMS || radius <= 0.0f) {
+        return;
+    }
+
+    const std::uint32_t teamBit = 1u << team;
+    const float radiusSquared = radius * radius;
+    const float halfCell = m_cellSize * 0.5f;
+
+    const std::int32_t minCellX = GetCellCoordinate(center.x - radius);
+    const std::int32_t maxCellX = GetCellCoordinate(center.x + radius);
+    const std::int32_t minCellZ = GetCellCoordinate(center.z - radius);
+    const std::int32_t maxCellZ = GetCellCoordinate(center.z + radius);
+
+    for (std::int32_t cellX = minCellX; cellX <= maxCellX; ++cellX) {
+        const float dx = static_cast<float>(cellX) * m_cellSize + halfCell - center.x;
+
+        for (std::int32_t cellZ = minCellZ; cellZ <= maxCellZ; ++cellZ) {
+            const float dz = static_cast<float>(cellZ) * m_cellSize + halfCell - center.z;
+            if (dx * dx + dz * dz <= radiusSquared) {
+                m_cells[MakeCellKey(cellX, cellZ)] |= teamBit;
+            }
+        }
+    }
+
+    // A source always sees the cell it stands in
+    m_cells[MakeCellKey(GetCellCoordinate(center.x), GetCellCoordinate(center.z))] |= teamBit;
+}
+
+std::uint32_t FogOfWar::GetVisionMask(const glm::vec3& position) const {
+    auto it = m_cells.find(MakeCellKey(GetCellCoordinate(position.x), GetCellCoordinate(position.z)));
+    return it != m_cells.end() ? it->second : 0;
+}
+
+bool FogOfWar::IsVisible(std::uint8_t team, const glm::vec3& position) const {
+    return team < MAX_VISION_TEAMS && (GetVisionMask(position) & (1u << team)) != 0;
+}
+
+std::int32_t FogOfWar::GetCellCoordinate(float value) const {
+    return static_cast<std::int32_t>(std::floor(value * m_inverseCellSize));
+}
+
+std::uint64_t FogOfWar::MakeCellKey(std::int32_t x, std::int32_t z) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(z);
+}
+
+// VisionSystem implementation
+VisionSystem::VisionSystem(EntityManager* manager, float cellSize)
+    : System(manager)
+    , m_fogOfWar(cellSize)
+    , m_localTeam(0)
+{
+    RequireComponent<VisionComponent>(ComponentAccess::Read);
+    RequireComponent<Transform>(ComponentAccess::Read);
+
+    // Rebuilds the fog other systems query
+    SetExclusive(true);
+
+    // Visibility decides what clients are sent, so it follows the simulation
+    SetFixedStep(true);
+}
+
+void VisionSystem::Update(float deltaTime) {
+    m_fogOfWar.Clear();
+
+    m_manager->View<VisionComponent, Transform>().ForEach(
+        [this](EntityID, VisionComponent& vision, Transform& transform) {
+            m_fogOfWar.Reveal(vision.GetTeam(), transform.GetWorldPosition(), vision.GetSightRadius());
+        });
+}
+
+bool VisionSystem::IsRevealedTo(EntityID entity, std::uint8_t team) const {
+    const VisionComponent* vision = m_manager->GetComponent<VisionComponent>(entity);
+    if (!vision || vision->GetTeam() == team) {
+        return true;
+    }
+
+    const Transform* transform = m_manager->GetComponent<Transform>(entity);
+    return !transform || m_fogOfWar.IsVisible(team, transform->GetWorldPosition());
+}
+
+} // namespace CHULUBME
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "../core/ecs.h"
+#include "../core/containers.h"
+
+namespace CHULUBME {
+
+// Number of teams a fog of war can track (one bit of a cell mask each)
+constexpr std::uint8_t MAX_VISION_TEAMS = 32;
+
+/**
+ * @brief Component giving an entity a team and a sight radius
+ *
+ * Entities without a vision component are neutral and always revealed.
+ * A sight radius of zero gives no vision (e.g. for decorations owned by a team).
+ */
+class VisionComponent : public Component {
+public:
+    VisionComponent(std::uint8_t team = 0, float sightRadius = 0.0f);
+    ~VisionComponent() = default;
+
+    // Set team
+    void SetTeam(std::uint8_t team) { m_team = team < MAX_VISION_TEAMS ? team : 0; }
+
+    // Get team
+    std::uint8_t GetTeam() const { return m_team; }
+
+    // Set sight radius
+    void SetSightRadius(float sightRadius) { m_sightRadius = sightRadius > 0.0f ? sightRadius : 0.0f; }
+
+    // Get sight radius
+    float GetSightRadius() const { return m_sightRadius; }
+
+private:
+    // Team the entity belongs to
+    std::uint8_t m_team;
+
+    // Radius the entity reveals for its team
+    float m_sightRadius;
+};
+
+/**
+ * @brief Per-team vision over a grid of cells on the XZ map plane
+ *
+ * Each occupied cell stores a bit mask of the teams that currently see it.
+ * Cells are revealed when their center lies within a sight radius, so vision
+ * edges are accurate to one cell. Only cells seen by some team are stored,
+ * and clearing keeps their storage for the next rebuild.
+ */
+class FogOfWar {
+public:
+    FogOfWar(float cellSize = 2.0f);
+    ~FogOfWar() = default;
+
+    // Hide every cell from every team
+    void Clear() { m_cells.clear(); }
+
+    // Reveal the cells within a radius of a point to a team
+    void Reveal(std::uint8_t team, const glm::vec3& center, float radius);
+
+    // Get the mask of teams that see a point
+    std::uint32_t GetVisionMask(const glm::vec3& position) const;
+
+    // Check if a team sees a point
+    bool IsVisible(std::uint8_t team, const glm::vec3& position) const;
+
+    // Get the cell size
+    float GetCellSize() const { return m_cellSize; }
+
+private:
+    // Cell coordinate of a position
+    std::int32_t GetCellCoordinate(float value) const;
+
+    // Pack cell coordinates into a cell key
+    static std::uint64_t MakeCellKey(std::int32_t x, std::int32_t z);
+
+    // Cell size
+    float m_cellSize;
+    float m_inverseCellSize;
+
+    // Vision mask of each revealed cell
+    FlatHashMap<std::uint64_t, std::uint32_t> m_cells;
+};
+
+/**
+ * @brief System rebuilding the fog of war from every vision source
+ *
+ * Each update clears the fog and reveals a circle around every entity with a
+ * sight radius for its team. Client-side code (rendering, UI, sound) checks
+ * IsRevealed to skip enemies the local team cannot see; the simulation itself
+ * is unaffected. The system is exclusive so fog queries made by other systems
+ * never race with the rebuild.
+ */
+class VisionSystem : public System {
+public:
+    VisionSystem(EntityManager* manager, float cellSize = 2.0f);
+    ~VisionSystem() = default;
+
+    // Rebuild the fog of war
+    void Update(float deltaTime) override;
+
+    // Set the team of the local player
+    void SetLocalTeam(std::uint8_t team) { m_localTeam = team < MAX_VISION_TEAMS ? team : 0; }
+
+    // Get the team of the local player
+    std::uint8_t GetLocalTeam() const { return m_localTeam; }
+
+    // Check if the local team can see an entity
+    bool IsRevealed(EntityID entity) const { return IsRevealedTo(entity, m_localTeam); }
+
+    // Check if a team can see an entity (its own and neutral entities always count as seen)
+    bool IsRevealedTo(EntityID entity, std::uint8_t team) const;
+
+    // Get the fog of war
+    const FogOfWar& GetFogOfWar() const { return m_fogOfWar; }
+
+private:
+    // Vision of every team
+    FogOfWar m_fogOfWar;
+
+    // Team of the local player
+    std::uint8_t m_localTeam;
+};
+
+} // namespace CHULUBME